@@ -0,0 +1,144 @@
+#include "AssetPack.h"
+
+#include <stb_image.h>
+
+#include <bit>
+#include <climits>
+#include <cstring>
+#include <iostream>
+
+bool FAssetPack::Open(const std::filesystem::path& InPackFilePath)
+{
+    PackFilePath = InPackFilePath;
+    if (!PackFile.OpenForRead(PackFilePath))
+    {
+        std::cout << "Pacote de assets nao encontrado: " << PackFilePath << std::endl;
+        return false;
+    }
+
+    // Tudo e validado aqui uma unica vez, assim as buscas nao precisam conferir os limites do arquivo
+    const std::uint64_t PackSize = PackFile.GetSize();
+    const FAssetPackHeader* Header = reinterpret_cast<const FAssetPackHeader*>(PackFile.GetData());
+    bool bIsValid = PackSize >= sizeof(FAssetPackHeader) &&
+                    Header->Magic == FAssetPackHeader::PackMagic &&
+                    Header->FormatVersion == FAssetPackHeader::PackFormatVersion &&
+                    Header->FileSize == PackSize &&
+                    std::has_single_bit(Header->TableSize) &&
+                    Header->NumAssets < Header->TableSize &&
+                    Header->TableOffset % alignof(FAssetPackEntry) == 0 &&
+                    Header->TableOffset <= PackSize &&
+                    static_cast<std::uint64_t>(Header->TableSize) * sizeof(FAssetPackEntry) <= PackSize - Header->TableOffset;
+
+    if (bIsValid)
+    {
+        const FAssetPackEntry* Table = reinterpret_cast<const FAssetPackEntry*>(PackFile.GetData() + Header->TableOffset);
+        std::uint32_t NumAssets = 0;
+        for (const FAssetPackEntry& Entry : std::span{ Table, Header->TableSize })
+        {
+            if (Entry.NameSize == 0)
+            {
+                continue;
+            }
+
+            NumAssets++;
+            bIsValid &= Entry.NameOffset <= PackSize && Entry.NameSize <= PackSize - Entry.NameOffset &&
+                        Entry.DataOffset <= PackSize && Entry.DataSize <= PackSize - Entry.DataOffset &&
+                        Entry.DataSize <= INT_MAX && Entry.UncompressedSize <= INT_MAX &&
+                        (Entry.Compression == EAssetCompression::Zlib || (Entry.Compression == EAssetCompression::None && Entry.DataSize == Entry.UncompressedSize));
+        }
+        bIsValid &= NumAssets == Header->NumAssets;
+    }
+
+    if (!bIsValid)
+    {
+        std::cout << "Pacote de assets invalido: " << PackFilePath << std::endl;
+        PackFile.Close();
+        return false;
+    }
+
+    std::cout << "Pacote de assets " << PackFilePath << " com " << Header->NumAssets << " assets" << std::endl;
+    return true;
+}
+
+std::uint32_t FAssetPack::GetNumAssets() const
+{
+    return IsOpen() ? reinterpret_cast<const FAssetPackHeader*>(PackFile.GetData())->NumAssets : 0;
+}
+
+const FAssetPackEntry* FAssetPack::FindEntry(std::string_view InName) const
+{
+    if (!IsOpen() || InName.empty())
+    {
+        return nullptr;
+    }
+
+    const FAssetPackHeader* Header = reinterpret_cast<const FAssetPackHeader*>(PackFile.GetData());
+    const FAssetPackEntry* Table = reinterpret_cast<const FAssetPackEntry*>(PackFile.GetData() + Header->TableOffset);
+    const std::uint64_t NameHash = HashAssetName(InName);
+    const std::uint32_t TableMask = Header->TableSize - 1;
+
+    // Sondagem linear. A tabela sempre tem entradas vazias, entao a busca termina
+    for (std::uint32_t Slot = static_cast<std::uint32_t>(NameHash) & TableMask;; Slot = (Slot + 1) & TableMask)
+    {
+        const FAssetPackEntry& Entry = Table[Slot];
+        if (Entry.NameSize == 0)
+        {
+            return nullptr;
+        }
+
+        const std::string_view EntryName{ reinterpret_cast<const char*>(PackFile.GetData() + Entry.NameOffset), Entry.NameSize };
+        if (Entry.NameHash == NameHash && EntryName == InName)
+        {
+            return &Entry;
+        }
+    }
+}
+
+std::span<const std::uint8_t> FAssetPack::GetMappedData(std::string_view InName) const
+{
+    const FAssetPackEntry* Entry = FindEntry(InName);
+    if (Entry == nullptr || Entry->Compression != EAssetCompression::None)
+    {
+        return {};
+    }
+    return { PackFile.GetData() + Entry->DataOffset, static_cast<std::size_t>(Entry->DataSize) };
+}
+
+bool FAssetPack::ReadEntry(const FAssetPackEntry& InEntry, std::uint8_t* OutData) const
+{
+    const std::uint8_t* EntryData = PackFile.GetData() + InEntry.DataOffset;
+    if (InEntry.Compression == EAssetCompression::None)
+    {
+        std::memcpy(OutData, EntryData, InEntry.DataSize);
+        return true;
+    }
+
+    // O decodificador zlib do stb_image descomprime o que o empacotador gerou com o stb_image_write
+    const int UncompressedSize = static_cast<int>(InEntry.UncompressedSize);
+    const int DecodedSize = stbi_zlib_decode_buffer(reinterpret_cast<char*>(OutData), UncompressedSize, reinterpret_cast<const char*>(EntryData), static_cast<int>(InEntry.DataSize));
+    return DecodedSize == UncompressedSize;
+}
+
+bool FAssetPack::ReadAsset(std::string_view InName, std::vector<std::uint8_t>& OutData) const
+{
+    const FAssetPackEntry* Entry = FindEntry(InName);
+    if (Entry == nullptr)
+    {
+        return false;
+    }
+
+    OutData.resize(Entry->UncompressedSize);
+    return ReadEntry(*Entry, OutData.data());
+}
+
+bool FAssetPack::ReadAsset(std::string_view InName, std::string& OutData) const
+{
+    const FAssetPackEntry* Entry = FindEntry(InName);
+    if (Entry == nullptr)
+    {
+        return false;
+    }
+
+    OutData.resize(Entry->UncompressedSize);
+    return ReadEntry(*Entry, reinterpret_cast<std::uint8_t*>(OutData.data()));
+}
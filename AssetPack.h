@@ -0,0 +1,95 @@
+#pragma once
+
+#include "MappedFile.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// FNV-1a de 64 bits, usado como chave da tabela de conteudo do pacote
+constexpr std::uint64_t HashAssetName(std::string_view InName)
+{
+    std::uint64_t Hash = 0xCBF29CE484222325ull;
+    for (const char Char : InName)
+    {
+        Hash ^= static_cast<std::uint8_t>(Char);
+        Hash *= 0x100000001B3ull;
+    }
+    return Hash;
+}
+
+enum class EAssetCompression : std::uint32_t
+{
+    None,
+    Zlib
+};
+
+// Layout do arquivo: cabecalho, tabela de conteudo com TableSize entradas (enderecamento aberto pelo
+// hash do nome), os nomes e por fim os dados de cada asset alinhados em AssetPackDataAlignment bytes
+struct FAssetPackHeader
+{
+    static constexpr std::uint32_t PackMagic = 0x4B504D42; // "BMPK"
+    static constexpr std::uint32_t PackFormatVersion = 1;
+
+    std::uint32_t Magic;
+    std::uint32_t FormatVersion;
+    std::uint32_t NumAssets;
+
+    // Sempre uma potencia de 2, com pelo menos metade das entradas vazias
+    std::uint32_t TableSize;
+    std::uint64_t TableOffset;
+    std::uint64_t FileSize;
+};
+
+struct FAssetPackEntry
+{
+    std::uint64_t NameHash;
+    std::uint64_t DataOffset;
+    std::uint64_t DataSize;
+    std::uint64_t UncompressedSize;
+    std::uint32_t NameOffset;
+
+    // Zero marca uma entrada vazia da tabela
+    std::uint32_t NameSize;
+    EAssetCompression Compression;
+    std::uint32_t Padding;
+};
+
+constexpr std::uint64_t AssetPackDataAlignment = 64;
+
+// Pacote de assets mapeado na memoria. Os assets sao nomeados pelo caminho relativo ao diretorio
+// de origem, por exemplo "shaders/triangle.vert". Depois de aberto o pacote so e lido, entao pode
+// ser acessado por varias threads ao mesmo tempo
+class FAssetPack
+{
+public:
+
+    bool Open(const std::filesystem::path& InPackFilePath);
+
+    bool IsOpen() const { return PackFile.IsOpen(); }
+
+    const std::filesystem::path& GetPackFilePath() const { return PackFilePath; }
+
+    std::uint32_t GetNumAssets() const;
+
+    bool Contains(std::string_view InName) const { return FindEntry(InName) != nullptr; }
+
+    // Dados do asset direto do arquivo mapeado, sem nenhuma copia. Vazio se o asset nao existir ou estiver comprimido
+    std::span<const std::uint8_t> GetMappedData(std::string_view InName) const;
+
+    // Copia o asset para OutData, descomprimindo se necessario
+    bool ReadAsset(std::string_view InName, std::vector<std::uint8_t>& OutData) const;
+    bool ReadAsset(std::string_view InName, std::string& OutData) const;
+
+private:
+
+    const FAssetPackEntry* FindEntry(std::string_view InName) const;
+
+    bool ReadEntry(const FAssetPackEntry& InEntry, std::uint8_t* OutData) const;
+
+    std::filesystem::path PackFilePath;
+    FMappedFile PackFile;
+};
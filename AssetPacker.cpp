@@ -0,0 +1,222 @@
+// Gera o pacote de assets lido pelo FAssetPack
+//
+// Uso: BlueMarblePacker <Pacote> <Prefixo>=<Diretorio>...
+//
+// Todos os arquivos de cada diretorio entram no pacote com o nome "<Prefixo>/<caminho relativo>"
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+#include "AssetPack.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+struct FPackedAsset
+{
+    std::string Name;
+    std::vector<std::uint8_t> Data;
+    std::uint64_t UncompressedSize = 0;
+    EAssetCompression Compression = EAssetCompression::None;
+};
+
+static bool ReadFile(const std::filesystem::path& InFilePath, std::vector<std::uint8_t>& OutData)
+{
+    std::ifstream FileStream{ InFilePath, std::ios::in | std::ios::binary };
+    if (!FileStream)
+    {
+        return false;
+    }
+
+    OutData.assign(std::istreambuf_iterator<char>(FileStream), std::istreambuf_iterator<char>());
+    return true;
+}
+
+static void CompressAsset(FPackedAsset& InOutAsset)
+{
+    constexpr int CompressionQuality = 8;
+
+    InOutAsset.UncompressedSize = InOutAsset.Data.size();
+    if (InOutAsset.Data.empty())
+    {
+        return;
+    }
+
+    int CompressedSize = 0;
+    std::uint8_t* CompressedData = stbi_zlib_compress(InOutAsset.Data.data(), static_cast<int>(InOutAsset.Data.size()), &CompressedSize, CompressionQuality);
+    if (CompressedData == nullptr)
+    {
+        return;
+    }
+
+    // Arquivos ja comprimidos (jpg, png) quase nao diminuem, entao ficam sem compressao e sao lidos
+    // direto do arquivo mapeado
+    if (static_cast<std::uint64_t>(CompressedSize) * 10 < InOutAsset.Data.size() * 9)
+    {
+        InOutAsset.Data.assign(CompressedData, CompressedData + CompressedSize);
+        InOutAsset.Compression = EAssetCompression::Zlib;
+    }
+    STBIW_FREE(CompressedData);
+}
+
+static std::uint64_t AlignOffset(std::uint64_t InOffset, std::uint64_t InAlignment)
+{
+    return (InOffset + InAlignment - 1) / InAlignment * InAlignment;
+}
+
+static bool WritePack(const std::filesystem::path& InPackFilePath, const std::vector<FPackedAsset>& InAssets)
+{
+    FAssetPackHeader Header{};
+    Header.Magic = FAssetPackHeader::PackMagic;
+    Header.FormatVersion = FAssetPackHeader::PackFormatVersion;
+    Header.NumAssets = static_cast<std::uint32_t>(InAssets.size());
+    Header.TableSize = std::bit_ceil(std::max<std::uint32_t>(Header.NumAssets * 2, 2));
+    Header.TableOffset = AlignOffset(sizeof(FAssetPackHeader), alignof(FAssetPackEntry));
+
+    // Os nomes ficam logo depois da tabela
+    std::vector<FAssetPackEntry> Table(Header.TableSize);
+    std::string Names;
+    std::uint64_t NamesOffset = Header.TableOffset + Header.TableSize * sizeof(FAssetPackEntry);
+    for (const FPackedAsset& Asset : InAssets)
+    {
+        Names += Asset.Name;
+    }
+
+    std::uint64_t DataOffset = AlignOffset(NamesOffset + Names.size(), AssetPackDataAlignment);
+    std::vector<std::uint64_t> AssetDataOffsets;
+    for (const FPackedAsset& Asset : InAssets)
+    {
+        const std::uint64_t NameHash = HashAssetName(Asset.Name);
+        const std::uint32_t TableMask = Header.TableSize - 1;
+
+        std::uint32_t Slot = static_cast<std::uint32_t>(NameHash) & TableMask;
+        while (Table[Slot].NameSize != 0)
+        {
+            Slot = (Slot + 1) & TableMask;
+        }
+
+        FAssetPackEntry& Entry = Table[Slot];
+        Entry.NameHash = NameHash;
+        Entry.NameOffset = static_cast<std::uint32_t>(NamesOffset);
+        Entry.NameSize = static_cast<std::uint32_t>(Asset.Name.size());
+        Entry.DataOffset = DataOffset;
+        Entry.DataSize = Asset.Data.size();
+        Entry.UncompressedSize = Asset.UncompressedSize;
+        Entry.Compression = Asset.Compression;
+
+        AssetDataOffsets.push_back(DataOffset);
+        NamesOffset += Asset.Name.size();
+        DataOffset = AlignOffset(DataOffset + Asset.Data.size(), AssetPackDataAlignment);
+    }
+    Header.FileSize = InAssets.empty() ? NamesOffset : AssetDataOffsets.back() + InAssets.back().Data.size();
+
+    // Escreve num arquivo temporario e renomeia no final, assim um pacote incompleto nunca e lido
+    std::filesystem::path TempFilePath = InPackFilePath;
+    TempFilePath += ".tmp";
+
+    std::ofstream PackStream{ TempFilePath, std::ios::out | std::ios::binary | std::ios::trunc };
+    const auto WriteAt = [&PackStream](std::uint64_t InOffset, const void* InData, std::size_t InSize)
+    {
+        PackStream.seekp(static_cast<std::streamoff>(InOffset));
+        PackStream.write(static_cast<const char*>(InData), static_cast<std::streamsize>(InSize));
+    };
+
+    WriteAt(0, &Header, sizeof(Header));
+    WriteAt(Header.TableOffset, Table.data(), Table.size() * sizeof(FAssetPackEntry));
+    WriteAt(Header.TableOffset + Table.size() * sizeof(FAssetPackEntry), Names.data(), Names.size());
+    for (std::size_t AssetIndex = 0; AssetIndex < InAssets.size(); ++AssetIndex)
+    {
+        WriteAt(AssetDataOffsets[AssetIndex], InAssets[AssetIndex].Data.data(), InAssets[AssetIndex].Data.size());
+    }
+
+    PackStream.close();
+    if (!PackStream)
+    {
+        std::cout << "Erro ao escrever " << TempFilePath << std::endl;
+        return false;
+    }
+
+    std::error_code ErrorCode;
+    std::filesystem::rename(TempFilePath, InPackFilePath, ErrorCode);
+    if (ErrorCode)
+    {
+        std::cout << "Erro ao gravar " << InPackFilePath << ": " << ErrorCode.message() << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+int main(int Argc, char** Argv)
+{
+    if (Argc < 3)
+    {
+        std::cout << "Uso: " << Argv[0] << " <Pacote> <Prefixo>=<Diretorio>..." << std::endl;
+        return 1;
+    }
+
+    std::vector<FPackedAsset> Assets;
+    for (int ArgIndex = 2; ArgIndex < Argc; ++ArgIndex)
+    {
+        const std::string_view Arg = Argv[ArgIndex];
+        const std::size_t Separator = Arg.find('=');
+        if (Separator == std::string_view::npos)
+        {
+            std::cout << "Argumento invalido, esperado <Prefixo>=<Diretorio>: " << Arg << std::endl;
+            return 1;
+        }
+
+        const std::string_view Prefix = Arg.substr(0, Separator);
+        const std::filesystem::path SourceDir = Arg.substr(Separator + 1);
+
+        std::error_code ErrorCode;
+        for (const std::filesystem::directory_entry& DirEntry : std::filesystem::recursive_directory_iterator(SourceDir, ErrorCode))
+        {
+            if (!DirEntry.is_regular_file())
+            {
+                continue;
+            }
+
+            FPackedAsset Asset;
+            Asset.Name = std::string{ Prefix } + '/' + DirEntry.path().lexically_relative(SourceDir).generic_string();
+            if (!ReadFile(DirEntry.path(), Asset.Data))
+            {
+                std::cout << "Erro ao ler " << DirEntry.path() << std::endl;
+                return 1;
+            }
+
+            CompressAsset(Asset);
+            Assets.push_back(std::move(Asset));
+        }
+
+        if (ErrorCode)
+        {
+            std::cout << "Erro ao listar " << SourceDir << ": " << ErrorCode.message() << std::endl;
+            return 1;
+        }
+    }
+
+    // A ordem dos arquivos no disco nao e garantida, ordenar deixa o pacote identico entre builds
+    std::sort(Assets.begin(), Assets.end(), [](const FPackedAsset& A, const FPackedAsset& B)
+    {
+        return A.Name < B.Name;
+    });
+
+    const std::filesystem::path PackFilePath = Argv[1];
+    if (!WritePack(PackFilePath, Assets))
+    {
+        return 1;
+    }
+
+    for (const FPackedAsset& Asset : Assets)
+    {
+        std::cout << Asset.Name << " : " << Asset.Data.size() << " / " << Asset.UncompressedSize << " bytes" << std::endl;
+    }
+    std::cout << "Pacote " << PackFilePath << " gerado com " << Assets.size() << " assets" << std::endl;
+    return 0;
+}
@@ -0,0 +1,416 @@
+// Micro benchmarks do codigo de CPU do BlueMarble: geracao de malhas e instancias, decodificacao
+// das texturas, leitura dos shaders e matrizes da camera. Nao cria contexto OpenGL.
+//
+// Uso: BlueMarbleBench [--filter <Texto>] [--min-time <Segundos>] [--workers <N>] [--output <Arquivo.json>]
+//
+// Cada benchmark e repetido ate passar de --min-time segundos. O resultado vai para o console e para
+// um JSON com ns/op, itens e bytes por segundo e alocacoes por operacao (contadas pelo FMemoryTracker)
+
+#include "Camera.h"
+#include "MemoryTracker.h"
+#include "MeshGenerators.h"
+#include "ShaderManager.h"
+#include "WorkerPool.h"
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifndef BLUEMARBLE_SHADERS_DIR
+#define BLUEMARBLE_SHADERS_DIR "shaders"
+#endif
+
+#ifndef BLUEMARBLE_TEXTURES_DIR
+#define BLUEMARBLE_TEXTURES_DIR "textures"
+#endif
+
+struct FBenchmarkSettings
+{
+    std::string Filter;
+    double MinTime = 0.5;
+    std::uint32_t NumWorkers = FWorkerPool::DefaultNumWorkers();
+    std::filesystem::path OutputPath = "BlueMarbleBench.json";
+};
+
+struct FBenchmarkResult
+{
+    std::string Name;
+    std::uint64_t NumIterations = 0;
+    double NanosecondsPerOp = 0.0;
+    double ItemsPerSecond = 0.0;
+    double BytesPerSecond = 0.0;
+    double AllocationsPerOp = 0.0;
+    double AllocatedBytesPerOp = 0.0;
+};
+
+// Impede que o compilador descarte o calculo de um valor que nao e usado
+template<typename T>
+void DoNotOptimize(const T& InValue)
+{
+    const volatile char* Sink = reinterpret_cast<const volatile char*>(&InValue);
+    static_cast<void>(*Sink);
+}
+
+class FBenchmarkRunner
+{
+public:
+
+    explicit FBenchmarkRunner(const FBenchmarkSettings& InSettings)
+        : Settings{ InSettings }
+    {
+    }
+
+    // InItemsPerOp e InBytesPerOp definem a vazao, zero omite a medida
+    void Run(const std::string& InName, std::uint64_t InItemsPerOp, std::uint64_t InBytesPerOp, const std::function<void()>& InOperation)
+    {
+        if (!Settings.Filter.empty() && InName.find(Settings.Filter) == std::string::npos)
+        {
+            return;
+        }
+
+        using FClock = std::chrono::steady_clock;
+
+        // Aquece caches e as alocacoes preguicosas antes de medir
+        InOperation();
+
+        FMemoryTracker& MemoryTracker = FMemoryTracker::Get();
+        std::uint64_t NumIterations = 1;
+        while (true)
+        {
+            MemoryTracker.BeginFrame();
+            const FClock::time_point Start = FClock::now();
+            for (std::uint64_t Iteration = 0; Iteration < NumIterations; ++Iteration)
+            {
+                InOperation();
+            }
+            const double Elapsed = std::chrono::duration<double>(FClock::now() - Start).count();
+            MemoryTracker.BeginFrame();
+
+            constexpr std::uint64_t MaxIterations = 1ull << 30;
+            if (Elapsed >= Settings.MinTime || NumIterations >= MaxIterations)
+            {
+                AddResult(InName, NumIterations, Elapsed, InItemsPerOp, InBytesPerOp, MemoryTracker.GetLastFrameStats().Total);
+                return;
+            }
+
+            // Estima quantas iteracoes passam do tempo minimo, crescendo no maximo 10x por rodada
+            const double Scale = Elapsed > 0.0 ? Settings.MinTime * 1.2 / Elapsed : 10.0;
+            NumIterations = std::min(MaxIterations, static_cast<std::uint64_t>(std::ceil(static_cast<double>(NumIterations) * std::clamp(Scale, 2.0, 10.0))));
+        }
+    }
+
+    bool WriteJson() const
+    {
+        if (Settings.OutputPath.empty())
+        {
+            return true;
+        }
+
+        std::ofstream File{ Settings.OutputPath, std::ios::out | std::ios::trunc };
+        if (!File)
+        {
+            std::cout << "Nao foi possivel criar " << Settings.OutputPath << std::endl;
+            return false;
+        }
+
+        File << "{\n";
+        File << "  \"context\": { \"num_workers\": " << Settings.NumWorkers
+             << ", \"min_time\": " << Settings.MinTime
+             << ", \"track_allocations\": " << (FMemoryTracker::IsEnabled() ? "true" : "false") << " },\n";
+        File << "  \"benchmarks\": [\n";
+        for (std::size_t ResultIndex = 0; ResultIndex < Results.size(); ++ResultIndex)
+        {
+            const FBenchmarkResult& Result = Results[ResultIndex];
+            File << "    { \"name\": \"" << Result.Name << "\""
+                 << ", \"iterations\": " << Result.NumIterations
+                 << ", \"ns_per_op\": " << Result.NanosecondsPerOp
+                 << ", \"items_per_second\": " << Result.ItemsPerSecond
+                 << ", \"bytes_per_second\": " << Result.BytesPerSecond
+                 << ", \"allocations_per_op\": " << Result.AllocationsPerOp
+                 << ", \"allocated_bytes_per_op\": " << Result.AllocatedBytesPerOp
+                 << " }" << (ResultIndex + 1 < Results.size() ? "," : "") << "\n";
+        }
+        File << "  ]\n}\n";
+
+        std::cout << "Resultados gravados em " << Settings.OutputPath << std::endl;
+        return static_cast<bool>(File);
+    }
+
+private:
+
+    void AddResult(const std::string& InName, std::uint64_t InNumIterations, double InElapsed, std::uint64_t InItemsPerOp, std::uint64_t InBytesPerOp, const FAllocationStats& InAllocations)
+    {
+        const double NumOps = static_cast<double>(InNumIterations);
+        const double OpsPerSecond = NumOps / InElapsed;
+
+        FBenchmarkResult& Result = Results.emplace_back();
+        Result.Name = InName;
+        Result.NumIterations = InNumIterations;
+        Result.NanosecondsPerOp = InElapsed * 1e9 / NumOps;
+        Result.ItemsPerSecond = static_cast<double>(InItemsPerOp) * OpsPerSecond;
+        Result.BytesPerSecond = static_cast<double>(InBytesPerOp) * OpsPerSecond;
+        Result.AllocationsPerOp = static_cast<double>(InAllocations.NumAllocations) / NumOps;
+        Result.AllocatedBytesPerOp = static_cast<double>(InAllocations.AllocatedBytes) / NumOps;
+
+        char Line[256];
+        std::snprintf(Line, sizeof(Line), "%-40s %14.1f ns/op %12.3f Mitems/s %10.1f MB/s %10.1f allocs/op",
+                      Result.Name.c_str(), Result.NanosecondsPerOp, Result.ItemsPerSecond / 1e6, Result.BytesPerSecond / (1024.0 * 1024.0), Result.AllocationsPerOp);
+        std::cout << Line << std::endl;
+    }
+
+    FBenchmarkSettings Settings;
+    std::vector<FBenchmarkResult> Results;
+};
+
+static void RunMeshBenchmarks(FBenchmarkRunner& InRunner, FWorkerPool& InWorkerPool)
+{
+    using FGetSize = FMeshSize(*)(std::uint32_t);
+    using FWrite = void(*)(std::uint32_t, std::span<FVertex>, std::span<GLuint>, FWorkerPool&);
+
+    struct FMeshGenerator
+    {
+        const char* Name;
+        FGetSize GetSize;
+        FWrite Write;
+    };
+
+    constexpr std::array<FMeshGenerator, 2> Generators =
+    {
+        FMeshGenerator{ "WriteSphere", GetSphereSize, WriteSphere },
+        FMeshGenerator{ "WriteCylinder", GetCylinderSize, WriteCylinder },
+    };
+
+    for (const FMeshGenerator& Generator : Generators)
+    {
+        for (const std::uint32_t Resolution : { 16u, 64u, 256u, 1024u, 2048u })
+        {
+            // A memoria e alocada fora da medida, como a memoria mapeada do FMeshArena
+            const FMeshSize Size = Generator.GetSize(Resolution);
+            std::vector<FVertex> Vertices(Size.NumVertices);
+            std::vector<GLuint> Indices(Size.NumIndices);
+
+            const std::uint64_t NumBytes = Vertices.size() * sizeof(FVertex) + Indices.size() * sizeof(GLuint);
+            InRunner.Run(std::string{ Generator.Name } + "/" + std::to_string(Resolution), Size.NumVertices, NumBytes, [&]
+            {
+                Generator.Write(Resolution, Vertices, Indices, InWorkerPool);
+                DoNotOptimize(Vertices.back());
+                DoNotOptimize(Indices.back());
+            });
+        }
+    }
+}
+
+static void RunInstanceBenchmarks(FBenchmarkRunner& InRunner)
+{
+    for (const std::uint32_t NumInstances : { 10'000u, 100'000u, 1'000'000u, 10'000'000u })
+    {
+        InRunner.Run("GenerateInstances/" + std::to_string(NumInstances), NumInstances, NumInstances * sizeof(glm::mat4), [NumInstances]
+        {
+            const std::vector<glm::mat4> Instances = GenerateInstances(NumInstances, 0);
+            DoNotOptimize(Instances.back());
+        });
+    }
+}
+
+static void RunTextureBenchmarks(FBenchmarkRunner& InRunner, const std::filesystem::path& InTexturesDir)
+{
+    std::error_code Error;
+    for (const std::filesystem::directory_entry& Entry : std::filesystem::directory_iterator{ InTexturesDir, Error })
+    {
+        if (Entry.path().extension() != ".jpg")
+        {
+            continue;
+        }
+
+        // Le o arquivo uma vez para medir so a decodificacao
+        std::vector<stbi_uc> EncodedImage;
+        if (std::ifstream FileStream{ Entry.path(), std::ios::in | std::ios::binary })
+        {
+            EncodedImage.assign(std::istreambuf_iterator<char>(FileStream), std::istreambuf_iterator<char>());
+        }
+
+        std::int32_t Width = 0;
+        std::int32_t Height = 0;
+        std::int32_t NumComponents = 0;
+        if (EncodedImage.empty() || !stbi_info_from_memory(EncodedImage.data(), static_cast<int>(EncodedImage.size()), &Width, &Height, &NumComponents))
+        {
+            std::cout << "Nao foi possivel ler " << Entry.path() << std::endl;
+            continue;
+        }
+
+        // O stb_image usa malloc, entao as alocacoes da decodificacao nao aparecem nas contagens
+        const std::uint64_t NumPixels = static_cast<std::uint64_t>(Width) * Height;
+        InRunner.Run("DecodeJpeg/" + Entry.path().filename().string(), NumPixels, EncodedImage.size(), [&EncodedImage]
+        {
+            std::int32_t ImageWidth = 0;
+            std::int32_t ImageHeight = 0;
+            stbi_uc* Data = stbi_load_from_memory(EncodedImage.data(), static_cast<int>(EncodedImage.size()), &ImageWidth, &ImageHeight, nullptr, 3);
+            DoNotOptimize(Data);
+            stbi_image_free(Data);
+        });
+    }
+}
+
+static void RunShaderBenchmarks(FBenchmarkRunner& InRunner, const std::filesystem::path& InShadersDir)
+{
+    FShaderManager ShaderManager;
+    ShaderManager.Initialize(InShadersDir);
+
+    std::error_code Error;
+    for (const std::filesystem::directory_entry& Entry : std::filesystem::directory_iterator{ InShadersDir, Error })
+    {
+        const std::filesystem::path Extension = Entry.path().extension();
+        if (Extension != ".vert" && Extension != ".frag")
+        {
+            continue;
+        }
+
+        const std::string ShaderFile = Entry.path().filename().string();
+        std::string Source;
+        if (!ShaderManager.PreprocessShader(ShaderFile, Source))
+        {
+            std::cout << "Nao foi possivel ler " << Entry.path() << std::endl;
+            continue;
+        }
+
+        InRunner.Run("PreprocessShader/" + ShaderFile, 1, Source.size(), [&ShaderManager, &ShaderFile]
+        {
+            std::string ShaderSource;
+            ShaderManager.PreprocessShader(ShaderFile, ShaderSource);
+            DoNotOptimize(ShaderSource.back());
+        });
+    }
+
+    // A reflexao consulta o programa linkado e precisa de um contexto OpenGL. Aqui so e medida a parte
+    // de CPU: a busca que os handles fazem na tabela ordenada por hash depois de cada link
+    constexpr std::array<std::string_view, 8> ParameterNames =
+    {
+        "Model", "NormalMatrix", "EarthTexture", "CloudsTexture", "Time", "FrameData", "LightData", "ModelData"
+    };
+
+    std::vector<FShaderParameter> Parameters;
+    for (const std::string_view Name : ParameterNames)
+    {
+        Parameters.push_back(FShaderParameter{ .NameHash = HashShaderParameterName(Name), .Value = static_cast<GLint>(Parameters.size()) });
+    }
+    std::sort(Parameters.begin(), Parameters.end(), [](const FShaderParameter& A, const FShaderParameter& B) { return A.NameHash < B.NameHash; });
+
+    std::size_t NameIndex = 0;
+    InRunner.Run("FindShaderParameter", 1, 0, [&]
+    {
+        const std::string_view Name = ParameterNames[NameIndex++ % ParameterNames.size()];
+        const GLint Value = FShader::FindParameter(Parameters, HashShaderParameterName(Name));
+        DoNotOptimize(Value);
+    });
+}
+
+static void RunCameraBenchmarks(FBenchmarkRunner& InRunner)
+{
+    FSimpleCamera Camera;
+    Camera.SetViewportSize(1920, 1080);
+
+    // A camera anda um pouco a cada operacao para que o resultado nao possa ser reaproveitado
+    InRunner.Run("Camera/GetView", 1, 0, [&Camera]
+    {
+        Camera.Location.x += 1e-6f;
+        const glm::mat4 View = Camera.GetView();
+        DoNotOptimize(View);
+    });
+
+    InRunner.Run("Camera/GetProjection", 1, 0, [&Camera]
+    {
+        Camera.FieldOfView = Camera.FieldOfView < 90.0f ? Camera.FieldOfView + 1e-4f : 45.0f;
+        const glm::mat4 Projection = Camera.GetProjection();
+        DoNotOptimize(Projection);
+    });
+
+    std::int32_t TileIndex = 0;
+    InRunner.Run("Camera/GetTileProjection", 1, 0, [&Camera, &TileIndex]
+    {
+        constexpr std::int32_t TileSize = 2048;
+        const std::int32_t TileX = (TileIndex % 8) * TileSize;
+        const std::int32_t TileY = (TileIndex / 8 % 4) * TileSize;
+        TileIndex++;
+        const glm::mat4 Projection = Camera.GetTileProjection(16384, 8192, TileX, TileY, TileSize, TileSize);
+        DoNotOptimize(Projection);
+    });
+
+    InRunner.Run("Camera/ViewProjection", 1, 0, [&Camera]
+    {
+        Camera.Location.y += 1e-6f;
+        const glm::mat4 ViewProjection = Camera.GetProjection() * Camera.GetView();
+        DoNotOptimize(ViewProjection);
+    });
+}
+
+int main(int Argc, char** Argv)
+{
+    FBenchmarkSettings Settings;
+    std::filesystem::path ShadersDir = BLUEMARBLE_SHADERS_DIR;
+    std::filesystem::path TexturesDir = BLUEMARBLE_TEXTURES_DIR;
+
+    for (std::int32_t ArgIndex = 1; ArgIndex < Argc; ++ArgIndex)
+    {
+        const std::string_view Arg = Argv[ArgIndex];
+        const bool bHasValue = ArgIndex + 1 < Argc;
+
+        if (Arg == "--filter" && bHasValue)
+        {
+            Settings.Filter = Argv[++ArgIndex];
+        }
+        else if (Arg == "--min-time" && bHasValue)
+        {
+            Settings.MinTime = std::max(std::atof(Argv[++ArgIndex]), 0.001);
+        }
+        else if (Arg == "--workers" && bHasValue)
+        {
+            Settings.NumWorkers = static_cast<std::uint32_t>(std::max(std::atoi(Argv[++ArgIndex]), 0));
+        }
+        else if (Arg == "--output" && bHasValue)
+        {
+            // Um caminho vazio so mostra os resultados no console
+            Settings.OutputPath = Argv[++ArgIndex];
+        }
+        else if (Arg == "--shaders-dir" && bHasValue)
+        {
+            ShadersDir = Argv[++ArgIndex];
+        }
+        else if (Arg == "--textures-dir" && bHasValue)
+        {
+            TexturesDir = Argv[++ArgIndex];
+        }
+        else
+        {
+            std::cout << "Argumento desconhecido: " << Arg << std::endl;
+            std::cout << "Uso: BlueMarbleBench [--filter <Texto>] [--min-time <Segundos>] [--workers <N>] [--output <Arquivo.json>]" << std::endl;
+            return 1;
+        }
+    }
+
+    if (!FMemoryTracker::IsEnabled())
+    {
+        std::cout << "Compilado sem BLUEMARBLE_TRACK_ALLOCATIONS, as alocacoes nao serao contadas" << std::endl;
+    }
+
+    FWorkerPool WorkerPool{ Settings.NumWorkers };
+    FBenchmarkRunner Runner{ Settings };
+
+    RunMeshBenchmarks(Runner, WorkerPool);
+    RunInstanceBenchmarks(Runner);
+    RunTextureBenchmarks(Runner, TexturesDir);
+    RunShaderBenchmarks(Runner, ShadersDir);
+    RunCameraBenchmarks(Runner);
+
+    return Runner.WriteJson() ? 0 : 1;
+}
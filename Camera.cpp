@@ -87,3 +87,35 @@ glm::mat4 FSimpleCamera::GetProjection()
 
 	return Projection;
 }
+
+glm::mat4 FSimpleCamera::GetTileProjection(std::int32_t InImageWidth, std::int32_t InImageHeight, std::int32_t InTileX, std::int32_t InTileY, std::int32_t InTileWidth, std::int32_t InTileHeight) const
+{
+    // Limites do plano near (ou do volume ortografico) da imagem inteira
+    float ImageLeft = Left;
+    float ImageRight = Right;
+    float ImageBottom = Bottom;
+    float ImageTop = Top;
+
+    if (!bIsOrtho)
+    {
+        ImageTop = Near * glm::tan(glm::radians(FieldOfView) / 2.0f);
+        ImageBottom = -ImageTop;
+        ImageRight = ImageTop * static_cast<float>(InImageWidth) / static_cast<float>(InImageHeight);
+        ImageLeft = -ImageRight;
+    }
+
+    const float PixelWidth = (ImageRight - ImageLeft) / static_cast<float>(InImageWidth);
+    const float PixelHeight = (ImageTop - ImageBottom) / static_cast<float>(InImageHeight);
+
+    const float TileLeft = ImageLeft + PixelWidth * static_cast<float>(InTileX);
+    const float TileRight = ImageLeft + PixelWidth * static_cast<float>(InTileX + InTileWidth);
+    const float TileTop = ImageTop - PixelHeight * static_cast<float>(InTileY);
+    const float TileBottom = ImageTop - PixelHeight * static_cast<float>(InTileY + InTileHeight);
+
+    if (bIsOrtho)
+    {
+        return glm::ortho(TileLeft, TileRight, TileBottom, TileTop, Near, Far);
+    }
+
+    return glm::frustum(TileLeft, TileRight, TileBottom, TileTop, Near, Far);
+}
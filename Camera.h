@@ -2,6 +2,8 @@
 
 #include <glm/glm.hpp>
 
+#include <cstdint>
+
 class FSimpleCamera
 {
 public:
@@ -16,6 +18,10 @@ public:
 	glm::mat4 GetView();
     glm::mat4 GetProjection();
 
+    // Projecao de um retangulo de uma imagem maior, em pixels com Y a partir do topo. Os tiles juntos
+    // formam a mesma imagem que GetProjection com a proporcao InImageWidth / InImageHeight
+    glm::mat4 GetTileProjection(std::int32_t InImageWidth, std::int32_t InImageHeight, std::int32_t InTileX, std::int32_t InTileY, std::int32_t InTileWidth, std::int32_t InTileHeight) const;
+
 	bool bEnableMouseMovement = false;
 	glm::vec2 PreviousCursor{ 0.0f };
 	float ForwardScale = 0.0f;
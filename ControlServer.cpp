@@ -0,0 +1,219 @@
+#include "ControlServer.h"
+
+#include <array>
+#include <chrono>
+#include <iostream>
+
+namespace
+{
+    // Sem cliente a thread so precisa verificar se deve parar; com um cliente ela tambem envia as respostas
+    constexpr std::chrono::milliseconds IdleTimeout{ 100 };
+    constexpr std::chrono::milliseconds ConnectedTimeout{ 10 };
+
+    // Um cliente que para de ler as respostas e desconectado em vez de travar a thread
+    constexpr std::chrono::milliseconds SendTimeout{ 1000 };
+
+    // Uma linha maior que isso derruba a conexao, nenhum comando chega perto
+    constexpr std::size_t MaxLineSize = 64 * 1024;
+
+    void AppendJsonString(std::string& OutText, std::string_view InText)
+    {
+        OutText += '"';
+        for (const char Character : InText)
+        {
+            switch (Character)
+            {
+                case '"': OutText += "\\\""; break;
+                case '\\': OutText += "\\\\"; break;
+                case '\n': OutText += "\\n"; break;
+                case '\r': OutText += "\\r"; break;
+                case '\t': OutText += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(Character) >= 0x20)
+                    {
+                        OutText += Character;
+                    }
+                    break;
+            }
+        }
+        OutText += '"';
+    }
+}
+
+FControlServer::~FControlServer()
+{
+    Stop();
+}
+
+bool FControlServer::Start(std::uint16_t InPort, std::function<void()> InOnCommandQueued)
+{
+    Stop();
+
+    if (!ListenSocket.Listen(InPort))
+    {
+        return false;
+    }
+
+    Port = InPort;
+    OnCommandQueued = std::move(InOnCommandQueued);
+    bStopRequested = false;
+    WorkerThread = std::thread{ &FControlServer::Run, this };
+
+    std::cout << "Controle em 127.0.0.1:" << Port << std::endl;
+    return true;
+}
+
+void FControlServer::Stop()
+{
+    if (WorkerThread.joinable())
+    {
+        bStopRequested = true;
+        WorkerThread.join();
+    }
+    Connection.Close();
+    ListenSocket.Close();
+}
+
+bool FControlServer::PopCommand(FControlCommand& OutCommand)
+{
+    return Commands.TryPop(OutCommand);
+}
+
+void FControlServer::SendReply(const FControlCommand& InCommand, std::string_view InError)
+{
+    // Com a fila cheia o cliente nao esta lendo as respostas, perder algumas nao trava o frame
+    Replies.TryPush(FReply{ .ConnectionId = InCommand.ConnectionId, .Line = FormatReply(InCommand.Name, InCommand.Id, InError) });
+}
+
+std::string FControlServer::FormatReply(std::string_view InName, std::int64_t InId, std::string_view InError)
+{
+    std::string Line = "{\"id\":" + std::to_string(InId) + ",\"cmd\":";
+    AppendJsonString(Line, InName);
+    if (InError.empty())
+    {
+        Line += ",\"ok\":true}\n";
+    }
+    else
+    {
+        Line += ",\"ok\":false,\"error\":";
+        AppendJsonString(Line, InError);
+        Line += "}\n";
+    }
+    return Line;
+}
+
+void FControlServer::Run()
+{
+    std::array<char, 4096> Buffer;
+    while (!bStopRequested)
+    {
+        SendQueuedReplies();
+
+        if (!Connection.IsOpen())
+        {
+            if (ListenSocket.WaitReadable(IdleTimeout))
+            {
+                Connection = ListenSocket.Accept();
+                ConnectionId++;
+                ReceivedText.clear();
+            }
+            continue;
+        }
+
+        if (!Connection.WaitReadable(ConnectedTimeout))
+        {
+            continue;
+        }
+
+        const std::int64_t NumReceived = Connection.Receive(Buffer.data(), Buffer.size());
+        if (NumReceived <= 0)
+        {
+            Connection.Close();
+            continue;
+        }
+        ReceivedText.append(Buffer.data(), static_cast<std::size_t>(NumReceived));
+
+        std::size_t LineStart = 0;
+        for (std::size_t LineEnd = ReceivedText.find('\n'); LineEnd != std::string::npos; LineEnd = ReceivedText.find('\n', LineStart))
+        {
+            HandleLine(std::string_view{ ReceivedText }.substr(LineStart, LineEnd - LineStart));
+            LineStart = LineEnd + 1;
+        }
+        ReceivedText.erase(0, LineStart);
+
+        if (ReceivedText.size() > MaxLineSize)
+        {
+            SendLine(FormatReply({}, 0, "linha grande demais"));
+            Connection.Close();
+        }
+    }
+}
+
+void FControlServer::HandleLine(std::string_view InLine)
+{
+    if (!InLine.empty() && InLine.back() == '\r')
+    {
+        InLine.remove_suffix(1);
+    }
+
+    if (InLine.find_first_not_of(" \t") == std::string_view::npos)
+    {
+        return;
+    }
+
+    FControlCommand Command;
+    Command.ConnectionId = ConnectionId;
+
+    std::string Error;
+    if (!FJsonValue::Parse(InLine, Command.Arguments, Error))
+    {
+        SendLine(FormatReply({}, 0, Error));
+        return;
+    }
+
+    // Sem um id numerico o servidor numera os comandos na ordem de chegada
+    const FJsonValue* Id = Command.Arguments.Find("id");
+    Command.Id = Id != nullptr && Id->IsNumber() ? static_cast<std::int64_t>(Id->GetNumber()) : NextCommandId;
+    NextCommandId = Command.Id + 1;
+
+    const FJsonValue* Name = Command.Arguments.Find("cmd");
+    if (Name == nullptr || !Name->IsString())
+    {
+        SendLine(FormatReply({}, Command.Id, "o comando deve ser um objeto com o membro \"cmd\""));
+        return;
+    }
+    Command.Name = Name->GetString();
+
+    // A fila so move o comando quando ha espaco
+    if (!Commands.TryPush(std::move(Command)))
+    {
+        SendLine(FormatReply(Command.Name, Command.Id, "fila de comandos cheia"));
+        return;
+    }
+
+    NumCommands.fetch_add(1, std::memory_order_relaxed);
+    if (OnCommandQueued)
+    {
+        OnCommandQueued();
+    }
+}
+
+void FControlServer::SendQueuedReplies()
+{
+    FReply Reply;
+    while (Replies.TryPop(Reply))
+    {
+        if (Reply.ConnectionId == ConnectionId)
+        {
+            SendLine(Reply.Line);
+        }
+    }
+}
+
+void FControlServer::SendLine(const std::string& InLine)
+{
+    if (Connection.IsOpen() && !Connection.SendAll(InLine, SendTimeout))
+    {
+        Connection.Close();
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Json.h"
+#include "LocalSocket.h"
+#include "SPSCQueue.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <thread>
+
+// Um comando recebido pelo socket de controle, ja validado como JSON. Cada linha e um objeto com o nome
+// do comando em "cmd" e um "id" opcional que volta na resposta
+struct FControlCommand
+{
+    std::string Name;
+    std::int64_t Id = 0;
+    FJsonValue Arguments;
+
+    // Conexao que enviou o comando, respostas para conexoes ja fechadas sao descartadas
+    std::uint64_t ConnectionId = 0;
+};
+
+// Servidor de comandos em 127.0.0.1 com um protocolo de linhas JSON. A thread do servidor le e valida as
+// linhas e coloca os comandos em uma fila sem locks; a thread principal aplica os comandos no inicio do
+// frame e devolve as respostas por outra fila, que o servidor envia. So um cliente e atendido por vez,
+// os outros esperam na fila de conexoes do socket
+class FControlServer
+{
+public:
+
+    FControlServer() = default;
+    ~FControlServer();
+
+    FControlServer(const FControlServer&) = delete;
+    FControlServer& operator=(const FControlServer&) = delete;
+
+    // InOnCommandQueued e chamado pela thread do servidor depois de cada comando colocado na fila, para
+    // acordar a thread principal se ela estiver dormindo esperando eventos
+    bool Start(std::uint16_t InPort, std::function<void()> InOnCommandQueued);
+    void Stop();
+
+    bool IsRunning() const { return WorkerThread.joinable(); }
+    std::uint16_t GetPort() const { return Port; }
+
+    // Chamados apenas pela thread principal
+    bool PopCommand(FControlCommand& OutCommand);
+    void SendReply(const FControlCommand& InCommand, std::string_view InError = {});
+
+    std::uint64_t GetNumCommands() const { return NumCommands.load(std::memory_order_relaxed); }
+
+private:
+
+    struct FReply
+    {
+        std::uint64_t ConnectionId = 0;
+        std::string Line;
+    };
+
+    // Chamados apenas pela thread do servidor
+    void Run();
+    void HandleLine(std::string_view InLine);
+    void SendQueuedReplies();
+    void SendLine(const std::string& InLine);
+
+    static std::string FormatReply(std::string_view InName, std::int64_t InId, std::string_view InError);
+
+    TSPSCQueue<FControlCommand, 256> Commands;
+    TSPSCQueue<FReply, 256> Replies;
+    std::atomic<std::uint64_t> NumCommands{ 0 };
+
+    std::atomic<bool> bStopRequested{ false };
+    std::function<void()> OnCommandQueued;
+    FLocalSocket ListenSocket;
+    std::thread WorkerThread;
+    std::uint16_t Port = 0;
+
+    // Estado da conexao atual, so acessado pela thread do servidor
+    FLocalSocket Connection;
+    std::uint64_t ConnectionId = 0;
+    std::string ReceivedText;
+    std::int64_t NextCommandId = 1;
+};
@@ -1,108 +1,47 @@
 #include "DirectoryWatcher.h"
 
-#include <Windows.h>
+void FDirectoryWatcher::GetChangedFiles(std::vector<std::filesystem::path>& OutChangedFiles)
+{
+    std::filesystem::path ChangedFile;
+    while (ChangedFiles.TryPop(ChangedFile))
+    {
+        OutChangedFiles.push_back(std::move(ChangedFile));
+    }
+}
 
-#include <iostream>
-#include <array>
+void FDirectoryWatcher::OnFileChanged(const std::filesystem::path& InFilePath)
+{
+    PendingFiles[InFilePath] = FClock::now() + CoalesceDelay;
+}
 
-FDirectoryWatcher::FDirectoryWatcher(const std::filesystem::path& InDirToWatch)
-    : DirToWatch{ std::filesystem::absolute(InDirToWatch) }
+std::chrono::milliseconds FDirectoryWatcher::FlushCoalescedFiles()
 {
-    DirHandle = CreateFile(DirToWatch.string().c_str(),
-                           FILE_LIST_DIRECTORY,
-                           FILE_SHARE_READ | FILE_SHARE_WRITE,
-                           NULL,
-                           OPEN_EXISTING,
-                           FILE_FLAG_BACKUP_SEMANTICS, NULL);
+    const FClock::time_point Now = FClock::now();
+    FClock::time_point NextDeadline = FClock::time_point::max();
 
-    WorkerThread = std::thread([&]
+    for (auto PendingIt = PendingFiles.begin(); PendingIt != PendingFiles.end();)
     {
-        std::vector<UCHAR> Buffer(64 * 1024, 0);
-
-        DWORD BytesReturned;
-        while (bShouldWatch)
+        if (PendingIt->second <= Now)
         {
-            bIsWaiting = true;
-            constexpr DWORD NotifyFilter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE;
-            if (ReadDirectoryChangesW(DirHandle, Buffer.data(), static_cast<DWORD>(Buffer.size() * sizeof(UCHAR)), FALSE, NotifyFilter, &BytesReturned, NULL, NULL) == TRUE)
+            std::filesystem::path ChangedFile = PendingIt->first;
+            if (ChangedFiles.TryPush(std::move(ChangedFile)))
             {
-                DWORD Offset = 0;
-                FILE_NOTIFY_INFORMATION* Info;
-                do
-                {
-                    Info = (FILE_NOTIFY_INFORMATION*) &Buffer[Offset];
-
-                    #if 0
-                    switch (Info->Action)
-                    {
-                        case FILE_ACTION_ADDED:
-                            std::cout << "Add: ";
-                            break;
-
-                        case FILE_ACTION_MODIFIED:
-                            std::cout << "Modified: ";
-                            break;
-
-                        case FILE_ACTION_REMOVED:
-                            std::cout << "Removed: ";
-                            break;
-
-                        case FILE_ACTION_RENAMED_NEW_NAME:
-                            std::cout << "Renamed New Name: ";
-                            break;
-
-                        case FILE_ACTION_RENAMED_OLD_NAME:
-                            std::cout << "Renamed Old Name: ";
-                            break;
-                    }
-
-                    std::wstring FileNameW{ Info->FileName, Info->FileNameLength / sizeof(WCHAR) };
-                    std::filesystem::path FilePath{ FileNameW };
-
-                    std::cout << FilePath << std::endl;
-                    #endif
-
-                    switch (Info->Action)
-                    {
-                        case FILE_ACTION_MODIFIED:
-                        case FILE_ACTION_RENAMED_NEW_NAME:
-                        {
-                            const std::wstring FileNameW{ Info->FileName, Info->FileNameLength / sizeof(WCHAR) };
-                            const std::filesystem::path FilePath{ FileNameW };
-
-                            {
-                                std::lock_guard Lock{ FilesChangedMutex };
-                                FilesChanged.insert(DirToWatch / FilePath);
-                            }
-
-                            break;
-                        }
-                    }
-
-                    Offset += Info->NextEntryOffset;
-                }
-                while (Info->NextEntryOffset != 0);
+                PendingIt = PendingFiles.erase(PendingIt);
+                continue;
             }
-            bIsWaiting = false;
+
+            // A fila esta cheia, tenta de novo depois que a thread principal consumir os arquivos
+            PendingIt->second = Now + CoalesceDelay;
         }
-    });
-}
 
-FDirectoryWatcher::~FDirectoryWatcher()
-{
-    bShouldWatch = false;
-    while (bIsWaiting)
+        NextDeadline = std::min(NextDeadline, PendingIt->second);
+        ++PendingIt;
+    }
+
+    if (NextDeadline == FClock::time_point::max())
     {
-        CancelIoEx(DirHandle, NULL);
+        return std::chrono::milliseconds{ -1 };
     }
-    WorkerThread.join();
-    CloseHandle(DirHandle);
-}
 
-std::set<std::filesystem::path> FDirectoryWatcher::GetChangedFiles()
-{
-    std::lock_guard Lock{ FilesChangedMutex };
-    std::set<std::filesystem::path> ChangedFiles = FilesChanged;
-    FilesChanged.clear();
-    return ChangedFiles;
-}
\ No newline at end of file
+    return std::chrono::ceil<std::chrono::milliseconds>(NextDeadline - Now);
+}
@@ -1,27 +1,53 @@
 #pragma once
 
-#include <set>
-#include <thread>
-#include <mutex>
+#include "SPSCQueue.h"
+
+#include <chrono>
 #include <filesystem>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
 
+// Observa um ou mais diretorios (recursivamente) em uma unica thread. Varias notificacoes
+// do mesmo arquivo em um intervalo curto (ex: um editor salvando) sao agrupadas em uma so.
 class FDirectoryWatcher
 {
 public:
 
-    FDirectoryWatcher(const std::filesystem::path& InDirToWatch);
+    static constexpr std::chrono::milliseconds DefaultCoalesceDelay{ 50 };
+
+    explicit FDirectoryWatcher(const std::vector<std::filesystem::path>& InDirsToWatch, std::chrono::milliseconds InCoalesceDelay = DefaultCoalesceDelay);
     ~FDirectoryWatcher();
 
-    std::set<std::filesystem::path> GetChangedFiles();
+    FDirectoryWatcher(const FDirectoryWatcher&) = delete;
+    FDirectoryWatcher& operator=(const FDirectoryWatcher&) = delete;
+
+    // Adiciona os arquivos alterados desde a ultima chamada em OutChangedFiles, sem locks
+    void GetChangedFiles(std::vector<std::filesystem::path>& OutChangedFiles);
+
+    const std::vector<std::filesystem::path>& GetWatchedDirs() const { return DirsToWatch; }
 
 private:
 
-    std::filesystem::path DirToWatch;
-    void* DirHandle;
-    std::thread WorkerThread;
-    std::atomic<bool> bIsWaiting{ false };
-    std::atomic<bool> bShouldWatch{ true };
+    using FClock = std::chrono::steady_clock;
+
+    // Implementado por cada plataforma
+    struct FBackend;
+    void Run();
+
+    // Chamados apenas pela thread do backend
+    void OnFileChanged(const std::filesystem::path& InFilePath);
 
-    std::mutex FilesChangedMutex;
-    std::set<std::filesystem::path> FilesChanged;
+    // Publica os arquivos cujo intervalo de agrupamento terminou. Retorna quanto tempo falta
+    // para o proximo arquivo pendente ou um valor negativo se nao houver nenhum
+    std::chrono::milliseconds FlushCoalescedFiles();
+
+    std::vector<std::filesystem::path> DirsToWatch;
+    std::chrono::milliseconds CoalesceDelay;
+    std::map<std::filesystem::path, FClock::time_point> PendingFiles;
+    TSPSCQueue<std::filesystem::path, 256> ChangedFiles;
+
+    std::unique_ptr<FBackend> Backend;
+    std::thread WorkerThread;
 };
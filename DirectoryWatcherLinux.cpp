@@ -0,0 +1,171 @@
+#include "DirectoryWatcher.h"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+
+struct FDirectoryWatcher::FBackend
+{
+    int InotifyFd = -1;
+    int EpollFd = -1;
+    int StopEventFd = -1;
+
+    // Identificador do inotify -> diretorio observado
+    std::unordered_map<int, std::filesystem::path> WatchedDirs;
+
+    void AddWatchRecursive(const std::filesystem::path& InDir)
+    {
+        constexpr std::uint32_t WatchMask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_ONLYDIR;
+
+        const int WatchDescriptor = inotify_add_watch(InotifyFd, InDir.c_str(), WatchMask);
+        if (WatchDescriptor < 0)
+        {
+            std::cout << "Erro ao observar " << InDir << ": " << std::strerror(errno) << std::endl;
+            return;
+        }
+
+        WatchedDirs[WatchDescriptor] = InDir;
+
+        std::error_code ErrorCode;
+        for (const std::filesystem::directory_entry& Entry : std::filesystem::directory_iterator{ InDir, ErrorCode })
+        {
+            if (Entry.is_directory(ErrorCode))
+            {
+                AddWatchRecursive(Entry.path());
+            }
+        }
+    }
+};
+
+FDirectoryWatcher::FDirectoryWatcher(const std::vector<std::filesystem::path>& InDirsToWatch, std::chrono::milliseconds InCoalesceDelay)
+    : CoalesceDelay{ InCoalesceDelay }
+    , Backend{ std::make_unique<FBackend>() }
+{
+    Backend->InotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    Backend->StopEventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    Backend->EpollFd = epoll_create1(EPOLL_CLOEXEC);
+
+    if (Backend->InotifyFd < 0 || Backend->StopEventFd < 0 || Backend->EpollFd < 0)
+    {
+        std::cout << "Erro ao inicializar o inotify: " << std::strerror(errno) << std::endl;
+        return;
+    }
+
+    for (const int Fd : { Backend->InotifyFd, Backend->StopEventFd })
+    {
+        epoll_event Event{};
+        Event.events = EPOLLIN;
+        Event.data.fd = Fd;
+        epoll_ctl(Backend->EpollFd, EPOLL_CTL_ADD, Fd, &Event);
+    }
+
+    for (const std::filesystem::path& DirToWatch : InDirsToWatch)
+    {
+        DirsToWatch.push_back(std::filesystem::absolute(DirToWatch).lexically_normal());
+        Backend->AddWatchRecursive(DirsToWatch.back());
+    }
+
+    WorkerThread = std::thread([this] { Run(); });
+}
+
+FDirectoryWatcher::~FDirectoryWatcher()
+{
+    if (WorkerThread.joinable())
+    {
+        // Acorda o epoll_wait imediatamente
+        const std::uint64_t StopValue = 1;
+        [[maybe_unused]] const ssize_t BytesWritten = write(Backend->StopEventFd, &StopValue, sizeof(StopValue));
+        WorkerThread.join();
+    }
+
+    for (const int Fd : { Backend->EpollFd, Backend->StopEventFd, Backend->InotifyFd })
+    {
+        if (Fd >= 0)
+        {
+            close(Fd);
+        }
+    }
+}
+
+void FDirectoryWatcher::Run()
+{
+    alignas(inotify_event) std::array<char, 16 * 1024> Buffer;
+    std::array<epoll_event, 2> Events;
+
+    while (true)
+    {
+        const int TimeoutMs = static_cast<int>(FlushCoalescedFiles().count());
+        const int NumEvents = epoll_wait(Backend->EpollFd, Events.data(), static_cast<int>(Events.size()), TimeoutMs);
+        if (NumEvents < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            std::cout << "Erro no epoll_wait: " << std::strerror(errno) << std::endl;
+            return;
+        }
+
+        for (int EventIndex = 0; EventIndex < NumEvents; ++EventIndex)
+        {
+            if (Events[EventIndex].data.fd == Backend->StopEventFd)
+            {
+                return;
+            }
+
+            ssize_t Length = 0;
+            while ((Length = read(Backend->InotifyFd, Buffer.data(), Buffer.size())) > 0)
+            {
+                for (ssize_t Offset = 0; Offset < Length;)
+                {
+                    const inotify_event* Event = reinterpret_cast<const inotify_event*>(Buffer.data() + Offset);
+                    Offset += sizeof(inotify_event) + Event->len;
+
+                    if (Event->mask & IN_Q_OVERFLOW)
+                    {
+                        std::cout << "Fila do inotify cheia, eventos foram perdidos" << std::endl;
+                        continue;
+                    }
+
+                    const auto DirIt = Backend->WatchedDirs.find(Event->wd);
+                    if (DirIt == Backend->WatchedDirs.end())
+                    {
+                        continue;
+                    }
+
+                    if (Event->mask & IN_IGNORED)
+                    {
+                        Backend->WatchedDirs.erase(DirIt);
+                        continue;
+                    }
+
+                    if (Event->len == 0)
+                    {
+                        continue;
+                    }
+
+                    const std::filesystem::path EventPath = DirIt->second / Event->name;
+                    if (Event->mask & IN_ISDIR)
+                    {
+                        if (Event->mask & (IN_CREATE | IN_MOVED_TO))
+                        {
+                            Backend->AddWatchRecursive(EventPath);
+                        }
+                    }
+                    else if (Event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+                    {
+                        OnFileChanged(EventPath);
+                    }
+                }
+            }
+        }
+    }
+}
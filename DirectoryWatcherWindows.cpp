@@ -0,0 +1,155 @@
+#include "DirectoryWatcher.h"
+
+#include <Windows.h>
+
+#include <iostream>
+
+struct FDirectoryWatcher::FBackend
+{
+    struct FWatchedDir
+    {
+        std::filesystem::path Dir;
+        HANDLE DirHandle = INVALID_HANDLE_VALUE;
+        OVERLAPPED Overlapped{};
+
+        // ReadDirectoryChangesW exige um buffer alinhado em DWORD
+        std::vector<DWORD> Buffer = std::vector<DWORD>(16 * 1024, 0);
+    };
+
+    // Sinalizado pelo destrutor para acordar a thread imediatamente
+    HANDLE StopEvent = nullptr;
+
+    // Os OVERLAPPED precisam de enderecos estaveis enquanto a leitura estiver pendente
+    std::vector<std::unique_ptr<FWatchedDir>> WatchedDirs;
+
+    static bool IssueRead(FWatchedDir& InWatchedDir)
+    {
+        constexpr DWORD NotifyFilter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE;
+        constexpr BOOL bWatchSubtree = TRUE;
+        return ReadDirectoryChangesW(InWatchedDir.DirHandle,
+                                     InWatchedDir.Buffer.data(),
+                                     static_cast<DWORD>(InWatchedDir.Buffer.size() * sizeof(DWORD)),
+                                     bWatchSubtree,
+                                     NotifyFilter,
+                                     nullptr,
+                                     &InWatchedDir.Overlapped,
+                                     nullptr) == TRUE;
+    }
+};
+
+FDirectoryWatcher::FDirectoryWatcher(const std::vector<std::filesystem::path>& InDirsToWatch, std::chrono::milliseconds InCoalesceDelay)
+    : CoalesceDelay{ InCoalesceDelay }
+    , Backend{ std::make_unique<FBackend>() }
+{
+    Backend->StopEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+
+    for (const std::filesystem::path& DirToWatch : InDirsToWatch)
+    {
+        DirsToWatch.push_back(std::filesystem::absolute(DirToWatch).lexically_normal());
+
+        std::unique_ptr<FBackend::FWatchedDir> WatchedDir = std::make_unique<FBackend::FWatchedDir>();
+        WatchedDir->Dir = DirsToWatch.back();
+        WatchedDir->DirHandle = CreateFileW(WatchedDir->Dir.c_str(),
+                                            FILE_LIST_DIRECTORY,
+                                            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                            NULL,
+                                            OPEN_EXISTING,
+                                            FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+                                            NULL);
+        if (WatchedDir->DirHandle == INVALID_HANDLE_VALUE)
+        {
+            std::cout << "Erro ao observar " << WatchedDir->Dir << std::endl;
+            continue;
+        }
+
+        WatchedDir->Overlapped.hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+        Backend->WatchedDirs.push_back(std::move(WatchedDir));
+    }
+
+    WorkerThread = std::thread([this] { Run(); });
+}
+
+FDirectoryWatcher::~FDirectoryWatcher()
+{
+    SetEvent(Backend->StopEvent);
+    WorkerThread.join();
+
+    for (const std::unique_ptr<FBackend::FWatchedDir>& WatchedDir : Backend->WatchedDirs)
+    {
+        CloseHandle(WatchedDir->Overlapped.hEvent);
+        CloseHandle(WatchedDir->DirHandle);
+    }
+    CloseHandle(Backend->StopEvent);
+}
+
+void FDirectoryWatcher::Run()
+{
+    std::vector<HANDLE> WaitHandles{ Backend->StopEvent };
+    for (const std::unique_ptr<FBackend::FWatchedDir>& WatchedDir : Backend->WatchedDirs)
+    {
+        FBackend::IssueRead(*WatchedDir);
+        WaitHandles.push_back(WatchedDir->Overlapped.hEvent);
+    }
+
+    while (true)
+    {
+        const std::chrono::milliseconds NextFlush = FlushCoalescedFiles();
+        const DWORD Timeout = NextFlush.count() < 0 ? INFINITE : static_cast<DWORD>(NextFlush.count());
+
+        const DWORD WaitResult = WaitForMultipleObjects(static_cast<DWORD>(WaitHandles.size()), WaitHandles.data(), FALSE, Timeout);
+        if (WaitResult == WAIT_OBJECT_0 || WaitResult == WAIT_FAILED)
+        {
+            break;
+        }
+
+        if (WaitResult == WAIT_TIMEOUT)
+        {
+            continue;
+        }
+
+        FBackend::FWatchedDir& WatchedDir = *Backend->WatchedDirs[WaitResult - WAIT_OBJECT_0 - 1];
+
+        DWORD BytesReturned = 0;
+        if (GetOverlappedResult(WatchedDir.DirHandle, &WatchedDir.Overlapped, &BytesReturned, FALSE) && BytesReturned > 0)
+        {
+            const std::uint8_t* BufferStart = reinterpret_cast<const std::uint8_t*>(WatchedDir.Buffer.data());
+            DWORD Offset = 0;
+            const FILE_NOTIFY_INFORMATION* Info;
+            do
+            {
+                Info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(BufferStart + Offset);
+
+                switch (Info->Action)
+                {
+                    case FILE_ACTION_ADDED:
+                    case FILE_ACTION_MODIFIED:
+                    case FILE_ACTION_RENAMED_NEW_NAME:
+                    {
+                        const std::wstring FileNameW{ Info->FileName, Info->FileNameLength / sizeof(WCHAR) };
+                        const std::filesystem::path FilePath = WatchedDir.Dir / FileNameW;
+                        if (!std::filesystem::is_directory(FilePath))
+                        {
+                            OnFileChanged(FilePath);
+                        }
+                        break;
+                    }
+                }
+
+                Offset += Info->NextEntryOffset;
+            }
+            while (Info->NextEntryOffset != 0);
+        }
+
+        FBackend::IssueRead(WatchedDir);
+    }
+
+    // Cancela as leituras pendentes e espera o cancelamento terminar antes de liberar os buffers
+    for (const std::unique_ptr<FBackend::FWatchedDir>& WatchedDir : Backend->WatchedDirs)
+    {
+        DWORD BytesReturned = 0;
+        if (CancelIoEx(WatchedDir->DirHandle, &WatchedDir->Overlapped) || GetLastError() != ERROR_NOT_FOUND)
+        {
+            GetOverlappedResult(WatchedDir->DirHandle, &WatchedDir->Overlapped, &BytesReturned, TRUE);
+        }
+    }
+}
@@ -0,0 +1,136 @@
+#include "DynamicResolution.h"
+
+#include "GLStateCache.h"
+#include "GPUResourceRegistry.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // A escala anda em passos fixos para que pequenas variacoes nas medicoes nao mudem o tamanho da cena
+    constexpr float ScaleStep = 0.05f;
+
+    // Abaixo desta fracao do orcamento a escala sobe. Entre ela e o orcamento a escala fica parada
+    constexpr double IncreaseThreshold = 0.8;
+
+    // A escala desejada mira um pouco abaixo do orcamento para nao voltar a ultrapassa-lo logo em seguida
+    constexpr double TargetFraction = 0.9;
+}
+
+void FDynamicResolution::Initialize(FShaderManager& InShaderManager)
+{
+    UpscaleShader = InShaderManager.AddShader("upscale.vert", "upscale.frag");
+    EmptyVAO = FGPUResourceRegistry::Get().CreateVertexArray("Upscale VAO");
+}
+
+void FDynamicResolution::Shutdown()
+{
+    ReleaseTarget();
+    FGPUResourceRegistry::Get().Delete(EGPUResourceType::VertexArray, EmptyVAO);
+    UpscaleShader.reset();
+}
+
+void FDynamicResolution::ReleaseTarget()
+{
+    SceneTarget.Shutdown();
+    Scale = Settings.MaxScale;
+    AccumulatedSceneTime = 0.0;
+    NumSceneTimes = 0;
+}
+
+void FDynamicResolution::AddSceneTime(double InSceneTime)
+{
+    AccumulatedSceneTime += InSceneTime;
+    NumSceneTimes++;
+    if (NumSceneTimes < std::max(Settings.AdjustInterval, 1u))
+    {
+        return;
+    }
+
+    const double AverageSceneTime = AccumulatedSceneTime / NumSceneTimes;
+    AccumulatedSceneTime = 0.0;
+    NumSceneTimes = 0;
+
+    const double Budget = Settings.FrameTimeBudget;
+    const bool bOverBudget = AverageSceneTime > Budget;
+    const bool bUnderBudget = AverageSceneTime < Budget * IncreaseThreshold;
+    if (AverageSceneTime <= 0.0 || (!bOverBudget && !bUnderBudget))
+    {
+        return;
+    }
+
+    // O custo do preenchimento cresce com a area, ou seja, com o quadrado da escala. So metade do caminho
+    // ate a escala desejada e percorrida por ajuste para nao oscilar com o ruido das medicoes
+    const float DesiredScale = Scale * static_cast<float>(std::sqrt(Budget * TargetFraction / AverageSceneTime));
+    float NewScale = std::round((Scale + (DesiredScale - Scale) * 0.5f) / ScaleStep) * ScaleStep;
+
+    // Fora da faixa morta a escala sempre anda pelo menos um passo, senao o arredondamento pode prende-la
+    NewScale = bOverBudget ? std::min(NewScale, Scale - ScaleStep) : std::max(NewScale, Scale + ScaleStep);
+    Scale = std::clamp(NewScale, Settings.MinScale, Settings.MaxScale);
+}
+
+void FDynamicResolution::BeginScene(std::int32_t InWindowWidth, std::int32_t InWindowHeight)
+{
+    if (!SceneTarget.IsValid())
+    {
+        Scale = Settings.MaxScale;
+    }
+
+    // A UI pode mudar os limites a qualquer momento
+    Scale = std::clamp(Scale, Settings.MinScale, Settings.MaxScale);
+
+    WindowWidth = InWindowWidth;
+    WindowHeight = InWindowHeight;
+    const std::int32_t TargetWidth = std::max(static_cast<std::int32_t>(std::lround(WindowWidth * Settings.MaxScale)), 1);
+    const std::int32_t TargetHeight = std::max(static_cast<std::int32_t>(std::lround(WindowHeight * Settings.MaxScale)), 1);
+    if (!SceneTarget.IsValid())
+    {
+        SceneTarget.Initialize(TargetWidth, TargetHeight, "Scaled Scene Target");
+    }
+    else
+    {
+        SceneTarget.Resize(TargetWidth, TargetHeight);
+    }
+
+    SceneWidth = std::clamp(static_cast<std::int32_t>(std::lround(WindowWidth * Scale)), 1, TargetWidth);
+    SceneHeight = std::clamp(static_cast<std::int32_t>(std::lround(WindowHeight * Scale)), 1, TargetHeight);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, SceneTarget.GetFramebuffer());
+    glViewport(0, 0, SceneWidth, SceneHeight);
+}
+
+void FDynamicResolution::Upscale(FGLStateCache& InStateCache)
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, WindowWidth, WindowHeight);
+
+    // Com o shader quebrado por um hot reload a janela fica so com a UI ate ele ser corrigido
+    const GLuint ProgramId = static_cast<GLuint>(UpscaleShader->ProgramId);
+    if (ProgramId == 0)
+    {
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        return;
+    }
+
+    const float TargetWidth = static_cast<float>(SceneTarget.GetWidth());
+    const float TargetHeight = static_cast<float>(SceneTarget.GetHeight());
+
+    // Sem ampliacao a passada e uma copia texel a texel, o unsharp mask so realcaria as bordas
+    const float Sharpness = SceneWidth < WindowWidth || SceneHeight < WindowHeight ? Settings.Sharpness : 0.0f;
+
+    glProgramUniform1i(ProgramId, UpscaleShader->GetUniformLocation("SceneTexture"), 0);
+    glProgramUniform2f(ProgramId, UpscaleShader->GetUniformLocation("UVScale"), SceneWidth / TargetWidth, SceneHeight / TargetHeight);
+    glProgramUniform2f(ProgramId, UpscaleShader->GetUniformLocation("MaxUV"), (SceneWidth - 0.5f) / TargetWidth, (SceneHeight - 0.5f) / TargetHeight);
+    glProgramUniform1f(ProgramId, UpscaleShader->GetUniformLocation("Sharpness"), Sharpness);
+
+    InStateCache.UseProgram(ProgramId);
+    InStateCache.BindVertexArray(EmptyVAO);
+    InStateCache.BindTexture(0, GL_TEXTURE_2D, SceneTarget.GetColorTexture());
+    InStateCache.SetPolygonMode(GL_FILL);
+    InStateCache.SetDepthTest(false);
+
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+
+    InStateCache.SetDepthTest(true);
+}
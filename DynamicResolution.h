@@ -0,0 +1,83 @@
+#pragma once
+
+#include "RenderTarget.h"
+#include "ShaderManager.h"
+
+#include <glad/glad.h>
+
+#include <cstdint>
+
+class FGLStateCache;
+
+struct FDynamicResolutionSettings
+{
+    bool bEnabled = false;
+
+    // Tempo de GPU da cena que o controle tenta manter, em milissegundos. Fica abaixo do intervalo do
+    // VSync para sobrar tempo para a ampliacao e a UI
+    float FrameTimeBudget = 12.0f;
+
+    // Fracao da resolucao da janela em cada eixo
+    float MinScale = 0.5f;
+    float MaxScale = 1.0f;
+
+    // Medicoes de GPU somadas antes de cada ajuste
+    std::uint32_t AdjustInterval = 8;
+
+    // Forca do unsharp mask aplicado na ampliacao
+    float Sharpness = 0.5f;
+};
+
+// Desenha a cena em um alvo fora da tela com resolucao menor que a da janela e amplia o resultado com um
+// filtro bilinear seguido de um unsharp mask. A escala e ajustada a cada AdjustInterval frames pelo tempo
+// de GPU da cena: o tempo da CPU fica preso ao VSync e nao mostra quanto a GPU ainda tem de folga.
+// O alvo tem o tamanho da janela na escala maxima e a cena usa so um canto dele, entao mudar a escala
+// nao recria as texturas
+class FDynamicResolution
+{
+public:
+
+    void Initialize(FShaderManager& InShaderManager);
+    void Shutdown();
+
+    FDynamicResolutionSettings& GetSettings() { return Settings; }
+    const FDynamicResolutionSettings& GetSettings() const { return Settings; }
+
+    bool IsEnabled() const { return Settings.bEnabled; }
+
+    // Tempo de GPU de uma passada da cena, em milissegundos. A escala e ajustada a cada AdjustInterval medicoes
+    void AddSceneTime(double InSceneTime);
+
+    // Liga o framebuffer da cena com a area da escala atual
+    void BeginScene(std::int32_t InWindowWidth, std::int32_t InWindowHeight);
+
+    // Amplia a cena para o back buffer da janela, que fica ligado no fim
+    void Upscale(FGLStateCache& InStateCache);
+
+    // Libera o alvo enquanto a escala dinamica esta desligada. O proximo BeginScene recomeca na escala maxima
+    void ReleaseTarget();
+
+    float GetScale() const { return Scale; }
+    std::int32_t GetSceneWidth() const { return SceneWidth; }
+    std::int32_t GetSceneHeight() const { return SceneHeight; }
+
+private:
+
+    FDynamicResolutionSettings Settings;
+
+    FRenderTarget SceneTarget;
+
+    FShaderPtr UpscaleShader;
+
+    // O vertex shader gera o triangulo sozinho, mas o core profile exige um VAO ligado
+    GLuint EmptyVAO = 0;
+
+    float Scale = 1.0f;
+    std::int32_t WindowWidth = 0;
+    std::int32_t WindowHeight = 0;
+    std::int32_t SceneWidth = 0;
+    std::int32_t SceneHeight = 0;
+
+    double AccumulatedSceneTime = 0.0;
+    std::uint32_t NumSceneTimes = 0;
+};
@@ -0,0 +1,65 @@
+#include "FrameAllocator.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdarg>
+#include <cstdio>
+#include <iostream>
+
+FFrameAllocator::FFrameAllocator(std::size_t InCapacity)
+    : Memory{ std::make_unique<std::uint8_t[]>(InCapacity) }
+    , Capacity{ InCapacity }
+{
+}
+
+void* FFrameAllocator::Allocate(std::size_t InSize, std::size_t InAlignment)
+{
+    const std::uintptr_t Base = reinterpret_cast<std::uintptr_t>(Memory.get());
+    const std::uintptr_t AlignedAddress = (Base + Offset + InAlignment - 1) & ~static_cast<std::uintptr_t>(InAlignment - 1);
+    const std::size_t AlignedOffset = AlignedAddress - Base;
+
+    UsedBytes += InSize;
+    PeakBytes = std::max(PeakBytes, UsedBytes);
+
+    if (AlignedOffset + InSize <= Capacity)
+    {
+        Offset = AlignedOffset + InSize;
+        return Memory.get() + AlignedOffset;
+    }
+
+    std::unique_ptr<std::uint8_t[]>& Block = OverflowBlocks.emplace_back(std::make_unique_for_overwrite<std::uint8_t[]>(InSize + InAlignment));
+    const std::uintptr_t BlockAddress = reinterpret_cast<std::uintptr_t>(Block.get());
+    return Block.get() + (((BlockAddress + InAlignment - 1) & ~static_cast<std::uintptr_t>(InAlignment - 1)) - BlockAddress);
+}
+
+const char* FFrameAllocator::Format(const char* InFormat, ...)
+{
+    std::va_list Args;
+    va_start(Args, InFormat);
+    std::va_list SizeArgs;
+    va_copy(SizeArgs, Args);
+    const int Length = std::vsnprintf(nullptr, 0, InFormat, SizeArgs);
+    va_end(SizeArgs);
+
+    char* Text = static_cast<char*>(Allocate(static_cast<std::size_t>(std::max(Length, 0)) + 1, alignof(char)));
+    std::vsnprintf(Text, static_cast<std::size_t>(std::max(Length, 0)) + 1, InFormat, Args);
+    va_end(Args);
+    return Text;
+}
+
+void FFrameAllocator::Reset()
+{
+    if (!OverflowBlocks.empty())
+    {
+        // O alinhamento pode desperdicar alguns bytes, por isso a folga na nova capacidade
+        const std::size_t NewCapacity = std::bit_ceil(PeakBytes + PeakBytes / 4);
+        std::cout << "FFrameAllocator: capacidade aumentada de " << Capacity << " para " << NewCapacity << " bytes" << std::endl;
+
+        OverflowBlocks.clear();
+        Memory = std::make_unique<std::uint8_t[]>(NewCapacity);
+        Capacity = NewCapacity;
+    }
+
+    Offset = 0;
+    UsedBytes = 0;
+}
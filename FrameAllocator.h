@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+// Memoria temporaria de um frame. Alocar so avanca um ponteiro e nada e liberado individualmente,
+// o Reset descarta tudo no inicio do frame seguinte. Nao e thread-safe, pertence a thread principal.
+//
+// Se a capacidade acabar no meio do frame o restante vem do heap e o proximo Reset aumenta a
+// capacidade, assim so o primeiro frame que precisar de mais memoria faz alocacoes.
+class FFrameAllocator
+{
+public:
+
+    static constexpr std::size_t DefaultCapacity = 64 * 1024;
+
+    explicit FFrameAllocator(std::size_t InCapacity = DefaultCapacity);
+
+    FFrameAllocator(const FFrameAllocator&) = delete;
+    FFrameAllocator& operator=(const FFrameAllocator&) = delete;
+
+    void* Allocate(std::size_t InSize, std::size_t InAlignment = alignof(std::max_align_t));
+
+    // Os destrutores nunca sao chamados, entao so tipos triviais podem ser alocados
+    template<typename T>
+    std::span<T> AllocateArray(std::size_t InNum)
+    {
+        static_assert(std::is_trivially_destructible_v<T>);
+        T* Data = static_cast<T*>(Allocate(InNum * sizeof(T), alignof(T)));
+        std::uninitialized_value_construct_n(Data, InNum);
+        return { Data, InNum };
+    }
+
+    // Texto formatado como no printf, valido ate o proximo Reset
+    const char* Format(const char* InFormat, ...);
+
+    void Reset();
+
+    std::size_t GetCapacity() const { return Capacity; }
+    std::size_t GetUsedBytes() const { return UsedBytes; }
+
+    // Maior uso em um frame desde o inicio, incluindo o que veio do heap
+    std::size_t GetPeakBytes() const { return PeakBytes; }
+
+private:
+
+    std::unique_ptr<std::uint8_t[]> Memory;
+    std::size_t Capacity = 0;
+    std::size_t Offset = 0;
+
+    std::size_t UsedBytes = 0;
+    std::size_t PeakBytes = 0;
+
+    // Blocos do heap usados quando a capacidade acaba, liberados no Reset
+    std::vector<std::unique_ptr<std::uint8_t[]>> OverflowBlocks;
+};
@@ -0,0 +1,389 @@
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+#include "FrameCapture.h"
+
+#include "GPUResourceRegistry.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+static constexpr std::array<const char*, 3> CaptureFormatNames = { "y4m", "png", "raw" };
+
+const char* GetCaptureFormatName(ECaptureFormat InFormat)
+{
+    return CaptureFormatNames[static_cast<std::size_t>(InFormat)];
+}
+
+std::optional<ECaptureFormat> ParseCaptureFormat(std::string_view InName)
+{
+    for (std::size_t FormatIndex = 0; FormatIndex < CaptureFormatNames.size(); ++FormatIndex)
+    {
+        if (InName == CaptureFormatNames[FormatIndex])
+        {
+            return static_cast<ECaptureFormat>(FormatIndex);
+        }
+    }
+    return std::nullopt;
+}
+
+FFrameCapture::~FFrameCapture()
+{
+    // Sem contexto do OpenGL aqui, os PBOs sao apagados no Shutdown
+    if (EncoderThread.joinable())
+    {
+        bStopEncoder.store(true, std::memory_order_release);
+        NumQueuedFrames.fetch_add(1, std::memory_order_release);
+        NumQueuedFrames.notify_one();
+        EncoderThread.join();
+    }
+}
+
+bool FFrameCapture::Start(const std::filesystem::path& InOutputPath, ECaptureFormat InFormat, std::uint32_t InFramesPerSecond)
+{
+    if (bCapturing)
+    {
+        Stop();
+    }
+
+    OutputPath = InOutputPath;
+    Format = InFormat;
+    FramesPerSecond = std::max(InFramesPerSecond, 1u);
+
+    std::error_code Error;
+    if (OutputPath.has_parent_path())
+    {
+        std::filesystem::create_directories(OutputPath.parent_path(), Error);
+    }
+
+    if (Format != ECaptureFormat::PNG)
+    {
+        OutputFile.open(OutputPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!OutputFile)
+        {
+            std::cout << "Nao foi possivel criar o arquivo de captura " << OutputPath << std::endl;
+            return false;
+        }
+    }
+
+    // Os frames so sao criados uma vez, depois de um Stop todos ja voltaram para FreeFrames
+    if (!EncoderFrames[0])
+    {
+        for (std::unique_ptr<FEncoderFrame>& Frame : EncoderFrames)
+        {
+            Frame = std::make_unique<FEncoderFrame>();
+            FreeFrames.TryPush(Frame.get());
+        }
+    }
+
+    // O OpenGL entrega as linhas de baixo para cima
+    stbi_flip_vertically_on_write(1);
+
+    StreamWidth = 0;
+    StreamHeight = 0;
+    NumCaptured = 0;
+    NumDroppedReadback = 0;
+    NumDroppedEncoder = 0;
+    NumEncoded.store(0, std::memory_order_relaxed);
+    NumDroppedResize.store(0, std::memory_order_relaxed);
+    bStopEncoder.store(false, std::memory_order_relaxed);
+
+    EncoderThread = std::thread{ [this] { EncoderLoop(); } };
+    bCapturing = true;
+
+    std::cout << "Captura iniciada: " << OutputPath << " (" << GetCaptureFormatName(Format) << ")" << std::endl;
+    return true;
+}
+
+void FFrameCapture::Stop()
+{
+    if (!bCapturing)
+    {
+        return;
+    }
+
+    // No fim da captura vale a pena esperar, nenhum frame ja lido e perdido
+    while (NumPendingReadbacks > 0)
+    {
+        CompleteReadback(Readbacks[OldestReadback], true);
+        OldestReadback = (OldestReadback + 1) % NumReadbackBuffers;
+        NumPendingReadbacks--;
+    }
+
+    bStopEncoder.store(true, std::memory_order_release);
+    NumQueuedFrames.fetch_add(1, std::memory_order_release);
+    NumQueuedFrames.notify_one();
+    EncoderThread.join();
+
+    if (OutputFile.is_open())
+    {
+        OutputFile.close();
+    }
+    bCapturing = false;
+
+    const FFrameCaptureStats Stats = GetStats();
+    std::cout << "Captura terminada: " << Stats.NumEncoded << " frames gravados em " << OutputPath
+              << ", descartados: " << Stats.NumDroppedReadback << " (GPU) " << Stats.NumDroppedEncoder << " (encoder) "
+              << Stats.NumDroppedResize << " (tamanho)" << std::endl;
+}
+
+void FFrameCapture::Shutdown()
+{
+    Stop();
+
+    for (FReadback& Readback : Readbacks)
+    {
+        if (Readback.Fence)
+        {
+            glDeleteSync(Readback.Fence);
+            Readback.Fence = nullptr;
+        }
+        FGPUResourceRegistry::Get().Delete(EGPUResourceType::Buffer, Readback.Buffer);
+        Readback.Capacity = 0;
+    }
+}
+
+void FFrameCapture::CaptureFrame(GLuint InFramebuffer, std::int32_t InWidth, std::int32_t InHeight)
+{
+    if (!bCapturing || InWidth <= 0 || InHeight <= 0)
+    {
+        return;
+    }
+
+    Poll();
+
+    // Todos os PBOs ainda esperando a GPU, esperar aqui seria justamente o stall que queremos evitar
+    if (NumPendingReadbacks == NumReadbackBuffers)
+    {
+        NumDroppedReadback++;
+        return;
+    }
+
+    FReadback& Readback = Readbacks[NextReadback];
+    const GLsizeiptr Size = static_cast<GLsizeiptr>(InWidth) * InHeight * 4;
+    if (Readback.Capacity < Size)
+    {
+        FGPUResourceRegistry& Registry = FGPUResourceRegistry::Get();
+        Registry.Delete(EGPUResourceType::Buffer, Readback.Buffer);
+        Readback.Buffer = Registry.CreateBuffer("Frame Capture Readback");
+        glNamedBufferStorage(Readback.Buffer, Size, nullptr, GL_MAP_READ_BIT | GL_CLIENT_STORAGE_BIT);
+        Registry.SetSize(EGPUResourceType::Buffer, Readback.Buffer, Size);
+        Readback.Capacity = Size;
+    }
+
+    // Com um PBO ligado o glReadPixels so agenda a copia e retorna imediatamente
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, InFramebuffer);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, Readback.Buffer);
+    glReadPixels(0, 0, InWidth, InHeight, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    Readback.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    Readback.Width = InWidth;
+    Readback.Height = InHeight;
+
+    NextReadback = (NextReadback + 1) % NumReadbackBuffers;
+    NumPendingReadbacks++;
+    NumCaptured++;
+}
+
+void FFrameCapture::Poll()
+{
+    while (NumPendingReadbacks > 0 && CompleteReadback(Readbacks[OldestReadback], false))
+    {
+        OldestReadback = (OldestReadback + 1) % NumReadbackBuffers;
+        NumPendingReadbacks--;
+    }
+}
+
+bool FFrameCapture::CompleteReadback(FReadback& InOutReadback, bool bInWait)
+{
+    // O flush garante que a fence chega a GPU mesmo sem glfwSwapBuffers (modo headless)
+    const GLuint64 Timeout = bInWait ? 1'000'000'000 : 0;
+    GLenum Status = glClientWaitSync(InOutReadback.Fence, GL_SYNC_FLUSH_COMMANDS_BIT, Timeout);
+    while (bInWait && Status == GL_TIMEOUT_EXPIRED)
+    {
+        Status = glClientWaitSync(InOutReadback.Fence, 0, Timeout);
+    }
+
+    if (Status == GL_TIMEOUT_EXPIRED)
+    {
+        return false;
+    }
+
+    glDeleteSync(InOutReadback.Fence);
+    InOutReadback.Fence = nullptr;
+
+    FEncoderFrame* Frame = nullptr;
+    while (!FreeFrames.TryPop(Frame))
+    {
+        if (!bInWait)
+        {
+            // Encoder atrasado, o PBO e liberado sem ser lido
+            NumDroppedEncoder++;
+            return true;
+        }
+        std::this_thread::yield();
+    }
+
+    const std::size_t Size = static_cast<std::size_t>(InOutReadback.Width) * InOutReadback.Height * 4;
+    Frame->Pixels.resize(Size);
+    Frame->Width = InOutReadback.Width;
+    Frame->Height = InOutReadback.Height;
+
+    if (const void* MappedPixels = glMapNamedBufferRange(InOutReadback.Buffer, 0, static_cast<GLsizeiptr>(Size), GL_MAP_READ_BIT))
+    {
+        std::memcpy(Frame->Pixels.data(), MappedPixels, Size);
+        glUnmapNamedBuffer(InOutReadback.Buffer);
+    }
+
+    // Nunca falha, as duas filas tem espaco para todos os frames
+    QueuedFrames.TryPush(Frame);
+    NumQueuedFrames.fetch_add(1, std::memory_order_release);
+    NumQueuedFrames.notify_one();
+    return true;
+}
+
+FFrameCaptureStats FFrameCapture::GetStats() const
+{
+    return FFrameCaptureStats{
+        .NumCaptured = NumCaptured,
+        .NumEncoded = NumEncoded.load(std::memory_order_relaxed),
+        .NumDroppedReadback = NumDroppedReadback,
+        .NumDroppedEncoder = NumDroppedEncoder,
+        .NumDroppedResize = NumDroppedResize.load(std::memory_order_relaxed),
+    };
+}
+
+void FFrameCapture::EncoderLoop()
+{
+    while (true)
+    {
+        // Lido antes de esvaziar a fila para nao perder um frame entregue entre o TryPop e o wait
+        const std::uint32_t LastQueued = NumQueuedFrames.load(std::memory_order_acquire);
+
+        FEncoderFrame* Frame = nullptr;
+        while (QueuedFrames.TryPop(Frame))
+        {
+            EncodeFrame(*Frame);
+            FreeFrames.TryPush(Frame);
+        }
+
+        if (bStopEncoder.load(std::memory_order_acquire) && QueuedFrames.IsEmpty())
+        {
+            return;
+        }
+
+        NumQueuedFrames.wait(LastQueued, std::memory_order_acquire);
+    }
+}
+
+void FFrameCapture::EncodeFrame(const FEncoderFrame& InFrame)
+{
+    const std::int32_t Width = InFrame.Width;
+    const std::int32_t Height = InFrame.Height;
+    const std::uint8_t* Pixels = InFrame.Pixels.data();
+
+    if (Format == ECaptureFormat::PNG)
+    {
+        char Suffix[32];
+        std::snprintf(Suffix, sizeof(Suffix), "_%06u.png", NumEncoded.load(std::memory_order_relaxed));
+        const std::filesystem::path FramePath = OutputPath.parent_path() / (OutputPath.stem().string() + Suffix);
+        if (stbi_write_png(FramePath.string().c_str(), Width, Height, 4, Pixels, Width * 4) == 0)
+        {
+            std::cout << "Erro ao gravar " << FramePath << std::endl;
+            return;
+        }
+        NumEncoded.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Um video tem tamanho fixo, o primeiro frame define o tamanho
+    if (StreamWidth == 0)
+    {
+        StreamWidth = Width;
+        StreamHeight = Height;
+
+        if (Format == ECaptureFormat::Y4M)
+        {
+            char Header[128];
+            const int HeaderSize = std::snprintf(Header, sizeof(Header), "YUV4MPEG2 W%d H%d F%u:1 Ip A1:1 C420jpeg\n", Width, Height, FramesPerSecond);
+            OutputFile.write(Header, HeaderSize);
+        }
+        else
+        {
+            std::cout << "Captura RAW: RGBA8 " << Width << "x" << Height << " por frame" << std::endl;
+        }
+    }
+    else if (Width != StreamWidth || Height != StreamHeight)
+    {
+        NumDroppedResize.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    const std::size_t RowSize = static_cast<std::size_t>(Width) * 4;
+    auto GetRow = [Pixels, Height, RowSize](std::int32_t InRow)
+    {
+        return Pixels + static_cast<std::size_t>(Height - 1 - InRow) * RowSize;
+    };
+
+    if (Format == ECaptureFormat::Raw)
+    {
+        for (std::int32_t Row = 0; Row < Height; ++Row)
+        {
+            OutputFile.write(reinterpret_cast<const char*>(GetRow(Row)), static_cast<std::streamsize>(RowSize));
+        }
+    }
+    else
+    {
+        // YUV 4:2:0 com a faixa completa do BT.601 (C420jpeg), crominancia da media de cada bloco 2x2
+        const std::int32_t ChromaWidth = (Width + 1) / 2;
+        const std::int32_t ChromaHeight = (Height + 1) / 2;
+        const std::size_t LumaSize = static_cast<std::size_t>(Width) * Height;
+        const std::size_t ChromaSize = static_cast<std::size_t>(ChromaWidth) * ChromaHeight;
+        ConvertedPixels.resize(LumaSize + ChromaSize * 2);
+
+        std::uint8_t* Luma = ConvertedPixels.data();
+        std::uint8_t* ChromaB = Luma + LumaSize;
+        std::uint8_t* ChromaR = ChromaB + ChromaSize;
+
+        for (std::int32_t Row = 0; Row < Height; ++Row)
+        {
+            const std::uint8_t* Pixel = GetRow(Row);
+            for (std::int32_t Column = 0; Column < Width; ++Column, Pixel += 4)
+            {
+                Luma[static_cast<std::size_t>(Row) * Width + Column] = static_cast<std::uint8_t>((77 * Pixel[0] + 150 * Pixel[1] + 29 * Pixel[2] + 128) >> 8);
+            }
+        }
+
+        for (std::int32_t ChromaRow = 0; ChromaRow < ChromaHeight; ++ChromaRow)
+        {
+            const std::uint8_t* TopRow = GetRow(ChromaRow * 2);
+            const std::uint8_t* BottomRow = GetRow(std::min(ChromaRow * 2 + 1, Height - 1));
+            for (std::int32_t ChromaColumn = 0; ChromaColumn < ChromaWidth; ++ChromaColumn)
+            {
+                const std::size_t Left = static_cast<std::size_t>(ChromaColumn) * 8;
+                const std::size_t Right = static_cast<std::size_t>(std::min(ChromaColumn * 2 + 1, Width - 1)) * 4;
+
+                const std::int32_t Red = (TopRow[Left] + TopRow[Right] + BottomRow[Left] + BottomRow[Right] + 2) / 4;
+                const std::int32_t Green = (TopRow[Left + 1] + TopRow[Right + 1] + BottomRow[Left + 1] + BottomRow[Right + 1] + 2) / 4;
+                const std::int32_t Blue = (TopRow[Left + 2] + TopRow[Right + 2] + BottomRow[Left + 2] + BottomRow[Right + 2] + 2) / 4;
+
+                const std::size_t ChromaIndex = static_cast<std::size_t>(ChromaRow) * ChromaWidth + ChromaColumn;
+                ChromaB[ChromaIndex] = static_cast<std::uint8_t>(std::clamp(((-43 * Red - 85 * Green + 128 * Blue + 128) >> 8) + 128, 0, 255));
+                ChromaR[ChromaIndex] = static_cast<std::uint8_t>(std::clamp(((128 * Red - 107 * Green - 21 * Blue + 128) >> 8) + 128, 0, 255));
+            }
+        }
+
+        OutputFile.write("FRAME\n", 6);
+        OutputFile.write(reinterpret_cast<const char*>(ConvertedPixels.data()), static_cast<std::streamsize>(ConvertedPixels.size()));
+    }
+
+    if (!OutputFile)
+    {
+        std::cout << "Erro ao gravar " << OutputPath << std::endl;
+        return;
+    }
+    NumEncoded.fetch_add(1, std::memory_order_relaxed);
+}
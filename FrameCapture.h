@@ -0,0 +1,140 @@
+#pragma once
+
+#include "SPSCQueue.h"
+
+#include <glad/glad.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+enum class ECaptureFormat : std::uint8_t
+{
+    // Um unico arquivo de video YUV 4:2:0 que ffmpeg e a maioria dos players abrem direto
+    Y4M,
+
+    // Uma imagem por frame: <nome>_000000.png
+    PNG,
+
+    // Frames RGBA8 de cima para baixo concatenados em um unico arquivo
+    Raw,
+};
+
+const char* GetCaptureFormatName(ECaptureFormat InFormat);
+std::optional<ECaptureFormat> ParseCaptureFormat(std::string_view InName);
+
+struct FFrameCaptureStats
+{
+    // Frames lidos da GPU
+    std::uint32_t NumCaptured = 0;
+
+    // Frames gravados no disco
+    std::uint32_t NumEncoded = 0;
+
+    // Frames descartados porque todos os PBOs estavam ocupados
+    std::uint32_t NumDroppedReadback = 0;
+
+    // Frames descartados porque o encoder nao deu conta
+    std::uint32_t NumDroppedEncoder = 0;
+
+    // Frames descartados porque o tamanho mudou no meio de um video (Y4M e Raw)
+    std::uint32_t NumDroppedResize = 0;
+};
+
+// Grava os frames renderizados no disco sem travar a thread do OpenGL. Cada frame e copiado com glReadPixels
+// para um PBO de um anel com fences; o PBO so e mapeado quando a fence ja foi sinalizada, e os pixels sao
+// entregues a uma thread que faz o encode. Quando a GPU ou o disco nao acompanham o frame e descartado
+// e contado, nunca espera. Os metodos, exceto GetStats, so podem ser chamados pela thread do OpenGL.
+class FFrameCapture
+{
+public:
+
+    static constexpr std::uint32_t NumReadbackBuffers = 4;
+    static constexpr std::uint32_t NumEncoderFrames = 8;
+
+    ~FFrameCapture();
+
+    bool Start(const std::filesystem::path& InOutputPath, ECaptureFormat InFormat, std::uint32_t InFramesPerSecond);
+
+    // Espera as leituras pendentes, termina de gravar tudo e fecha o arquivo
+    void Stop();
+
+    // Apaga os PBOs. Chama Stop se ainda estiver gravando
+    void Shutdown();
+
+    // Copia a cor do framebuffer para o proximo PBO livre. Deve ser chamado depois de desenhar o frame
+    // e antes do glfwSwapBuffers. InFramebuffer zero e o back buffer da janela
+    void CaptureFrame(GLuint InFramebuffer, std::int32_t InWidth, std::int32_t InHeight);
+
+    // Entrega ao encoder as leituras que a GPU ja terminou. Deve ser chamado uma vez por frame
+    void Poll();
+
+    bool IsCapturing() const { return bCapturing; }
+    const std::filesystem::path& GetOutputPath() const { return OutputPath; }
+    ECaptureFormat GetFormat() const { return Format; }
+    FFrameCaptureStats GetStats() const;
+
+private:
+
+    struct FReadback
+    {
+        GLuint Buffer = 0;
+        GLsync Fence = nullptr;
+        GLsizeiptr Capacity = 0;
+        std::int32_t Width = 0;
+        std::int32_t Height = 0;
+    };
+
+    struct FEncoderFrame
+    {
+        std::vector<std::uint8_t> Pixels;
+        std::int32_t Width = 0;
+        std::int32_t Height = 0;
+    };
+
+    // Retorna false se a leitura ainda nao terminou e bInWait e false
+    bool CompleteReadback(FReadback& InOutReadback, bool bInWait);
+
+    void EncoderLoop();
+    void EncodeFrame(const FEncoderFrame& InFrame);
+
+    std::filesystem::path OutputPath;
+    ECaptureFormat Format = ECaptureFormat::Y4M;
+    std::uint32_t FramesPerSecond = 60;
+    bool bCapturing = false;
+
+    // Anel de PBOs, NextReadback e o proximo a receber um frame e OldestReadback o proximo a ser mapeado
+    std::array<FReadback, NumReadbackBuffers> Readbacks{};
+    std::uint32_t NextReadback = 0;
+    std::uint32_t OldestReadback = 0;
+    std::uint32_t NumPendingReadbacks = 0;
+
+    // Os frames circulam entre as duas filas, a memoria dos pixels so e alocada quando o tamanho muda
+    std::array<std::unique_ptr<FEncoderFrame>, NumEncoderFrames> EncoderFrames;
+    TSPSCQueue<FEncoderFrame*, NumEncoderFrames> FreeFrames;
+    TSPSCQueue<FEncoderFrame*, NumEncoderFrames> QueuedFrames;
+
+    // So aumenta, a thread do encoder dorme com wait ate ele mudar
+    std::atomic<std::uint32_t> NumQueuedFrames{ 0 };
+    std::atomic<bool> bStopEncoder{ false };
+    std::thread EncoderThread;
+
+    // Estado do encoder, so acessado pela thread do encoder entre Start e Stop
+    std::ofstream OutputFile;
+    std::int32_t StreamWidth = 0;
+    std::int32_t StreamHeight = 0;
+    std::vector<std::uint8_t> ConvertedPixels;
+
+    std::uint32_t NumCaptured = 0;
+    std::uint32_t NumDroppedReadback = 0;
+    std::uint32_t NumDroppedEncoder = 0;
+    std::atomic<std::uint32_t> NumEncoded{ 0 };
+    std::atomic<std::uint32_t> NumDroppedResize{ 0 };
+};
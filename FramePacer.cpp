@@ -0,0 +1,130 @@
+#include "FramePacer.h"
+
+#include <algorithm>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BLUEMARBLE_PACER_PAUSE 1
+#include <emmintrin.h>
+#else
+#define BLUEMARBLE_PACER_PAUSE 0
+#endif
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#include <timeapi.h>
+#endif
+
+namespace
+{
+    // Limites da margem de spin: o minimo cobre o custo de acordar a thread, o maximo evita girar
+    // o frame inteiro quando o sistema tem um timer grosseiro
+    constexpr std::chrono::microseconds MinSpinMargin{ 250 };
+    constexpr std::chrono::microseconds MaxSpinMargin{ 4000 };
+
+    void CpuRelax()
+    {
+#if BLUEMARBLE_PACER_PAUSE
+        _mm_pause();
+#else
+        std::this_thread::yield();
+#endif
+    }
+
+    double ToMilliseconds(std::chrono::steady_clock::duration InDuration)
+    {
+        return std::chrono::duration<double, std::milli>(InDuration).count();
+    }
+}
+
+FFramePacer::~FFramePacer()
+{
+    SetHighResolutionTimer(false);
+}
+
+void FFramePacer::SetTargetFrameRate(double InFramesPerSecond)
+{
+    TargetFrameRate = std::max(InFramesPerSecond, 0.0);
+    FrameInterval = IsEnabled() ? std::chrono::duration_cast<FClock::duration>(std::chrono::duration<double>(1.0 / TargetFrameRate)) : FClock::duration{ 0 };
+    Reset();
+    SetHighResolutionTimer(IsEnabled());
+}
+
+void FFramePacer::SetHighResolutionTimer(bool bInEnable)
+{
+    if (bHighResolutionTimer == bInEnable)
+    {
+        return;
+    }
+
+#ifdef _WIN32
+    // O sleep do Windows tem resolucao de 15.6 ms por padrao, maior que a margem de spin
+    if (bInEnable)
+    {
+        timeBeginPeriod(1);
+    }
+    else
+    {
+        timeEndPeriod(1);
+    }
+#endif
+
+    bHighResolutionTimer = bInEnable;
+}
+
+void FFramePacer::WaitForNextFrame()
+{
+    Stats.SleepTime = 0.0;
+    Stats.SpinTime = 0.0;
+
+    if (!IsEnabled())
+    {
+        return;
+    }
+
+    const FClock::time_point StartTime = FClock::now();
+    const bool bFirstFrame = NextFrameTime == FClock::time_point{};
+    if (bFirstFrame || StartTime >= NextFrameTime)
+    {
+        // Um atraso menor que um frame e absorvido pelo proximo. Com um atraso maior a grade recomeca agora,
+        // em vez de tentar recuperar com varios frames curtos
+        if (bFirstFrame || StartTime >= NextFrameTime + FrameInterval)
+        {
+            Stats.NumMissedFrames += bFirstFrame ? 0 : 1;
+            NextFrameTime = StartTime + FrameInterval;
+        }
+        else
+        {
+            NextFrameTime += FrameInterval;
+        }
+        return;
+    }
+
+    const FClock::duration SpinMargin = std::clamp<FClock::duration>(PeakOversleep + PeakOversleep / 2, MinSpinMargin, MaxSpinMargin);
+    const FClock::time_point WakeTime = NextFrameTime - SpinMargin;
+
+    FClock::time_point SpinStartTime = StartTime;
+    if (StartTime < WakeTime)
+    {
+        std::this_thread::sleep_until(WakeTime);
+        SpinStartTime = FClock::now();
+
+        const FClock::duration Oversleep = std::max(SpinStartTime - WakeTime, FClock::duration{ 0 });
+        PeakOversleep = std::max(Oversleep, PeakOversleep - PeakOversleep / 16);
+        Stats.Oversleep = ToMilliseconds(Oversleep);
+    }
+
+    FClock::time_point EndTime = SpinStartTime;
+    while (EndTime < NextFrameTime)
+    {
+        CpuRelax();
+        EndTime = FClock::now();
+    }
+
+    Stats.SleepTime = ToMilliseconds(SpinStartTime - StartTime);
+    Stats.SpinTime = ToMilliseconds(EndTime - SpinStartTime);
+    Stats.SpinMargin = ToMilliseconds(SpinMargin);
+
+    NextFrameTime += FrameInterval;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+// Tempos da ultima espera, em milissegundos
+struct FFramePacerStats
+{
+    double SleepTime = 0.0;
+    double SpinTime = 0.0;
+
+    // Atraso do sleep do sistema em relacao ao pedido e a margem de spin calculada a partir dele
+    double Oversleep = 0.0;
+    double SpinMargin = 0.0;
+
+    // Frames que terminaram depois do horario do proximo, a grade de horarios recomeca a partir deles
+    std::uint32_t NumMissedFrames = 0;
+};
+
+// Limita a taxa de frames sem ocupar um nucleo inteiro. Dorme ate um pouco antes do horario do proximo frame
+// e so gira no final, ja que o sleep do sistema pode acordar um ou mais milissegundos atrasado. A margem do
+// spin acompanha os maiores atrasos medidos recentemente, entao fica pequena em sistemas com timers precisos
+class FFramePacer
+{
+public:
+
+    FFramePacer() = default;
+    ~FFramePacer();
+
+    FFramePacer(const FFramePacer&) = delete;
+    FFramePacer& operator=(const FFramePacer&) = delete;
+
+    // Zero desliga o limite
+    void SetTargetFrameRate(double InFramesPerSecond);
+    double GetTargetFrameRate() const { return TargetFrameRate; }
+    bool IsEnabled() const { return TargetFrameRate > 0.0; }
+
+    // Espera ate o horario do proximo frame. Retorna na hora se o limite esta desligado ou se o frame atrasou
+    void WaitForNextFrame();
+
+    // Recomeca a grade de horarios sem contar um frame perdido, para quando o loop parou de proposito
+    void Reset() { NextFrameTime = {}; }
+
+    const FFramePacerStats& GetStats() const { return Stats; }
+
+private:
+
+    using FClock = std::chrono::steady_clock;
+
+    void SetHighResolutionTimer(bool bInEnable);
+
+    double TargetFrameRate = 0.0;
+    FClock::duration FrameInterval{ 0 };
+    FClock::time_point NextFrameTime{};
+
+    // Maior atraso recente do sleep, decai a cada espera
+    FClock::duration PeakOversleep{ 0 };
+
+    bool bHighResolutionTimer = false;
+
+    FFramePacerStats Stats;
+};
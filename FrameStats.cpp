@@ -0,0 +1,104 @@
+#include "FrameStats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+
+void FFrameStatsRecorder::Start(std::uint32_t InNumWarmUpFrames)
+{
+    bRecording = true;
+    NumWarmUpFrames = InNumWarmUpFrames;
+    NumSkippedFrames = 0;
+    FrameTimes.clear();
+    TotalUpdateTime = 0.0;
+    TotalRenderTime = 0.0;
+}
+
+void FFrameStatsRecorder::AddFrame(double InFrameTime, double InUpdateTime, double InRenderTime)
+{
+    if (!bRecording)
+    {
+        return;
+    }
+
+    if (NumSkippedFrames < NumWarmUpFrames)
+    {
+        NumSkippedFrames++;
+        return;
+    }
+
+    FrameTimes.push_back(InFrameTime);
+    TotalUpdateTime += InUpdateTime;
+    TotalRenderTime += InRenderTime;
+}
+
+FFrameStatsSummary FFrameStatsRecorder::Summarize() const
+{
+    FFrameStatsSummary Summary;
+    if (FrameTimes.empty())
+    {
+        return Summary;
+    }
+
+    std::vector<double> SortedFrameTimes = FrameTimes;
+    std::sort(SortedFrameTimes.begin(), SortedFrameTimes.end());
+
+    // Percentil pelo metodo do posto mais proximo
+    const auto GetPercentile = [&SortedFrameTimes](double InPercentile)
+    {
+        const std::size_t Rank = static_cast<std::size_t>(std::ceil(InPercentile * static_cast<double>(SortedFrameTimes.size())));
+        return SortedFrameTimes[std::clamp<std::size_t>(Rank, 1, SortedFrameTimes.size()) - 1] * 1000.0;
+    };
+
+    const double NumFrames = static_cast<double>(FrameTimes.size());
+    const double TotalFrameTime = std::accumulate(FrameTimes.begin(), FrameTimes.end(), 0.0);
+
+    Summary.NumFrames = static_cast<std::uint32_t>(FrameTimes.size());
+    Summary.MeanFrameTime = TotalFrameTime / NumFrames * 1000.0;
+    Summary.MedianFrameTime = GetPercentile(0.5);
+    Summary.P95FrameTime = GetPercentile(0.95);
+    Summary.P99FrameTime = GetPercentile(0.99);
+    Summary.MaxFrameTime = SortedFrameTimes.back() * 1000.0;
+    Summary.MeanUpdateTime = TotalUpdateTime / NumFrames * 1000.0;
+    Summary.MeanRenderTime = TotalRenderTime / NumFrames * 1000.0;
+    Summary.FramesPerSecond = TotalFrameTime > 0.0 ? NumFrames / TotalFrameTime : 0.0;
+    return Summary;
+}
+
+bool FFrameStatsRecorder::WriteCsv(const std::filesystem::path& InFilePath, const std::vector<std::pair<std::string, std::string>>& InLabels) const
+{
+    if (InFilePath.has_parent_path())
+    {
+        std::error_code Error;
+        std::filesystem::create_directories(InFilePath.parent_path(), Error);
+    }
+
+    std::ofstream File{ InFilePath, std::ios::out | std::ios::trunc };
+    if (!File)
+    {
+        std::cout << "Nao foi possivel criar " << InFilePath << std::endl;
+        return false;
+    }
+
+    const FFrameStatsSummary Summary = Summarize();
+
+    for (const auto& [Name, Value] : InLabels)
+    {
+        File << Name << ',';
+    }
+    File << "frames,mean_ms,median_ms,p95_ms,p99_ms,max_ms,fps,update_ms,render_ms\n";
+
+    for (const auto& [Name, Value] : InLabels)
+    {
+        File << Value << ',';
+    }
+    File << Summary.NumFrames << ',' << Summary.MeanFrameTime << ',' << Summary.MedianFrameTime << ',' << Summary.P95FrameTime << ','
+         << Summary.P99FrameTime << ',' << Summary.MaxFrameTime << ',' << Summary.FramesPerSecond << ',' << Summary.MeanUpdateTime << ','
+         << Summary.MeanRenderTime << '\n';
+
+    std::cout << "Estatisticas de " << Summary.NumFrames << " frames gravadas em " << InFilePath << ": mediana " << Summary.MedianFrameTime
+              << " ms, p99 " << Summary.P99FrameTime << " ms" << std::endl;
+    return static_cast<bool>(File);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Resumo dos tempos dos frames medidos, em milissegundos
+struct FFrameStatsSummary
+{
+    std::uint32_t NumFrames = 0;
+    double MeanFrameTime = 0.0;
+    double MedianFrameTime = 0.0;
+    double P95FrameTime = 0.0;
+    double P99FrameTime = 0.0;
+    double MaxFrameTime = 0.0;
+    double MeanUpdateTime = 0.0;
+    double MeanRenderTime = 0.0;
+    double FramesPerSecond = 0.0;
+};
+
+// Guarda o tempo de cada frame depois do aquecimento para gerar estatisticas de uma execucao headless.
+// Os primeiros frames compilam shaders, enchem caches e nao representam o regime do programa
+class FFrameStatsRecorder
+{
+public:
+
+    void Start(std::uint32_t InNumWarmUpFrames);
+
+    bool IsRecording() const { return bRecording; }
+
+    // Tempos em segundos
+    void AddFrame(double InFrameTime, double InUpdateTime, double InRenderTime);
+
+    FFrameStatsSummary Summarize() const;
+
+    // Grava um CSV com uma linha de cabecalho e uma de valores: as colunas de InLabels seguidas do resumo
+    bool WriteCsv(const std::filesystem::path& InFilePath, const std::vector<std::pair<std::string, std::string>>& InLabels) const;
+
+private:
+
+    bool bRecording = false;
+    std::uint32_t NumWarmUpFrames = 0;
+    std::uint32_t NumSkippedFrames = 0;
+
+    std::vector<double> FrameTimes;
+    double TotalUpdateTime = 0.0;
+    double TotalRenderTime = 0.0;
+};
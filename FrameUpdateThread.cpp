@@ -0,0 +1,52 @@
+#include "FrameUpdateThread.h"
+
+FFrameUpdateThread::FFrameUpdateThread(std::function<void()> InUpdate)
+    : Update{ std::move(InUpdate) }
+{
+    Thread = std::thread{ [this] { ThreadMain(); } };
+}
+
+FFrameUpdateThread::~FFrameUpdateThread()
+{
+    Wait();
+
+    bShouldStop.store(true, std::memory_order_release);
+    RequestedFrame.fetch_add(1, std::memory_order_release);
+    RequestedFrame.notify_one();
+
+    Thread.join();
+}
+
+void FFrameUpdateThread::Kick()
+{
+    RequestedFrame.fetch_add(1, std::memory_order_release);
+    RequestedFrame.notify_one();
+}
+
+void FFrameUpdateThread::Wait()
+{
+    const std::uint64_t Requested = RequestedFrame.load(std::memory_order_relaxed);
+    for (std::uint64_t Completed = CompletedFrame.load(std::memory_order_acquire); Completed != Requested; Completed = CompletedFrame.load(std::memory_order_acquire))
+    {
+        CompletedFrame.wait(Completed, std::memory_order_acquire);
+    }
+}
+
+void FFrameUpdateThread::ThreadMain()
+{
+    std::uint64_t LastFrame = 0;
+    while (true)
+    {
+        RequestedFrame.wait(LastFrame, std::memory_order_acquire);
+        if (bShouldStop.load(std::memory_order_acquire))
+        {
+            return;
+        }
+
+        LastFrame = RequestedFrame.load(std::memory_order_acquire);
+        Update();
+
+        CompletedFrame.store(LastFrame, std::memory_order_release);
+        CompletedFrame.notify_one();
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+// Thread dedicada que executa o update de um frame enquanto a thread do OpenGL desenha o anterior.
+// Kick e Wait usam apenas atomicos, sem mutex no caminho de cada frame
+class FFrameUpdateThread
+{
+public:
+
+    explicit FFrameUpdateThread(std::function<void()> InUpdate);
+    ~FFrameUpdateThread();
+
+    FFrameUpdateThread(const FFrameUpdateThread&) = delete;
+    FFrameUpdateThread& operator=(const FFrameUpdateThread&) = delete;
+
+    // Pede o update do proximo frame. Nao pode ser chamado com um update em andamento
+    void Kick();
+
+    // Espera o update pedido no ultimo Kick terminar
+    void Wait();
+
+private:
+
+    void ThreadMain();
+
+    std::function<void()> Update;
+    std::thread Thread;
+
+    std::atomic<std::uint64_t> RequestedFrame{ 0 };
+    std::atomic<std::uint64_t> CompletedFrame{ 0 };
+    std::atomic<bool> bShouldStop{ false };
+};
@@ -0,0 +1,168 @@
+#include "GLStateCache.h"
+
+#include <GLFW/glfw3.h>
+
+// Estado booleano desconhecido, diferente de true e false
+static constexpr std::int8_t UnknownFlag = -1;
+
+FGLStateCache::FGLStateCache()
+{
+    Invalidate();
+}
+
+void FGLStateCache::Invalidate()
+{
+    Program = UnknownObject;
+    VAO = UnknownObject;
+    ArrayBuffer = UnknownObject;
+    UniformBuffer = UnknownObject;
+    UniformBufferRanges.fill(FBufferRange{ .Buffer = UnknownObject, .Offset = -1, .Size = -1 });
+    ActiveTextureUnit = UnknownObject;
+    Texture2DBindings.fill(UnknownObject);
+    bCullFace = UnknownFlag;
+    bDepthTest = UnknownFlag;
+    PolygonMode = UnknownObject;
+    SwapInterval = -1;
+}
+
+void FGLStateCache::BeginFrame()
+{
+    LastFrameStats = CurrentFrameStats;
+    CurrentFrameStats = {};
+}
+
+bool FGLStateCache::ShouldIssue(bool bInChanged)
+{
+    bInChanged ? CurrentFrameStats.IssuedCalls++ : CurrentFrameStats.SkippedCalls++;
+    return bInChanged;
+}
+
+void FGLStateCache::UseProgram(GLuint InProgramId)
+{
+    if (ShouldIssue(Program != InProgramId))
+    {
+        glUseProgram(InProgramId);
+        Program = InProgramId;
+    }
+}
+
+void FGLStateCache::BindVertexArray(GLuint InVAO)
+{
+    if (ShouldIssue(VAO != InVAO))
+    {
+        glBindVertexArray(InVAO);
+        VAO = InVAO;
+    }
+}
+
+void FGLStateCache::BindBuffer(GLenum InTarget, GLuint InBuffer)
+{
+    GLuint* CachedBuffer = nullptr;
+    switch (InTarget)
+    {
+        case GL_ARRAY_BUFFER:
+            CachedBuffer = &ArrayBuffer;
+            break;
+
+        case GL_UNIFORM_BUFFER:
+            CachedBuffer = &UniformBuffer;
+            break;
+
+        default:
+            // GL_ELEMENT_ARRAY_BUFFER faz parte do estado do VAO, entao nao e guardado aqui
+            ShouldIssue(true);
+            glBindBuffer(InTarget, InBuffer);
+            return;
+    }
+
+    if (ShouldIssue(*CachedBuffer != InBuffer))
+    {
+        glBindBuffer(InTarget, InBuffer);
+        *CachedBuffer = InBuffer;
+    }
+}
+
+void FGLStateCache::BindBufferRange(GLenum InTarget, GLuint InIndex, GLuint InBuffer, GLintptr InOffset, GLsizeiptr InSize)
+{
+    if (InTarget != GL_UNIFORM_BUFFER || InIndex >= MaxUniformBufferBindings)
+    {
+        ShouldIssue(true);
+        glBindBufferRange(InTarget, InIndex, InBuffer, InOffset, InSize);
+        return;
+    }
+
+    FBufferRange& Range = UniformBufferRanges[InIndex];
+    if (ShouldIssue(Range.Buffer != InBuffer || Range.Offset != InOffset || Range.Size != InSize))
+    {
+        glBindBufferRange(InTarget, InIndex, InBuffer, InOffset, InSize);
+        Range = FBufferRange{ .Buffer = InBuffer, .Offset = InOffset, .Size = InSize };
+
+        // glBindBufferRange tambem altera o binding generico do alvo
+        UniformBuffer = InBuffer;
+    }
+}
+
+void FGLStateCache::BindTexture(GLuint InUnit, GLenum InTarget, GLuint InTexture)
+{
+    if (InTarget != GL_TEXTURE_2D || InUnit >= MaxTextureUnits)
+    {
+        ShouldIssue(true);
+        glActiveTexture(GL_TEXTURE0 + InUnit);
+        ActiveTextureUnit = InUnit;
+        glBindTexture(InTarget, InTexture);
+        return;
+    }
+
+    if (Texture2DBindings[InUnit] == InTexture)
+    {
+        ShouldIssue(false);
+        return;
+    }
+
+    // Conta uma chamada por BindTexture, como os outros setters, mesmo quando a unidade ativa tambem muda
+    ShouldIssue(true);
+    if (ActiveTextureUnit != InUnit)
+    {
+        glActiveTexture(GL_TEXTURE0 + InUnit);
+        ActiveTextureUnit = InUnit;
+    }
+
+    glBindTexture(InTarget, InTexture);
+    Texture2DBindings[InUnit] = InTexture;
+}
+
+void FGLStateCache::SetCullFace(bool bInEnabled)
+{
+    if (ShouldIssue(bCullFace != static_cast<std::int8_t>(bInEnabled)))
+    {
+        bInEnabled ? glEnable(GL_CULL_FACE) : glDisable(GL_CULL_FACE);
+        bCullFace = bInEnabled;
+    }
+}
+
+void FGLStateCache::SetDepthTest(bool bInEnabled)
+{
+    if (ShouldIssue(bDepthTest != static_cast<std::int8_t>(bInEnabled)))
+    {
+        bInEnabled ? glEnable(GL_DEPTH_TEST) : glDisable(GL_DEPTH_TEST);
+        bDepthTest = bInEnabled;
+    }
+}
+
+void FGLStateCache::SetPolygonMode(GLenum InMode)
+{
+    if (ShouldIssue(PolygonMode != InMode))
+    {
+        glPolygonMode(GL_FRONT_AND_BACK, InMode);
+        PolygonMode = InMode;
+    }
+}
+
+void FGLStateCache::SetSwapInterval(std::int32_t InInterval)
+{
+    if (ShouldIssue(SwapInterval != InInterval))
+    {
+        glfwSwapInterval(InInterval);
+        SwapInterval = InInterval;
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstdint>
+
+struct FGLStateCacheStats
+{
+    std::uint32_t IssuedCalls = 0;
+    std::uint32_t SkippedCalls = 0;
+};
+
+// Guarda o estado atual do OpenGL para evitar chamadas redundantes ao driver.
+// Todo codigo que altera esse estado durante o frame deve passar por aqui ou chamar Invalidate().
+class FGLStateCache
+{
+public:
+
+    FGLStateCache();
+
+    // Esquece o estado conhecido, a proxima chamada de cada funcao sempre chega ao driver
+    void Invalidate();
+
+    // Fecha as estatisticas do frame anterior e comeca a contar o proximo
+    void BeginFrame();
+
+    const FGLStateCacheStats& GetLastFrameStats() const { return LastFrameStats; }
+
+    void UseProgram(GLuint InProgramId);
+    void BindVertexArray(GLuint InVAO);
+    void BindBuffer(GLenum InTarget, GLuint InBuffer);
+    void BindBufferRange(GLenum InTarget, GLuint InIndex, GLuint InBuffer, GLintptr InOffset, GLsizeiptr InSize);
+    void BindTexture(GLuint InUnit, GLenum InTarget, GLuint InTexture);
+    void SetCullFace(bool bInEnabled);
+    void SetDepthTest(bool bInEnabled);
+    void SetPolygonMode(GLenum InMode);
+    void SetSwapInterval(std::int32_t InInterval);
+
+private:
+
+    bool ShouldIssue(bool bInChanged);
+
+    struct FBufferRange
+    {
+        GLuint Buffer;
+        GLintptr Offset;
+        GLsizeiptr Size;
+    };
+
+    static constexpr GLuint UnknownObject = ~0u;
+    static constexpr GLuint MaxUniformBufferBindings = 36;
+    static constexpr GLuint MaxTextureUnits = 32;
+
+    GLuint Program;
+    GLuint VAO;
+    GLuint ArrayBuffer;
+    GLuint UniformBuffer;
+    std::array<FBufferRange, MaxUniformBufferBindings> UniformBufferRanges;
+    GLuint ActiveTextureUnit;
+    std::array<GLuint, MaxTextureUnits> Texture2DBindings;
+    std::int8_t bCullFace;
+    std::int8_t bDepthTest;
+    GLenum PolygonMode;
+    std::int32_t SwapInterval;
+
+    FGLStateCacheStats CurrentFrameStats;
+    FGLStateCacheStats LastFrameStats;
+};
@@ -0,0 +1,313 @@
+#include "GLTracer.h"
+
+#include <cstring>
+#include <iostream>
+#include <tuple>
+
+static constexpr std::array<const char*, static_cast<std::size_t>(EGLTracedCall::Count)> CallNames =
+{
+#define BLUEMARBLE_GL_TRACED_CALL_NAME(Name, Category) "gl" #Name,
+    BLUEMARBLE_GL_TRACED_CALLS(BLUEMARBLE_GL_TRACED_CALL_NAME)
+#undef BLUEMARBLE_GL_TRACED_CALL_NAME
+};
+
+static constexpr std::array<EGLCallCategory, static_cast<std::size_t>(EGLTracedCall::Count)> CallCategories =
+{
+#define BLUEMARBLE_GL_TRACED_CALL_CATEGORY(Name, Category) EGLCallCategory::Category,
+    BLUEMARBLE_GL_TRACED_CALLS(BLUEMARBLE_GL_TRACED_CALL_CATEGORY)
+#undef BLUEMARBLE_GL_TRACED_CALL_CATEGORY
+};
+
+static std::uint64_t CountTriangles(GLenum InMode, GLsizei InCount, GLsizei InInstanceCount)
+{
+    std::uint64_t TrianglesPerInstance = 0;
+    switch (InMode)
+    {
+        case GL_TRIANGLES:
+            TrianglesPerInstance = InCount / 3;
+            break;
+
+        case GL_TRIANGLE_STRIP:
+        case GL_TRIANGLE_FAN:
+            TrianglesPerInstance = InCount > 2 ? InCount - 2 : 0;
+            break;
+
+        default:
+            break;
+    }
+    return TrianglesPerInstance * InInstanceCount;
+}
+
+static std::uint64_t GetPixelDataSize(GLsizei InWidth, GLsizei InHeight, GLenum InFormat, GLenum InType)
+{
+    std::uint64_t NumComponents = 0;
+    switch (InFormat)
+    {
+        case GL_RED:
+        case GL_DEPTH_COMPONENT:
+            NumComponents = 1;
+            break;
+
+        case GL_RG:
+            NumComponents = 2;
+            break;
+
+        case GL_RGB:
+        case GL_BGR:
+            NumComponents = 3;
+            break;
+
+        case GL_RGBA:
+        case GL_BGRA:
+            NumComponents = 4;
+            break;
+
+        default:
+            break;
+    }
+
+    std::uint64_t ComponentSize = 0;
+    switch (InType)
+    {
+        case GL_UNSIGNED_BYTE:
+        case GL_BYTE:
+            ComponentSize = 1;
+            break;
+
+        case GL_UNSIGNED_SHORT:
+        case GL_SHORT:
+        case GL_HALF_FLOAT:
+            ComponentSize = 2;
+            break;
+
+        case GL_UNSIGNED_INT:
+        case GL_INT:
+        case GL_FLOAT:
+            ComponentSize = 4;
+            break;
+
+        default:
+            break;
+    }
+
+    return static_cast<std::uint64_t>(InWidth) * InHeight * NumComponents * ComponentSize;
+}
+
+// Mesmo layout do comando lido pelo glMultiDrawElementsIndirect
+struct FTracedIndirectCommand
+{
+    GLuint Count;
+    GLuint InstanceCount;
+    GLuint FirstIndex;
+    GLint BaseVertex;
+    GLuint BaseInstance;
+};
+
+template<EGLTracedCall Call, typename FunctionType>
+struct TTracedFunction;
+
+template<EGLTracedCall Call, typename ReturnType, typename... ArgTypes>
+struct TTracedFunction<Call, ReturnType (APIENTRY *)(ArgTypes...)>
+{
+    static inline ReturnType (APIENTRY *Real)(ArgTypes...) = nullptr;
+
+    static ReturnType APIENTRY Hook(ArgTypes... InArgs)
+    {
+        FGLTracer::Get().Record<Call>(InArgs...);
+        return Real(InArgs...);
+    }
+};
+
+FGLTracer& FGLTracer::Get()
+{
+    static FGLTracer Tracer;
+    return Tracer;
+}
+
+const char* FGLTracer::GetCallName(EGLTracedCall InCall)
+{
+    return CallNames[static_cast<std::size_t>(InCall)];
+}
+
+template<EGLTracedCall Call, typename... ArgTypes>
+void FGLTracer::Record(ArgTypes... InArgs)
+{
+    const std::size_t CallIndex = static_cast<std::size_t>(Call);
+    CurrentFrameStats.CallCounts[CallIndex]++;
+
+    switch (CallCategories[CallIndex])
+    {
+        case EGLCallCategory::Draw:
+            CurrentFrameStats.DrawCalls++;
+            break;
+
+        case EGLCallCategory::State:
+            CurrentFrameStats.StateChanges++;
+            break;
+
+        case EGLCallCategory::Upload:
+            CurrentFrameStats.Uploads++;
+            break;
+
+        default:
+            break;
+    }
+
+    const std::tuple<ArgTypes...> Args{ InArgs... };
+    if constexpr (Call == EGLTracedCall::DrawArrays)
+    {
+        CurrentFrameStats.TrianglesSubmitted += CountTriangles(std::get<0>(Args), std::get<2>(Args), 1);
+    }
+    else if constexpr (Call == EGLTracedCall::DrawElements)
+    {
+        CurrentFrameStats.TrianglesSubmitted += CountTriangles(std::get<0>(Args), std::get<1>(Args), 1);
+    }
+    else if constexpr (Call == EGLTracedCall::DrawElementsInstanced)
+    {
+        CurrentFrameStats.TrianglesSubmitted += CountTriangles(std::get<0>(Args), std::get<1>(Args), std::get<4>(Args));
+    }
+    else if constexpr (Call == EGLTracedCall::MultiDrawElementsIndirect)
+    {
+        CurrentFrameStats.TrianglesSubmitted += CountIndirectTriangles(std::get<0>(Args), std::get<2>(Args), std::get<3>(Args), std::get<4>(Args));
+    }
+    else if constexpr (Call == EGLTracedCall::BindBuffer)
+    {
+        if (std::get<0>(Args) == GL_DRAW_INDIRECT_BUFFER)
+        {
+            BoundIndirectBuffer = std::get<1>(Args);
+        }
+    }
+    else if constexpr (Call == EGLTracedCall::BufferData)
+    {
+        CurrentFrameStats.BufferBytesUploaded += std::get<1>(Args);
+        if (std::get<0>(Args) == GL_DRAW_INDIRECT_BUFFER)
+        {
+            // Realocar descarta o conteudo anterior
+            IndirectBufferCopies[BoundIndirectBuffer].assign(static_cast<std::size_t>(std::get<1>(Args)), 0);
+            RecordIndirectUpload(0, std::get<1>(Args), std::get<2>(Args));
+        }
+    }
+    else if constexpr (Call == EGLTracedCall::BufferSubData)
+    {
+        CurrentFrameStats.BufferBytesUploaded += std::get<2>(Args);
+        if (std::get<0>(Args) == GL_DRAW_INDIRECT_BUFFER)
+        {
+            RecordIndirectUpload(std::get<1>(Args), std::get<2>(Args), std::get<3>(Args));
+        }
+    }
+    else if constexpr (Call == EGLTracedCall::TexImage2D)
+    {
+        if (std::get<8>(Args) != nullptr)
+        {
+            CurrentFrameStats.TextureBytesUploaded += GetPixelDataSize(std::get<3>(Args), std::get<4>(Args), std::get<6>(Args), std::get<7>(Args));
+        }
+    }
+    else if constexpr (Call == EGLTracedCall::TexSubImage2D)
+    {
+        CurrentFrameStats.TextureBytesUploaded += GetPixelDataSize(std::get<4>(Args), std::get<5>(Args), std::get<6>(Args), std::get<7>(Args));
+    }
+
+    if (TraceStream.is_open())
+    {
+        TraceStream << GetCallName(Call) << '(';
+        bool bFirstArg = true;
+        ((TraceStream << (bFirstArg ? "" : ", ") << +InArgs, bFirstArg = false), ...);
+        TraceStream << ")\n";
+    }
+}
+
+void FGLTracer::RecordIndirectUpload(GLintptr InOffset, GLsizeiptr InSize, const void* InData)
+{
+    std::vector<std::uint8_t>& Copy = IndirectBufferCopies[BoundIndirectBuffer];
+    if (InData == nullptr || InOffset < 0 || InSize <= 0 || static_cast<std::size_t>(InOffset + InSize) > Copy.size())
+    {
+        return;
+    }
+
+    std::memcpy(Copy.data() + InOffset, InData, static_cast<std::size_t>(InSize));
+}
+
+std::uint64_t FGLTracer::CountIndirectTriangles(GLenum InMode, const void* InIndirect, GLsizei InDrawCount, GLsizei InStride) const
+{
+    const auto CopyIt = IndirectBufferCopies.find(BoundIndirectBuffer);
+    if (CopyIt == IndirectBufferCopies.end())
+    {
+        return 0;
+    }
+
+    // Com um buffer ligado o ponteiro e um offset dentro dele
+    const std::vector<std::uint8_t>& Copy = CopyIt->second;
+    const std::size_t Stride = InStride != 0 ? static_cast<std::size_t>(InStride) : sizeof(FTracedIndirectCommand);
+    const std::size_t FirstOffset = reinterpret_cast<std::uintptr_t>(InIndirect);
+
+    std::uint64_t NumTriangles = 0;
+    for (GLsizei DrawIndex = 0; DrawIndex < InDrawCount; ++DrawIndex)
+    {
+        const std::size_t Offset = FirstOffset + static_cast<std::size_t>(DrawIndex) * Stride;
+        if (Offset + sizeof(FTracedIndirectCommand) > Copy.size())
+        {
+            break;
+        }
+
+        FTracedIndirectCommand Command;
+        std::memcpy(&Command, Copy.data() + Offset, sizeof(Command));
+        NumTriangles += CountTriangles(InMode, static_cast<GLsizei>(Command.Count), static_cast<GLsizei>(Command.InstanceCount));
+    }
+    return NumTriangles;
+}
+
+void FGLTracer::Install()
+{
+    if (bIsInstalled)
+    {
+        return;
+    }
+
+#define BLUEMARBLE_GL_INSTALL_HOOK(Name, Category)                                                  \
+    TTracedFunction<EGLTracedCall::Name, decltype(glad_gl##Name)>::Real = glad_gl##Name;           \
+    glad_gl##Name = TTracedFunction<EGLTracedCall::Name, decltype(glad_gl##Name)>::Hook;
+    BLUEMARBLE_GL_TRACED_CALLS(BLUEMARBLE_GL_INSTALL_HOOK)
+#undef BLUEMARBLE_GL_INSTALL_HOOK
+
+    bIsInstalled = true;
+    std::cout << "GL Tracer instalado" << std::endl;
+}
+
+void FGLTracer::BeginFrame()
+{
+    LastFrameStats = CurrentFrameStats;
+    CurrentFrameStats = {};
+    FrameNumber++;
+
+    if (NumFramesToCapture > 0 && !TraceStream.is_open())
+    {
+        TraceStream.open(PendingTraceFilePath, std::ios::out | std::ios::trunc);
+        if (!TraceStream)
+        {
+            std::cout << "Erro ao abrir " << PendingTraceFilePath << std::endl;
+            NumFramesToCapture = 0;
+        }
+    }
+    else if (NumFramesToCapture == 0 && TraceStream.is_open())
+    {
+        TraceStream.close();
+        std::cout << "Trace salvo em " << PendingTraceFilePath << std::endl;
+    }
+
+    if (NumFramesToCapture > 0)
+    {
+        TraceStream << "# Frame " << FrameNumber << '\n';
+        NumFramesToCapture--;
+    }
+}
+
+void FGLTracer::CaptureFrames(std::uint32_t InNumFrames, const std::filesystem::path& InTraceFilePath)
+{
+    if (IsCapturing())
+    {
+        return;
+    }
+
+    NumFramesToCapture = InNumFrames;
+    PendingTraceFilePath = InTraceFilePath;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+
+// Lista das funcoes do OpenGL interceptadas pelo FGLTracer: X(Nome, Categoria)
+#define BLUEMARBLE_GL_TRACED_CALLS(X)       \
+    X(DrawArrays, Draw)                     \
+    X(DrawElements, Draw)                   \
+    X(DrawElementsInstanced, Draw)          \
+    X(MultiDrawElementsIndirect, Draw)      \
+    X(UseProgram, State)                    \
+    X(BindVertexArray, State)               \
+    X(BindBuffer, State)                    \
+    X(BindBufferRange, State)               \
+    X(ActiveTexture, State)                 \
+    X(BindTexture, State)                   \
+    X(Enable, State)                        \
+    X(Disable, State)                       \
+    X(PolygonMode, State)                   \
+    X(Uniform1i, State)                     \
+    X(BufferData, Upload)                   \
+    X(BufferSubData, Upload)                \
+    X(TexImage2D, Upload)                   \
+    X(TexSubImage2D, Upload)                \
+    X(Clear, Other)
+
+enum class EGLTracedCall : std::uint32_t
+{
+#define BLUEMARBLE_GL_TRACED_CALL_ENUM(Name, Category) Name,
+    BLUEMARBLE_GL_TRACED_CALLS(BLUEMARBLE_GL_TRACED_CALL_ENUM)
+#undef BLUEMARBLE_GL_TRACED_CALL_ENUM
+    Count
+};
+
+enum class EGLCallCategory
+{
+    Draw,
+    State,
+    Upload,
+    Other
+};
+
+struct FGLFrameStats
+{
+    std::array<std::uint32_t, static_cast<std::size_t>(EGLTracedCall::Count)> CallCounts{};
+    std::uint32_t DrawCalls = 0;
+    std::uint32_t StateChanges = 0;
+    std::uint32_t Uploads = 0;
+    std::uint64_t BufferBytesUploaded = 0;
+    std::uint64_t TextureBytesUploaded = 0;
+
+    std::uint64_t TrianglesSubmitted = 0;
+};
+
+// Intercepta os ponteiros de funcao do glad para contar chamadas, bytes enviados e
+// triangulos desenhados por frame. So e instalado quando BLUEMARBLE_GL_TRACE esta ligado.
+class FGLTracer
+{
+public:
+
+    static FGLTracer& Get();
+
+    static const char* GetCallName(EGLTracedCall InCall);
+
+    // Deve ser chamado depois do gladLoadGLLoader
+    void Install();
+
+    bool IsInstalled() const { return bIsInstalled; }
+
+    void BeginFrame();
+
+    const FGLFrameStats& GetLastFrameStats() const { return LastFrameStats; }
+
+    // Grava todas as chamadas dos proximos InNumFrames frames em InTraceFilePath
+    void CaptureFrames(std::uint32_t InNumFrames, const std::filesystem::path& InTraceFilePath);
+
+    bool IsCapturing() const { return NumFramesToCapture > 0 || TraceStream.is_open(); }
+
+    template<EGLTracedCall Call, typename... ArgTypes>
+    void Record(ArgTypes... InArgs);
+
+private:
+
+    FGLTracer() = default;
+
+    // Os comandos do MultiDrawElementsIndirect estao num buffer da GPU. O tracer guarda uma copia do que foi
+    // enviado para cada buffer de GL_DRAW_INDIRECT_BUFFER para contar os triangulos sem ler a GPU
+    void RecordIndirectUpload(GLintptr InOffset, GLsizeiptr InSize, const void* InData);
+    std::uint64_t CountIndirectTriangles(GLenum InMode, const void* InIndirect, GLsizei InDrawCount, GLsizei InStride) const;
+
+    GLuint BoundIndirectBuffer = 0;
+    std::unordered_map<GLuint, std::vector<std::uint8_t>> IndirectBufferCopies;
+
+    bool bIsInstalled = false;
+
+    FGLFrameStats CurrentFrameStats;
+    FGLFrameStats LastFrameStats;
+
+    std::uint64_t FrameNumber = 0;
+    std::uint32_t NumFramesToCapture = 0;
+    std::filesystem::path PendingTraceFilePath;
+    std::ofstream TraceStream;
+};
@@ -0,0 +1,303 @@
+#include "GPUBufferArena.h"
+
+#include "GPUResourceRegistry.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+    GLintptr AlignOffset(GLintptr InOffset, GLsizeiptr InAlignment)
+    {
+        return (InOffset + InAlignment - 1) / InAlignment * InAlignment;
+    }
+}
+
+void FGPUBufferArena::Initialize(GLsizeiptr InCapacity, const char* InDebugName)
+{
+    DebugName = InDebugName;
+    ReplaceBuffer(CreateBuffer(InCapacity), InCapacity);
+
+    FreeBlocks.clear();
+    FreeBlocks.push_back(FGPUBufferBlock{ .Offset = 0, .Size = InCapacity });
+}
+
+void FGPUBufferArena::Shutdown()
+{
+    FGPUResourceRegistry::Get().Delete(EGPUResourceType::Buffer, BufferId);
+    Capacity = 0;
+
+    Allocations.clear();
+    FreeHandles.clear();
+    FreeBlocks.clear();
+}
+
+GLuint FGPUBufferArena::CreateBuffer(GLsizeiptr InCapacity) const
+{
+    FGPUResourceRegistry& Registry = FGPUResourceRegistry::Get();
+    const GLuint NewBufferId = Registry.CreateBuffer(DebugName);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, NewBufferId);
+    glBufferData(GL_COPY_WRITE_BUFFER, InCapacity, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    Registry.SetSize(EGPUResourceType::Buffer, NewBufferId, InCapacity);
+    return NewBufferId;
+}
+
+void FGPUBufferArena::ReplaceBuffer(GLuint InNewBufferId, GLsizeiptr InNewCapacity)
+{
+    FGPUResourceRegistry::Get().Delete(EGPUResourceType::Buffer, BufferId);
+
+    BufferId = InNewBufferId;
+    Capacity = InNewCapacity;
+    Generation++;
+}
+
+bool FGPUBufferArena::TryAllocateFromFreeList(GLsizeiptr InSize, GLsizeiptr InAlignment, GLintptr& OutOffset)
+{
+    for (std::size_t BlockIndex = 0; BlockIndex < FreeBlocks.size(); ++BlockIndex)
+    {
+        const FGPUBufferBlock FreeBlock = FreeBlocks[BlockIndex];
+        const GLintptr AlignedOffset = AlignOffset(FreeBlock.Offset, InAlignment);
+        const GLsizeiptr Padding = AlignedOffset - FreeBlock.Offset;
+        if (Padding + InSize > FreeBlock.Size)
+        {
+            continue;
+        }
+
+        // O que sobra antes e depois da regiao alocada continua livre
+        FreeBlocks.erase(FreeBlocks.begin() + BlockIndex);
+
+        const GLsizeiptr Remaining = FreeBlock.Size - Padding - InSize;
+        if (Remaining > 0)
+        {
+            FreeBlocks.insert(FreeBlocks.begin() + BlockIndex, FGPUBufferBlock{ .Offset = AlignedOffset + InSize, .Size = Remaining });
+        }
+
+        if (Padding > 0)
+        {
+            FreeBlocks.insert(FreeBlocks.begin() + BlockIndex, FGPUBufferBlock{ .Offset = FreeBlock.Offset, .Size = Padding });
+        }
+
+        OutOffset = AlignedOffset;
+        return true;
+    }
+
+    return false;
+}
+
+FGPUBufferHandle FGPUBufferArena::Allocate(GLsizeiptr InSize, GLsizeiptr InAlignment)
+{
+    InAlignment = std::max<GLsizeiptr>(InAlignment, 1);
+
+    GLintptr Offset = 0;
+    if (!TryAllocateFromFreeList(InSize, InAlignment, Offset))
+    {
+        const FGPUBufferArenaStats Stats = GetStats();
+        const GLsizeiptr FreeBytes = Stats.Capacity - Stats.UsedBytes;
+
+        // Se a memoria livre e suficiente o problema e a fragmentacao, senao o buffer precisa crescer
+        const bool bDefragmented = FreeBytes >= InSize + InAlignment && Defragment();
+        if (!bDefragmented || !TryAllocateFromFreeList(InSize, InAlignment, Offset))
+        {
+            Grow(Capacity + InSize + InAlignment);
+            TryAllocateFromFreeList(InSize, InAlignment, Offset);
+        }
+    }
+
+    FGPUBufferHandle Handle = InvalidGPUBufferHandle;
+    if (!FreeHandles.empty())
+    {
+        Handle = FreeHandles.back();
+        FreeHandles.pop_back();
+    }
+    else
+    {
+        Handle = static_cast<FGPUBufferHandle>(Allocations.size());
+        Allocations.emplace_back();
+    }
+
+    Allocations[Handle] = FAllocation{ .Block = { .Offset = Offset, .Size = InSize }, .Alignment = InAlignment };
+    return Handle;
+}
+
+void FGPUBufferArena::ReleaseRange(GLintptr InOffset, GLsizeiptr InSize)
+{
+    auto Next = std::lower_bound(FreeBlocks.begin(), FreeBlocks.end(), InOffset, [](const FGPUBufferBlock& Block, GLintptr Offset)
+    {
+        return Block.Offset < Offset;
+    });
+
+    Next = FreeBlocks.insert(Next, FGPUBufferBlock{ .Offset = InOffset, .Size = InSize });
+
+    // Une com o bloco seguinte e depois com o anterior
+    if (Next + 1 != FreeBlocks.end() && Next->Offset + Next->Size == (Next + 1)->Offset)
+    {
+        Next->Size += (Next + 1)->Size;
+        FreeBlocks.erase(Next + 1);
+    }
+
+    if (Next != FreeBlocks.begin() && (Next - 1)->Offset + (Next - 1)->Size == Next->Offset)
+    {
+        (Next - 1)->Size += Next->Size;
+        FreeBlocks.erase(Next);
+    }
+}
+
+void FGPUBufferArena::Free(FGPUBufferHandle InHandle)
+{
+    FAllocation& Allocation = Allocations[InHandle];
+    if (Allocation.Alignment == 0)
+    {
+        return;
+    }
+
+    if (Allocation.Block.Size > 0)
+    {
+        ReleaseRange(Allocation.Block.Offset, Allocation.Block.Size);
+    }
+
+    Allocation = FAllocation{};
+    FreeHandles.push_back(InHandle);
+}
+
+void FGPUBufferArena::Upload(FGPUBufferHandle InHandle, const void* InData, GLsizeiptr InSize)
+{
+    const FGPUBufferBlock& Block = GetBlock(InHandle);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, BufferId);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, Block.Offset, std::min(InSize, Block.Size), InData);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+void* FGPUBufferArena::Map(FGPUBufferHandle InHandle)
+{
+    const FGPUBufferBlock& Block = GetBlock(InHandle);
+    if (Block.Size == 0)
+    {
+        return nullptr;
+    }
+
+    // Usa DSA para nao precisar ligar o buffer em nenhum target
+    return glMapNamedBufferRange(BufferId, Block.Offset, Block.Size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+}
+
+bool FGPUBufferArena::Unmap()
+{
+    if (glUnmapNamedBuffer(BufferId) == GL_FALSE)
+    {
+        std::cout << "GPU Buffer Arena '" << DebugName << "' perdeu o conteudo mapeado" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+void FGPUBufferArena::Grow(GLsizeiptr InMinCapacity)
+{
+    const GLsizeiptr OldCapacity = Capacity;
+    const GLsizeiptr NewCapacity = std::max(InMinCapacity, Capacity * 2);
+
+    const GLuint NewBufferId = CreateBuffer(NewCapacity);
+    if (OldCapacity > 0)
+    {
+        glBindBuffer(GL_COPY_READ_BUFFER, BufferId);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, NewBufferId);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, OldCapacity);
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+
+    ReplaceBuffer(NewBufferId, NewCapacity);
+    ReleaseRange(OldCapacity, NewCapacity - OldCapacity);
+
+    std::cout << "GPU Buffer Arena '" << DebugName << "' cresceu para " << NewCapacity << " bytes" << std::endl;
+}
+
+bool FGPUBufferArena::Defragment()
+{
+    std::vector<FGPUBufferHandle> LiveHandles;
+    for (FGPUBufferHandle Handle = 0; Handle < Allocations.size(); ++Handle)
+    {
+        if (Allocations[Handle].Alignment != 0)
+        {
+            LiveHandles.push_back(Handle);
+        }
+    }
+
+    std::sort(LiveHandles.begin(), LiveHandles.end(), [this](FGPUBufferHandle A, FGPUBufferHandle B)
+    {
+        return Allocations[A].Block.Offset < Allocations[B].Block.Offset;
+    });
+
+    // Calcula as novas posicoes antes de copiar para saber se alguma regiao realmente se move
+    std::vector<GLintptr> NewOffsets;
+    NewOffsets.reserve(LiveHandles.size());
+
+    bool bAnyMoved = false;
+    GLintptr NextOffset = 0;
+    for (const FGPUBufferHandle Handle : LiveHandles)
+    {
+        const FAllocation& Allocation = Allocations[Handle];
+        const GLintptr NewOffset = AlignOffset(NextOffset, Allocation.Alignment);
+        bAnyMoved |= NewOffset != Allocation.Block.Offset;
+        NewOffsets.push_back(NewOffset);
+        NextOffset = NewOffset + Allocation.Block.Size;
+    }
+
+    if (!bAnyMoved)
+    {
+        return false;
+    }
+
+    // As regioes sao copiadas para um buffer novo porque as origens e os destinos podem se sobrepor
+    const GLuint NewBufferId = CreateBuffer(Capacity);
+    glBindBuffer(GL_COPY_READ_BUFFER, BufferId);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, NewBufferId);
+
+    FreeBlocks.clear();
+    GLintptr PreviousEnd = 0;
+    for (std::size_t LiveIndex = 0; LiveIndex < LiveHandles.size(); ++LiveIndex)
+    {
+        FGPUBufferBlock& Block = Allocations[LiveHandles[LiveIndex]].Block;
+        const GLintptr NewOffset = NewOffsets[LiveIndex];
+        if (Block.Size > 0)
+        {
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, Block.Offset, NewOffset, Block.Size);
+        }
+
+        // O espaco deixado pelo alinhamento continua disponivel para alocacoes menores
+        if (NewOffset > PreviousEnd)
+        {
+            FreeBlocks.push_back(FGPUBufferBlock{ .Offset = PreviousEnd, .Size = NewOffset - PreviousEnd });
+        }
+
+        Block.Offset = NewOffset;
+        PreviousEnd = NewOffset + Block.Size;
+    }
+
+    if (PreviousEnd < Capacity)
+    {
+        FreeBlocks.push_back(FGPUBufferBlock{ .Offset = PreviousEnd, .Size = Capacity - PreviousEnd });
+    }
+
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    ReplaceBuffer(NewBufferId, Capacity);
+    return true;
+}
+
+FGPUBufferArenaStats FGPUBufferArena::GetStats() const
+{
+    FGPUBufferArenaStats Stats;
+    Stats.Capacity = Capacity;
+    Stats.NumFreeBlocks = static_cast<std::uint32_t>(FreeBlocks.size());
+    for (const FAllocation& Allocation : Allocations)
+    {
+        if (Allocation.Alignment != 0)
+        {
+            Stats.UsedBytes += Allocation.Block.Size;
+            Stats.NumAllocations++;
+        }
+    }
+    return Stats;
+}
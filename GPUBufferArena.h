@@ -0,0 +1,90 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <vector>
+
+// Handle estavel para uma regiao do arena. O offset pode mudar quando o arena cresce ou e desfragmentado
+using FGPUBufferHandle = std::uint32_t;
+inline constexpr FGPUBufferHandle InvalidGPUBufferHandle = ~0u;
+
+struct FGPUBufferBlock
+{
+    GLintptr Offset = 0;
+    GLsizeiptr Size = 0;
+};
+
+struct FGPUBufferArenaStats
+{
+    GLsizeiptr Capacity = 0;
+    GLsizeiptr UsedBytes = 0;
+    std::uint32_t NumAllocations = 0;
+    std::uint32_t NumFreeBlocks = 0;
+};
+
+// Sub-alocador de um unico buffer do OpenGL. As regioes livres ficam numa free-list ordenada por offset
+// e sao unidas com as vizinhas quando liberadas. Todas as copias usam GL_COPY_READ_BUFFER e
+// GL_COPY_WRITE_BUFFER para nao alterar os bindings do VAO ou do FGLStateCache
+class FGPUBufferArena
+{
+public:
+
+    FGPUBufferArena() = default;
+
+    FGPUBufferArena(const FGPUBufferArena&) = delete;
+    FGPUBufferArena& operator=(const FGPUBufferArena&) = delete;
+
+    void Initialize(GLsizeiptr InCapacity, const char* InDebugName);
+
+    // Apaga o buffer. Todos os handles ficam invalidos
+    void Shutdown();
+
+    // InAlignment e o multiplo exigido para o offset, nao precisa ser potencia de 2
+    FGPUBufferHandle Allocate(GLsizeiptr InSize, GLsizeiptr InAlignment);
+    void Free(FGPUBufferHandle InHandle);
+
+    void Upload(FGPUBufferHandle InHandle, const void* InData, GLsizeiptr InSize);
+
+    // Mapeia a regiao para escrita direta, descartando o conteudo anterior. O ponteiro pode ser escrito por
+    // qualquer thread, mas Map e Unmap precisam ser chamados na thread do OpenGL e so uma regiao fica mapeada
+    // por vez. Unmap retorna false se o conteudo foi perdido e precisa ser escrito de novo
+    void* Map(FGPUBufferHandle InHandle);
+    bool Unmap();
+
+    // Compacta todas as regioes no inicio de um novo buffer. Retorna true se alguma regiao mudou de lugar
+    bool Defragment();
+
+    const FGPUBufferBlock& GetBlock(FGPUBufferHandle InHandle) const { return Allocations[InHandle].Block; }
+    GLuint GetBufferId() const { return BufferId; }
+
+    // Muda sempre que o BufferId muda, para quem guarda o buffer num VAO saber quando refazer o binding
+    std::uint32_t GetGeneration() const { return Generation; }
+
+    FGPUBufferArenaStats GetStats() const;
+
+private:
+
+    struct FAllocation
+    {
+        FGPUBufferBlock Block;
+
+        // Zero indica um handle livre para ser reaproveitado
+        GLsizeiptr Alignment = 0;
+    };
+
+    bool TryAllocateFromFreeList(GLsizeiptr InSize, GLsizeiptr InAlignment, GLintptr& OutOffset);
+    void ReleaseRange(GLintptr InOffset, GLsizeiptr InSize);
+    void Grow(GLsizeiptr InMinCapacity);
+    GLuint CreateBuffer(GLsizeiptr InCapacity) const;
+    void ReplaceBuffer(GLuint InNewBufferId, GLsizeiptr InNewCapacity);
+
+    GLuint BufferId = 0;
+    GLsizeiptr Capacity = 0;
+    std::uint32_t Generation = 0;
+    const char* DebugName = "";
+
+    std::vector<FAllocation> Allocations;
+    std::vector<FGPUBufferHandle> FreeHandles;
+    std::vector<FGPUBufferBlock> FreeBlocks;
+};
@@ -0,0 +1,175 @@
+#include "GPUResourceRegistry.h"
+
+#include <iostream>
+
+static constexpr std::array<const char*, static_cast<std::size_t>(EGPUResourceType::Count)> TypeNames =
+{
+#define BLUEMARBLE_GPU_RESOURCE_TYPE_NAME(Name, Identifier) #Name,
+    BLUEMARBLE_GPU_RESOURCE_TYPES(BLUEMARBLE_GPU_RESOURCE_TYPE_NAME)
+#undef BLUEMARBLE_GPU_RESOURCE_TYPE_NAME
+};
+
+static constexpr std::array<GLenum, static_cast<std::size_t>(EGPUResourceType::Count)> LabelIdentifiers =
+{
+#define BLUEMARBLE_GPU_RESOURCE_TYPE_IDENTIFIER(Name, Identifier) Identifier,
+    BLUEMARBLE_GPU_RESOURCE_TYPES(BLUEMARBLE_GPU_RESOURCE_TYPE_IDENTIFIER)
+#undef BLUEMARBLE_GPU_RESOURCE_TYPE_IDENTIFIER
+};
+
+FGPUResourceRegistry& FGPUResourceRegistry::Get()
+{
+    static FGPUResourceRegistry Registry;
+    return Registry;
+}
+
+const char* FGPUResourceRegistry::GetTypeName(EGPUResourceType InType)
+{
+    return TypeNames[static_cast<std::size_t>(InType)];
+}
+
+void FGPUResourceRegistry::Register(EGPUResourceType InType, GLuint InId, std::string_view InLabel)
+{
+    glObjectLabel(LabelIdentifiers[static_cast<std::size_t>(InType)], InId, static_cast<GLsizei>(InLabel.size()), InLabel.data());
+
+    Resources[{ InType, InId }] = FGPUResourceInfo{ .Label = std::string{ InLabel } };
+    Totals[static_cast<std::size_t>(InType)].NumResources++;
+}
+
+GLuint FGPUResourceRegistry::CreateBuffer(std::string_view InLabel)
+{
+    GLuint BufferId = 0;
+    glCreateBuffers(1, &BufferId);
+    Register(EGPUResourceType::Buffer, BufferId, InLabel);
+    return BufferId;
+}
+
+GLuint FGPUResourceRegistry::CreateTexture(GLenum InTarget, std::string_view InLabel)
+{
+    GLuint TextureId = 0;
+    glCreateTextures(InTarget, 1, &TextureId);
+    Register(EGPUResourceType::Texture, TextureId, InLabel);
+    return TextureId;
+}
+
+GLuint FGPUResourceRegistry::CreateVertexArray(std::string_view InLabel)
+{
+    GLuint VertexArrayId = 0;
+    glCreateVertexArrays(1, &VertexArrayId);
+    Register(EGPUResourceType::VertexArray, VertexArrayId, InLabel);
+    return VertexArrayId;
+}
+
+GLuint FGPUResourceRegistry::CreateFramebuffer(std::string_view InLabel)
+{
+    GLuint FramebufferId = 0;
+    glCreateFramebuffers(1, &FramebufferId);
+    Register(EGPUResourceType::Framebuffer, FramebufferId, InLabel);
+    return FramebufferId;
+}
+
+GLuint FGPUResourceRegistry::CreateProgram(std::string_view InLabel)
+{
+    const GLuint ProgramId = glCreateProgram();
+    Register(EGPUResourceType::Program, ProgramId, InLabel);
+    return ProgramId;
+}
+
+GLuint FGPUResourceRegistry::CreateQuery(GLenum InTarget, std::string_view InLabel)
+{
+    GLuint QueryId = 0;
+    glCreateQueries(InTarget, 1, &QueryId);
+    Register(EGPUResourceType::Query, QueryId, InLabel);
+    return QueryId;
+}
+
+void FGPUResourceRegistry::SetSize(EGPUResourceType InType, GLuint InId, std::int64_t InSize)
+{
+    const auto ResourceIt = Resources.find({ InType, InId });
+    if (ResourceIt == Resources.end())
+    {
+        std::cout << "SetSize de um recurso nao registrado: " << GetTypeName(InType) << " " << InId << std::endl;
+        return;
+    }
+
+    Totals[static_cast<std::size_t>(InType)].Size += InSize - ResourceIt->second.Size;
+    ResourceIt->second.Size = InSize;
+}
+
+void FGPUResourceRegistry::Delete(EGPUResourceType InType, GLuint& InOutId)
+{
+    if (InOutId == 0)
+    {
+        return;
+    }
+
+    switch (InType)
+    {
+        case EGPUResourceType::Buffer:
+            glDeleteBuffers(1, &InOutId);
+            break;
+
+        case EGPUResourceType::Texture:
+            glDeleteTextures(1, &InOutId);
+            break;
+
+        case EGPUResourceType::VertexArray:
+            glDeleteVertexArrays(1, &InOutId);
+            break;
+
+        case EGPUResourceType::Framebuffer:
+            glDeleteFramebuffers(1, &InOutId);
+            break;
+
+        case EGPUResourceType::Program:
+            glDeleteProgram(InOutId);
+            break;
+
+        case EGPUResourceType::Query:
+            glDeleteQueries(1, &InOutId);
+            break;
+
+        default:
+            break;
+    }
+
+    const auto ResourceIt = Resources.find({ InType, InOutId });
+    if (ResourceIt != Resources.end())
+    {
+        FGPUResourceTotals& TypeTotals = Totals[static_cast<std::size_t>(InType)];
+        TypeTotals.NumResources--;
+        TypeTotals.Size -= ResourceIt->second.Size;
+        Resources.erase(ResourceIt);
+    }
+    else
+    {
+        std::cout << "Apagando um recurso nao registrado: " << GetTypeName(InType) << " " << InOutId << std::endl;
+    }
+
+    InOutId = 0;
+}
+
+FGPUResourceTotals FGPUResourceRegistry::GetTotals() const
+{
+    FGPUResourceTotals AllTotals;
+    for (const FGPUResourceTotals& TypeTotals : Totals)
+    {
+        AllTotals.NumResources += TypeTotals.NumResources;
+        AllTotals.Size += TypeTotals.Size;
+    }
+    return AllTotals;
+}
+
+std::uint32_t FGPUResourceRegistry::ReportLeaks() const
+{
+    for (const auto& [Key, Info] : Resources)
+    {
+        std::cout << "Recurso da GPU nao liberado: " << GetTypeName(Key.first) << " " << Key.second << " '" << Info.Label << "' (" << Info.Size << " bytes)" << std::endl;
+    }
+
+    if (Resources.empty())
+    {
+        std::cout << "Todos os recursos da GPU foram liberados" << std::endl;
+    }
+
+    return static_cast<std::uint32_t>(Resources.size());
+}
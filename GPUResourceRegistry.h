@@ -0,0 +1,84 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+
+// Tipos de objetos do OpenGL registrados: X(Nome, Identificador do glObjectLabel)
+#define BLUEMARBLE_GPU_RESOURCE_TYPES(X)    \
+    X(Buffer, GL_BUFFER)                    \
+    X(Texture, GL_TEXTURE)                  \
+    X(VertexArray, GL_VERTEX_ARRAY)         \
+    X(Framebuffer, GL_FRAMEBUFFER)          \
+    X(Program, GL_PROGRAM)                  \
+    X(Query, GL_QUERY)
+
+enum class EGPUResourceType : std::uint8_t
+{
+#define BLUEMARBLE_GPU_RESOURCE_TYPE_ENUM(Name, Identifier) Name,
+    BLUEMARBLE_GPU_RESOURCE_TYPES(BLUEMARBLE_GPU_RESOURCE_TYPE_ENUM)
+#undef BLUEMARBLE_GPU_RESOURCE_TYPE_ENUM
+    Count
+};
+
+struct FGPUResourceInfo
+{
+    std::string Label;
+
+    // Memoria estimada na GPU, zero quando nao se aplica (VAOs, framebuffers, programas e queries)
+    std::int64_t Size = 0;
+};
+
+struct FGPUResourceTotals
+{
+    std::uint32_t NumResources = 0;
+    std::int64_t Size = 0;
+};
+
+using FGPUResourceKey = std::pair<EGPUResourceType, GLuint>;
+
+// Registro de todos os objetos do OpenGL criados pelo programa, com nome (tambem enviado ao driver com
+// glObjectLabel) e tamanho. Os objetos sao criados com as funcoes DSA para que existam antes do primeiro bind.
+// So pode ser usado pela thread do OpenGL. Os objetos do ImGui nao sao registrados.
+class FGPUResourceRegistry
+{
+public:
+
+    static FGPUResourceRegistry& Get();
+
+    static const char* GetTypeName(EGPUResourceType InType);
+
+    GLuint CreateBuffer(std::string_view InLabel);
+    GLuint CreateTexture(GLenum InTarget, std::string_view InLabel);
+    GLuint CreateVertexArray(std::string_view InLabel);
+    GLuint CreateFramebuffer(std::string_view InLabel);
+    GLuint CreateProgram(std::string_view InLabel);
+    GLuint CreateQuery(GLenum InTarget, std::string_view InLabel);
+
+    // Deve ser chamado sempre que o armazenamento do objeto for alocado de novo
+    void SetSize(EGPUResourceType InType, GLuint InId, std::int64_t InSize);
+
+    // Apaga o objeto e zera InOutId. Um identificador zero e ignorado
+    void Delete(EGPUResourceType InType, GLuint& InOutId);
+
+    const std::map<FGPUResourceKey, FGPUResourceInfo>& GetResources() const { return Resources; }
+    const FGPUResourceTotals& GetTotals(EGPUResourceType InType) const { return Totals[static_cast<std::size_t>(InType)]; }
+    FGPUResourceTotals GetTotals() const;
+
+    // Loga todos os objetos que ainda nao foram apagados e retorna quantos sao
+    std::uint32_t ReportLeaks() const;
+
+private:
+
+    FGPUResourceRegistry() = default;
+
+    void Register(EGPUResourceType InType, GLuint InId, std::string_view InLabel);
+
+    std::map<FGPUResourceKey, FGPUResourceInfo> Resources;
+    std::array<FGPUResourceTotals, static_cast<std::size_t>(EGPUResourceType::Count)> Totals{};
+};
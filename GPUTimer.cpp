@@ -0,0 +1,95 @@
+#include "GPUTimer.h"
+
+#include "GPUResourceRegistry.h"
+
+#include <string>
+
+static constexpr std::array<const char*, static_cast<std::size_t>(EGPUPass::Count)> PassNames =
+{
+#define BLUEMARBLE_GPU_PASS_NAME(Name) #Name,
+    BLUEMARBLE_GPU_PASSES(BLUEMARBLE_GPU_PASS_NAME)
+#undef BLUEMARBLE_GPU_PASS_NAME
+};
+
+const char* GetGPUPassName(EGPUPass InPass)
+{
+    return PassNames[static_cast<std::size_t>(InPass)];
+}
+
+void FGPUTimer::Initialize(std::string_view InLabel)
+{
+    FGPUResourceRegistry& Registry = FGPUResourceRegistry::Get();
+    for (std::uint32_t QueryIndex = 0; QueryIndex < NumQueries; ++QueryIndex)
+    {
+        Queries[QueryIndex] = Registry.CreateQuery(GL_TIME_ELAPSED, std::string{ InLabel } + " " + std::to_string(QueryIndex));
+    }
+
+    NextQuery = 0;
+    NumPendingQueries = 0;
+    bMeasuring = false;
+}
+
+void FGPUTimer::Shutdown()
+{
+    if (bMeasuring)
+    {
+        glEndQuery(GL_TIME_ELAPSED);
+        bMeasuring = false;
+    }
+
+    FGPUResourceRegistry& Registry = FGPUResourceRegistry::Get();
+    for (GLuint& Query : Queries)
+    {
+        Registry.Delete(EGPUResourceType::Query, Query);
+    }
+    NumPendingQueries = 0;
+}
+
+void FGPUTimer::Begin()
+{
+    if (Queries[0] == 0 || NumPendingQueries == NumQueries)
+    {
+        return;
+    }
+
+    glBeginQuery(GL_TIME_ELAPSED, Queries[NextQuery]);
+    bMeasuring = true;
+}
+
+void FGPUTimer::End()
+{
+    if (!bMeasuring)
+    {
+        return;
+    }
+
+    glEndQuery(GL_TIME_ELAPSED);
+    NextQuery = (NextQuery + 1) % NumQueries;
+    NumPendingQueries++;
+    bMeasuring = false;
+}
+
+std::uint32_t FGPUTimer::Poll()
+{
+    std::uint32_t NumResults = 0;
+    while (NumPendingQueries > 0)
+    {
+        const GLuint Query = Queries[(NextQuery + NumQueries - NumPendingQueries) % NumQueries];
+
+        // As queries terminam em ordem, se a mais antiga nao esta pronta as outras tambem nao estao
+        GLint bAvailable = GL_FALSE;
+        glGetQueryObjectiv(Query, GL_QUERY_RESULT_AVAILABLE, &bAvailable);
+        if (bAvailable == GL_FALSE)
+        {
+            break;
+        }
+
+        GLuint64 ElapsedTime = 0;
+        glGetQueryObjectui64v(Query, GL_QUERY_RESULT, &ElapsedTime);
+        LastTime = static_cast<double>(ElapsedTime) / 1.0e6;
+
+        NumPendingQueries--;
+        NumResults++;
+    }
+    return NumResults;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+// Passadas do frame que tem o tempo de GPU medido
+#define BLUEMARBLE_GPU_PASSES(X)    \
+    X(Scene)                        \
+    X(Upscale)                      \
+    X(UI)
+
+enum class EGPUPass : std::uint8_t
+{
+#define BLUEMARBLE_GPU_PASS_ENUM(Name) Name,
+    BLUEMARBLE_GPU_PASSES(BLUEMARBLE_GPU_PASS_ENUM)
+#undef BLUEMARBLE_GPU_PASS_ENUM
+    Count
+};
+
+const char* GetGPUPassName(EGPUPass InPass);
+
+// Mede quanto tempo a GPU leva para executar os comandos entre Begin e End com queries GL_TIME_ELAPSED.
+// O resultado so fica pronto alguns frames depois, entao as queries ficam em um anel e sao lidas sem
+// esperar pela GPU. Queries GL_TIME_ELAPSED nao podem ser aninhadas: so um timer mede por vez
+class FGPUTimer
+{
+public:
+
+    void Initialize(std::string_view InLabel);
+    void Shutdown();
+
+    // Com todas as queries ainda na GPU o frame nao e medido
+    void Begin();
+    void End();
+
+    // Le as medicoes que ja terminaram e retorna quantas chegaram
+    std::uint32_t Poll();
+
+    // Tempo da ultima medicao lida, em milissegundos
+    double GetLastTime() const { return LastTime; }
+
+private:
+
+    static constexpr std::uint32_t NumQueries = 4;
+
+    std::array<GLuint, NumQueries> Queries{};
+
+    // As medicoes pendentes sao as NumPendingQueries queries antes de NextQuery
+    std::uint32_t NextQuery = 0;
+    std::uint32_t NumPendingQueries = 0;
+    bool bMeasuring = false;
+
+    double LastTime = 0.0;
+};
@@ -0,0 +1,172 @@
+#include "InputRecording.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <type_traits>
+
+static_assert(std::is_trivially_copyable_v<FInputEvent> && sizeof(FInputEvent) == 32);
+static_assert(std::is_trivially_copyable_v<FInputFrameHeader>);
+static_assert(std::is_trivially_copyable_v<FInputLogHeader>);
+
+FCameraState FCameraState::FromCamera(const FSimpleCamera& InCamera)
+{
+    return FCameraState{
+        .Location = InCamera.Location,
+        .Direction = InCamera.Direction,
+        .Up = InCamera.Up,
+        .ForwardScale = InCamera.ForwardScale,
+        .RightScale = InCamera.RightScale,
+        .bIsOrtho = InCamera.bIsOrtho ? 1u : 0u,
+    };
+}
+
+void FCameraState::ApplyTo(FSimpleCamera& OutCamera) const
+{
+    OutCamera.Location = Location;
+    OutCamera.Direction = Direction;
+    OutCamera.Up = Up;
+    OutCamera.ForwardScale = ForwardScale;
+    OutCamera.RightScale = RightScale;
+    OutCamera.bIsOrtho = bIsOrtho != 0;
+}
+
+float FCameraState::GetMaxDifference(const FCameraState& InOther) const
+{
+    float MaxDifference = 0.0f;
+    for (std::int32_t Axis = 0; Axis < 3; ++Axis)
+    {
+        MaxDifference = std::max({ MaxDifference,
+                                   std::abs(Location[Axis] - InOther.Location[Axis]),
+                                   std::abs(Direction[Axis] - InOther.Direction[Axis]),
+                                   std::abs(Up[Axis] - InOther.Up[Axis]) });
+    }
+
+    MaxDifference = std::max({ MaxDifference, std::abs(ForwardScale - InOther.ForwardScale), std::abs(RightScale - InOther.RightScale) });
+    return bIsOrtho == InOther.bIsOrtho ? MaxDifference : std::numeric_limits<float>::infinity();
+}
+
+bool FInputRecorder::Open(const std::filesystem::path& InFilePath, std::uint32_t InRandomSeed, bool bInStartPaused, double InTimeStep)
+{
+    Close();
+
+    if (InFilePath.has_parent_path())
+    {
+        std::error_code Error;
+        std::filesystem::create_directories(InFilePath.parent_path(), Error);
+    }
+
+    File.open(InFilePath, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!File)
+    {
+        std::cout << "Nao foi possivel criar a gravacao de entrada " << InFilePath << std::endl;
+        return false;
+    }
+
+    FilePath = InFilePath;
+    TimeStep = InTimeStep;
+    NumFrames = 0;
+
+    const FInputLogHeader Header = {
+        .Magic = FInputLogHeader::LogMagic,
+        .FormatVersion = FInputLogHeader::LogFormatVersion,
+        .RandomSeed = InRandomSeed,
+        .bStartPaused = bInStartPaused ? 1u : 0u,
+        .TimeStep = InTimeStep,
+    };
+    File.write(reinterpret_cast<const char*>(&Header), sizeof(Header));
+
+    std::cout << "Gravando a entrada em " << FilePath << " (semente " << InRandomSeed << ", passo " << InTimeStep << " s)" << std::endl;
+    return static_cast<bool>(File);
+}
+
+void FInputRecorder::Close()
+{
+    if (File.is_open())
+    {
+        File.close();
+        std::cout << "Gravacao de entrada terminada: " << NumFrames << " frames em " << FilePath << std::endl;
+    }
+}
+
+void FInputRecorder::BeginFrame(const FSimpleCamera& InCamera)
+{
+    CurrentFrame.Camera = FCameraState::FromCamera(InCamera);
+    CurrentFrame.Events.clear();
+}
+
+void FInputRecorder::AddEvent(const FInputEvent& InEvent)
+{
+    CurrentFrame.Events.push_back(InEvent);
+}
+
+void FInputRecorder::EndFrame()
+{
+    if (!File.is_open())
+    {
+        return;
+    }
+
+    const FInputFrameHeader FrameHeader = { .Camera = CurrentFrame.Camera, .NumEvents = static_cast<std::uint32_t>(CurrentFrame.Events.size()) };
+    File.write(reinterpret_cast<const char*>(&FrameHeader), sizeof(FrameHeader));
+    File.write(reinterpret_cast<const char*>(CurrentFrame.Events.data()), static_cast<std::streamsize>(CurrentFrame.Events.size() * sizeof(FInputEvent)));
+    NumFrames++;
+}
+
+bool FInputReplay::Open(const std::filesystem::path& InFilePath)
+{
+    Close();
+
+    File.open(InFilePath, std::ios::in | std::ios::binary);
+    if (!File)
+    {
+        std::cout << "Nao foi possivel abrir a gravacao de entrada " << InFilePath << std::endl;
+        return false;
+    }
+
+    File.read(reinterpret_cast<char*>(&Header), sizeof(Header));
+    if (!File || Header.Magic != FInputLogHeader::LogMagic || Header.FormatVersion != FInputLogHeader::LogFormatVersion || Header.TimeStep <= 0.0)
+    {
+        std::cout << "Gravacao de entrada invalida: " << InFilePath << std::endl;
+        File.close();
+        return false;
+    }
+
+    NumFrames = 0;
+    std::cout << "Reproduzindo a entrada de " << InFilePath << " (semente " << Header.RandomSeed << ", passo " << Header.TimeStep << " s)" << std::endl;
+    return true;
+}
+
+void FInputReplay::Close()
+{
+    if (File.is_open())
+    {
+        File.close();
+    }
+}
+
+bool FInputReplay::ReadFrame(FInputFrame& OutFrame)
+{
+    if (!File.is_open())
+    {
+        return false;
+    }
+
+    FInputFrameHeader FrameHeader;
+    if (!File.read(reinterpret_cast<char*>(&FrameHeader), sizeof(FrameHeader)))
+    {
+        return false;
+    }
+
+    OutFrame.Camera = FrameHeader.Camera;
+    OutFrame.Events.resize(FrameHeader.NumEvents);
+    if (!File.read(reinterpret_cast<char*>(OutFrame.Events.data()), static_cast<std::streamsize>(FrameHeader.NumEvents * sizeof(FInputEvent))))
+    {
+        std::cout << "Gravacao de entrada truncada no frame " << NumFrames << std::endl;
+        return false;
+    }
+
+    NumFrames++;
+    return true;
+}
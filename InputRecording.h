@@ -0,0 +1,127 @@
+#pragma once
+
+#include "Camera.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+enum class EInputEventType : std::uint8_t
+{
+    Key,
+    MouseButton,
+    CursorPos,
+};
+
+// Um evento da glfw que chegou aos callbacks depois do filtro do ImGui
+struct FInputEvent
+{
+    EInputEventType Type = EInputEventType::Key;
+    std::uint8_t Padding[3] = {};
+
+    // Tecla ou botao do mouse e a acao (GLFW_PRESS, GLFW_RELEASE...)
+    std::int32_t Code = 0;
+    std::int32_t Action = 0;
+    std::int32_t Padding2 = 0;
+
+    // Posicao do cursor
+    double X = 0.0;
+    double Y = 0.0;
+};
+
+// Estado da camera no inicio de um frame, antes dos eventos daquele frame
+struct FCameraState
+{
+    glm::vec3 Location{ 0.0f };
+    glm::vec3 Direction{ 0.0f };
+    glm::vec3 Up{ 0.0f };
+    float ForwardScale = 0.0f;
+    float RightScale = 0.0f;
+    std::uint32_t bIsOrtho = 0;
+
+    static FCameraState FromCamera(const FSimpleCamera& InCamera);
+    void ApplyTo(FSimpleCamera& OutCamera) const;
+
+    // Diferenca maxima entre os componentes, a camera e gravada a cada frame para detectar divergencias
+    float GetMaxDifference(const FCameraState& InOther) const;
+};
+
+// Layout do arquivo: cabecalho e, para cada frame, FInputFrameHeader seguido dos NumEvents eventos
+struct FInputLogHeader
+{
+    static constexpr std::uint32_t LogMagic = 0x52494D42; // "BMIR"
+    static constexpr std::uint32_t LogFormatVersion = 1;
+
+    std::uint32_t Magic;
+    std::uint32_t FormatVersion;
+
+    // Semente das instancias geradas aleatoriamente
+    std::uint32_t RandomSeed;
+    std::uint32_t bStartPaused;
+
+    // Passo fixo da simulacao usado na gravacao e no replay
+    double TimeStep;
+};
+
+struct FInputFrameHeader
+{
+    FCameraState Camera;
+    std::uint32_t NumEvents;
+};
+
+struct FInputFrame
+{
+    FCameraState Camera;
+    std::vector<FInputEvent> Events;
+};
+
+// Grava a camera e os eventos de entrada de cada frame. So a thread principal usa
+class FInputRecorder
+{
+public:
+
+    bool Open(const std::filesystem::path& InFilePath, std::uint32_t InRandomSeed, bool bInStartPaused, double InTimeStep);
+    void Close();
+
+    bool IsRecording() const { return File.is_open(); }
+    double GetTimeStep() const { return TimeStep; }
+    std::uint32_t GetNumFrames() const { return NumFrames; }
+
+    // Chamado antes do glfwPollEvents, os eventos recebidos ate o EndFrame pertencem a este frame
+    void BeginFrame(const FSimpleCamera& InCamera);
+    void AddEvent(const FInputEvent& InEvent);
+    void EndFrame();
+
+private:
+
+    std::ofstream File;
+    std::filesystem::path FilePath;
+    double TimeStep = 0.0;
+    std::uint32_t NumFrames = 0;
+    FInputFrame CurrentFrame;
+};
+
+// Le um arquivo gravado pelo FInputRecorder, um frame por vez
+class FInputReplay
+{
+public:
+
+    bool Open(const std::filesystem::path& InFilePath);
+    void Close();
+
+    bool IsReplaying() const { return File.is_open(); }
+    const FInputLogHeader& GetHeader() const { return Header; }
+    std::uint32_t GetNumFrames() const { return NumFrames; }
+
+    // Retorna false no fim do arquivo
+    bool ReadFrame(FInputFrame& OutFrame);
+
+private:
+
+    std::ifstream File;
+    FInputLogHeader Header{};
+    std::uint32_t NumFrames = 0;
+};
@@ -0,0 +1,451 @@
+#include "Json.h"
+
+#include <algorithm>
+#include <charconv>
+
+// Descida recursiva sobre o texto, com a profundidade limitada para que um documento malicioso
+// nao estoure a pilha
+class FJsonParser
+{
+public:
+
+    explicit FJsonParser(std::string_view InText)
+        : Text{ InText }
+    {
+    }
+
+    bool ParseDocument(FJsonValue& OutValue, std::string& OutError)
+    {
+        SkipWhitespace();
+        if (!ParseValue(OutValue, 0))
+        {
+            OutError = "Erro na posicao " + std::to_string(Position) + ": " + Error;
+            return false;
+        }
+
+        SkipWhitespace();
+        if (Position != Text.size())
+        {
+            OutError = "Erro na posicao " + std::to_string(Position) + ": texto depois do fim do documento";
+            return false;
+        }
+        return true;
+    }
+
+private:
+
+    static constexpr std::uint32_t MaxDepth = 64;
+
+    bool Fail(const char* InError)
+    {
+        Error = InError;
+        return false;
+    }
+
+    void SkipWhitespace()
+    {
+        while (Position < Text.size() && (Text[Position] == ' ' || Text[Position] == '\t' || Text[Position] == '\n' || Text[Position] == '\r'))
+        {
+            Position++;
+        }
+    }
+
+    bool Consume(std::string_view InToken)
+    {
+        if (Text.substr(Position, InToken.size()) != InToken)
+        {
+            return false;
+        }
+        Position += InToken.size();
+        return true;
+    }
+
+    bool ParseValue(FJsonValue& OutValue, std::uint32_t InDepth)
+    {
+        if (InDepth > MaxDepth)
+        {
+            return Fail("documento aninhado demais");
+        }
+
+        if (Position >= Text.size())
+        {
+            return Fail("fim inesperado do documento");
+        }
+
+        switch (Text[Position])
+        {
+            case '{':
+                return ParseObject(OutValue, InDepth);
+
+            case '[':
+                return ParseArray(OutValue, InDepth);
+
+            case '"':
+                OutValue.Type = EJsonType::String;
+                return ParseString(OutValue.String);
+
+            case 't':
+            case 'f':
+                OutValue.Type = EJsonType::Bool;
+                OutValue.bBool = Text[Position] == 't';
+                return Consume(OutValue.bBool ? "true" : "false") || Fail("valor invalido");
+
+            case 'n':
+                OutValue.Type = EJsonType::Null;
+                return Consume("null") || Fail("valor invalido");
+
+            default:
+                return ParseNumber(OutValue);
+        }
+    }
+
+    bool ParseNumber(FJsonValue& OutValue)
+    {
+        // O from_chars aceita inf e nan, que nao existem no JSON
+        const char First = Text[Position];
+        if (First != '-' && (First < '0' || First > '9'))
+        {
+            return Fail("valor invalido");
+        }
+
+        // Diferente do strtod, o from_chars nao depende do locale
+        const char* Begin = Text.data() + Position;
+        const std::from_chars_result Result = std::from_chars(Begin, Text.data() + Text.size(), OutValue.Number);
+        if (Result.ec != std::errc{} || Result.ptr == Begin)
+        {
+            return Fail("valor invalido");
+        }
+
+        OutValue.Type = EJsonType::Number;
+        Position += static_cast<std::size_t>(Result.ptr - Begin);
+        return true;
+    }
+
+    static void AppendUtf8(std::string& OutString, std::uint32_t InCodepoint)
+    {
+        if (InCodepoint < 0x80)
+        {
+            OutString += static_cast<char>(InCodepoint);
+        }
+        else if (InCodepoint < 0x800)
+        {
+            OutString += static_cast<char>(0xC0 | (InCodepoint >> 6));
+            OutString += static_cast<char>(0x80 | (InCodepoint & 0x3F));
+        }
+        else if (InCodepoint < 0x10000)
+        {
+            OutString += static_cast<char>(0xE0 | (InCodepoint >> 12));
+            OutString += static_cast<char>(0x80 | ((InCodepoint >> 6) & 0x3F));
+            OutString += static_cast<char>(0x80 | (InCodepoint & 0x3F));
+        }
+        else
+        {
+            OutString += static_cast<char>(0xF0 | (InCodepoint >> 18));
+            OutString += static_cast<char>(0x80 | ((InCodepoint >> 12) & 0x3F));
+            OutString += static_cast<char>(0x80 | ((InCodepoint >> 6) & 0x3F));
+            OutString += static_cast<char>(0x80 | (InCodepoint & 0x3F));
+        }
+    }
+
+    bool ParseHex4(std::uint32_t& OutValue)
+    {
+        if (Position + 4 > Text.size())
+        {
+            return Fail("escape \\u incompleto");
+        }
+
+        const char* Begin = Text.data() + Position;
+        const std::from_chars_result Result = std::from_chars(Begin, Begin + 4, OutValue, 16);
+        if (Result.ec != std::errc{} || Result.ptr != Begin + 4)
+        {
+            return Fail("escape \\u invalido");
+        }
+        Position += 4;
+        return true;
+    }
+
+    bool ParseString(std::string& OutString)
+    {
+        // Pula a aspa de abertura
+        Position++;
+        OutString.clear();
+
+        while (Position < Text.size())
+        {
+            const char Character = Text[Position++];
+            if (Character == '"')
+            {
+                return true;
+            }
+
+            if (static_cast<unsigned char>(Character) < 0x20)
+            {
+                return Fail("caractere de controle dentro de uma string");
+            }
+
+            if (Character != '\\')
+            {
+                OutString += Character;
+                continue;
+            }
+
+            if (Position >= Text.size())
+            {
+                break;
+            }
+
+            const char Escape = Text[Position++];
+            switch (Escape)
+            {
+                case '"': OutString += '"'; break;
+                case '\\': OutString += '\\'; break;
+                case '/': OutString += '/'; break;
+                case 'b': OutString += '\b'; break;
+                case 'f': OutString += '\f'; break;
+                case 'n': OutString += '\n'; break;
+                case 'r': OutString += '\r'; break;
+                case 't': OutString += '\t'; break;
+
+                case 'u':
+                {
+                    std::uint32_t Codepoint = 0;
+                    if (!ParseHex4(Codepoint))
+                    {
+                        return false;
+                    }
+
+                    // Caracteres fora do plano basico chegam como um par de surrogates
+                    if (Codepoint >= 0xD800 && Codepoint <= 0xDBFF)
+                    {
+                        std::uint32_t LowSurrogate = 0;
+                        if (!Consume("\\u") || !ParseHex4(LowSurrogate) || LowSurrogate < 0xDC00 || LowSurrogate > 0xDFFF)
+                        {
+                            return Fail("par de surrogates invalido");
+                        }
+                        Codepoint = 0x10000 + ((Codepoint - 0xD800) << 10) + (LowSurrogate - 0xDC00);
+                    }
+
+                    AppendUtf8(OutString, Codepoint);
+                    break;
+                }
+
+                default:
+                    return Fail("escape invalido");
+            }
+        }
+
+        return Fail("string sem aspa de fechamento");
+    }
+
+    bool ParseArray(FJsonValue& OutValue, std::uint32_t InDepth)
+    {
+        // Pula o '['
+        Position++;
+        OutValue.Type = EJsonType::Array;
+
+        SkipWhitespace();
+        if (Consume("]"))
+        {
+            return true;
+        }
+
+        while (true)
+        {
+            SkipWhitespace();
+            if (!ParseValue(OutValue.Elements.emplace_back(), InDepth + 1))
+            {
+                return false;
+            }
+
+            SkipWhitespace();
+            if (Consume("]"))
+            {
+                return true;
+            }
+            if (!Consume(","))
+            {
+                return Fail("esperado ',' ou ']'");
+            }
+        }
+    }
+
+    bool ParseObject(FJsonValue& OutValue, std::uint32_t InDepth)
+    {
+        // Pula o '{'
+        Position++;
+        OutValue.Type = EJsonType::Object;
+
+        SkipWhitespace();
+        if (Consume("}"))
+        {
+            return true;
+        }
+
+        while (true)
+        {
+            SkipWhitespace();
+            if (Position >= Text.size() || Text[Position] != '"')
+            {
+                return Fail("esperado o nome de um membro");
+            }
+            if (!ParseString(OutValue.Keys.emplace_back()))
+            {
+                return false;
+            }
+
+            SkipWhitespace();
+            if (!Consume(":"))
+            {
+                return Fail("esperado ':'");
+            }
+
+            SkipWhitespace();
+            if (!ParseValue(OutValue.Elements.emplace_back(), InDepth + 1))
+            {
+                return false;
+            }
+
+            SkipWhitespace();
+            if (Consume("}"))
+            {
+                return true;
+            }
+            if (!Consume(","))
+            {
+                return Fail("esperado ',' ou '}'");
+            }
+        }
+    }
+
+    std::string_view Text;
+    std::size_t Position = 0;
+    const char* Error = "";
+};
+
+bool FJsonValue::Parse(std::string_view InText, FJsonValue& OutValue, std::string& OutError)
+{
+    OutValue = FJsonValue{};
+    return FJsonParser{ InText }.ParseDocument(OutValue, OutError);
+}
+
+const FJsonValue* FJsonValue::Find(std::string_view InKey) const
+{
+    if (Type != EJsonType::Object)
+    {
+        return nullptr;
+    }
+
+    for (std::size_t MemberIndex = 0; MemberIndex < Keys.size(); ++MemberIndex)
+    {
+        if (Keys[MemberIndex] == InKey)
+        {
+            return &Elements[MemberIndex];
+        }
+    }
+    return nullptr;
+}
+
+const FJsonValue* FJsonObjectReader::FindTyped(std::string_view InKey, EJsonType InType, const char* InTypeName)
+{
+    const FJsonValue* Value = Object.Find(InKey);
+    if (Value == nullptr || Value->GetType() == InType)
+    {
+        return Value;
+    }
+
+    if (Error.empty())
+    {
+        Error = "\"" + std::string{ InKey } + "\" deve ser " + InTypeName;
+    }
+    return nullptr;
+}
+
+bool FJsonObjectReader::Read(std::string_view InKey, bool& InOutValue)
+{
+    const FJsonValue* Value = FindTyped(InKey, EJsonType::Bool, "um booleano");
+    if (Value != nullptr)
+    {
+        InOutValue = Value->GetBool();
+    }
+    return Value != nullptr;
+}
+
+bool FJsonObjectReader::Read(std::string_view InKey, float& InOutValue)
+{
+    const FJsonValue* Value = FindTyped(InKey, EJsonType::Number, "um numero");
+    if (Value != nullptr)
+    {
+        InOutValue = static_cast<float>(Value->GetNumber());
+    }
+    return Value != nullptr;
+}
+
+bool FJsonObjectReader::Read(std::string_view InKey, double& InOutValue)
+{
+    const FJsonValue* Value = FindTyped(InKey, EJsonType::Number, "um numero");
+    if (Value != nullptr)
+    {
+        InOutValue = Value->GetNumber();
+    }
+    return Value != nullptr;
+}
+
+bool FJsonObjectReader::Read(std::string_view InKey, std::int32_t& InOutValue)
+{
+    const FJsonValue* Value = FindTyped(InKey, EJsonType::Number, "um inteiro");
+    if (Value != nullptr)
+    {
+        InOutValue = static_cast<std::int32_t>(std::clamp(Value->GetNumber(), -2147483648.0, 2147483647.0));
+    }
+    return Value != nullptr;
+}
+
+bool FJsonObjectReader::Read(std::string_view InKey, std::uint32_t& InOutValue)
+{
+    const FJsonValue* Value = FindTyped(InKey, EJsonType::Number, "um inteiro");
+    if (Value != nullptr)
+    {
+        InOutValue = static_cast<std::uint32_t>(std::clamp(Value->GetNumber(), 0.0, 4294967295.0));
+    }
+    return Value != nullptr;
+}
+
+bool FJsonObjectReader::Read(std::string_view InKey, std::string& InOutValue)
+{
+    const FJsonValue* Value = FindTyped(InKey, EJsonType::String, "uma string");
+    if (Value != nullptr)
+    {
+        InOutValue = Value->GetString();
+    }
+    return Value != nullptr;
+}
+
+bool FJsonObjectReader::ReadFloats(std::string_view InKey, float* InOutValues, std::size_t InNumValues)
+{
+    const char* TypeName = "um array de numeros";
+    const FJsonValue* Value = FindTyped(InKey, EJsonType::Array, TypeName);
+    if (Value == nullptr)
+    {
+        return false;
+    }
+
+    const std::vector<FJsonValue>& Elements = Value->GetElements();
+    const bool bValid = Elements.size() == InNumValues && std::all_of(Elements.begin(), Elements.end(), [](const FJsonValue& Element)
+    {
+        return Element.IsNumber();
+    });
+    if (!bValid)
+    {
+        if (Error.empty())
+        {
+            Error = "\"" + std::string{ InKey } + "\" deve ter " + std::to_string(InNumValues) + " numeros";
+        }
+        return false;
+    }
+
+    for (std::size_t ValueIndex = 0; ValueIndex < InNumValues; ++ValueIndex)
+    {
+        InOutValues[ValueIndex] = static_cast<float>(Elements[ValueIndex].GetNumber());
+    }
+    return true;
+}
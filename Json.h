@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class EJsonType : std::uint8_t
+{
+    Null,
+    Bool,
+    Number,
+    String,
+    Array,
+    Object
+};
+
+// Valor de um documento JSON lido por completo na memoria. Usado nos protocolos e arquivos pequenos
+// do programa, sem preocupacao com documentos grandes. Os membros dos objetos mantem a ordem do texto
+class FJsonValue
+{
+public:
+
+    // Le um documento inteiro. Em caso de erro OutError recebe a posicao e o motivo
+    static bool Parse(std::string_view InText, FJsonValue& OutValue, std::string& OutError);
+
+    EJsonType GetType() const { return Type; }
+    bool IsNull() const { return Type == EJsonType::Null; }
+    bool IsBool() const { return Type == EJsonType::Bool; }
+    bool IsNumber() const { return Type == EJsonType::Number; }
+    bool IsString() const { return Type == EJsonType::String; }
+    bool IsArray() const { return Type == EJsonType::Array; }
+    bool IsObject() const { return Type == EJsonType::Object; }
+
+    bool GetBool() const { return bBool; }
+    double GetNumber() const { return Number; }
+    const std::string& GetString() const { return String; }
+
+    // Elementos de um array ou valores de um objeto
+    const std::vector<FJsonValue>& GetElements() const { return Elements; }
+
+    // Chaves de um objeto, na mesma ordem de GetElements
+    const std::vector<std::string>& GetKeys() const { return Keys; }
+
+    // Membro de um objeto, nullptr se nao existir ou se o valor nao for um objeto
+    const FJsonValue* Find(std::string_view InKey) const;
+
+private:
+
+    friend class FJsonParser;
+
+    EJsonType Type = EJsonType::Null;
+    bool bBool = false;
+    double Number = 0.0;
+    std::string String;
+    std::vector<FJsonValue> Elements;
+    std::vector<std::string> Keys;
+};
+
+// Le membros opcionais de um objeto para variaveis que ja tem o valor padrao. Um membro ausente nao muda
+// a variavel; um membro com o tipo errado tambem nao, e fica registrado no erro
+class FJsonObjectReader
+{
+public:
+
+    explicit FJsonObjectReader(const FJsonValue& InObject)
+        : Object{ InObject }
+    {
+    }
+
+    bool Read(std::string_view InKey, bool& InOutValue);
+    bool Read(std::string_view InKey, float& InOutValue);
+    bool Read(std::string_view InKey, double& InOutValue);
+    bool Read(std::string_view InKey, std::int32_t& InOutValue);
+    bool Read(std::string_view InKey, std::uint32_t& InOutValue);
+    bool Read(std::string_view InKey, std::string& InOutValue);
+
+    // Array com exatamente InNumValues numeros, usado para vetores
+    bool ReadFloats(std::string_view InKey, float* InOutValues, std::size_t InNumValues);
+
+    bool Has(std::string_view InKey) const { return Object.Find(InKey) != nullptr; }
+
+    bool HasError() const { return !Error.empty(); }
+    const std::string& GetError() const { return Error; }
+
+private:
+
+    // Membro do tipo pedido ou nullptr. Registra o erro se o membro existe com outro tipo
+    const FJsonValue* FindTyped(std::string_view InKey, EJsonType InType, const char* InTypeName);
+
+    const FJsonValue& Object;
+    std::string Error;
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+// Socket TCP que so aceita conexoes da propria maquina (127.0.0.1), usado pelos servidores locais que
+// rodam em threads proprias. Nenhuma chamada espera mais que o timeout pedido, entao a thread do servidor
+// consegue verificar periodicamente se deve parar
+class FLocalSocket
+{
+public:
+
+    FLocalSocket();
+    ~FLocalSocket();
+
+    FLocalSocket(FLocalSocket&& InOther) noexcept;
+    FLocalSocket& operator=(FLocalSocket&& InOther) noexcept;
+
+    FLocalSocket(const FLocalSocket&) = delete;
+    FLocalSocket& operator=(const FLocalSocket&) = delete;
+
+    // Escuta em 127.0.0.1:InPort
+    bool Listen(std::uint16_t InPort);
+
+    // Espera uma conexao pendente (socket de escuta) ou dados para ler. Retorna false no timeout
+    bool WaitReadable(std::chrono::milliseconds InTimeout);
+
+    // Aceita uma conexao pendente. Em caso de erro o socket retornado esta fechado
+    FLocalSocket Accept();
+
+    // Le no maximo InSize bytes do que ja chegou. Retorna zero quando a outra ponta fechou a conexao e um
+    // valor negativo em caso de erro
+    std::int64_t Receive(void* OutData, std::size_t InSize);
+
+    // Envia todos os bytes. Retorna false se a conexao caiu ou se a outra ponta parou de ler e nem tudo coube
+    // no buffer do sistema dentro de InTimeout; nesse caso a conexao deve ser fechada
+    bool SendAll(std::string_view InData, std::chrono::milliseconds InTimeout);
+
+    void Close();
+
+    bool IsOpen() const;
+
+private:
+
+    // Implementado por cada plataforma
+    struct FBackend;
+
+    std::unique_ptr<FBackend> Backend;
+};
@@ -0,0 +1,171 @@
+#include "LocalSocket.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+struct FLocalSocket::FBackend
+{
+    int Fd = -1;
+};
+
+FLocalSocket::FLocalSocket()
+    : Backend{ std::make_unique<FBackend>() }
+{
+}
+
+FLocalSocket::~FLocalSocket()
+{
+    Close();
+}
+
+FLocalSocket::FLocalSocket(FLocalSocket&& InOther) noexcept = default;
+
+FLocalSocket& FLocalSocket::operator=(FLocalSocket&& InOther) noexcept
+{
+    if (this != &InOther)
+    {
+        Close();
+        Backend = std::move(InOther.Backend);
+    }
+    return *this;
+}
+
+bool FLocalSocket::Listen(std::uint16_t InPort)
+{
+    Close();
+
+    const int Fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (Fd < 0)
+    {
+        std::cout << "Erro ao criar o socket: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Permite abrir a mesma porta logo depois de fechar o programa, sem esperar o TIME_WAIT das conexoes antigas
+    const int bReuseAddress = 1;
+    setsockopt(Fd, SOL_SOCKET, SO_REUSEADDR, &bReuseAddress, sizeof(bReuseAddress));
+
+    sockaddr_in Address{};
+    Address.sin_family = AF_INET;
+    Address.sin_port = htons(InPort);
+    Address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (bind(Fd, reinterpret_cast<const sockaddr*>(&Address), sizeof(Address)) != 0 || listen(Fd, 8) != 0)
+    {
+        std::cout << "Erro ao escutar na porta " << InPort << ": " << std::strerror(errno) << std::endl;
+        close(Fd);
+        return false;
+    }
+
+    if (!Backend)
+    {
+        Backend = std::make_unique<FBackend>();
+    }
+    Backend->Fd = Fd;
+    return true;
+}
+
+bool FLocalSocket::WaitReadable(std::chrono::milliseconds InTimeout)
+{
+    if (!IsOpen())
+    {
+        return false;
+    }
+
+    pollfd PollFd{ .fd = Backend->Fd, .events = POLLIN, .revents = 0 };
+    return poll(&PollFd, 1, static_cast<int>(InTimeout.count())) > 0;
+}
+
+FLocalSocket FLocalSocket::Accept()
+{
+    FLocalSocket Connection;
+    if (!IsOpen())
+    {
+        return Connection;
+    }
+
+    const int Fd = accept4(Backend->Fd, nullptr, nullptr, SOCK_CLOEXEC);
+    if (Fd < 0)
+    {
+        std::cout << "Erro ao aceitar a conexao: " << std::strerror(errno) << std::endl;
+        return Connection;
+    }
+
+    Connection.Backend->Fd = Fd;
+    return Connection;
+}
+
+std::int64_t FLocalSocket::Receive(void* OutData, std::size_t InSize)
+{
+    if (!IsOpen())
+    {
+        return -1;
+    }
+
+    ssize_t NumReceived = 0;
+    do
+    {
+        NumReceived = recv(Backend->Fd, OutData, InSize, 0);
+    } while (NumReceived < 0 && errno == EINTR);
+
+    return NumReceived;
+}
+
+bool FLocalSocket::SendAll(std::string_view InData, std::chrono::milliseconds InTimeout)
+{
+    if (!IsOpen())
+    {
+        return false;
+    }
+
+    const std::chrono::steady_clock::time_point Deadline = std::chrono::steady_clock::now() + InTimeout;
+    while (!InData.empty())
+    {
+        // Sem o MSG_NOSIGNAL um cliente que desconectou no meio da resposta mataria o processo com SIGPIPE. O
+        // MSG_DONTWAIT envia so o que cabe no buffer, o resto espera o POLLOUT ate o prazo
+        const ssize_t NumSent = send(Backend->Fd, InData.data(), InData.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (NumSent >= 0)
+        {
+            InData.remove_prefix(static_cast<std::size_t>(NumSent));
+            continue;
+        }
+
+        if (errno == EINTR)
+        {
+            continue;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK)
+        {
+            return false;
+        }
+
+        const auto RemainingTime = std::chrono::ceil<std::chrono::milliseconds>(Deadline - std::chrono::steady_clock::now());
+        pollfd PollFd{ .fd = Backend->Fd, .events = POLLOUT, .revents = 0 };
+        if (RemainingTime.count() <= 0 || poll(&PollFd, 1, static_cast<int>(RemainingTime.count())) == 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void FLocalSocket::Close()
+{
+    if (IsOpen())
+    {
+        close(Backend->Fd);
+        Backend->Fd = -1;
+    }
+}
+
+bool FLocalSocket::IsOpen() const
+{
+    return Backend && Backend->Fd >= 0;
+}
@@ -0,0 +1,176 @@
+#include "LocalSocket.h"
+
+#define NOMINMAX
+#include <WinSock2.h>
+#include <WS2tcpip.h>
+
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+    // O Winsock precisa ser inicializado uma vez por processo antes do primeiro socket
+    bool InitializeWinsock()
+    {
+        static const bool bInitialized = []
+        {
+            WSADATA WinsockData{};
+            const int Error = WSAStartup(MAKEWORD(2, 2), &WinsockData);
+            if (Error != 0)
+            {
+                std::cout << "Erro ao inicializar o Winsock: " << Error << std::endl;
+            }
+            return Error == 0;
+        }();
+        return bInitialized;
+    }
+}
+
+struct FLocalSocket::FBackend
+{
+    SOCKET Socket = INVALID_SOCKET;
+};
+
+FLocalSocket::FLocalSocket()
+    : Backend{ std::make_unique<FBackend>() }
+{
+}
+
+FLocalSocket::~FLocalSocket()
+{
+    Close();
+}
+
+FLocalSocket::FLocalSocket(FLocalSocket&& InOther) noexcept = default;
+
+FLocalSocket& FLocalSocket::operator=(FLocalSocket&& InOther) noexcept
+{
+    if (this != &InOther)
+    {
+        Close();
+        Backend = std::move(InOther.Backend);
+    }
+    return *this;
+}
+
+bool FLocalSocket::Listen(std::uint16_t InPort)
+{
+    Close();
+
+    if (!InitializeWinsock())
+    {
+        return false;
+    }
+
+    const SOCKET Socket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (Socket == INVALID_SOCKET)
+    {
+        std::cout << "Erro ao criar o socket: " << WSAGetLastError() << std::endl;
+        return false;
+    }
+
+    // No Windows o SO_REUSEADDR deixaria outro processo roubar a porta, o uso exclusivo evita isso
+    const BOOL bExclusiveAddress = TRUE;
+    setsockopt(Socket, SOL_SOCKET, SO_EXCLUSIVEADDRUSE, reinterpret_cast<const char*>(&bExclusiveAddress), sizeof(bExclusiveAddress));
+
+    sockaddr_in Address{};
+    Address.sin_family = AF_INET;
+    Address.sin_port = htons(InPort);
+    Address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (bind(Socket, reinterpret_cast<const sockaddr*>(&Address), sizeof(Address)) != 0 || listen(Socket, 8) != 0)
+    {
+        std::cout << "Erro ao escutar na porta " << InPort << ": " << WSAGetLastError() << std::endl;
+        closesocket(Socket);
+        return false;
+    }
+
+    if (!Backend)
+    {
+        Backend = std::make_unique<FBackend>();
+    }
+    Backend->Socket = Socket;
+    return true;
+}
+
+bool FLocalSocket::WaitReadable(std::chrono::milliseconds InTimeout)
+{
+    if (!IsOpen())
+    {
+        return false;
+    }
+
+    WSAPOLLFD PollFd{};
+    PollFd.fd = Backend->Socket;
+    PollFd.events = POLLRDNORM;
+    return WSAPoll(&PollFd, 1, static_cast<INT>(InTimeout.count())) > 0;
+}
+
+FLocalSocket FLocalSocket::Accept()
+{
+    FLocalSocket Connection;
+    if (!IsOpen())
+    {
+        return Connection;
+    }
+
+    const SOCKET Socket = accept(Backend->Socket, nullptr, nullptr);
+    if (Socket == INVALID_SOCKET)
+    {
+        std::cout << "Erro ao aceitar a conexao: " << WSAGetLastError() << std::endl;
+        return Connection;
+    }
+
+    Connection.Backend->Socket = Socket;
+    return Connection;
+}
+
+std::int64_t FLocalSocket::Receive(void* OutData, std::size_t InSize)
+{
+    if (!IsOpen())
+    {
+        return -1;
+    }
+
+    const int MaxSize = static_cast<int>(std::min<std::size_t>(InSize, 1 << 30));
+    return recv(Backend->Socket, static_cast<char*>(OutData), MaxSize, 0);
+}
+
+bool FLocalSocket::SendAll(std::string_view InData, std::chrono::milliseconds InTimeout)
+{
+    if (!IsOpen())
+    {
+        return false;
+    }
+
+    // O Winsock nao tem MSG_DONTWAIT, o send bloqueante desiste sozinho depois do SO_SNDTIMEO. Depois de um
+    // timeout o estado do socket e indefinido, por isso o chamador fecha a conexao
+    const DWORD SendTimeout = static_cast<DWORD>(std::max<std::chrono::milliseconds::rep>(InTimeout.count(), 1));
+    setsockopt(Backend->Socket, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&SendTimeout), sizeof(SendTimeout));
+
+    while (!InData.empty())
+    {
+        const int Size = static_cast<int>(std::min<std::size_t>(InData.size(), 1 << 30));
+        const int NumSent = send(Backend->Socket, InData.data(), Size, 0);
+        if (NumSent == SOCKET_ERROR)
+        {
+            return false;
+        }
+        InData.remove_prefix(static_cast<std::size_t>(NumSent));
+    }
+    return true;
+}
+
+void FLocalSocket::Close()
+{
+    if (IsOpen())
+    {
+        closesocket(Backend->Socket);
+        Backend->Socket = INVALID_SOCKET;
+    }
+}
+
+bool FLocalSocket::IsOpen() const
+{
+    return Backend && Backend->Socket != INVALID_SOCKET;
+}
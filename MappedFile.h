@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+
+// Arquivo mapeado na memoria. Depois de aberto o conteudo e acessado sem nenhuma chamada de sistema
+class FMappedFile
+{
+public:
+
+    FMappedFile();
+    ~FMappedFile();
+
+    FMappedFile(const FMappedFile&) = delete;
+    FMappedFile& operator=(const FMappedFile&) = delete;
+
+    // Mapeia um arquivo existente somente para leitura
+    bool OpenForRead(const std::filesystem::path& InFilePath);
+
+    // Cria (ou substitui) o arquivo com exatamente InSize bytes e mapeia para escrita
+    bool CreateForWrite(const std::filesystem::path& InFilePath, std::size_t InSize);
+
+    void Close();
+
+    bool IsOpen() const { return bIsOpen; }
+    const std::uint8_t* GetData() const { return Data; }
+    std::uint8_t* GetMutableData() { return Data; }
+    std::size_t GetSize() const { return Size; }
+
+private:
+
+    // Implementado por cada plataforma
+    struct FBackend;
+
+    std::unique_ptr<FBackend> Backend;
+    std::uint8_t* Data = nullptr;
+    std::size_t Size = 0;
+    bool bIsOpen = false;
+};
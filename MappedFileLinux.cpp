@@ -0,0 +1,118 @@
+#include "MappedFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+struct FMappedFile::FBackend
+{
+    int Fd = -1;
+};
+
+FMappedFile::FMappedFile() = default;
+
+FMappedFile::~FMappedFile()
+{
+    Close();
+}
+
+bool FMappedFile::OpenForRead(const std::filesystem::path& InFilePath)
+{
+    Close();
+
+    const int Fd = open(InFilePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (Fd < 0)
+    {
+        return false;
+    }
+
+    struct stat FileStat{};
+    if (fstat(Fd, &FileStat) != 0)
+    {
+        std::cout << "Erro ao ler o tamanho de " << InFilePath << ": " << std::strerror(errno) << std::endl;
+        close(Fd);
+        return false;
+    }
+
+    // Um arquivo vazio nao pode ser mapeado mas continua sendo um arquivo valido
+    void* MappedData = nullptr;
+    if (FileStat.st_size > 0)
+    {
+        MappedData = mmap(nullptr, static_cast<std::size_t>(FileStat.st_size), PROT_READ, MAP_PRIVATE, Fd, 0);
+        if (MappedData == MAP_FAILED)
+        {
+            std::cout << "Erro ao mapear " << InFilePath << ": " << std::strerror(errno) << std::endl;
+            close(Fd);
+            return false;
+        }
+    }
+
+    Backend = std::make_unique<FBackend>();
+    Backend->Fd = Fd;
+    Data = static_cast<std::uint8_t*>(MappedData);
+    Size = static_cast<std::size_t>(FileStat.st_size);
+    bIsOpen = true;
+    return true;
+}
+
+bool FMappedFile::CreateForWrite(const std::filesystem::path& InFilePath, std::size_t InSize)
+{
+    Close();
+
+    const int Fd = open(InFilePath.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (Fd < 0)
+    {
+        std::cout << "Erro ao criar " << InFilePath << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    if (ftruncate(Fd, static_cast<off_t>(InSize)) != 0)
+    {
+        std::cout << "Erro ao alocar " << InSize << " bytes para " << InFilePath << ": " << std::strerror(errno) << std::endl;
+        close(Fd);
+        return false;
+    }
+
+    void* MappedData = nullptr;
+    if (InSize > 0)
+    {
+        MappedData = mmap(nullptr, InSize, PROT_READ | PROT_WRITE, MAP_SHARED, Fd, 0);
+        if (MappedData == MAP_FAILED)
+        {
+            std::cout << "Erro ao mapear " << InFilePath << ": " << std::strerror(errno) << std::endl;
+            close(Fd);
+            return false;
+        }
+    }
+
+    Backend = std::make_unique<FBackend>();
+    Backend->Fd = Fd;
+    Data = static_cast<std::uint8_t*>(MappedData);
+    Size = InSize;
+    bIsOpen = true;
+    return true;
+}
+
+void FMappedFile::Close()
+{
+    if (!bIsOpen)
+    {
+        return;
+    }
+
+    if (Data != nullptr)
+    {
+        munmap(Data, Size);
+    }
+
+    close(Backend->Fd);
+    Backend.reset();
+    Data = nullptr;
+    Size = 0;
+    bIsOpen = false;
+}
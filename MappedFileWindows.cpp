@@ -0,0 +1,128 @@
+#include "MappedFile.h"
+
+#include <Windows.h>
+
+#include <iostream>
+
+struct FMappedFile::FBackend
+{
+    HANDLE FileHandle = INVALID_HANDLE_VALUE;
+    HANDLE MappingHandle = nullptr;
+};
+
+FMappedFile::FMappedFile() = default;
+
+FMappedFile::~FMappedFile()
+{
+    Close();
+}
+
+bool FMappedFile::OpenForRead(const std::filesystem::path& InFilePath)
+{
+    Close();
+
+    const HANDLE FileHandle = CreateFileW(InFilePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (FileHandle == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER FileSize{};
+    if (!GetFileSizeEx(FileHandle, &FileSize))
+    {
+        std::cout << "Erro ao ler o tamanho de " << InFilePath << ": " << GetLastError() << std::endl;
+        CloseHandle(FileHandle);
+        return false;
+    }
+
+    // Um arquivo vazio nao pode ser mapeado mas continua sendo um arquivo valido
+    HANDLE MappingHandle = nullptr;
+    void* MappedData = nullptr;
+    if (FileSize.QuadPart > 0)
+    {
+        MappingHandle = CreateFileMappingW(FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        MappedData = MappingHandle ? MapViewOfFile(MappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (MappedData == nullptr)
+        {
+            std::cout << "Erro ao mapear " << InFilePath << ": " << GetLastError() << std::endl;
+            if (MappingHandle)
+            {
+                CloseHandle(MappingHandle);
+            }
+            CloseHandle(FileHandle);
+            return false;
+        }
+    }
+
+    Backend = std::make_unique<FBackend>();
+    Backend->FileHandle = FileHandle;
+    Backend->MappingHandle = MappingHandle;
+    Data = static_cast<std::uint8_t*>(MappedData);
+    Size = static_cast<std::size_t>(FileSize.QuadPart);
+    bIsOpen = true;
+    return true;
+}
+
+bool FMappedFile::CreateForWrite(const std::filesystem::path& InFilePath, std::size_t InSize)
+{
+    Close();
+
+    const HANDLE FileHandle = CreateFileW(InFilePath.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (FileHandle == INVALID_HANDLE_VALUE)
+    {
+        std::cout << "Erro ao criar " << InFilePath << ": " << GetLastError() << std::endl;
+        return false;
+    }
+
+    HANDLE MappingHandle = nullptr;
+    void* MappedData = nullptr;
+    if (InSize > 0)
+    {
+        // O mapeamento com tamanho maior que o arquivo aumenta o arquivo para InSize
+        const ULARGE_INTEGER MappingSize{ .QuadPart = InSize };
+        MappingHandle = CreateFileMappingW(FileHandle, nullptr, PAGE_READWRITE, MappingSize.HighPart, MappingSize.LowPart, nullptr);
+        MappedData = MappingHandle ? MapViewOfFile(MappingHandle, FILE_MAP_WRITE, 0, 0, InSize) : nullptr;
+        if (MappedData == nullptr)
+        {
+            std::cout << "Erro ao mapear " << InFilePath << ": " << GetLastError() << std::endl;
+            if (MappingHandle)
+            {
+                CloseHandle(MappingHandle);
+            }
+            CloseHandle(FileHandle);
+            return false;
+        }
+    }
+
+    Backend = std::make_unique<FBackend>();
+    Backend->FileHandle = FileHandle;
+    Backend->MappingHandle = MappingHandle;
+    Data = static_cast<std::uint8_t*>(MappedData);
+    Size = InSize;
+    bIsOpen = true;
+    return true;
+}
+
+void FMappedFile::Close()
+{
+    if (!bIsOpen)
+    {
+        return;
+    }
+
+    if (Data != nullptr)
+    {
+        UnmapViewOfFile(Data);
+    }
+
+    if (Backend->MappingHandle)
+    {
+        CloseHandle(Backend->MappingHandle);
+    }
+
+    CloseHandle(Backend->FileHandle);
+    Backend.reset();
+    Data = nullptr;
+    Size = 0;
+    bIsOpen = false;
+}
@@ -0,0 +1,199 @@
+#include "MemoryTracker.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+static constexpr std::array<const char*, static_cast<std::size_t>(EAllocationZone::Count)> ZoneNames =
+{
+#define BLUEMARBLE_ALLOCATION_ZONE_NAME(Name) #Name,
+    BLUEMARBLE_ALLOCATION_ZONES(BLUEMARBLE_ALLOCATION_ZONE_NAME)
+#undef BLUEMARBLE_ALLOCATION_ZONE_NAME
+};
+
+namespace
+{
+    struct FZoneCounters
+    {
+        std::atomic<std::uint32_t> NumAllocations{ 0 };
+        std::atomic<std::uint32_t> NumFrees{ 0 };
+        std::atomic<std::uint64_t> AllocatedBytes{ 0 };
+    };
+
+    // Inicializados em tempo de compilacao, o operator new pode ser chamado antes de qualquer construtor estatico
+    constinit std::array<FZoneCounters, static_cast<std::size_t>(EAllocationZone::Count)> ZoneCounters;
+    constinit thread_local EAllocationZone CurrentZone = EAllocationZone::Other;
+}
+
+FMemoryTracker& FMemoryTracker::Get()
+{
+    static FMemoryTracker MemoryTracker;
+    return MemoryTracker;
+}
+
+const char* FMemoryTracker::GetZoneName(EAllocationZone InZone)
+{
+    return ZoneNames[static_cast<std::size_t>(InZone)];
+}
+
+EAllocationZone FMemoryTracker::ExchangeCurrentZone(EAllocationZone InZone)
+{
+    const EAllocationZone PreviousZone = CurrentZone;
+    CurrentZone = InZone;
+    return PreviousZone;
+}
+
+void FMemoryTracker::BeginFrame()
+{
+    LastFrameStats.Total = {};
+    for (std::size_t ZoneIndex = 0; ZoneIndex < ZoneCounters.size(); ++ZoneIndex)
+    {
+        FAllocationStats& ZoneStats = LastFrameStats.Zones[ZoneIndex];
+        ZoneStats.NumAllocations = ZoneCounters[ZoneIndex].NumAllocations.exchange(0, std::memory_order_relaxed);
+        ZoneStats.NumFrees = ZoneCounters[ZoneIndex].NumFrees.exchange(0, std::memory_order_relaxed);
+        ZoneStats.AllocatedBytes = ZoneCounters[ZoneIndex].AllocatedBytes.exchange(0, std::memory_order_relaxed);
+
+        LastFrameStats.Total.NumAllocations += ZoneStats.NumAllocations;
+        LastFrameStats.Total.NumFrees += ZoneStats.NumFrees;
+        LastFrameStats.Total.AllocatedBytes += ZoneStats.AllocatedBytes;
+    }
+
+    // Mesmo limite do GetNumTrackedFrames: o frame fechado agora e o FrameNumber-esimo
+    if (++FrameNumber > NumWarmUpFrames && LastFrameStats.Total.NumAllocations > 0)
+    {
+        NumFramesWithAllocations++;
+    }
+}
+
+void FMemoryTracker::ResetFramesWithAllocations()
+{
+    FrameNumber = 0;
+    NumFramesWithAllocations = 0;
+}
+
+#if BLUEMARBLE_TRACK_ALLOCATIONS
+
+static void RecordAllocation(std::size_t InSize)
+{
+    FZoneCounters& Counters = ZoneCounters[static_cast<std::size_t>(CurrentZone)];
+    Counters.NumAllocations.fetch_add(1, std::memory_order_relaxed);
+    Counters.AllocatedBytes.fetch_add(InSize, std::memory_order_relaxed);
+}
+
+static void RecordFree(void* InPtr)
+{
+    if (InPtr != nullptr)
+    {
+        ZoneCounters[static_cast<std::size_t>(CurrentZone)].NumFrees.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+static void* TrackedAllocate(std::size_t InSize)
+{
+    void* Ptr = std::malloc(InSize > 0 ? InSize : 1);
+    if (Ptr != nullptr)
+    {
+        RecordAllocation(InSize);
+    }
+    return Ptr;
+}
+
+static void* TrackedAllocateAligned(std::size_t InSize, std::align_val_t InAlignment)
+{
+    const std::size_t Alignment = static_cast<std::size_t>(InAlignment);
+#ifdef _WIN32
+    void* Ptr = _aligned_malloc(InSize > 0 ? InSize : 1, Alignment);
+#else
+    // O aligned_alloc exige um tamanho multiplo do alinhamento
+    void* Ptr = std::aligned_alloc(Alignment, InSize > 0 ? (InSize + Alignment - 1) / Alignment * Alignment : Alignment);
+#endif
+    if (Ptr != nullptr)
+    {
+        RecordAllocation(InSize);
+    }
+    return Ptr;
+}
+
+static void TrackedFree(void* InPtr)
+{
+    RecordFree(InPtr);
+    std::free(InPtr);
+}
+
+static void TrackedFreeAligned(void* InPtr)
+{
+    RecordFree(InPtr);
+#ifdef _WIN32
+    _aligned_free(InPtr);
+#else
+    std::free(InPtr);
+#endif
+}
+
+void* operator new(std::size_t InSize)
+{
+    if (void* Ptr = TrackedAllocate(InSize))
+    {
+        return Ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t InSize)
+{
+    return operator new(InSize);
+}
+
+void* operator new(std::size_t InSize, const std::nothrow_t&) noexcept
+{
+    return TrackedAllocate(InSize);
+}
+
+void* operator new[](std::size_t InSize, const std::nothrow_t&) noexcept
+{
+    return TrackedAllocate(InSize);
+}
+
+void* operator new(std::size_t InSize, std::align_val_t InAlignment)
+{
+    if (void* Ptr = TrackedAllocateAligned(InSize, InAlignment))
+    {
+        return Ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t InSize, std::align_val_t InAlignment)
+{
+    return operator new(InSize, InAlignment);
+}
+
+void* operator new(std::size_t InSize, std::align_val_t InAlignment, const std::nothrow_t&) noexcept
+{
+    return TrackedAllocateAligned(InSize, InAlignment);
+}
+
+void* operator new[](std::size_t InSize, std::align_val_t InAlignment, const std::nothrow_t&) noexcept
+{
+    return TrackedAllocateAligned(InSize, InAlignment);
+}
+
+void operator delete(void* InPtr) noexcept { TrackedFree(InPtr); }
+void operator delete[](void* InPtr) noexcept { TrackedFree(InPtr); }
+void operator delete(void* InPtr, const std::nothrow_t&) noexcept { TrackedFree(InPtr); }
+void operator delete[](void* InPtr, const std::nothrow_t&) noexcept { TrackedFree(InPtr); }
+void operator delete(void* InPtr, std::size_t) noexcept { TrackedFree(InPtr); }
+void operator delete[](void* InPtr, std::size_t) noexcept { TrackedFree(InPtr); }
+
+void operator delete(void* InPtr, std::align_val_t) noexcept { TrackedFreeAligned(InPtr); }
+void operator delete[](void* InPtr, std::align_val_t) noexcept { TrackedFreeAligned(InPtr); }
+void operator delete(void* InPtr, std::align_val_t, const std::nothrow_t&) noexcept { TrackedFreeAligned(InPtr); }
+void operator delete[](void* InPtr, std::align_val_t, const std::nothrow_t&) noexcept { TrackedFreeAligned(InPtr); }
+void operator delete(void* InPtr, std::size_t, std::align_val_t) noexcept { TrackedFreeAligned(InPtr); }
+void operator delete[](void* InPtr, std::size_t, std::align_val_t) noexcept { TrackedFreeAligned(InPtr); }
+
+#endif
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#ifndef BLUEMARBLE_TRACK_ALLOCATIONS
+#define BLUEMARBLE_TRACK_ALLOCATIONS 0
+#endif
+
+// Zonas usadas para agrupar as alocacoes: X(Nome)
+#define BLUEMARBLE_ALLOCATION_ZONES(X)  \
+    X(Other)                            \
+    X(Assets)                           \
+    X(UI)                               \
+    X(Update)                           \
+    X(Render)
+
+enum class EAllocationZone : std::uint8_t
+{
+#define BLUEMARBLE_ALLOCATION_ZONE_ENUM(Name) Name,
+    BLUEMARBLE_ALLOCATION_ZONES(BLUEMARBLE_ALLOCATION_ZONE_ENUM)
+#undef BLUEMARBLE_ALLOCATION_ZONE_ENUM
+    Count
+};
+
+struct FAllocationStats
+{
+    std::uint32_t NumAllocations = 0;
+    std::uint32_t NumFrees = 0;
+    std::uint64_t AllocatedBytes = 0;
+};
+
+struct FMemoryFrameStats
+{
+    std::array<FAllocationStats, static_cast<std::size_t>(EAllocationZone::Count)> Zones{};
+    FAllocationStats Total;
+};
+
+// Conta as alocacoes feitas pelos operator new/delete globais, por frame e por zona. Os operadores
+// so sao substituidos quando BLUEMARBLE_TRACK_ALLOCATIONS esta ligado, senao todas as contagens ficam em zero.
+// Alocacoes do ImGui e do driver usam malloc diretamente e nao sao contadas.
+class FMemoryTracker
+{
+public:
+
+    static FMemoryTracker& Get();
+
+    static const char* GetZoneName(EAllocationZone InZone);
+
+    static constexpr bool IsEnabled() { return BLUEMARBLE_TRACK_ALLOCATIONS != 0; }
+
+    // Zona das proximas alocacoes da thread atual, retorna a zona anterior
+    static EAllocationZone ExchangeCurrentZone(EAllocationZone InZone);
+
+    // Fecha as contagens do frame anterior. Os frames depois dos primeiros InNumWarmUpFrames
+    // que fizerem alguma alocacao sao contados em GetNumFramesWithAllocations
+    void BeginFrame();
+
+    const FMemoryFrameStats& GetLastFrameStats() const { return LastFrameStats; }
+
+    std::uint64_t GetNumFramesWithAllocations() const { return NumFramesWithAllocations; }
+    std::uint64_t GetNumTrackedFrames() const { return FrameNumber > NumWarmUpFrames ? FrameNumber - NumWarmUpFrames : 0; }
+
+    void ResetFramesWithAllocations();
+
+private:
+
+    // Carga de assets, criacao de buffers e os primeiros frames da UI ainda alocam
+    static constexpr std::uint64_t NumWarmUpFrames = 60;
+
+    FMemoryTracker() = default;
+
+    FMemoryFrameStats LastFrameStats;
+    std::uint64_t FrameNumber = 0;
+    std::uint64_t NumFramesWithAllocations = 0;
+};
+
+// Define a zona das alocacoes da thread atual ate o fim do escopo
+class FAllocationZoneScope
+{
+public:
+
+    explicit FAllocationZoneScope(EAllocationZone InZone)
+        : PreviousZone{ FMemoryTracker::ExchangeCurrentZone(InZone) }
+    {
+    }
+
+    ~FAllocationZoneScope()
+    {
+        FMemoryTracker::ExchangeCurrentZone(PreviousZone);
+    }
+
+    FAllocationZoneScope(const FAllocationZoneScope&) = delete;
+    FAllocationZoneScope& operator=(const FAllocationZoneScope&) = delete;
+
+private:
+
+    EAllocationZone PreviousZone;
+};
@@ -0,0 +1,203 @@
+#include "MeshArena.h"
+
+#include "GPUResourceRegistry.h"
+
+#include <cstddef>
+#include <iostream>
+
+void FMeshArena::Initialize(GLsizeiptr InVertexCapacity, GLsizeiptr InIndexCapacity)
+{
+    VertexArena.Initialize(InVertexCapacity, "Vertices");
+    IndexArena.Initialize(InIndexCapacity, "Indices");
+
+    // Usa DSA para configurar o VAO sem alterar o VAO que estiver ligado no FGLStateCache
+    VAO = FGPUResourceRegistry::Get().CreateVertexArray("Mesh Arena");
+
+    glEnableVertexArrayAttrib(VAO, 0);
+    glEnableVertexArrayAttrib(VAO, 1);
+    glEnableVertexArrayAttrib(VAO, 2);
+
+    glVertexArrayAttribFormat(VAO, 0, 3, GL_FLOAT, GL_FALSE, offsetof(FVertex, Position));
+    glVertexArrayAttribFormat(VAO, 1, 3, GL_FLOAT, GL_TRUE, offsetof(FVertex, Normal));
+    glVertexArrayAttribFormat(VAO, 2, 2, GL_FLOAT, GL_FALSE, offsetof(FVertex, UV));
+
+    glVertexArrayAttribBinding(VAO, 0, 0);
+    glVertexArrayAttribBinding(VAO, 1, 0);
+    glVertexArrayAttribBinding(VAO, 2, 0);
+
+    // Uma mat4 por instancia ocupa os atributos 3, 4, 5 e 6
+    for (GLuint Column = 0; Column < 4; ++Column)
+    {
+        const GLuint AttribIndex = 3 + Column;
+        glEnableVertexArrayAttrib(VAO, AttribIndex);
+        glVertexArrayAttribFormat(VAO, AttribIndex, 4, GL_FLOAT, GL_FALSE, Column * sizeof(glm::vec4));
+        glVertexArrayAttribBinding(VAO, AttribIndex, 1);
+    }
+
+    glVertexArrayBindingDivisor(VAO, 1, 1);
+
+    UpdateVertexArray();
+}
+
+void FMeshArena::Shutdown()
+{
+    FGPUResourceRegistry::Get().Delete(EGPUResourceType::VertexArray, VAO);
+    VertexArena.Shutdown();
+    IndexArena.Shutdown();
+
+    Meshes.clear();
+    FreeMeshes.clear();
+    MappedMesh = InvalidMeshHandle;
+}
+
+void FMeshArena::UpdateVertexArray()
+{
+    if (BoundVertexGeneration != VertexArena.GetGeneration())
+    {
+        glVertexArrayVertexBuffer(VAO, 0, VertexArena.GetBufferId(), 0, sizeof(FVertex));
+        glVertexArrayVertexBuffer(VAO, 1, VertexArena.GetBufferId(), 0, sizeof(glm::mat4));
+        BoundVertexGeneration = VertexArena.GetGeneration();
+    }
+
+    if (BoundIndexGeneration != IndexArena.GetGeneration())
+    {
+        glVertexArrayElementBuffer(VAO, IndexArena.GetBufferId());
+        BoundIndexGeneration = IndexArena.GetGeneration();
+    }
+}
+
+FMeshHandle FMeshArena::AllocateMesh(std::uint32_t InNumVertices, std::uint32_t InNumIndices)
+{
+    // Os offsets sao multiplos do tamanho do elemento para virarem BaseVertex e FirstIndex
+    FMesh Mesh;
+    Mesh.Vertices = VertexArena.Allocate(static_cast<GLsizeiptr>(InNumVertices) * sizeof(FVertex), sizeof(FVertex));
+    Mesh.Indices = IndexArena.Allocate(static_cast<GLsizeiptr>(InNumIndices) * sizeof(GLuint), sizeof(GLuint));
+    Mesh.NumIndices = static_cast<GLsizei>(InNumIndices);
+    UpdateVertexArray();
+
+    FMeshHandle Handle = InvalidMeshHandle;
+    if (!FreeMeshes.empty())
+    {
+        Handle = FreeMeshes.back();
+        FreeMeshes.pop_back();
+        Meshes[Handle] = Mesh;
+    }
+    else
+    {
+        Handle = static_cast<FMeshHandle>(Meshes.size());
+        Meshes.push_back(Mesh);
+    }
+
+    return Handle;
+}
+
+FMeshHandle FMeshArena::AddMesh(std::span<const FVertex> InVertices, std::span<const GLuint> InIndices)
+{
+    const FMeshHandle Handle = AllocateMesh(static_cast<std::uint32_t>(InVertices.size()), static_cast<std::uint32_t>(InIndices.size()));
+
+    const FMesh& Mesh = Meshes[Handle];
+    VertexArena.Upload(Mesh.Vertices, InVertices.data(), InVertices.size_bytes());
+    IndexArena.Upload(Mesh.Indices, InIndices.data(), InIndices.size_bytes());
+
+    return Handle;
+}
+
+FMeshWriter FMeshArena::MapMesh(FMeshHandle InMesh)
+{
+    const FMesh& Mesh = Meshes[InMesh];
+
+    const bool bHasVertices = VertexArena.GetBlock(Mesh.Vertices).Size > 0;
+    const bool bHasIndices = IndexArena.GetBlock(Mesh.Indices).Size > 0;
+
+    FMeshWriter Writer;
+    FVertex* Vertices = static_cast<FVertex*>(VertexArena.Map(Mesh.Vertices));
+    GLuint* Indices = static_cast<GLuint*>(IndexArena.Map(Mesh.Indices));
+
+    // Se um dos mapeamentos falhar o outro e desfeito e nada fica mapeado
+    if ((bHasVertices && Vertices == nullptr) || (bHasIndices && Indices == nullptr))
+    {
+        std::cout << "Nao foi possivel mapear a malha " << InMesh << std::endl;
+        if (Vertices != nullptr)
+        {
+            VertexArena.Unmap();
+        }
+        if (Indices != nullptr)
+        {
+            IndexArena.Unmap();
+        }
+        return Writer;
+    }
+
+    if (Vertices != nullptr)
+    {
+        Writer.Vertices = { Vertices, static_cast<std::size_t>(VertexArena.GetBlock(Mesh.Vertices).Size / sizeof(FVertex)) };
+    }
+    if (Indices != nullptr)
+    {
+        Writer.Indices = { Indices, static_cast<std::size_t>(Mesh.NumIndices) };
+    }
+
+    MappedMesh = InMesh;
+    return Writer;
+}
+
+bool FMeshArena::UnmapMesh()
+{
+    const FMesh& Mesh = Meshes[MappedMesh];
+    MappedMesh = InvalidMeshHandle;
+
+    // Regioes vazias nao chegam a ser mapeadas
+    const bool bVerticesValid = VertexArena.GetBlock(Mesh.Vertices).Size == 0 || VertexArena.Unmap();
+    const bool bIndicesValid = IndexArena.GetBlock(Mesh.Indices).Size == 0 || IndexArena.Unmap();
+    return bVerticesValid && bIndicesValid;
+}
+
+void FMeshArena::RemoveMesh(FMeshHandle InMesh)
+{
+    FMesh& Mesh = Meshes[InMesh];
+    if (Mesh.Vertices == InvalidGPUBufferHandle)
+    {
+        return;
+    }
+
+    VertexArena.Free(Mesh.Vertices);
+    IndexArena.Free(Mesh.Indices);
+    Mesh = FMesh{};
+    FreeMeshes.push_back(InMesh);
+}
+
+FGPUBufferHandle FMeshArena::AddInstances(std::span<const glm::mat4> InInstances)
+{
+    const FGPUBufferHandle Instances = VertexArena.Allocate(InInstances.size_bytes(), sizeof(glm::mat4));
+    VertexArena.Upload(Instances, InInstances.data(), InInstances.size_bytes());
+    UpdateVertexArray();
+    return Instances;
+}
+
+void FMeshArena::RemoveInstances(FGPUBufferHandle InInstances)
+{
+    VertexArena.Free(InInstances);
+}
+
+FMeshDrawInfo FMeshArena::GetDrawInfo(FMeshHandle InMesh) const
+{
+    const FMesh& Mesh = Meshes[InMesh];
+
+    FMeshDrawInfo DrawInfo;
+    DrawInfo.NumIndices = Mesh.NumIndices;
+    DrawInfo.FirstIndex = static_cast<GLuint>(IndexArena.GetBlock(Mesh.Indices).Offset / sizeof(GLuint));
+    DrawInfo.BaseVertex = static_cast<GLint>(VertexArena.GetBlock(Mesh.Vertices).Offset / sizeof(FVertex));
+    return DrawInfo;
+}
+
+GLuint FMeshArena::GetBaseInstance(FGPUBufferHandle InInstances) const
+{
+    return static_cast<GLuint>(VertexArena.GetBlock(InInstances).Offset / sizeof(glm::mat4));
+}
+
+void FMeshArena::Defragment()
+{
+    VertexArena.Defragment();
+    IndexArena.Defragment();
+    UpdateVertexArray();
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "GPUBufferArena.h"
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+struct FVertex
+{
+    glm::vec3 Position;
+    glm::vec3 Normal;
+    glm::vec2 UV;
+};
+
+using FMeshHandle = std::uint32_t;
+inline constexpr FMeshHandle InvalidMeshHandle = ~0u;
+
+// Numero exato de vertices e indices de uma malha, conhecido antes de gerar ou carregar
+struct FMeshSize
+{
+    std::uint32_t NumVertices = 0;
+    std::uint32_t NumIndices = 0;
+};
+
+// Parametros para desenhar uma malha com glDrawElementsBaseVertex ou um comando indireto
+struct FMeshDrawInfo
+{
+    GLsizei NumIndices = 0;
+    GLuint FirstIndex = 0;
+    GLint BaseVertex = 0;
+};
+
+// Regioes mapeadas de uma malha, escritas diretamente pelos geradores
+struct FMeshWriter
+{
+    std::span<FVertex> Vertices;
+    std::span<GLuint> Indices;
+};
+
+// Todas as malhas estaticas compartilham um arena de vertices, um arena de indices e um unico VAO.
+// Os atributos 0-2 leem FVertex do binding 0 e os atributos 3-6 leem matrizes por instancia do binding 1,
+// as duas no arena de vertices, entao uma malha e escolhida com BaseVertex/FirstIndex e um conjunto de
+// instancias com BaseInstance, sem trocar de VAO
+class FMeshArena
+{
+public:
+
+    void Initialize(GLsizeiptr InVertexCapacity, GLsizeiptr InIndexCapacity);
+
+    // Apaga o VAO e os buffers. Todos os handles ficam invalidos
+    void Shutdown();
+
+    FMeshHandle AddMesh(std::span<const FVertex> InVertices, std::span<const GLuint> InIndices);
+
+    // Reserva espaco para uma malha sem enviar dados. O conteudo e escrito entre MapMesh e UnmapMesh,
+    // e so uma malha pode ficar mapeada por vez. Se o mapeamento falhar MapMesh retorna um FMeshWriter
+    // vazio, nada fica mapeado e UnmapMesh nao deve ser chamado
+    FMeshHandle AllocateMesh(std::uint32_t InNumVertices, std::uint32_t InNumIndices);
+    FMeshWriter MapMesh(FMeshHandle InMesh);
+    bool UnmapMesh();
+    void RemoveMesh(FMeshHandle InMesh);
+
+    FGPUBufferHandle AddInstances(std::span<const glm::mat4> InInstances);
+    void RemoveInstances(FGPUBufferHandle InInstances);
+
+    FMeshDrawInfo GetDrawInfo(FMeshHandle InMesh) const;
+    GLuint GetBaseInstance(FGPUBufferHandle InInstances) const;
+
+    GLuint GetVAO() const { return VAO; }
+
+    // Compacta os dois arenas. Os handles continuam validos mas os offsets mudam
+    void Defragment();
+
+    FGPUBufferArenaStats GetVertexStats() const { return VertexArena.GetStats(); }
+    FGPUBufferArenaStats GetIndexStats() const { return IndexArena.GetStats(); }
+
+private:
+
+    struct FMesh
+    {
+        FGPUBufferHandle Vertices = InvalidGPUBufferHandle;
+        FGPUBufferHandle Indices = InvalidGPUBufferHandle;
+        GLsizei NumIndices = 0;
+    };
+
+    // Refaz os bindings do VAO se algum arena trocou de buffer
+    void UpdateVertexArray();
+
+    FGPUBufferArena VertexArena;
+    FGPUBufferArena IndexArena;
+
+    GLuint VAO = 0;
+    std::uint32_t BoundVertexGeneration = 0;
+    std::uint32_t BoundIndexGeneration = 0;
+
+    FMeshHandle MappedMesh = InvalidMeshHandle;
+
+    std::vector<FMesh> Meshes;
+    std::vector<FMeshHandle> FreeMeshes;
+};
@@ -0,0 +1,172 @@
+#include "MeshCache.h"
+
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+    constexpr std::uint32_t MeshCacheMagic = 0x48534D42; // "BMSH"
+    constexpr std::uint64_t MeshCacheDataAlignment = 64;
+    constexpr std::size_t MaxGeneratorNameLength = 32;
+
+    struct FMeshCacheHeader
+    {
+        std::uint32_t Magic;
+        std::uint32_t FormatVersion;
+        std::uint32_t VertexSize;
+        std::uint32_t NumVertices;
+        std::uint32_t NumIndices;
+        std::array<std::uint32_t, 4> Parameters;
+        std::array<char, MaxGeneratorNameLength> Generator;
+
+        // Ocupa o alinhamento dos offsets. O cabecalho e gravado e comparado byte a byte, entao nao pode ter padding
+        std::uint32_t Reserved;
+        std::uint64_t VertexDataOffset;
+        std::uint64_t IndexDataOffset;
+    };
+    static_assert(sizeof(FMeshCacheHeader) == 88, "FMeshCacheHeader nao pode ter padding");
+
+    std::uint64_t AlignDataOffset(std::uint64_t InOffset)
+    {
+        return (InOffset + MeshCacheDataAlignment - 1) / MeshCacheDataAlignment * MeshCacheDataAlignment;
+    }
+
+    // FNV-1a de 64 bits
+    std::uint64_t HashBytes(std::uint64_t InHash, const void* InData, std::size_t InSize)
+    {
+        const std::uint8_t* Bytes = static_cast<const std::uint8_t*>(InData);
+        for (std::size_t Index = 0; Index < InSize; ++Index)
+        {
+            InHash = (InHash ^ Bytes[Index]) * 0x100000001B3ull;
+        }
+        return InHash;
+    }
+
+    FMeshCacheHeader MakeHeader(const FMeshCacheKey& InKey, const FMeshSize& InSize)
+    {
+        FMeshCacheHeader Header{};
+        Header.Magic = MeshCacheMagic;
+        Header.FormatVersion = FMeshCache::FormatVersion;
+        Header.VertexSize = sizeof(FVertex);
+        Header.NumVertices = InSize.NumVertices;
+        Header.NumIndices = InSize.NumIndices;
+        Header.Parameters = InKey.Parameters;
+        std::copy_n(InKey.Generator.data(), std::min(InKey.Generator.size(), MaxGeneratorNameLength - 1), Header.Generator.data());
+        Header.VertexDataOffset = AlignDataOffset(sizeof(FMeshCacheHeader));
+        Header.IndexDataOffset = AlignDataOffset(Header.VertexDataOffset + static_cast<std::uint64_t>(InSize.NumVertices) * sizeof(FVertex));
+        return Header;
+    }
+
+    std::uint64_t GetFileSize(const FMeshCacheHeader& InHeader)
+    {
+        return InHeader.IndexDataOffset + static_cast<std::uint64_t>(InHeader.NumIndices) * sizeof(GLuint);
+    }
+}
+
+void FMeshCache::Initialize(const std::filesystem::path& InCacheDir)
+{
+    CacheDir = InCacheDir;
+    if (CacheDir.empty())
+    {
+        return;
+    }
+
+    std::error_code ErrorCode;
+    std::filesystem::create_directories(CacheDir, ErrorCode);
+    if (ErrorCode)
+    {
+        std::cout << "Erro ao criar o diretorio do cache de malhas " << CacheDir << ": " << ErrorCode.message() << std::endl;
+        CacheDir.clear();
+    }
+}
+
+std::filesystem::path FMeshCache::GetCacheFilePath(const FMeshCacheKey& InKey) const
+{
+    // A versao e o tamanho do vertice fazem parte da chave para que um formato antigo nunca seja lido
+    std::uint64_t Hash = 0xCBF29CE484222325ull;
+    Hash = HashBytes(Hash, InKey.Generator.data(), InKey.Generator.size());
+    Hash = HashBytes(Hash, InKey.Parameters.data(), sizeof(InKey.Parameters));
+    Hash = HashBytes(Hash, &FormatVersion, sizeof(FormatVersion));
+
+    const std::uint32_t VertexSize = sizeof(FVertex);
+    Hash = HashBytes(Hash, &VertexSize, sizeof(VertexSize));
+
+    std::stringstream FileName;
+    FileName << InKey.Generator << "_" << std::hex << Hash << ".mesh";
+    return CacheDir / FileName.str();
+}
+
+FMeshHandle FMeshCache::GetOrGenerate(FMeshArena& InMeshArena, const FMeshCacheKey& InKey, const FMeshSize& InSize, const FWriteMeshFunction& InWriteMesh)
+{
+    FMeshHandle Mesh = InvalidMeshHandle;
+    GetOrGenerate(InKey, InSize, InWriteMesh, [&InMeshArena, &Mesh](std::span<const FVertex> InVertices, std::span<const GLuint> InIndices)
+    {
+        Mesh = InMeshArena.AddMesh(InVertices, InIndices);
+    });
+    return Mesh;
+}
+
+bool FMeshCache::GetOrGenerate(const FMeshCacheKey& InKey, const FMeshSize& InSize, const FWriteMeshFunction& InWriteMesh, const FReadMeshFunction& InReadMesh)
+{
+    if (CacheDir.empty())
+    {
+        return false;
+    }
+
+    const FMeshCacheHeader ExpectedHeader = MakeHeader(InKey, InSize);
+    const std::filesystem::path CacheFilePath = GetCacheFilePath(InKey);
+
+    FMappedFile CacheFile;
+    if (CacheFile.OpenForRead(CacheFilePath))
+    {
+        // O cabecalho inteiro precisa ser igual, o hash do nome do arquivo pode colidir
+        if (CacheFile.GetSize() == GetFileSize(ExpectedHeader) && std::memcmp(CacheFile.GetData(), &ExpectedHeader, sizeof(FMeshCacheHeader)) == 0)
+        {
+            NumHits++;
+
+            const FVertex* Vertices = reinterpret_cast<const FVertex*>(CacheFile.GetData() + ExpectedHeader.VertexDataOffset);
+            const GLuint* Indices = reinterpret_cast<const GLuint*>(CacheFile.GetData() + ExpectedHeader.IndexDataOffset);
+            InReadMesh({ Vertices, InSize.NumVertices }, { Indices, InSize.NumIndices });
+            return true;
+        }
+
+        std::cout << "Cache de malha invalido, gerando novamente: " << CacheFilePath << std::endl;
+        CacheFile.Close();
+    }
+
+    NumMisses++;
+
+    // Escreve num arquivo temporario e renomeia no final, assim um arquivo incompleto nunca e lido
+    std::filesystem::path TempFilePath = CacheFilePath;
+    TempFilePath += ".tmp";
+
+    FMappedFile NewCacheFile;
+    if (!NewCacheFile.CreateForWrite(TempFilePath, GetFileSize(ExpectedHeader)))
+    {
+        return false;
+    }
+
+    std::uint8_t* FileData = NewCacheFile.GetMutableData();
+    std::memcpy(FileData, &ExpectedHeader, sizeof(FMeshCacheHeader));
+
+    FVertex* Vertices = reinterpret_cast<FVertex*>(FileData + ExpectedHeader.VertexDataOffset);
+    GLuint* Indices = reinterpret_cast<GLuint*>(FileData + ExpectedHeader.IndexDataOffset);
+    InWriteMesh({ Vertices, InSize.NumVertices }, { Indices, InSize.NumIndices });
+
+    InReadMesh({ Vertices, InSize.NumVertices }, { Indices, InSize.NumIndices });
+    NewCacheFile.Close();
+
+    std::error_code ErrorCode;
+    std::filesystem::rename(TempFilePath, CacheFilePath, ErrorCode);
+    if (ErrorCode)
+    {
+        std::cout << "Erro ao gravar o cache de malha " << CacheFilePath << ": " << ErrorCode.message() << std::endl;
+        std::filesystem::remove(TempFilePath, ErrorCode);
+    }
+
+    return true;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "MeshArena.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <span>
+#include <string_view>
+
+// Identifica uma malha procedural: o gerador e seus parametros
+struct FMeshCacheKey
+{
+    std::string_view Generator;
+    std::array<std::uint32_t, 4> Parameters{};
+};
+
+// Cache em disco de malhas procedurais, enderecado pelo conteudo da chave. Cada arquivo tem um cabecalho
+// seguido dos vertices e indices exatamente como o FMeshArena envia para a GPU, entao o arquivo e mapeado
+// na memoria e enviado sem nenhuma conversao
+class FMeshCache
+{
+public:
+
+    // Precisa mudar sempre que FVertex ou o layout do arquivo mudarem
+    static constexpr std::uint32_t FormatVersion = 1;
+
+    using FWriteMeshFunction = std::function<void(std::span<FVertex>, std::span<GLuint>)>;
+
+    // Recebe a malha lida do cache ou recem gerada. Os dados so sao validos durante a chamada
+    using FReadMeshFunction = std::function<void(std::span<const FVertex>, std::span<const GLuint>)>;
+
+    // Um diretorio vazio desliga o cache
+    void Initialize(const std::filesystem::path& InCacheDir);
+
+    // Envia a malha do cache para o InMeshArena. Se ela nao estiver no cache, InWriteMesh escreve direto no
+    // arquivo novo, que depois e enviado. Retorna InvalidMeshHandle se o arquivo do cache nao puder ser criado
+    FMeshHandle GetOrGenerate(FMeshArena& InMeshArena, const FMeshCacheKey& InKey, const FMeshSize& InSize, const FWriteMeshFunction& InWriteMesh);
+
+    // Mesmo processo, mas a malha e entregue para InReadMesh em vez de ir para a GPU. Nao usa o OpenGL e pode
+    // rodar fora da thread principal. Retorna false se o arquivo do cache nao puder ser criado
+    bool GetOrGenerate(const FMeshCacheKey& InKey, const FMeshSize& InSize, const FWriteMeshFunction& InWriteMesh, const FReadMeshFunction& InReadMesh);
+
+    const std::filesystem::path& GetCacheDir() const { return CacheDir; }
+    std::uint32_t GetNumHits() const { return NumHits; }
+    std::uint32_t GetNumMisses() const { return NumMisses; }
+
+private:
+
+    std::filesystem::path GetCacheFilePath(const FMeshCacheKey& InKey) const;
+
+    std::filesystem::path CacheDir;
+    // Atualizados tambem pela thread que prepara a proxima cena
+    std::atomic<std::uint32_t> NumHits{ 0 };
+    std::atomic<std::uint32_t> NumMisses{ 0 };
+};
@@ -0,0 +1,501 @@
+#include "MeshGenerators.h"
+
+#include "WorkerPool.h"
+
+#include <glm/ext.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BLUEMARBLE_SINCOS_SSE2 1
+#include <emmintrin.h>
+#else
+#define BLUEMARBLE_SINCOS_SSE2 0
+#endif
+
+namespace
+{
+    // Coeficientes do sincosf da Cephes: reducao para [-Pi/4, Pi/4] e um polinomio para cada funcao
+    constexpr float FourOverPi = 1.27323954473516f;
+    constexpr float MinusDP1 = -0.78515625f;
+    constexpr float MinusDP2 = -2.4187564849853515625e-4f;
+    constexpr float MinusDP3 = -3.77489497744594108e-8f;
+    constexpr float SinCoef0 = -1.9515295891e-4f;
+    constexpr float SinCoef1 = 8.3321608736e-3f;
+    constexpr float SinCoef2 = -1.6666654611e-1f;
+    constexpr float CosCoef0 = 2.443315711809948e-5f;
+    constexpr float CosCoef1 = -1.388731625493765e-3f;
+    constexpr float CosCoef2 = 4.166664568298827e-2f;
+
+    void SinCosScalar(float InAngle, float& OutSin, float& OutCos)
+    {
+        const bool bNegativeAngle = InAngle < 0.0f;
+        float X = std::abs(InAngle);
+
+        // Octante arredondado para par, os bits 1 e 2 decidem troca de funcao e sinal
+        const std::int32_t Octant = (static_cast<std::int32_t>(X * FourOverPi) + 1) & ~1;
+        const float Y = static_cast<float>(Octant);
+        X = ((X + Y * MinusDP1) + Y * MinusDP2) + Y * MinusDP3;
+
+        const float Z = X * X;
+        const float CosPoly = ((CosCoef0 * Z + CosCoef1) * Z + CosCoef2) * Z * Z - 0.5f * Z + 1.0f;
+        const float SinPoly = ((SinCoef0 * Z + SinCoef1) * Z + SinCoef2) * Z * X + X;
+
+        const bool bSwap = (Octant & 2) != 0;
+        const bool bNegateSin = bNegativeAngle != ((Octant & 4) != 0);
+        const bool bNegateCos = ((Octant - 2) & 4) == 0;
+
+        OutSin = bNegateSin ? -(bSwap ? CosPoly : SinPoly) : (bSwap ? CosPoly : SinPoly);
+        OutCos = bNegateCos ? -(bSwap ? SinPoly : CosPoly) : (bSwap ? SinPoly : CosPoly);
+    }
+
+#if BLUEMARBLE_SINCOS_SSE2
+    // Mesmo algoritmo do SinCosScalar com 4 angulos por registrador
+    void SinCos4(const float* InAngles, float* OutSin, float* OutCos)
+    {
+        const __m128 SignMask = _mm_castsi128_ps(_mm_set1_epi32(static_cast<std::int32_t>(0x80000000u)));
+
+        __m128 X = _mm_loadu_ps(InAngles);
+        __m128 SinSign = _mm_and_ps(X, SignMask);
+        X = _mm_andnot_ps(SignMask, X);
+
+        __m128i Octant = _mm_cvttps_epi32(_mm_mul_ps(X, _mm_set1_ps(FourOverPi)));
+        Octant = _mm_and_si128(_mm_add_epi32(Octant, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+        const __m128 Y = _mm_cvtepi32_ps(Octant);
+
+        X = _mm_add_ps(X, _mm_mul_ps(Y, _mm_set1_ps(MinusDP1)));
+        X = _mm_add_ps(X, _mm_mul_ps(Y, _mm_set1_ps(MinusDP2)));
+        X = _mm_add_ps(X, _mm_mul_ps(Y, _mm_set1_ps(MinusDP3)));
+
+        const __m128 SwapMask = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(Octant, _mm_set1_epi32(2)), _mm_set1_epi32(2)));
+        SinSign = _mm_xor_ps(SinSign, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(Octant, _mm_set1_epi32(4)), 29)));
+        const __m128 CosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(Octant, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));
+
+        const __m128 Z = _mm_mul_ps(X, X);
+
+        __m128 CosPoly = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(CosCoef0), Z), _mm_set1_ps(CosCoef1));
+        CosPoly = _mm_add_ps(_mm_mul_ps(CosPoly, Z), _mm_set1_ps(CosCoef2));
+        CosPoly = _mm_mul_ps(_mm_mul_ps(CosPoly, Z), Z);
+        CosPoly = _mm_sub_ps(CosPoly, _mm_mul_ps(Z, _mm_set1_ps(0.5f)));
+        CosPoly = _mm_add_ps(CosPoly, _mm_set1_ps(1.0f));
+
+        __m128 SinPoly = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(SinCoef0), Z), _mm_set1_ps(SinCoef1));
+        SinPoly = _mm_add_ps(_mm_mul_ps(SinPoly, Z), _mm_set1_ps(SinCoef2));
+        SinPoly = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(SinPoly, Z), X), X);
+
+        const __m128 Sin = _mm_or_ps(_mm_and_ps(SwapMask, CosPoly), _mm_andnot_ps(SwapMask, SinPoly));
+        const __m128 Cos = _mm_or_ps(_mm_and_ps(SwapMask, SinPoly), _mm_andnot_ps(SwapMask, CosPoly));
+
+        _mm_storeu_ps(OutSin, _mm_xor_ps(Sin, SinSign));
+        _mm_storeu_ps(OutCos, _mm_xor_ps(Cos, CosSign));
+    }
+#endif
+
+    // Divide InNumRows em intervalos [Begin, End) para os jobs do InWorkerPool
+    template<typename FunctionType>
+    void ParallelForRows(FWorkerPool& InWorkerPool, std::uint32_t InNumRows, const FunctionType& InFunction)
+    {
+        constexpr std::uint32_t JobsPerThread = 4;
+        const std::uint32_t NumJobs = std::max(std::min(InNumRows, (InWorkerPool.GetNumWorkers() + 1) * JobsPerThread), 1u);
+        const std::uint32_t RowsPerJob = (InNumRows + NumJobs - 1) / NumJobs;
+
+        InWorkerPool.ParallelFor(NumJobs, [&](std::uint32_t JobIndex)
+        {
+            const std::uint32_t Begin = JobIndex * RowsPerJob;
+            const std::uint32_t End = std::min(Begin + RowsPerJob, InNumRows);
+            if (Begin < End)
+            {
+                InFunction(Begin, End);
+            }
+        });
+    }
+
+    // Seno e cosseno de InCount angulos igualmente espacados em [0, InMaxAngle]
+    void SinCosTable(std::uint32_t InCount, float InMaxAngle, std::vector<float>& OutSin, std::vector<float>& OutCos)
+    {
+        const float InvCount = 1.0f / static_cast<float>(InCount - 1);
+
+        std::vector<float> Angles(InCount);
+        for (std::uint32_t Index = 0; Index < InCount; ++Index)
+        {
+            Angles[Index] = glm::mix(0.0f, InMaxAngle, Index * InvCount);
+        }
+
+        OutSin.resize(InCount);
+        OutCos.resize(InCount);
+        SinCos(Angles, OutSin, OutCos);
+    }
+
+    // As linhas e colunas da grade compartilham o mesmo padrao de indices nos dois geradores
+    void WriteGridQuad(std::uint32_t InResolution, std::uint32_t InU, std::uint32_t InV, bool bInFlipWinding, GLuint* OutIndices)
+    {
+        const GLuint P0 = InU + InV * InResolution;
+        const GLuint P1 = InU + 1 + InV * InResolution;
+        const GLuint P2 = InU + (InV + 1) * InResolution;
+        const GLuint P3 = InU + 1 + (InV + 1) * InResolution;
+
+        const GLuint Triangles[6] = { P3, P2, P0, P1, P3, P0 };
+        const GLuint FlippedTriangles[6] = { P0, P2, P3, P0, P3, P1 };
+        std::memcpy(OutIndices, bInFlipWinding ? FlippedTriangles : Triangles, sizeof(Triangles));
+    }
+}
+
+void SinCos(std::span<const float> InAngles, std::span<float> OutSin, std::span<float> OutCos)
+{
+    std::size_t Index = 0;
+
+#if BLUEMARBLE_SINCOS_SSE2
+    for (; Index + 4 <= InAngles.size(); Index += 4)
+    {
+        SinCos4(InAngles.data() + Index, OutSin.data() + Index, OutCos.data() + Index);
+    }
+#endif
+
+    for (; Index < InAngles.size(); ++Index)
+    {
+        SinCosScalar(InAngles[Index], OutSin[Index], OutCos[Index]);
+    }
+}
+
+FMeshSize GetSphereSize(std::uint32_t InResolution)
+{
+    return FMeshSize{ .NumVertices = InResolution * InResolution, .NumIndices = (InResolution - 1) * (InResolution - 1) * 6 };
+}
+
+FMeshSize GetCylinderSize(std::uint32_t InResolution)
+{
+    // Grade lateral mais os vertices do centro das tampas e um triangulo por segmento em cada tampa
+    const FMeshSize GridSize = GetSphereSize(InResolution);
+    return FMeshSize{ .NumVertices = GridSize.NumVertices + 2, .NumIndices = GridSize.NumIndices + (InResolution - 1) * 3 * 2 };
+}
+
+void WriteSphere(std::uint32_t InResolution, std::span<FVertex> OutVertices, std::span<GLuint> OutIndices, FWorkerPool& InWorkerPool)
+{
+    // So 2 * InResolution senos e cossenos sao calculados, o resto da malha e apenas multiplicacao
+    std::vector<float> SinPhi, CosPhi, SinTheta, CosTheta;
+    SinCosTable(InResolution, glm::two_pi<float>(), SinPhi, CosPhi);
+    SinCosTable(InResolution, glm::pi<float>(), SinTheta, CosTheta);
+
+    const float InvResolution = 1.0f / static_cast<float>(InResolution - 1);
+
+    ParallelForRows(InWorkerPool, InResolution, [&](std::uint32_t Begin, std::uint32_t End)
+    {
+        for (std::uint32_t UIndex = Begin; UIndex < End; ++UIndex)
+        {
+            const float U = UIndex * InvResolution;
+            FVertex* Row = OutVertices.data() + UIndex * InResolution;
+
+            for (std::uint32_t VIndex = 0; VIndex < InResolution; ++VIndex)
+            {
+                // Equacao parametrica da esfera usando o Y como eixo polar. A posicao ja tem comprimento 1
+                const glm::vec3 Position =
+                {
+                    SinTheta[VIndex] * SinPhi[UIndex],
+                    CosTheta[VIndex],
+                    SinTheta[VIndex] * CosPhi[UIndex]
+                };
+
+                Row[VIndex] = FVertex{ .Position = Position, .Normal = Position, .UV = { U, VIndex * InvResolution } };
+            }
+
+            if (UIndex + 1 < InResolution)
+            {
+                for (std::uint32_t V = 0; V < InResolution - 1; ++V)
+                {
+                    WriteGridQuad(InResolution, UIndex, V, false, OutIndices.data() + (UIndex * (InResolution - 1) + V) * 6);
+                }
+            }
+        }
+    });
+}
+
+void WriteCylinder(std::uint32_t InResolution, std::span<FVertex> OutVertices, std::span<GLuint> OutIndices, FWorkerPool& InWorkerPool)
+{
+    constexpr float CylinderHeight = 1.0f;
+    constexpr float HalfCylinderHeight = CylinderHeight / 2.0f;
+
+    std::vector<float> SinTheta, CosTheta;
+    SinCosTable(InResolution, glm::two_pi<float>(), SinTheta, CosTheta);
+
+    const float InvResolution = 1.0f / static_cast<float>(InResolution - 1);
+    const std::uint32_t NumGridIndices = GetSphereSize(InResolution).NumIndices;
+    const GLuint TopVertexIndex = InResolution * InResolution;
+    const GLuint BotVertexIndex = TopVertexIndex + 1;
+
+    ParallelForRows(InWorkerPool, InResolution, [&](std::uint32_t Begin, std::uint32_t End)
+    {
+        for (std::uint32_t UIndex = Begin; UIndex < End; ++UIndex)
+        {
+            const float U = UIndex * InvResolution;
+            const glm::vec3 Normal = { SinTheta[UIndex], 0.0f, CosTheta[UIndex] };
+            FVertex* Row = OutVertices.data() + UIndex * InResolution;
+
+            for (std::uint32_t VIndex = 0; VIndex < InResolution; ++VIndex)
+            {
+                const float V = VIndex * InvResolution;
+                const glm::vec3 Position = { Normal.x, glm::mix(-HalfCylinderHeight, HalfCylinderHeight, V), Normal.z };
+                Row[VIndex] = FVertex{ .Position = Position, .Normal = Normal, .UV = { U, 1.0f - V } };
+            }
+
+            if (UIndex + 1 < InResolution)
+            {
+                for (std::uint32_t V = 0; V < InResolution - 1; ++V)
+                {
+                    WriteGridQuad(InResolution, UIndex, V, true, OutIndices.data() + (UIndex * (InResolution - 1) + V) * 6);
+                }
+
+                // Um triangulo da tampa de baixo e um da tampa de cima por segmento
+                GLuint* BotCap = OutIndices.data() + NumGridIndices + UIndex * 3;
+                BotCap[0] = UIndex * InResolution;
+                BotCap[1] = BotVertexIndex;
+                BotCap[2] = UIndex * InResolution + InResolution;
+
+                GLuint* TopCap = OutIndices.data() + NumGridIndices + (InResolution - 1) * 3 + UIndex * 3;
+                TopCap[0] = UIndex * InResolution + (InResolution - 1);
+                TopCap[1] = (UIndex + 1) * InResolution + (InResolution - 1);
+                TopCap[2] = TopVertexIndex;
+            }
+        }
+    });
+
+    OutVertices[TopVertexIndex] = FVertex{ .Position = { 0.0f, HalfCylinderHeight, 0.0f }, .Normal = { 0.0f, 1.0f, 0.0f }, .UV = { 1.0f, 1.0f } };
+    OutVertices[BotVertexIndex] = FVertex{ .Position = { 0.0f, -HalfCylinderHeight, 0.0f }, .Normal = { 0.0f, -1.0f, 0.0f }, .UV = { 0.0f, 0.0f } };
+}
+
+namespace
+{
+    template<typename SizeFunctionType, typename WriteFunctionType>
+    FMeshHandle GenerateMesh(FMeshArena& InMeshArena, FWorkerPool& InWorkerPool, std::uint32_t InResolution, FMeshCache* InMeshCache, std::string_view InGenerator, const SizeFunctionType& InGetSize, const WriteFunctionType& InWrite)
+    {
+        // Abaixo de 2 nao existe grade e o espacamento seria uma divisao por zero
+        InResolution = std::max(InResolution, 2u);
+
+        const FMeshSize Size = InGetSize(InResolution);
+
+        if (InMeshCache != nullptr)
+        {
+            const FMeshCacheKey Key{ .Generator = InGenerator, .Parameters = { InResolution } };
+            const FMeshHandle CachedMesh = InMeshCache->GetOrGenerate(InMeshArena, Key, Size, [&](std::span<FVertex> OutVertices, std::span<GLuint> OutIndices)
+            {
+                InWrite(InResolution, OutVertices, OutIndices, InWorkerPool);
+            });
+
+            // Sem acesso ao diretorio do cache a malha e gerada direto na GPU
+            if (CachedMesh != InvalidMeshHandle)
+            {
+                return CachedMesh;
+            }
+        }
+
+        const FMeshHandle Mesh = InMeshArena.AllocateMesh(Size.NumVertices, Size.NumIndices);
+
+        // O conteudo mapeado pode ser perdido (troca de modo de video, por exemplo) e precisa ser escrito de novo
+        constexpr std::uint32_t MaxMapAttempts = 3;
+        for (std::uint32_t Attempt = 0; Attempt < MaxMapAttempts; ++Attempt)
+        {
+            const FMeshWriter Writer = InMeshArena.MapMesh(Mesh);
+            if (Writer.Vertices.size() < Size.NumVertices || Writer.Indices.size() < Size.NumIndices)
+            {
+                break;
+            }
+
+            InWrite(InResolution, Writer.Vertices, Writer.Indices, InWorkerPool);
+            if (InMeshArena.UnmapMesh())
+            {
+                return Mesh;
+            }
+        }
+
+        // Sem mapeamento a malha e gerada na memoria e enviada por copia
+        std::cout << "Enviando a malha " << InGenerator << " sem mapear o buffer" << std::endl;
+        InMeshArena.RemoveMesh(Mesh);
+
+        std::vector<FVertex> Vertices(Size.NumVertices);
+        std::vector<GLuint> Indices(Size.NumIndices);
+        InWrite(InResolution, Vertices, Indices, InWorkerPool);
+        return InMeshArena.AddMesh(Vertices, Indices);
+    }
+
+    template<typename SizeFunctionType, typename WriteFunctionType>
+    FMeshData GenerateMeshData(FWorkerPool& InWorkerPool, std::uint32_t InResolution, FMeshCache* InMeshCache, std::string_view InGenerator, const SizeFunctionType& InGetSize, const WriteFunctionType& InWrite)
+    {
+        InResolution = std::max(InResolution, 2u);
+
+        const FMeshSize Size = InGetSize(InResolution);
+
+        FMeshData MeshData;
+        if (InMeshCache != nullptr)
+        {
+            const FMeshCacheKey Key{ .Generator = InGenerator, .Parameters = { InResolution } };
+            const bool bCached = InMeshCache->GetOrGenerate(Key, Size, [&](std::span<FVertex> OutVertices, std::span<GLuint> OutIndices)
+            {
+                InWrite(InResolution, OutVertices, OutIndices, InWorkerPool);
+            },
+            [&MeshData](std::span<const FVertex> InVertices, std::span<const GLuint> InIndices)
+            {
+                MeshData.Vertices.assign(InVertices.begin(), InVertices.end());
+                MeshData.Indices.assign(InIndices.begin(), InIndices.end());
+            });
+
+            if (bCached)
+            {
+                return MeshData;
+            }
+        }
+
+        MeshData.Vertices.resize(Size.NumVertices);
+        MeshData.Indices.resize(Size.NumIndices);
+        InWrite(InResolution, MeshData.Vertices, MeshData.Indices, InWorkerPool);
+        return MeshData;
+    }
+}
+
+FMeshHandle GenerateSphereMesh(FMeshArena& InMeshArena, FWorkerPool& InWorkerPool, std::uint32_t InResolution, FMeshCache* InMeshCache)
+{
+    return GenerateMesh(InMeshArena, InWorkerPool, InResolution, InMeshCache, "Sphere", GetSphereSize, WriteSphere);
+}
+
+FMeshHandle GenerateCylinderMesh(FMeshArena& InMeshArena, FWorkerPool& InWorkerPool, std::uint32_t InResolution, FMeshCache* InMeshCache)
+{
+    return GenerateMesh(InMeshArena, InWorkerPool, InResolution, InMeshCache, "Cylinder", GetCylinderSize, WriteCylinder);
+}
+
+FMeshData GenerateSphereData(std::uint32_t InResolution, FWorkerPool& InWorkerPool, FMeshCache* InMeshCache)
+{
+    return GenerateMeshData(InWorkerPool, InResolution, InMeshCache, "Sphere", GetSphereSize, WriteSphere);
+}
+
+FMeshData GenerateCylinderData(std::uint32_t InResolution, FWorkerPool& InWorkerPool, FMeshCache* InMeshCache)
+{
+    return GenerateMeshData(InWorkerPool, InResolution, InMeshCache, "Cylinder", GetCylinderSize, WriteCylinder);
+}
+
+FMeshData GenerateQuadData()
+{
+    FMeshData QuadData;
+
+    constexpr glm::vec3 Normal = { 0.0f, 0.0f, 1.0f };
+    QuadData.Vertices =
+    {
+        FVertex{.Position = { 0.0f, 0.0f, 0.0f }, .Normal = Normal, .UV = { 0.0f, 1.0f } },
+        FVertex{.Position = { 1.0f, 0.0f, 0.0f }, .Normal = Normal, .UV = { 1.0f, 1.0f } },
+        FVertex{.Position = { 1.0f, 1.0f, 0.0f }, .Normal = Normal, .UV = { 1.0f, 0.0f } },
+        FVertex{.Position = { 0.0f, 1.0f, 0.0f }, .Normal = Normal, .UV = { 0.0f, 0.0f } },
+    };
+    QuadData.Indices =
+    {
+        0, 1, 2,
+        2, 3, 0,
+    };
+
+    return QuadData;
+}
+
+FMeshData GenerateCubeData()
+{
+    FMeshData CubeData;
+
+    constexpr glm::vec3 XNormal = { 1.0f, 0.0f, 0.0f };
+    constexpr glm::vec3 YNormal = { 0.0f, 1.0f, 0.0f };
+    constexpr glm::vec3 ZNormal = { 0.0f, 0.0f, 1.0f };
+
+    CubeData.Vertices =
+    {
+        // +Z
+        FVertex{ .Position = { -0.5f, -0.5f, 0.5f }, .Normal = ZNormal, .UV = { 0.0f, 1.0f } },
+        FVertex{ .Position = {  0.5f, -0.5f, 0.5f }, .Normal = ZNormal, .UV = { 1.0f, 1.0f } },
+        FVertex{ .Position = {  0.5f,  0.5f, 0.5f }, .Normal = ZNormal, .UV = { 1.0f, 0.0f } },
+        FVertex{ .Position = { -0.5f,  0.5f, 0.5f }, .Normal = ZNormal, .UV = { 0.0f, 0.0f } },
+
+        // -Z
+        FVertex{ .Position = { -0.5f, -0.5f, -0.5f }, .Normal = -ZNormal, .UV = { 0.0f, 1.0f } },
+        FVertex{ .Position = {  0.5f, -0.5f, -0.5f }, .Normal = -ZNormal, .UV = { 1.0f, 1.0f } },
+        FVertex{ .Position = {  0.5f,  0.5f, -0.5f }, .Normal = -ZNormal, .UV = { 1.0f, 0.0f } },
+        FVertex{ .Position = { -0.5f,  0.5f, -0.5f }, .Normal = -ZNormal, .UV = { 0.0f, 0.0f } },
+
+        // +X
+        FVertex{ .Position = { 0.5f, -0.5f, -0.5f }, .Normal = XNormal, .UV = { 0.0f, 1.0f } },
+        FVertex{ .Position = { 0.5f,  0.5f, -0.5f }, .Normal = XNormal, .UV = { 1.0f, 1.0f } },
+        FVertex{ .Position = { 0.5f,  0.5f,  0.5f }, .Normal = XNormal, .UV = { 1.0f, 0.0f } },
+        FVertex{ .Position = { 0.5f, -0.5f,  0.5f }, .Normal = XNormal, .UV = { 0.0f, 0.0f } },
+
+        // -X
+        FVertex{ .Position = { -0.5f, -0.5f, -0.5f }, .Normal = -XNormal, .UV = { 0.0f, 1.0f } },
+        FVertex{ .Position = { -0.5f,  0.5f, -0.5f }, .Normal = -XNormal, .UV = { 1.0f, 1.0f } },
+        FVertex{ .Position = { -0.5f,  0.5f,  0.5f }, .Normal = -XNormal, .UV = { 1.0f, 0.0f } },
+        FVertex{ .Position = { -0.5f, -0.5f,  0.5f }, .Normal = -XNormal, .UV = { 0.0f, 0.0f } },
+
+        // +Y
+        FVertex{ .Position = { -0.5f, 0.5f, -0.5f }, .Normal = YNormal, .UV = { 0.0f, 1.0f } },
+        FVertex{ .Position = {  0.5f, 0.5f, -0.5f }, .Normal = YNormal, .UV = { 1.0f, 1.0f } },
+        FVertex{ .Position = {  0.5f, 0.5f,  0.5f }, .Normal = YNormal, .UV = { 1.0f, 0.0f } },
+        FVertex{ .Position = { -0.5f, 0.5f,  0.5f }, .Normal = YNormal, .UV = { 0.0f, 0.0f } },
+
+        // -Y
+        FVertex{ .Position = { -0.5f, -0.5f, -0.5f }, .Normal = -YNormal, .UV = { 0.0f, 1.0f } },
+        FVertex{ .Position = {  0.5f, -0.5f, -0.5f }, .Normal = -YNormal, .UV = { 1.0f, 1.0f } },
+        FVertex{ .Position = {  0.5f, -0.5f,  0.5f }, .Normal = -YNormal, .UV = { 1.0f, 0.0f } },
+        FVertex{ .Position = { -0.5f, -0.5f,  0.5f }, .Normal = -YNormal, .UV = { 0.0f, 0.0f } },
+    };
+    CubeData.Indices =
+    {
+        0, 1, 2,
+        2, 3, 0,
+
+        4, 5, 6,
+        6, 7, 4,
+
+        8, 9, 10,
+        10, 11, 8,
+
+        12, 13, 14,
+        14, 15, 12,
+
+        16, 17, 18,
+        18, 19, 16,
+
+        20, 21, 22,
+        22, 23, 20,
+    };
+
+    return CubeData;
+}
+
+std::vector<glm::mat4> GenerateInstances(std::uint32_t InNumInstances, std::uint32_t InSeed)
+{
+    std::vector<glm::mat4> ModelMatrices;
+    ModelMatrices.reserve(InNumInstances);
+
+    std::default_random_engine Generator(InSeed);
+
+    constexpr float Jitter = 0.1f;
+    std::normal_distribution<float> JitterDistribution{ -Jitter, Jitter };
+    std::normal_distribution<float> NormalDistribution(0.0f, 0.1f);
+
+    for (std::uint32_t Index = 0; Index < InNumInstances; ++Index)
+    {
+        const float Radius = 5.0f + JitterDistribution(Generator);
+
+        const float Alpha = static_cast<float>(Index) / static_cast<float>(InNumInstances);
+        const float Angle = glm::mix(0.0f, glm::two_pi<float>(), Alpha);
+
+        const float X = Radius * glm::sin(Angle);
+        // const float Y = NormalDistribution(Generator);
+        float Y = Index / (float) InNumInstances;
+        Y += NormalDistribution(Generator) * 0.5f;
+        const float Z = Radius * glm::cos(Angle);
+
+        glm::mat4 InstanceMatrix = glm::translate(glm::identity<glm::mat4>(), { X, Y, Z });
+        constexpr float Scale = 0.01f;
+        InstanceMatrix = glm::scale(InstanceMatrix, { Scale, Scale, Scale });
+
+        ModelMatrices.emplace_back(InstanceMatrix);
+    }
+
+    return ModelMatrices;
+}
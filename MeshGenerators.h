@@ -0,0 +1,46 @@
+#pragma once
+
+#include "MeshArena.h"
+#include "MeshCache.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+class FWorkerPool;
+
+// Calcula seno e cosseno de varios angulos de uma vez. Usa SSE2 quando disponivel, 4 angulos por vez
+void SinCos(std::span<const float> InAngles, std::span<float> OutSin, std::span<float> OutCos);
+
+FMeshSize GetSphereSize(std::uint32_t InResolution);
+FMeshSize GetCylinderSize(std::uint32_t InResolution);
+
+// Escrevem a malha diretamente em OutVertices e OutIndices, que precisam ter exatamente o tamanho
+// retornado por Get*Size. As linhas da malha sao divididas entre os jobs do InWorkerPool
+void WriteSphere(std::uint32_t InResolution, std::span<FVertex> OutVertices, std::span<GLuint> OutIndices, FWorkerPool& InWorkerPool);
+void WriteCylinder(std::uint32_t InResolution, std::span<FVertex> OutVertices, std::span<GLuint> OutIndices, FWorkerPool& InWorkerPool);
+
+// Aloca a malha no arena e gera direto na memoria mapeada da GPU, sem copias intermediarias.
+// Com um InMeshCache a malha e lida do cache em disco, ou gerada direto no arquivo do cache na primeira vez
+FMeshHandle GenerateSphereMesh(FMeshArena& InMeshArena, FWorkerPool& InWorkerPool, std::uint32_t InResolution, FMeshCache* InMeshCache = nullptr);
+FMeshHandle GenerateCylinderMesh(FMeshArena& InMeshArena, FWorkerPool& InWorkerPool, std::uint32_t InResolution, FMeshCache* InMeshCache = nullptr);
+
+// Malha na memoria do processo, gerada fora da thread do OpenGL e enviada depois com FMeshArena::AddMesh
+struct FMeshData
+{
+    std::vector<FVertex> Vertices;
+    std::vector<GLuint> Indices;
+};
+
+// Mesmas malhas do Generate*Mesh sem tocar no OpenGL. InWorkerPool nao pode ser usado ao mesmo tempo por outra thread
+FMeshData GenerateSphereData(std::uint32_t InResolution, FWorkerPool& InWorkerPool, FMeshCache* InMeshCache = nullptr);
+FMeshData GenerateCylinderData(std::uint32_t InResolution, FWorkerPool& InWorkerPool, FMeshCache* InMeshCache = nullptr);
+
+// Quadrado de lado 1 com o canto em (0, 0) no plano XY e cubo de lado 1 centrado na origem
+FMeshData GenerateQuadData();
+FMeshData GenerateCubeData();
+
+// Matrizes de modelo das instancias distribuidas em espiral. A mesma semente gera sempre as mesmas instancias
+std::vector<glm::mat4> GenerateInstances(std::uint32_t InNumInstances, std::uint32_t InSeed);
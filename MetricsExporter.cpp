@@ -0,0 +1,269 @@
+#include "MetricsExporter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+namespace
+{
+    // Intervalo em que a thread acorda sem conexoes para esvaziar a fila e verificar se deve parar
+    constexpr std::chrono::milliseconds IdleTimeout{ 100 };
+
+    // Um cliente que nao termina de mandar o pedido ou de ler a resposta nesse tempo e desconectado
+    constexpr std::chrono::milliseconds RequestTimeout{ 1000 };
+    constexpr std::size_t MaxRequestSize = 8 * 1024;
+
+    void AppendValue(std::string& OutText, double InValue)
+    {
+        char Value[32];
+        std::snprintf(Value, sizeof(Value), "%.9g", InValue);
+        OutText += Value;
+    }
+
+    void AppendHeader(std::string& OutText, std::string_view InName, std::string_view InType, std::string_view InHelp)
+    {
+        OutText.append("# HELP ").append(InName).append(" ").append(InHelp).append("\n");
+        OutText.append("# TYPE ").append(InName).append(" ").append(InType).append("\n");
+    }
+
+    void AppendSample(std::string& OutText, std::string_view InName, std::string_view InLabels, double InValue)
+    {
+        OutText.append(InName);
+        if (!InLabels.empty())
+        {
+            OutText.append("{").append(InLabels).append("}");
+        }
+        OutText.append(" ");
+        AppendValue(OutText, InValue);
+        OutText.append("\n");
+    }
+}
+
+void FMetricsExporter::FHistogram::Add(double InValue)
+{
+    const auto BucketIt = std::lower_bound(BucketBounds.begin(), BucketBounds.end(), InValue);
+    BucketCounts[static_cast<std::size_t>(BucketIt - BucketBounds.begin())]++;
+    Sum += InValue;
+    Count++;
+}
+
+void FMetricsExporter::FHistogram::Write(std::string& OutText, std::string_view InName, std::string_view InLabels) const
+{
+    const std::string BucketName = std::string{ InName } + "_bucket";
+    const std::string LabelPrefix = InLabels.empty() ? std::string{} : std::string{ InLabels } + ",";
+
+    std::uint64_t CumulativeCount = 0;
+    for (std::size_t BucketIndex = 0; BucketIndex < BucketCounts.size(); ++BucketIndex)
+    {
+        CumulativeCount += BucketCounts[BucketIndex];
+
+        std::string Labels = LabelPrefix + "le=\"";
+        if (BucketIndex < BucketBounds.size())
+        {
+            AppendValue(Labels, BucketBounds[BucketIndex]);
+        }
+        else
+        {
+            Labels += "+Inf";
+        }
+        Labels += "\"";
+
+        AppendSample(OutText, BucketName, Labels, static_cast<double>(CumulativeCount));
+    }
+
+    AppendSample(OutText, std::string{ InName } + "_sum", InLabels, Sum);
+    AppendSample(OutText, std::string{ InName } + "_count", InLabels, static_cast<double>(Count));
+}
+
+FMetricsExporter::~FMetricsExporter()
+{
+    Stop();
+}
+
+bool FMetricsExporter::Start(std::uint16_t InPort)
+{
+    Stop();
+
+    if (!ListenSocket.Listen(InPort))
+    {
+        return false;
+    }
+
+    Port = InPort;
+    bStopRequested = false;
+    WorkerThread = std::thread{ &FMetricsExporter::Run, this };
+
+    std::cout << "Metricas em http://127.0.0.1:" << Port << "/metrics" << std::endl;
+    return true;
+}
+
+void FMetricsExporter::Stop()
+{
+    if (WorkerThread.joinable())
+    {
+        bStopRequested = true;
+        WorkerThread.join();
+    }
+    ListenSocket.Close();
+}
+
+void FMetricsExporter::AddSample(const FMetricsSample& InSample)
+{
+    if (!IsRunning())
+    {
+        return;
+    }
+
+    if (!Samples.TryPush(InSample))
+    {
+        NumDroppedSamples.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void FMetricsExporter::Run()
+{
+    while (!bStopRequested)
+    {
+        AggregateSamples();
+
+        if (!ListenSocket.WaitReadable(IdleTimeout))
+        {
+            continue;
+        }
+
+        FLocalSocket Connection = ListenSocket.Accept();
+        if (Connection.IsOpen())
+        {
+            HandleConnection(Connection);
+        }
+    }
+}
+
+void FMetricsExporter::AggregateSamples()
+{
+    FMetricsSample Sample;
+    while (Samples.TryPop(Sample))
+    {
+        NumFrames++;
+        FrameTimes.Add(Sample.FrameTime);
+        UpdateTimes.Add(Sample.UpdateTime);
+        RenderTimes.Add(Sample.RenderTime);
+
+        for (std::size_t PassIndex = 0; PassIndex < GPUPassTimes.size(); ++PassIndex)
+        {
+            if (Sample.GPUPassTimes[PassIndex] >= 0.0)
+            {
+                GPUPassTimes[PassIndex].Add(Sample.GPUPassTimes[PassIndex]);
+            }
+        }
+
+        LastSample = Sample;
+    }
+}
+
+void FMetricsExporter::HandleConnection(FLocalSocket& InConnection)
+{
+    // So a linha do pedido importa, mas o cabecalho inteiro e lido antes de responder
+    std::string Request;
+    std::array<char, 1024> Buffer;
+    while (Request.find("\r\n\r\n") == std::string::npos)
+    {
+        if (Request.size() > MaxRequestSize || !InConnection.WaitReadable(RequestTimeout))
+        {
+            return;
+        }
+
+        const std::int64_t NumReceived = InConnection.Receive(Buffer.data(), Buffer.size());
+        if (NumReceived <= 0)
+        {
+            return;
+        }
+        Request.append(Buffer.data(), static_cast<std::size_t>(NumReceived));
+    }
+
+    const std::string_view RequestLine = std::string_view{ Request }.substr(0, Request.find("\r\n"));
+    const bool bMetricsRequest = RequestLine.starts_with("GET /metrics ") || RequestLine.starts_with("GET /metrics?");
+
+    std::string Body;
+    std::string Status;
+    if (bMetricsRequest)
+    {
+        AggregateSamples();
+        Body = FormatMetrics();
+        Status = "200 OK";
+        NumScrapes.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        Body = "Use /metrics\n";
+        Status = "404 Not Found";
+    }
+
+    std::string Response = "HTTP/1.1 " + Status + "\r\n";
+    Response += "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n";
+    Response += "Content-Length: " + std::to_string(Body.size()) + "\r\n";
+    Response += "Connection: close\r\n\r\n";
+    Response += Body;
+    InConnection.SendAll(Response, RequestTimeout);
+}
+
+std::string FMetricsExporter::FormatMetrics() const
+{
+    std::string Text;
+    Text.reserve(16 * 1024);
+
+    AppendHeader(Text, "bluemarble_frames_total", "counter", "Frames rendered since the exporter started.");
+    AppendSample(Text, "bluemarble_frames_total", {}, static_cast<double>(NumFrames));
+
+    AppendHeader(Text, "bluemarble_metrics_dropped_samples_total", "counter", "Frame samples dropped because the exporter queue was full.");
+    AppendSample(Text, "bluemarble_metrics_dropped_samples_total", {}, static_cast<double>(NumDroppedSamples.load(std::memory_order_relaxed)));
+
+    AppendHeader(Text, "bluemarble_frame_time_seconds", "histogram", "Time between the end of consecutive frames.");
+    FrameTimes.Write(Text, "bluemarble_frame_time_seconds", {});
+
+    AppendHeader(Text, "bluemarble_update_time_seconds", "histogram", "CPU time of the simulation update of each frame.");
+    UpdateTimes.Write(Text, "bluemarble_update_time_seconds", {});
+
+    AppendHeader(Text, "bluemarble_render_time_seconds", "histogram", "CPU time spent recording and submitting each frame.");
+    RenderTimes.Write(Text, "bluemarble_render_time_seconds", {});
+
+    AppendHeader(Text, "bluemarble_gpu_pass_time_seconds", "histogram", "GPU time of each render pass, from timer queries.");
+    for (std::size_t PassIndex = 0; PassIndex < GPUPassTimes.size(); ++PassIndex)
+    {
+        const std::string Labels = std::string{ "pass=\"" } + GetGPUPassName(static_cast<EGPUPass>(PassIndex)) + "\"";
+        GPUPassTimes[PassIndex].Write(Text, "bluemarble_gpu_pass_time_seconds", Labels);
+    }
+
+    AppendHeader(Text, "bluemarble_draw_calls", "gauge", "Draw calls issued in the last frame.");
+    AppendSample(Text, "bluemarble_draw_calls", {}, LastSample.NumDrawCalls);
+
+    AppendHeader(Text, "bluemarble_draw_packets", "gauge", "Draw packets submitted in the last frame.");
+    AppendSample(Text, "bluemarble_draw_packets", {}, LastSample.NumDrawPackets);
+
+    AppendHeader(Text, "bluemarble_instances", "gauge", "Instances drawn in the last frame.");
+    AppendSample(Text, "bluemarble_instances", {}, LastSample.NumInstances);
+
+    AppendHeader(Text, "bluemarble_render_scale", "gauge", "Scene resolution as a fraction of the window resolution.");
+    AppendSample(Text, "bluemarble_render_scale", {}, LastSample.RenderScale);
+
+    AppendHeader(Text, "bluemarble_shader_reloads_total", "counter", "Shader programs rebuilt by hot reload.");
+    AppendSample(Text, "bluemarble_shader_reloads_total", "result=\"success\"", LastSample.NumShaderReloads);
+    AppendSample(Text, "bluemarble_shader_reloads_total", "result=\"failure\"", LastSample.NumFailedShaderReloads);
+
+    AppendHeader(Text, "bluemarble_gpu_memory_bytes", "gauge", "Estimated GPU memory of the registered OpenGL objects.");
+    for (std::size_t TypeIndex = 0; TypeIndex < LastSample.GPUResources.size(); ++TypeIndex)
+    {
+        const std::string Labels = std::string{ "type=\"" } + FGPUResourceRegistry::GetTypeName(static_cast<EGPUResourceType>(TypeIndex)) + "\"";
+        AppendSample(Text, "bluemarble_gpu_memory_bytes", Labels, static_cast<double>(LastSample.GPUResources[TypeIndex].Size));
+    }
+
+    AppendHeader(Text, "bluemarble_gpu_resources", "gauge", "Registered OpenGL objects.");
+    for (std::size_t TypeIndex = 0; TypeIndex < LastSample.GPUResources.size(); ++TypeIndex)
+    {
+        const std::string Labels = std::string{ "type=\"" } + FGPUResourceRegistry::GetTypeName(static_cast<EGPUResourceType>(TypeIndex)) + "\"";
+        AppendSample(Text, "bluemarble_gpu_resources", Labels, LastSample.GPUResources[TypeIndex].NumResources);
+    }
+
+    return Text;
+}
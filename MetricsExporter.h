@@ -0,0 +1,101 @@
+#pragma once
+
+#include "GPUResourceRegistry.h"
+#include "GPUTimer.h"
+#include "LocalSocket.h"
+#include "SPSCQueue.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <thread>
+
+// Dados de um frame enviados pela thread do OpenGL, tempos em segundos
+struct FMetricsSample
+{
+    double FrameTime = 0.0;
+    double UpdateTime = 0.0;
+    double RenderTime = 0.0;
+
+    // Negativo quando nenhuma medicao da passada chegou neste frame
+    std::array<double, static_cast<std::size_t>(EGPUPass::Count)> GPUPassTimes{};
+
+    std::uint32_t NumDrawCalls = 0;
+    std::uint32_t NumDrawPackets = 0;
+    std::uint32_t NumInstances = 0;
+    float RenderScale = 1.0f;
+
+    // Contados desde o inicio do programa
+    std::uint32_t NumShaderReloads = 0;
+    std::uint32_t NumFailedShaderReloads = 0;
+
+    std::array<FGPUResourceTotals, static_cast<std::size_t>(EGPUResourceType::Count)> GPUResources{};
+};
+
+// Exporta as metricas no formato texto do Prometheus em http://127.0.0.1:<porta>/metrics. A thread do OpenGL
+// so coloca uma amostra por frame em uma fila sem locks e nunca espera pelo servidor: com a fila cheia a amostra
+// e descartada. A thread do exportador agrega as amostras em histogramas e responde os scrapes
+class FMetricsExporter
+{
+public:
+
+    FMetricsExporter() = default;
+    ~FMetricsExporter();
+
+    FMetricsExporter(const FMetricsExporter&) = delete;
+    FMetricsExporter& operator=(const FMetricsExporter&) = delete;
+
+    bool Start(std::uint16_t InPort);
+    void Stop();
+
+    bool IsRunning() const { return WorkerThread.joinable(); }
+    std::uint16_t GetPort() const { return Port; }
+
+    // Chamado apenas pela thread do OpenGL, uma vez por frame
+    void AddSample(const FMetricsSample& InSample);
+
+    std::uint64_t GetNumScrapes() const { return NumScrapes.load(std::memory_order_relaxed); }
+    std::uint64_t GetNumDroppedSamples() const { return NumDroppedSamples.load(std::memory_order_relaxed); }
+
+private:
+
+    // Histograma cumulativo do Prometheus com os limites em segundos
+    struct FHistogram
+    {
+        static constexpr std::array<double, 16> BucketBounds = { 0.001, 0.002, 0.004, 0.006, 0.008, 0.010, 0.0125, 0.015,
+                                                                 0.01667, 0.020, 0.025, 0.0333, 0.050, 0.100, 0.250, 0.500 };
+
+        // Amostras de cada bucket sem acumular, a ultima posicao e o +Inf
+        std::array<std::uint64_t, BucketBounds.size() + 1> BucketCounts{};
+        double Sum = 0.0;
+        std::uint64_t Count = 0;
+
+        void Add(double InValue);
+        void Write(std::string& OutText, std::string_view InName, std::string_view InLabels) const;
+    };
+
+    // Chamados apenas pela thread do exportador
+    void Run();
+    void AggregateSamples();
+    void HandleConnection(FLocalSocket& InConnection);
+    std::string FormatMetrics() const;
+
+    TSPSCQueue<FMetricsSample, 1024> Samples;
+    std::atomic<std::uint64_t> NumDroppedSamples{ 0 };
+    std::atomic<std::uint64_t> NumScrapes{ 0 };
+
+    std::atomic<bool> bStopRequested{ false };
+    FLocalSocket ListenSocket;
+    std::thread WorkerThread;
+    std::uint16_t Port = 0;
+
+    // Estado agregado, so acessado pela thread do exportador
+    std::uint64_t NumFrames = 0;
+    FHistogram FrameTimes;
+    FHistogram UpdateTimes;
+    FHistogram RenderTimes;
+    std::array<FHistogram, static_cast<std::size_t>(EGPUPass::Count)> GPUPassTimes;
+    FMetricsSample LastSample;
+};
@@ -0,0 +1,293 @@
+#include "RenderQueue.h"
+
+#include "GLStateCache.h"
+#include "GPUResourceRegistry.h"
+#include "WorkerPool.h"
+
+#include <algorithm>
+#include <cstring>
+
+std::uint64_t FRenderQueue::MakeSortKey(const FDrawPacket& InPacket, float InFarPlane)
+{
+    constexpr std::uint64_t DepthMask = (1ull << 24) - 1;
+    constexpr std::uint64_t StateMask = (1ull << 12) - 1;
+
+    const float NormalizedDepth = std::clamp(InPacket.ViewDepth / InFarPlane, 0.0f, 1.0f);
+    std::uint64_t Depth = static_cast<std::uint64_t>(NormalizedDepth * static_cast<float>(DepthMask));
+
+    std::uint64_t TextureHash = 0;
+    for (const GLuint Texture : InPacket.Textures)
+    {
+        TextureHash = TextureHash * 31 + Texture;
+    }
+
+    const std::uint64_t Pass = static_cast<std::uint64_t>(InPacket.Pass);
+    const std::uint64_t Program = InPacket.ProgramId & StateMask;
+    const std::uint64_t VAO = InPacket.VAO & StateMask;
+    const std::uint64_t Textures = TextureHash & StateMask;
+
+    if (InPacket.Pass == ERenderPass::Translucent)
+    {
+        // Objetos translucidos precisam ser desenhados de tras para frente, a profundidade vem antes do estado
+        Depth = DepthMask - Depth;
+        return (Pass << 60) | (Depth << 36) | (Program << 24) | (VAO << 12) | Textures;
+    }
+
+    // Objetos opacos sao agrupados por estado e desenhados de frente para tras para aproveitar o early-Z
+    return (Pass << 60) | (Program << 48) | (VAO << 36) | (Textures << 24) | Depth;
+}
+
+
+void FRenderQueue::RadixSort()
+{
+    constexpr std::uint32_t RadixBits = 8;
+    constexpr std::uint32_t NumBuckets = 1 << RadixBits;
+    constexpr std::uint32_t NumPasses = 64 / RadixBits;
+
+    SortScratch.resize(SortEntries.size());
+
+    for (std::uint32_t PassIndex = 0; PassIndex < NumPasses; ++PassIndex)
+    {
+        const std::uint32_t Shift = PassIndex * RadixBits;
+
+        std::array<std::uint32_t, NumBuckets> Offsets{};
+        for (const FSortEntry& Entry : SortEntries)
+        {
+            Offsets[(Entry.Key >> Shift) & (NumBuckets - 1)]++;
+        }
+
+        // Todas as chaves tem o mesmo digito, nao ha nada para reordenar neste passe
+        if (std::find(Offsets.begin(), Offsets.end(), static_cast<std::uint32_t>(SortEntries.size())) != Offsets.end())
+        {
+            continue;
+        }
+
+        std::uint32_t Sum = 0;
+        for (std::uint32_t& Offset : Offsets)
+        {
+            const std::uint32_t Count = Offset;
+            Offset = Sum;
+            Sum += Count;
+        }
+
+        for (const FSortEntry& Entry : SortEntries)
+        {
+            SortScratch[Offsets[(Entry.Key >> Shift) & (NumBuckets - 1)]++] = Entry;
+        }
+
+        std::swap(SortEntries, SortScratch);
+    }
+}
+
+void FRenderQueue::UploadModelData(FGLStateCache& InStateCache)
+{
+    if (ModelUBO == 0)
+    {
+        GLint UniformBufferOffsetAlignment = 0;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &UniformBufferOffsetAlignment);
+        const GLsizeiptr Alignment = std::max<GLsizeiptr>(UniformBufferOffsetAlignment, 1);
+        ModelDataStride = (static_cast<GLsizeiptr>(sizeof(FPerModelData)) + Alignment - 1) / Alignment * Alignment;
+
+        ModelUBO = FGPUResourceRegistry::Get().CreateBuffer("Render Queue Model UBO");
+    }
+
+    const GLsizeiptr DataSize = static_cast<GLsizeiptr>(SortEntries.size()) * ModelDataStride;
+    ModelDataStaging.resize(DataSize);
+
+    for (std::size_t EntryIndex = 0; EntryIndex < SortEntries.size(); ++EntryIndex)
+    {
+        const FSortEntry& Entry = SortEntries[EntryIndex];
+        const FDrawPacket& Packet = Recorders[Entry.RecorderIndex].Packets[Entry.PacketIndex];
+        std::memcpy(ModelDataStaging.data() + EntryIndex * ModelDataStride, &Packet.ModelData, sizeof(FPerModelData));
+    }
+
+    InStateCache.BindBuffer(GL_UNIFORM_BUFFER, ModelUBO);
+    if (DataSize > ModelUBOSize)
+    {
+        ModelUBOSize = std::max(DataSize, ModelUBOSize * 2);
+        FGPUResourceRegistry::Get().SetSize(EGPUResourceType::Buffer, ModelUBO, ModelUBOSize);
+    }
+
+    // Descarta o conteudo anterior para nao esperar a GPU terminar de usar o frame passado
+    glBufferData(GL_UNIFORM_BUFFER, ModelUBOSize, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, DataSize, ModelDataStaging.data());
+}
+
+bool FRenderQueue::CanBatch(const FDrawPacket& InFirst, const FDrawPacket& InSecond)
+{
+    if (!InFirst.bIndexed || !InSecond.bIndexed)
+    {
+        return false;
+    }
+
+    const bool bSameState = InFirst.Pass == InSecond.Pass &&
+                            InFirst.ProgramId == InSecond.ProgramId &&
+                            InFirst.VAO == InSecond.VAO &&
+                            InFirst.PrimitiveType == InSecond.PrimitiveType &&
+                            InFirst.PolygonMode == InSecond.PolygonMode &&
+                            InFirst.Textures == InSecond.Textures &&
+                            InFirst.UniformBlocks == InSecond.UniformBlocks &&
+                            InFirst.Uniforms == InSecond.Uniforms &&
+                            InFirst.ModelBlock == InSecond.ModelBlock;
+    if (!bSameState)
+    {
+        return false;
+    }
+
+    // O lote usa os dados de modelo do primeiro pacote
+    return InFirst.ModelBlock == nullptr || std::memcmp(&InFirst.ModelData, &InSecond.ModelData, sizeof(FPerModelData)) == 0;
+}
+
+void FRenderQueue::BuildBatches()
+{
+    Batches.clear();
+    IndirectCommands.clear();
+
+    const FDrawPacket* PreviousPacket = nullptr;
+    for (std::size_t EntryIndex = 0; EntryIndex < SortEntries.size(); ++EntryIndex)
+    {
+        const FSortEntry& Entry = SortEntries[EntryIndex];
+        const FDrawPacket& Packet = Recorders[Entry.RecorderIndex].Packets[Entry.PacketIndex];
+        if (Packet.NumInstances == 0)
+        {
+            continue;
+        }
+
+        if (PreviousPacket == nullptr || !CanBatch(*PreviousPacket, Packet))
+        {
+            Batches.push_back(FDrawBatch{ .FirstEntry = static_cast<std::uint32_t>(EntryIndex), .FirstCommand = static_cast<std::uint32_t>(IndirectCommands.size()), .NumCommands = 0 });
+        }
+
+        if (Packet.bIndexed)
+        {
+            IndirectCommands.push_back(FDrawElementsIndirectCommand{ .Count = static_cast<GLuint>(Packet.NumElements),
+                                                                     .InstanceCount = static_cast<GLuint>(Packet.NumInstances),
+                                                                     .FirstIndex = Packet.FirstIndex,
+                                                                     .BaseVertex = Packet.BaseVertex,
+                                                                     .BaseInstance = Packet.BaseInstance });
+            Batches.back().NumCommands++;
+        }
+
+        PreviousPacket = &Packet;
+    }
+
+    if (IndirectCommands.empty())
+    {
+        return;
+    }
+
+    if (IndirectBuffer == 0)
+    {
+        IndirectBuffer = FGPUResourceRegistry::Get().CreateBuffer("Render Queue Indirect Commands");
+    }
+
+    // GL_DRAW_INDIRECT_BUFFER so e usado pela fila, entao fica ligado direto sem passar pelo FGLStateCache
+    const GLsizeiptr CommandsSize = static_cast<GLsizeiptr>(IndirectCommands.size() * sizeof(FDrawElementsIndirectCommand));
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, IndirectBuffer);
+    if (CommandsSize > IndirectBufferSize)
+    {
+        IndirectBufferSize = std::max(CommandsSize, IndirectBufferSize * 2);
+        FGPUResourceRegistry::Get().SetSize(EGPUResourceType::Buffer, IndirectBuffer, IndirectBufferSize);
+    }
+
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, IndirectBufferSize, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, CommandsSize, IndirectCommands.data());
+}
+
+void FRenderQueue::ApplyPacketState(FGLStateCache& InStateCache, const FDrawPacket& InPacket, std::size_t InEntryIndex)
+{
+    InStateCache.UseProgram(InPacket.ProgramId);
+
+    for (const FDrawUniformBlock& Block : InPacket.UniformBlocks)
+    {
+        const GLint Binding = Block.Handle ? Block.Handle->Get() : -1;
+        if (Binding >= 0)
+        {
+            InStateCache.BindBufferRange(GL_UNIFORM_BUFFER, Binding, Block.Buffer, 0, Block.Size);
+        }
+    }
+
+    const GLint ModelBlockBinding = InPacket.ModelBlock ? InPacket.ModelBlock->Get() : -1;
+    if (ModelBlockBinding >= 0)
+    {
+        InStateCache.BindBufferRange(GL_UNIFORM_BUFFER, ModelBlockBinding, ModelUBO, InEntryIndex * ModelDataStride, sizeof(FPerModelData));
+    }
+
+    for (GLuint TextureUnit = 0; TextureUnit < InPacket.Textures.size(); ++TextureUnit)
+    {
+        if (InPacket.Textures[TextureUnit] != 0)
+        {
+            InStateCache.BindTexture(TextureUnit, GL_TEXTURE_2D, InPacket.Textures[TextureUnit]);
+        }
+    }
+
+    for (const FDrawUniform& Uniform : InPacket.Uniforms)
+    {
+        const GLint Location = Uniform.Handle ? Uniform.Handle->Get() : -1;
+        if (Location >= 0)
+        {
+            glUniform1i(Location, Uniform.Value);
+        }
+    }
+
+    InStateCache.SetPolygonMode(InPacket.PolygonMode);
+    InStateCache.BindVertexArray(InPacket.VAO);
+}
+
+void FRenderQueue::Submit(FGLStateCache& InStateCache, float InFarPlane)
+{
+    SortEntries.clear();
+    for (std::uint32_t RecorderIndex = 0; RecorderIndex < Recorders.size(); ++RecorderIndex)
+    {
+        const std::vector<FDrawPacket>& Packets = Recorders[RecorderIndex].Packets;
+        for (std::uint32_t PacketIndex = 0; PacketIndex < Packets.size(); ++PacketIndex)
+        {
+            SortEntries.push_back(FSortEntry{ .Key = MakeSortKey(Packets[PacketIndex], InFarPlane), .RecorderIndex = RecorderIndex, .PacketIndex = PacketIndex });
+        }
+    }
+
+    NumSubmittedPackets = static_cast<std::uint32_t>(SortEntries.size());
+    NumDrawCalls = 0;
+    if (SortEntries.empty())
+    {
+        return;
+    }
+
+    RadixSort();
+    UploadModelData(InStateCache);
+    BuildBatches();
+
+    for (const FDrawBatch& Batch : Batches)
+    {
+        const FSortEntry& Entry = SortEntries[Batch.FirstEntry];
+        const FDrawPacket& Packet = Recorders[Entry.RecorderIndex].Packets[Entry.PacketIndex];
+
+        ApplyPacketState(InStateCache, Packet, Batch.FirstEntry);
+        NumDrawCalls++;
+
+        if (Packet.bIndexed)
+        {
+            const GLintptr CommandOffset = Batch.FirstCommand * sizeof(FDrawElementsIndirectCommand);
+            glMultiDrawElementsIndirect(Packet.PrimitiveType, GL_UNSIGNED_INT, reinterpret_cast<const void*>(CommandOffset), Batch.NumCommands, 0);
+        }
+        else
+        {
+            Packet.NumInstances == 1 ? glDrawArrays(Packet.PrimitiveType, 0, Packet.NumElements)
+                                     : glDrawArraysInstanced(Packet.PrimitiveType, 0, Packet.NumElements, Packet.NumInstances);
+        }
+    }
+
+    for (FDrawPacketRecorder& Recorder : Recorders)
+    {
+        Recorder.Packets.clear();
+    }
+}
+
+void FRenderQueue::Shutdown()
+{
+    FGPUResourceRegistry& Registry = FGPUResourceRegistry::Get();
+    Registry.Delete(EGPUResourceType::Buffer, ModelUBO);
+    Registry.Delete(EGPUResourceType::Buffer, IndirectBuffer);
+    ModelUBOSize = 0;
+    IndirectBufferSize = 0;
+}
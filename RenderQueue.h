@@ -0,0 +1,179 @@
+#pragma once
+
+#include "ShaderManager.h"
+#include "WorkerPool.h"
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+class FGLStateCache;
+
+struct FPerModelData
+{
+    glm::mat4 ModelMatrix;
+    glm::mat4 NormalMatrix;
+};
+
+// Os passes sao desenhados na ordem em que aparecem aqui
+enum class ERenderPass : std::uint8_t
+{
+    Opaque,
+    Translucent,
+    Count
+};
+
+// Os handles so sao resolvidos no Submit, na thread do OpenGL, entao os jobs de gravacao nunca os modificam
+struct FDrawUniformBlock
+{
+    const FUniformBlockHandle* Handle = nullptr;
+    GLuint Buffer = 0;
+    GLsizeiptr Size = 0;
+
+    bool operator==(const FDrawUniformBlock&) const = default;
+};
+
+struct FDrawUniform
+{
+    const FUniformHandle* Handle = nullptr;
+    GLint Value = 0;
+
+    bool operator==(const FDrawUniform&) const = default;
+};
+
+struct FDrawPacket
+{
+    static constexpr std::uint32_t MaxTextures = 2;
+    static constexpr std::uint32_t MaxUniformBlocks = 3;
+    static constexpr std::uint32_t MaxUniforms = 4;
+
+    ERenderPass Pass = ERenderPass::Opaque;
+
+    // Distancia ate a camera no espaco de visao, usada para ordenar os pacotes do mesmo estado
+    float ViewDepth = 0.0f;
+
+    GLuint ProgramId = 0;
+    GLuint VAO = 0;
+    GLenum PrimitiveType = GL_TRIANGLES;
+    GLenum PolygonMode = GL_FILL;
+    bool bIndexed = true;
+    GLsizei NumElements = 0;
+    GLsizei NumInstances = 1;
+
+    // Posicao da malha e das instancias dentro dos buffers compartilhados do FMeshArena
+    GLuint FirstIndex = 0;
+    GLint BaseVertex = 0;
+    GLuint BaseInstance = 0;
+
+    // Cada textura e ligada na unidade de mesmo indice
+    std::array<GLuint, MaxTextures> Textures{};
+    std::array<FDrawUniformBlock, MaxUniformBlocks> UniformBlocks{};
+    std::array<FDrawUniform, MaxUniforms> Uniforms{};
+
+    // Os dados de modelo de todos os pacotes sao enviados juntos para um unico UBO
+    const FUniformBlockHandle* ModelBlock = nullptr;
+    FPerModelData ModelData;
+};
+
+// Pacotes gravados por um unico job. A memoria e reaproveitada entre os frames
+class FDrawPacketRecorder
+{
+public:
+
+    FDrawPacket& AddPacket() { return Packets.emplace_back(); }
+
+private:
+
+    friend class FRenderQueue;
+    std::vector<FDrawPacket> Packets;
+};
+
+// Fila de desenho: os pacotes podem ser gravados em paralelo, cada job no seu proprio recorder,
+// e sao ordenados por uma chave de 64 bits antes de serem enviados pela thread do OpenGL.
+// Pacotes indexados consecutivos com o mesmo estado viram um unico glMultiDrawElementsIndirect
+class FRenderQueue
+{
+public:
+
+    // Chave: passe (4 bits) | programa (12 bits) | VAO (12 bits) | texturas (12 bits) | profundidade (24 bits)
+    static std::uint64_t MakeSortKey(const FDrawPacket& InPacket, float InFarPlane);
+
+    // Executa InRecordJob(Recorder, JobIndex) para cada job usando o InWorkerPool. O job e passado por
+    // referencia, entao o std::function do ParallelFor guarda so dois ponteiros e nao aloca memoria
+    template<typename RecordJobType>
+    void Record(FWorkerPool& InWorkerPool, std::uint32_t InNumJobs, const RecordJobType& InRecordJob)
+    {
+        if (Recorders.size() < InNumJobs)
+        {
+            Recorders.resize(InNumJobs);
+        }
+
+        InWorkerPool.ParallelFor(InNumJobs, [this, &InRecordJob](std::uint32_t JobIndex)
+        {
+            InRecordJob(Recorders[JobIndex], JobIndex);
+        });
+    }
+
+    // Ordena e envia todos os pacotes gravados desde o ultimo Submit
+    void Submit(FGLStateCache& InStateCache, float InFarPlane);
+
+    // Apaga os buffers da fila
+    void Shutdown();
+
+    std::uint32_t GetNumSubmittedPackets() const { return NumSubmittedPackets; }
+    std::uint32_t GetNumDrawCalls() const { return NumDrawCalls; }
+
+private:
+
+    struct FSortEntry
+    {
+        std::uint64_t Key;
+        std::uint32_t RecorderIndex;
+        std::uint32_t PacketIndex;
+    };
+
+    // Mesmo layout do comando lido pelo glMultiDrawElementsIndirect
+    struct FDrawElementsIndirectCommand
+    {
+        GLuint Count;
+        GLuint InstanceCount;
+        GLuint FirstIndex;
+        GLint BaseVertex;
+        GLuint BaseInstance;
+    };
+
+    struct FDrawBatch
+    {
+        std::uint32_t FirstEntry;
+        std::uint32_t FirstCommand;
+        std::uint32_t NumCommands;
+    };
+
+    static bool CanBatch(const FDrawPacket& InFirst, const FDrawPacket& InSecond);
+
+    void RadixSort();
+
+    void UploadModelData(FGLStateCache& InStateCache);
+
+    void BuildBatches();
+
+    void ApplyPacketState(FGLStateCache& InStateCache, const FDrawPacket& InPacket, std::size_t InEntryIndex);
+
+    std::vector<FDrawPacketRecorder> Recorders;
+    std::vector<FSortEntry> SortEntries;
+    std::vector<FSortEntry> SortScratch;
+    std::vector<std::uint8_t> ModelDataStaging;
+    std::vector<FDrawBatch> Batches;
+    std::vector<FDrawElementsIndirectCommand> IndirectCommands;
+    GLuint IndirectBuffer = 0;
+    GLsizeiptr IndirectBufferSize = 0;
+    GLuint ModelUBO = 0;
+    GLsizeiptr ModelUBOSize = 0;
+    GLsizeiptr ModelDataStride = 0;
+    std::uint32_t NumSubmittedPackets = 0;
+    std::uint32_t NumDrawCalls = 0;
+};
@@ -0,0 +1,70 @@
+#include "RenderTarget.h"
+
+#include "GPUResourceRegistry.h"
+
+#include <algorithm>
+#include <iostream>
+
+void FRenderTarget::Initialize(std::int32_t InWidth, std::int32_t InHeight, std::string_view InLabel)
+{
+    Label = InLabel;
+    if (Framebuffer == 0)
+    {
+        Framebuffer = FGPUResourceRegistry::Get().CreateFramebuffer(Label);
+    }
+
+    Width = 0;
+    Height = 0;
+    Resize(InWidth, InHeight);
+}
+
+void FRenderTarget::Resize(std::int32_t InWidth, std::int32_t InHeight)
+{
+    if (InWidth == Width && InHeight == Height)
+    {
+        return;
+    }
+
+    DeleteTextures();
+
+    Width = std::max(InWidth, 1);
+    Height = std::max(InHeight, 1);
+
+    // Texturas imutaveis, mudar o tamanho sempre cria texturas novas
+    FGPUResourceRegistry& Registry = FGPUResourceRegistry::Get();
+    ColorTexture = Registry.CreateTexture(GL_TEXTURE_2D, Label + " Color");
+    glTextureStorage2D(ColorTexture, 1, GL_RGBA8, Width, Height);
+    glTextureParameteri(ColorTexture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTextureParameteri(ColorTexture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTextureParameteri(ColorTexture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(ColorTexture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    Registry.SetSize(EGPUResourceType::Texture, ColorTexture, static_cast<std::int64_t>(Width) * Height * 4);
+
+    DepthTexture = Registry.CreateTexture(GL_TEXTURE_2D, Label + " Depth");
+    glTextureStorage2D(DepthTexture, 1, GL_DEPTH_COMPONENT32F, Width, Height);
+    Registry.SetSize(EGPUResourceType::Texture, DepthTexture, static_cast<std::int64_t>(Width) * Height * 4);
+
+    glNamedFramebufferTexture(Framebuffer, GL_COLOR_ATTACHMENT0, ColorTexture, 0);
+    glNamedFramebufferTexture(Framebuffer, GL_DEPTH_ATTACHMENT, DepthTexture, 0);
+
+    const GLenum Status = glCheckNamedFramebufferStatus(Framebuffer, GL_FRAMEBUFFER);
+    if (Status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cout << "Render target '" << Label << "' incompleto: 0x" << std::hex << Status << std::dec << std::endl;
+    }
+}
+
+void FRenderTarget::DeleteTextures()
+{
+    FGPUResourceRegistry& Registry = FGPUResourceRegistry::Get();
+    Registry.Delete(EGPUResourceType::Texture, ColorTexture);
+    Registry.Delete(EGPUResourceType::Texture, DepthTexture);
+}
+
+void FRenderTarget::Shutdown()
+{
+    DeleteTextures();
+    FGPUResourceRegistry::Get().Delete(EGPUResourceType::Framebuffer, Framebuffer);
+    Width = 0;
+    Height = 0;
+}
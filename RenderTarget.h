@@ -0,0 +1,41 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Framebuffer fora da tela com uma textura de cor RGBA8 e uma de profundidade. Usado quando nao ha
+// janela visivel (modo headless) e para renderizar em resolucoes diferentes da janela
+class FRenderTarget
+{
+public:
+
+    // Cria as texturas com o tamanho pedido. Pode ser chamado de novo para mudar o tamanho
+    void Initialize(std::int32_t InWidth, std::int32_t InHeight, std::string_view InLabel);
+
+    // So recria as texturas se o tamanho mudou
+    void Resize(std::int32_t InWidth, std::int32_t InHeight);
+
+    void Shutdown();
+
+    bool IsValid() const { return Framebuffer != 0; }
+
+    GLuint GetFramebuffer() const { return Framebuffer; }
+    GLuint GetColorTexture() const { return ColorTexture; }
+    GLuint GetDepthTexture() const { return DepthTexture; }
+    std::int32_t GetWidth() const { return Width; }
+    std::int32_t GetHeight() const { return Height; }
+
+private:
+
+    void DeleteTextures();
+
+    std::string Label;
+    GLuint Framebuffer = 0;
+    GLuint ColorTexture = 0;
+    GLuint DepthTexture = 0;
+    std::int32_t Width = 0;
+    std::int32_t Height = 0;
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <new>
+
+// Fila de tamanho fixo sem locks para exatamente uma thread produtora e uma consumidora
+template<typename T, std::size_t Capacity>
+class TSPSCQueue
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity deve ser uma potencia de 2");
+
+public:
+
+    // Chamado apenas pela thread produtora. Retorna false se a fila estiver cheia
+    bool TryPush(T&& InItem)
+    {
+        const std::size_t CurrentTail = Tail.load(std::memory_order_relaxed);
+        if (CurrentTail - Head.load(std::memory_order_acquire) == Capacity)
+        {
+            return false;
+        }
+
+        Items[CurrentTail & Mask] = std::move(InItem);
+        Tail.store(CurrentTail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool TryPush(const T& InItem)
+    {
+        T Item = InItem;
+        return TryPush(std::move(Item));
+    }
+
+    // Chamado apenas pela thread consumidora. Retorna false se a fila estiver vazia
+    bool TryPop(T& OutItem)
+    {
+        const std::size_t CurrentHead = Head.load(std::memory_order_relaxed);
+        if (CurrentHead == Tail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        OutItem = std::move(Items[CurrentHead & Mask]);
+        Head.store(CurrentHead + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool IsEmpty() const
+    {
+        return Head.load(std::memory_order_acquire) == Tail.load(std::memory_order_acquire);
+    }
+
+private:
+
+    static constexpr std::size_t Mask = Capacity - 1;
+    static constexpr std::size_t CacheLineSize = 64;
+
+    std::array<T, Capacity> Items{};
+    alignas(CacheLineSize) std::atomic<std::size_t> Head{ 0 };
+    alignas(CacheLineSize) std::atomic<std::size_t> Tail{ 0 };
+};
@@ -0,0 +1,373 @@
+#include "Scene.h"
+
+#include "Json.h"
+#include "MeshCache.h"
+
+#include <glm/ext.hpp>
+
+#include <array>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+    constexpr std::array<const char*, 4> SceneMeshNames = { "sphere", "cylinder", "cube", "quad" };
+
+    double ToSeconds(std::chrono::steady_clock::duration InDuration)
+    {
+        return std::chrono::duration<double>(InDuration).count();
+    }
+
+    bool ReadVec3(FJsonObjectReader& InReader, std::string_view InKey, glm::vec3& InOutValue)
+    {
+        return InReader.ReadFloats(InKey, &InOutValue.x, 3);
+    }
+
+    // Secao opcional do arquivo. Registra o erro em OutError se o membro existe mas nao e um objeto
+    const FJsonValue* FindSection(const FJsonValue& InRoot, std::string_view InKey, std::string& OutError)
+    {
+        const FJsonValue* Section = InRoot.Find(InKey);
+        if (Section != nullptr && !Section->IsObject())
+        {
+            OutError = "\"" + std::string{ InKey } + "\" deve ser um objeto";
+            return nullptr;
+        }
+        return Section;
+    }
+}
+
+const char* GetSceneMeshName(ESceneMesh InMesh)
+{
+    return SceneMeshNames[static_cast<std::size_t>(InMesh)];
+}
+
+std::optional<ESceneMesh> ParseSceneMesh(std::string_view InName)
+{
+    for (std::size_t MeshIndex = 0; MeshIndex < SceneMeshNames.size(); ++MeshIndex)
+    {
+        if (InName == SceneMeshNames[MeshIndex])
+        {
+            return static_cast<ESceneMesh>(MeshIndex);
+        }
+    }
+    return std::nullopt;
+}
+
+glm::mat4 FSceneDescription::GetTransform() const
+{
+    glm::mat4 Transform = glm::translate(glm::identity<glm::mat4>(), Location);
+    Transform = glm::rotate(Transform, glm::radians(Rotation.x), { 1.0f, 0.0f, 0.0f });
+    Transform = glm::rotate(Transform, glm::radians(Rotation.y), { 0.0f, 1.0f, 0.0f });
+    Transform = glm::rotate(Transform, glm::radians(Rotation.z), { 0.0f, 0.0f, 1.0f });
+    return glm::scale(Transform, Scale);
+}
+
+bool FSceneDescription::Parse(std::string_view InText, FSceneDescription& OutDescription, std::string& OutError)
+{
+    FJsonValue Root;
+    if (!FJsonValue::Parse(InText, Root, OutError))
+    {
+        return false;
+    }
+
+    if (!Root.IsObject())
+    {
+        OutError = "a cena deve ser um objeto";
+        return false;
+    }
+
+    // Cada secao e lida sobre os valores de OutDescription, que so e alterada no fim
+    FSceneDescription Description = OutDescription;
+    FJsonObjectReader RootReader{ Root };
+    RootReader.Read("name", Description.Name);
+    if (RootReader.HasError())
+    {
+        OutError = RootReader.GetError();
+        return false;
+    }
+
+    const auto ReadSection = [&Root, &OutError](std::string_view InKey, const auto& InReadMembers)
+    {
+        const FJsonValue* Section = FindSection(Root, InKey, OutError);
+        if (Section == nullptr)
+        {
+            return OutError.empty();
+        }
+
+        FJsonObjectReader Reader{ *Section };
+        InReadMembers(Reader);
+        if (Reader.HasError() && OutError.empty())
+        {
+            OutError = std::string{ InKey } + ": " + Reader.GetError();
+        }
+        return OutError.empty();
+    };
+
+    const bool bValid =
+        ReadSection("mesh", [&Description, &OutError](FJsonObjectReader& Reader)
+        {
+            std::string MeshName = GetSceneMeshName(Description.Mesh);
+            if (Reader.Read("type", MeshName))
+            {
+                const std::optional<ESceneMesh> Mesh = ParseSceneMesh(MeshName);
+                if (!Mesh)
+                {
+                    OutError = "mesh: tipo desconhecido \"" + MeshName + "\"";
+                    return;
+                }
+                Description.Mesh = *Mesh;
+            }
+            Reader.Read("resolution", Description.MeshResolution);
+        })
+        && ReadSection("transform", [&Description](FJsonObjectReader& Reader)
+        {
+            ReadVec3(Reader, "location", Description.Location);
+            ReadVec3(Reader, "rotation", Description.Rotation);
+            ReadVec3(Reader, "scale", Description.Scale);
+        })
+        && ReadSection("shaders", [&Description](FJsonObjectReader& Reader)
+        {
+            Reader.Read("vertex", Description.VertexShader);
+            Reader.Read("fragment", Description.FragmentShader);
+        })
+        && ReadSection("textures", [&Description](FJsonObjectReader& Reader)
+        {
+            Reader.Read("earth", Description.EarthTexture);
+            Reader.Read("clouds", Description.CloudsTexture);
+        })
+        && ReadSection("camera", [&Description](FJsonObjectReader& Reader)
+        {
+            Reader.Read("ortho", Description.bOrthoCamera);
+
+            glm::vec3 Vector{ 0.0f, 0.0f, 0.0f };
+            if (ReadVec3(Reader, "location", Vector))
+            {
+                Description.CameraLocation = Vector;
+            }
+            if (ReadVec3(Reader, "direction", Vector))
+            {
+                Description.CameraDirection = Vector;
+            }
+        })
+        && ReadSection("light", [&Description](FJsonObjectReader& Reader)
+        {
+            ReadVec3(Reader, "position", Description.LightPosition);
+            Reader.Read("intensity", Description.LightIntensity);
+            Reader.Read("follow_cursor", Description.bLightFollowsCursor);
+        });
+
+    if (!bValid)
+    {
+        return false;
+    }
+
+    if (Description.CameraDirection && glm::length(*Description.CameraDirection) <= 0.0f)
+    {
+        OutError = "camera: a direcao nao pode ser nula";
+        return false;
+    }
+
+    OutDescription = std::move(Description);
+    return true;
+}
+
+bool FSceneDescription::LoadFromFile(const std::filesystem::path& InFilePath, FSceneDescription& OutDescription, std::string& OutError)
+{
+    std::ifstream File{ InFilePath, std::ios::in | std::ios::binary };
+    if (!File)
+    {
+        OutError = "nao foi possivel abrir " + InFilePath.string();
+        return false;
+    }
+
+    std::stringstream Text;
+    Text << File.rdbuf();
+
+    // Sem nome no arquivo a cena leva o nome do arquivo
+    FSceneDescription Description;
+    Description.Name = InFilePath.stem().string();
+    if (!Parse(Text.str(), Description, OutError))
+    {
+        OutError = InFilePath.filename().string() + ": " + OutError;
+        return false;
+    }
+
+    if (Description.Name.empty())
+    {
+        Description.Name = InFilePath.stem().string();
+    }
+
+    OutDescription = std::move(Description);
+    return true;
+}
+
+void FScenePreparer::Request(const FSceneDescription& InDescription, FMeshCache* InMeshCache)
+{
+    if (Stage == EStage::Idle)
+    {
+        Start(FSceneDescription{ InDescription }, InMeshCache);
+        return;
+    }
+
+    QueuedDescription = InDescription;
+    QueuedMeshCache = InMeshCache;
+}
+
+void FScenePreparer::Start(FSceneDescription&& InDescription, FMeshCache* InMeshCache)
+{
+    Scene = FPreparedScene{};
+    Scene.Description = std::move(InDescription);
+    bTexturesRequested = false;
+    Stage = EStage::Preparing;
+    StartTime = FClock::now();
+
+    std::cout << "Preparando a cena " << Scene.Description.Name << std::endl;
+
+    GeneratedMesh = std::async(std::launch::async, &FScenePreparer::GenerateMesh, this, Scene.Description, InMeshCache);
+}
+
+FScenePreparer::FGeneratedMesh FScenePreparer::GenerateMesh(const FSceneDescription& InDescription, FMeshCache* InMeshCache)
+{
+    const FClock::time_point GenerationStartTime = FClock::now();
+
+    FGeneratedMesh Mesh;
+    switch (InDescription.Mesh)
+    {
+        case ESceneMesh::Sphere:
+            Mesh.Data = GenerateSphereData(InDescription.MeshResolution, WorkerPool, InMeshCache);
+            break;
+
+        case ESceneMesh::Cylinder:
+            Mesh.Data = GenerateCylinderData(InDescription.MeshResolution, WorkerPool, InMeshCache);
+            break;
+
+        case ESceneMesh::Cube:
+            Mesh.Data = GenerateCubeData();
+            break;
+
+        case ESceneMesh::Quad:
+            Mesh.Data = GenerateQuadData();
+            break;
+
+        default:
+            break;
+    }
+
+    Mesh.GenerationTime = ToSeconds(FClock::now() - GenerationStartTime);
+    return Mesh;
+}
+
+void FScenePreparer::Discard(FMeshArena& InMeshArena)
+{
+    if (GeneratedMesh.valid())
+    {
+        GeneratedMesh.get();
+    }
+
+    if (Scene.Mesh != InvalidMeshHandle)
+    {
+        InMeshArena.RemoveMesh(Scene.Mesh);
+    }
+
+    // As texturas ficam com o FTextureManager ate o proximo RemoveUnusedTextures
+    Scene = FPreparedScene{};
+    bTexturesRequested = false;
+    Stage = EStage::Idle;
+}
+
+bool FScenePreparer::Update(FMeshArena& InMeshArena, FShaderManager& InShaderManager, FTextureManager& InTextureManager)
+{
+    if (QueuedDescription)
+    {
+        // So descarta quando isso nao trava o frame esperando a geracao da malha
+        const bool bGenerating = GeneratedMesh.valid() && GeneratedMesh.wait_for(std::chrono::seconds{ 0 }) != std::future_status::ready;
+        if (Stage != EStage::Idle && !bGenerating)
+        {
+            std::cout << "Descartando a cena " << Scene.Description.Name << std::endl;
+            Discard(InMeshArena);
+        }
+
+        if (Stage == EStage::Idle)
+        {
+            Start(std::move(*QueuedDescription), QueuedMeshCache);
+            QueuedDescription.reset();
+        }
+    }
+
+    if (Stage != EStage::Preparing)
+    {
+        return IsReady();
+    }
+
+    const FSceneDescription& Description = Scene.Description;
+    if (!bTexturesRequested)
+    {
+        const std::vector<FTexturePtr> Textures = InTextureManager.LoadTexturesAsync({ Description.EarthTexture, Description.CloudsTexture });
+        Scene.EarthTexture = Textures[0];
+        Scene.CloudsTexture = Textures[1];
+        bTexturesRequested = true;
+    }
+
+    // Compilar e o passo mais caro na thread do OpenGL, fica sozinho no frame. Um programa ja usado por
+    // outra cena volta na hora
+    if (!Scene.Program)
+    {
+        Scene.Program = InShaderManager.AddShader(Description.VertexShader, Description.FragmentShader);
+        return false;
+    }
+
+    if (Scene.Mesh == InvalidMeshHandle)
+    {
+        if (GeneratedMesh.wait_for(std::chrono::seconds{ 0 }) != std::future_status::ready)
+        {
+            return false;
+        }
+
+        const FGeneratedMesh Mesh = GeneratedMesh.get();
+        Scene.Mesh = InMeshArena.AddMesh(Mesh.Data.Vertices, Mesh.Data.Indices);
+        Scene.MeshGenerationTime = Mesh.GenerationTime;
+        return false;
+    }
+
+    if (InTextureManager.IsLoading(Scene.EarthTexture) || InTextureManager.IsLoading(Scene.CloudsTexture))
+    {
+        return false;
+    }
+
+    Scene.PreparationTime = ToSeconds(FClock::now() - StartTime);
+    Stage = EStage::Ready;
+
+    std::cout << "Cena " << Description.Name << " preparada em " << Scene.PreparationTime << " segundos" << std::endl;
+    return true;
+}
+
+void FScenePreparer::Finish(FMeshArena& InMeshArena, FShaderManager& InShaderManager, FTextureManager& InTextureManager)
+{
+    while (Stage == EStage::Preparing || QueuedDescription)
+    {
+        if (GeneratedMesh.valid())
+        {
+            GeneratedMesh.wait();
+        }
+
+        if (!Update(InMeshArena, InShaderManager, InTextureManager))
+        {
+            InTextureManager.WaitForPendingLoads();
+        }
+    }
+}
+
+FPreparedScene FScenePreparer::TakePreparedScene()
+{
+    FPreparedScene PreparedScene = std::move(Scene);
+    Scene = FPreparedScene{};
+    Stage = EStage::Idle;
+    return PreparedScene;
+}
+
+void FScenePreparer::Shutdown(FMeshArena& InMeshArena)
+{
+    QueuedDescription.reset();
+    Discard(InMeshArena);
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "MeshArena.h"
+#include "MeshGenerators.h"
+#include "ShaderManager.h"
+#include "TextureManager.h"
+#include "WorkerPool.h"
+
+#include <glm/glm.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <optional>
+#include <string>
+#include <string_view>
+
+class FMeshCache;
+
+enum class ESceneMesh : std::uint8_t
+{
+    Sphere,
+    Cylinder,
+    Cube,
+    Quad
+};
+
+const char* GetSceneMeshName(ESceneMesh InMesh);
+std::optional<ESceneMesh> ParseSceneMesh(std::string_view InName);
+
+// Cena descrita por dados, lida de um arquivo JSON. Os valores padrao sao os da cena BlueMarble, entao um
+// arquivo so precisa ter o que muda
+struct FSceneDescription
+{
+    std::string Name = "BlueMarble";
+
+    // A resolucao so e usada pela esfera e pelo cilindro
+    ESceneMesh Mesh = ESceneMesh::Sphere;
+    std::uint32_t MeshResolution = 100;
+
+    // Rotacao em graus em torno de X, Y e Z, nesta ordem
+    glm::vec3 Location{ 0.0f, 0.0f, 0.0f };
+    glm::vec3 Rotation{ 0.0f, 180.0f, 0.0f };
+    glm::vec3 Scale{ 1.0f, 1.0f, 1.0f };
+
+    std::string VertexShader = "triangle.vert";
+    std::string FragmentShader = "triangle.frag";
+    std::string EarthTexture = "earth_2k.jpg";
+    std::string CloudsTexture = "earth_clouds_2k.jpg";
+
+    // Sem valor a camera continua onde estava na cena anterior
+    bool bOrthoCamera = false;
+    std::optional<glm::vec3> CameraLocation;
+    std::optional<glm::vec3> CameraDirection;
+
+    glm::vec3 LightPosition{ 0.0f, 0.0f, 1000.0f };
+    float LightIntensity = 1.0f;
+
+    // A luz acompanha o cursor no plano XY, em coordenadas normalizadas da janela
+    bool bLightFollowsCursor = false;
+
+    glm::mat4 GetTransform() const;
+
+    // Os membros ausentes mantem os valores de OutDescription. Em caso de erro OutError recebe o motivo e
+    // OutDescription nao e alterada
+    static bool Parse(std::string_view InText, FSceneDescription& OutDescription, std::string& OutError);
+    static bool LoadFromFile(const std::filesystem::path& InFilePath, FSceneDescription& OutDescription, std::string& OutError);
+};
+
+// Recursos de uma cena prontos para desenhar
+struct FPreparedScene
+{
+    FSceneDescription Description;
+    FMeshHandle Mesh = InvalidMeshHandle;
+    FShaderPtr Program;
+    FTexturePtr EarthTexture;
+    FTexturePtr CloudsTexture;
+
+    // Em segundos, do pedido ate a cena ficar pronta e so a geracao da malha
+    double PreparationTime = 0.0;
+    double MeshGenerationTime = 0.0;
+};
+
+// Prepara a proxima cena enquanto a atual continua sendo desenhada. A malha e gerada numa thread propria, as
+// texturas sao decodificadas pelo FTextureManager em segundo plano e a thread do OpenGL so faz os envios, um
+// passo por frame: o programa em um frame, a malha em outro. A cena pronta e entregue inteira, para ser trocada
+// num unico frame
+class FScenePreparer
+{
+public:
+
+    FScenePreparer() = default;
+
+    FScenePreparer(const FScenePreparer&) = delete;
+    FScenePreparer& operator=(const FScenePreparer&) = delete;
+
+    // Comeca a preparar InDescription. Com um InMeshCache a malha e lida do cache em disco. Um pedido durante
+    // uma preparacao substitui o que estiver na fila, e a preparacao atual e descartada quando puder ser
+    void Request(const FSceneDescription& InDescription, FMeshCache* InMeshCache);
+
+    // Avanca a preparacao, chamado uma vez por frame na thread do OpenGL. As texturas sao enviadas pelo
+    // FTextureManager::UpdateTextures. Retorna true enquanto houver uma cena pronta para TakePreparedScene
+    bool Update(FMeshArena& InMeshArena, FShaderManager& InShaderManager, FTextureManager& InTextureManager);
+
+    // Termina a preparacao esperando a malha e as texturas, para o inicio do programa
+    void Finish(FMeshArena& InMeshArena, FShaderManager& InShaderManager, FTextureManager& InTextureManager);
+
+    bool IsBusy() const { return Stage != EStage::Idle; }
+    bool IsReady() const { return Stage == EStage::Ready; }
+
+    // Nome da cena sendo preparada, so vale com IsBusy
+    const std::string& GetPendingSceneName() const { return Scene.Description.Name; }
+
+    // A cena pronta passa a ser do chamador, que apaga a malha quando terminar de usar
+    FPreparedScene TakePreparedScene();
+
+    // Espera a geracao em andamento e apaga o que ja tinha sido enviado
+    void Shutdown(FMeshArena& InMeshArena);
+
+private:
+
+    enum class EStage : std::uint8_t
+    {
+        Idle,
+        Preparing,
+        Ready
+    };
+
+    using FClock = std::chrono::steady_clock;
+
+    void Start(FSceneDescription&& InDescription, FMeshCache* InMeshCache);
+
+    // Descarta a cena atual. A geracao da malha nao pode ser interrompida, entao espera ela terminar
+    void Discard(FMeshArena& InMeshArena);
+
+    struct FGeneratedMesh
+    {
+        FMeshData Data;
+        double GenerationTime = 0.0;
+    };
+
+    FGeneratedMesh GenerateMesh(const FSceneDescription& InDescription, FMeshCache* InMeshCache);
+
+    // Proprio da thread de geracao, o pool do frame e usado pela gravacao dos pacotes ao mesmo tempo
+    FWorkerPool WorkerPool{ 1 };
+
+    EStage Stage = EStage::Idle;
+    FPreparedScene Scene;
+    bool bTexturesRequested = false;
+    std::future<FGeneratedMesh> GeneratedMesh;
+    FClock::time_point StartTime;
+
+    std::optional<FSceneDescription> QueuedDescription;
+    FMeshCache* QueuedMeshCache = nullptr;
+};
@@ -1,9 +1,20 @@
 
 #include "ShaderManager.h"
 
+#include "AssetPack.h"
+#include "GPUResourceRegistry.h"
+
+#include <algorithm>
 #include <array>
 #include <fstream>
 #include <iostream>
+#include <set>
+#include <sstream>
+
+static std::filesystem::path NormalizePath(const std::filesystem::path& InFilePath)
+{
+    return std::filesystem::absolute(InFilePath).lexically_normal();
+}
 
 static std::string ReadFile(const std::filesystem::path & InFilePath)
 {
@@ -15,6 +26,127 @@ static std::string ReadFile(const std::filesystem::path & InFilePath)
     return FileContents;
 }
 
+std::string FShaderManager::ReadShaderFile(const std::filesystem::path& InFilePath) const
+{
+    if (AssetPack == nullptr)
+    {
+        return ReadFile(InFilePath);
+    }
+
+    std::string FileContents;
+    AssetPack->ReadAsset("shaders/" + InFilePath.lexically_relative(ShadersDir).generic_string(), FileContents);
+    return FileContents;
+}
+
+static bool ParseIncludeDirective(std::string_view InLine, std::string_view& OutIncludeFile)
+{
+    constexpr std::string_view IncludeDirective = "#include";
+
+    const std::size_t DirectiveStart = InLine.find_first_not_of(" \t");
+    if (DirectiveStart == std::string_view::npos || InLine.substr(DirectiveStart, IncludeDirective.size()) != IncludeDirective)
+    {
+        return false;
+    }
+
+    const std::size_t OpenQuote = InLine.find('"', DirectiveStart + IncludeDirective.size());
+    const std::size_t CloseQuote = OpenQuote != std::string_view::npos ? InLine.find('"', OpenQuote + 1) : std::string_view::npos;
+    if (CloseQuote == std::string_view::npos)
+    {
+        return false;
+    }
+
+    OutIncludeFile = InLine.substr(OpenQuote + 1, CloseQuote - OpenQuote - 1);
+    return true;
+}
+
+bool FShaderManager::ReadShaderSource(const std::filesystem::path& InFilePath, std::vector<std::filesystem::path>& InOutDependencies, std::string& OutSource)
+{
+    InOutDependencies.push_back(InFilePath);
+
+    const std::string FileContents = ReadShaderFile(InFilePath);
+    if (FileContents.empty())
+    {
+        return false;
+    }
+
+    // O indice do arquivo em InOutDependencies e usado como o source-string-number da diretiva #line,
+    // assim os erros de compilacao apontam para o arquivo e a linha corretos
+    const std::size_t SourceStringIndex = InOutDependencies.size() - 1;
+
+    std::istringstream FileStream{ FileContents };
+    std::string Line;
+    std::size_t LineNumber = 0;
+    while (std::getline(FileStream, Line))
+    {
+        ++LineNumber;
+
+        std::string_view IncludeFile;
+        if (!ParseIncludeDirective(Line, IncludeFile))
+        {
+            OutSource += Line;
+            OutSource += '\n';
+            continue;
+        }
+
+        const std::filesystem::path IncludeFilePath = NormalizePath(InFilePath.parent_path() / IncludeFile);
+
+        // Cada arquivo e incluido uma unica vez, o que tambem evita includes circulares
+        if (std::find(InOutDependencies.begin(), InOutDependencies.end(), IncludeFilePath) == InOutDependencies.end())
+        {
+            OutSource += "#line 1 " + std::to_string(InOutDependencies.size()) + '\n';
+            if (!ReadShaderSource(IncludeFilePath, InOutDependencies, OutSource))
+            {
+                FailureLogs[InFilePath] = "Erro ao incluir " + IncludeFilePath.string() + " na linha " + std::to_string(LineNumber);
+                return false;
+            }
+        }
+
+        OutSource += "#line " + std::to_string(LineNumber + 1) + ' ' + std::to_string(SourceStringIndex) + '\n';
+    }
+
+    return true;
+}
+
+static void SortParameters(std::vector<FShaderParameter>& InOutParameters, const std::filesystem::path& InShaderFilePath)
+{
+    std::sort(InOutParameters.begin(), InOutParameters.end(), [](const FShaderParameter& A, const FShaderParameter& B)
+    {
+        return A.NameHash < B.NameHash;
+    });
+
+    const auto CollisionIt = std::adjacent_find(InOutParameters.begin(), InOutParameters.end(), [](const FShaderParameter& A, const FShaderParameter& B)
+    {
+        return A.NameHash == B.NameHash;
+    });
+    if (CollisionIt != InOutParameters.end())
+    {
+        std::cout << "Colisao de hash entre parametros do programa " << InShaderFilePath << std::endl;
+    }
+}
+
+void FShaderManager::UpdateDependencies(FShaderPtr InShader, std::vector<std::filesystem::path>&& InDependencies)
+{
+    for (const std::filesystem::path& Dependency : InShader->Dependencies)
+    {
+        std::vector<FShaderPtr>& Dependents = DependentShaders[Dependency];
+        Dependents.erase(std::remove(Dependents.begin(), Dependents.end(), InShader), Dependents.end());
+        if (Dependents.empty())
+        {
+            DependentShaders.erase(Dependency);
+        }
+    }
+
+    std::sort(InDependencies.begin(), InDependencies.end());
+    InDependencies.erase(std::unique(InDependencies.begin(), InDependencies.end()), InDependencies.end());
+
+    for (const std::filesystem::path& Dependency : InDependencies)
+    {
+        DependentShaders[Dependency].push_back(InShader);
+    }
+
+    InShader->Dependencies = std::move(InDependencies);
+}
+
 bool FShaderManager::IsShaderValid(GLuint InShaderId, std::string& OutInfoLog)
 {
     // Verificar se o shader foi compilado
@@ -92,18 +224,32 @@ bool FShaderManager::IsProgramValid(GLuint InProgramId)
 
 bool FShaderManager::CompileAndLink(FShaderPtr InShader)
 {
-    // Criar os identificadores de cada um dos shaders
-    const GLuint VertShaderId = glCreateShader(GL_VERTEX_SHADER);
-    const GLuint FragShaderId = glCreateShader(GL_FRAGMENT_SHADER);
+    for (const std::filesystem::path& Dependency : InShader->Dependencies)
+    {
+        FailureLogs.erase(Dependency);
+    }
+
+    // Cada estagio e compilado sozinho, entao o include unico vale por estagio: um arquivo incluido pelo vertex
+    // shader tambem precisa entrar no fragment shader
+    std::vector<std::filesystem::path> Dependencies, FragmentDependencies;
+    std::string VertexShaderSource, FragmentShaderSource;
+    const bool bVertexSourceRead = ReadShaderSource(InShader->VertexShaderFilePath, Dependencies, VertexShaderSource);
+    const bool bFragmentSourceRead = ReadShaderSource(InShader->FragmentShaderFilePath, FragmentDependencies, FragmentShaderSource);
 
-    const std::string VertexShaderSource = ReadFile(InShader->VertexShaderFilePath);
-    const std::string FragmentShaderSource = ReadFile(InShader->FragmentShaderFilePath);
+    // Registra as dependencias mesmo em caso de falha para que a correcao de qualquer arquivo dispare a recompilacao.
+    // UpdateDependencies remove os arquivos repetidos entre os dois estagios
+    Dependencies.insert(Dependencies.end(), FragmentDependencies.begin(), FragmentDependencies.end());
+    UpdateDependencies(InShader, std::move(Dependencies));
 
-    if (VertexShaderSource.empty() || FragmentShaderSource.empty())
+    if (!bVertexSourceRead || !bFragmentSourceRead)
     {
         return false;
     }
 
+    // Criar os identificadores de cada um dos shaders
+    const GLuint VertShaderId = glCreateShader(GL_VERTEX_SHADER);
+    const GLuint FragShaderId = glCreateShader(GL_FRAGMENT_SHADER);
+
     std::cout << "Compilando " << InShader->VertexShaderFilePath << std::endl;
     const char* VertexShaderSourcePtr = VertexShaderSource.c_str();
     glShaderSource(VertShaderId, 1, &VertexShaderSourcePtr, nullptr);
@@ -117,7 +263,8 @@ bool FShaderManager::CompileAndLink(FShaderPtr InShader)
     std::string VertexShaderInfoLog, FragmentShaderInfoLog;
     if (IsShaderValid(VertShaderId, VertexShaderInfoLog) && IsShaderValid(FragShaderId, FragmentShaderInfoLog))
     {
-        const GLint ProgramId = glCreateProgram();
+        const std::string ProgramLabel = InShader->VertexShaderFilePath.filename().string() + " + " + InShader->FragmentShaderFilePath.filename().string();
+        GLuint ProgramId = FGPUResourceRegistry::Get().CreateProgram(ProgramLabel);
 
         std::cout << "Linkando Programa" << std::endl;
         glAttachShader(ProgramId, VertShaderId);
@@ -150,7 +297,7 @@ bool FShaderManager::CompileAndLink(FShaderPtr InShader)
                 const std::string UniformName = UniformNameBuffer.substr(0, UniformNameLength);
                 const GLint UniformLoc = glGetUniformLocation(ProgramId, UniformName.c_str());
 
-                InShader->UniformLocations[UniformName] = UniformLoc;
+                InShader->UniformLocations.push_back(FShaderParameter{ .NameHash = HashShaderParameterName(UniformName), .Value = UniformLoc });
             }
 
 
@@ -167,22 +314,31 @@ bool FShaderManager::CompileAndLink(FShaderPtr InShader)
                 const std::string UniformBlockName = UniformBlockNameBuffer.substr(0, UniformBlockNameLength);
                 glUniformBlockBinding(ProgramId, UBOIndex, UBOIndex);
 
-                InShader->UniformBlockBindings[UniformBlockName] = UBOIndex;
+                InShader->UniformBlockBindings.push_back(FShaderParameter{ .NameHash = HashShaderParameterName(UniformBlockName), .Value = UBOIndex });
             }
 
+            SortParameters(InShader->UniformLocations, InShader->VertexShaderFilePath);
+            SortParameters(InShader->UniformBlockBindings, InShader->VertexShaderFilePath);
+
             InShader->ProgramId = ProgramId;
+            InShader->LinkCount++;
 
             return true;
         }
+
+        FGPUResourceRegistry::Get().Delete(EGPUResourceType::Program, ProgramId);
     }
     else
     {
+        glDeleteShader(VertShaderId);
+        glDeleteShader(FragShaderId);
+
         if (!VertexShaderInfoLog.empty())
         {
             FailureLogs[InShader->VertexShaderFilePath] = VertexShaderInfoLog;
         }
 
-        if (!FragmentShaderSource.empty())
+        if (!FragmentShaderInfoLog.empty())
         {
             FailureLogs[InShader->FragmentShaderFilePath] = FragmentShaderInfoLog;
         }
@@ -191,48 +347,99 @@ bool FShaderManager::CompileAndLink(FShaderPtr InShader)
     return false;
 }
 
+void FShaderManager::Initialize(const std::filesystem::path& InShadersDir, const FAssetPack* InAssetPack)
+{
+    ShadersDir = NormalizePath(InShadersDir);
+    AssetPack = InAssetPack;
+
+    if (AssetPack != nullptr)
+    {
+        std::cout << "Shaders no pacote " << AssetPack->GetPackFilePath() << std::endl;
+    }
+    else
+    {
+        std::cout << "Shaders em " << ShadersDir << std::endl;
+    }
+}
+
 FShaderPtr FShaderManager::AddShader(const std::string& InVertexShaderFile, const std::string& InFragmentShaderFile)
 {
-    const std::filesystem::path AbsoluteVertexShaderFile = std::filesystem::absolute(std::filesystem::path{ ShadersDir } / InVertexShaderFile);
-    const std::filesystem::path AbsoluteFragShaderFile = std::filesystem::absolute(std::filesystem::path{ ShadersDir } / InFragmentShaderFile);
+    const std::filesystem::path AbsoluteVertexShaderFile = NormalizePath(ShadersDir / InVertexShaderFile);
+    const std::filesystem::path AbsoluteFragShaderFile = NormalizePath(ShadersDir / InFragmentShaderFile);
+
+    const auto ShaderIt = std::find_if(Shaders.begin(), Shaders.end(), [&](const FShaderPtr& Shader)
+    {
+        return Shader->VertexShaderFilePath == AbsoluteVertexShaderFile && Shader->FragmentShaderFilePath == AbsoluteFragShaderFile;
+    });
+    if (ShaderIt != Shaders.end())
+    {
+        return *ShaderIt;
+    }
 
     FShaderPtr Shader = std::make_shared<FShader>();
     Shader->VertexShaderFilePath = AbsoluteVertexShaderFile;
     Shader->FragmentShaderFilePath = AbsoluteFragShaderFile;
 
-    if (CompileAndLink(Shader))
-    {
-        Shaders.push_back(Shader);
-    }
+    // O shader e registrado mesmo se falhar para que possa ser corrigido com o programa rodando
+    CompileAndLink(Shader);
+    Shaders.push_back(Shader);
 
     return Shader;
 }
 
-void FShaderManager::UpdateShaders()
+bool FShaderManager::PreprocessShader(const std::string& InShaderFile, std::string& OutSource)
 {
-    std::set<std::filesystem::path> ChangedFiles = DirWatcher.GetChangedFiles();
-    if (!ChangedFiles.empty())
+    std::vector<std::filesystem::path> Dependencies;
+    return ReadShaderSource(NormalizePath(ShadersDir / InShaderFile), Dependencies, OutSource);
+}
+
+bool FShaderManager::UpdateShaders(const std::vector<std::filesystem::path>& InChangedFiles)
+{
+    if (InChangedFiles.empty())
     {
-        FailureLogs.clear();
+        return false;
+    }
 
-        for (const std::filesystem::path& ShaderFile : ChangedFiles)
+    // Junta todos os programas afetados antes de recompilar, assim um arquivo incluido por
+    // varios shaders (ou varios arquivos de um mesmo shader) gera uma unica recompilacao por programa
+    std::set<FShaderPtr> ShadersToRebuild;
+    for (const std::filesystem::path& ChangedFile : InChangedFiles)
+    {
+        const auto DependentsIt = DependentShaders.find(NormalizePath(ChangedFile));
+        if (DependentsIt != DependentShaders.end())
         {
-            auto ShaderIt = std::find_if(Shaders.begin(), Shaders.end(), [ShaderFile](FShaderPtr Shader)
-            {
-                return Shader->VertexShaderFilePath == ShaderFile || Shader->FragmentShaderFilePath == ShaderFile;
-            });
-            if (ShaderIt != Shaders.end())
-            {
-                FShaderPtr Shader = *ShaderIt;
+            ShadersToRebuild.insert(DependentsIt->second.begin(), DependentsIt->second.end());
+        }
+    }
 
-                const GLint PreviousProgramId = Shader->ProgramId;
-                if (CompileAndLink(Shader))
-                {
-                    glDeleteProgram(PreviousProgramId);
-                }
-            }
+    bool bAnyProgramRebuilt = false;
+    for (const FShaderPtr& Shader : ShadersToRebuild)
+    {
+        // O programa antigo continua em uso se a nova versao falhar
+        GLuint PreviousProgramId = Shader->ProgramId;
+        if (CompileAndLink(Shader))
+        {
+            bAnyProgramRebuilt = true;
+            NumReloads++;
+            FGPUResourceRegistry::Get().Delete(EGPUResourceType::Program, PreviousProgramId);
+        }
+        else
+        {
+            NumFailedReloads++;
         }
     }
+
+    return bAnyProgramRebuilt;
+}
+
+void FShaderManager::Shutdown()
+{
+    for (const FShaderPtr& Shader : Shaders)
+    {
+        GLuint ProgramId = Shader->ProgramId;
+        FGPUResourceRegistry::Get().Delete(EGPUResourceType::Program, ProgramId);
+        Shader->ProgramId = 0;
+    }
 }
 
 
@@ -1,45 +1,176 @@
 #pragma once
 
-#include "DirectoryWatcher.h"
-
 #include <glad/glad.h>
 
+#include <algorithm>
+#include <cstdint>
 #include <filesystem>
 #include <map>
 #include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class FAssetPack;
+
+// FNV-1a de 32 bits
+constexpr std::uint32_t HashShaderParameterName(std::string_view InName)
+{
+    std::uint32_t Hash = 2166136261u;
+    for (const char Char : InName)
+    {
+        Hash ^= static_cast<std::uint8_t>(Char);
+        Hash *= 16777619u;
+    }
+    return Hash;
+}
+
+// Nome de um uniform ou uniform block, sempre calculado em tempo de compilacao a partir de um literal
+struct FShaderParameterName
+{
+    template<std::size_t N>
+    consteval FShaderParameterName(const char (&InName)[N])
+        : Hash{ HashShaderParameterName({ InName, N - 1 }) }
+    {
+    }
+
+    std::uint32_t Hash;
+};
+
+struct FShaderParameter
+{
+    std::uint32_t NameHash;
+    GLint Value;
+};
 
 struct FShader
 {
-    GLint ProgramId;
+    GLint ProgramId = 0;
+
+    // Incrementado a cada link com sucesso, usado para revalidar os handles de parametros
+    std::uint32_t LinkCount = 0;
+
     std::filesystem::path VertexShaderFilePath;
     std::filesystem::path FragmentShaderFilePath;
-    std::map<std::string, GLint> UniformBlockBindings;
-    std::map<std::string, GLint> UniformLocations;
+
+    // Ordenados por NameHash
+    std::vector<FShaderParameter> UniformBlockBindings;
+    std::vector<FShaderParameter> UniformLocations;
+
+    // Todos os arquivos usados para gerar o programa, incluindo os arquivos de #include
+    std::vector<std::filesystem::path> Dependencies;
+
+    static GLint FindParameter(const std::vector<FShaderParameter>& InParameters, std::uint32_t InNameHash)
+    {
+        const auto ParameterIt = std::lower_bound(InParameters.begin(), InParameters.end(), InNameHash, [](const FShaderParameter& Parameter, std::uint32_t NameHash)
+        {
+            return Parameter.NameHash < NameHash;
+        });
+        return ParameterIt != InParameters.end() && ParameterIt->NameHash == InNameHash ? ParameterIt->Value : -1;
+    }
+
+    GLint GetUniformLocation(FShaderParameterName InName) const { return FindParameter(UniformLocations, InName.Hash); }
+    GLint GetUniformBlockBinding(FShaderParameterName InName) const { return FindParameter(UniformBlockBindings, InName.Hash); }
 };
 
 using FShaderPtr = std::shared_ptr<FShader>;
 
+enum class EShaderParameterType
+{
+    Uniform,
+    UniformBlock
+};
+
+// Handle para um parametro de um programa. O valor e resolvido uma unica vez e so volta
+// a ser procurado quando o programa for linkado novamente (hot reload)
+template<EShaderParameterType ParameterType>
+class TShaderParameterHandle
+{
+public:
+
+    TShaderParameterHandle(FShaderPtr InShader, FShaderParameterName InName)
+        : Shader{ std::move(InShader) }
+        , NameHash{ InName.Hash }
+    {
+    }
+
+    GLint Get() const
+    {
+        if (CachedLinkCount != Shader->LinkCount)
+        {
+            const std::vector<FShaderParameter>& Parameters = ParameterType == EShaderParameterType::Uniform ? Shader->UniformLocations : Shader->UniformBlockBindings;
+            CachedValue = FShader::FindParameter(Parameters, NameHash);
+            CachedLinkCount = Shader->LinkCount;
+        }
+        return CachedValue;
+    }
+
+    bool IsValid() const { return Get() >= 0; }
+
+private:
+
+    FShaderPtr Shader;
+    std::uint32_t NameHash;
+    mutable std::uint32_t CachedLinkCount = 0;
+    mutable GLint CachedValue = -1;
+};
+
+using FUniformHandle = TShaderParameterHandle<EShaderParameterType::Uniform>;
+using FUniformBlockHandle = TShaderParameterHandle<EShaderParameterType::UniformBlock>;
+
 class FShaderManager
 {
 public:
 
+    // Os arquivos dos shaders sao procurados em InShadersDir. Com um pacote de assets eles sao lidos do
+    // pacote, com o caminho relativo a InShadersDir e o prefixo "shaders/"
+    void Initialize(const std::filesystem::path& InShadersDir, const FAssetPack* InAssetPack = nullptr);
+
+    const std::filesystem::path& GetShadersDir() const { return ShadersDir; }
+
+    // Um par de arquivos ja adicionado retorna o mesmo programa, sem compilar de novo
     FShaderPtr AddShader(const std::string& InVertexShaderFile, const std::string& InFragmentShaderFile);
 
-    const std::map<std::filesystem::path, std::string> GetFailureLogs() const { return FailureLogs; }
+    // Le o arquivo de InShadersDir e resolve os #include como na compilacao, sem usar o OpenGL
+    bool PreprocessShader(const std::string& InShaderFile, std::string& OutSource);
+
+    const std::map<std::filesystem::path, std::string>& GetFailureLogs() const { return FailureLogs; }
+
+    // Recompila os programas que dependem dos arquivos alterados. Retorna true se algum programa foi recompilado
+    bool UpdateShaders(const std::vector<std::filesystem::path>& InChangedFiles);
 
-    void UpdateShaders();
+    // Recompilacoes do hot reload desde o inicio, com sucesso e com erro
+    std::uint32_t GetNumReloads() const { return NumReloads; }
+    std::uint32_t GetNumFailedReloads() const { return NumFailedReloads; }
+
+    // Apaga todos os programas, os FShader continuam registrados com ProgramId zero
+    void Shutdown();
 
 private:
 
+    struct FPathHash
+    {
+        std::size_t operator()(const std::filesystem::path& InPath) const { return std::filesystem::hash_value(InPath); }
+    };
+
     bool IsShaderValid(GLuint InShaderId, std::string& OutInfoLog);
 
     bool IsProgramValid(GLuint InProgramId);
 
+    std::string ReadShaderFile(const std::filesystem::path& InFilePath) const;
+
+    bool ReadShaderSource(const std::filesystem::path& InFilePath, std::vector<std::filesystem::path>& InOutDependencies, std::string& OutSource);
+
+    void UpdateDependencies(FShaderPtr InShader, std::vector<std::filesystem::path>&& InDependencies);
+
     bool CompileAndLink(FShaderPtr InShader);
 
 private:
-    static constexpr std::string_view ShadersDir = "../../../shaders";
-    FDirectoryWatcher DirWatcher{ ShadersDir };
+    std::filesystem::path ShadersDir;
+    const FAssetPack* AssetPack = nullptr;
     std::vector<FShaderPtr> Shaders;
+    std::unordered_map<std::filesystem::path, std::vector<FShaderPtr>, FPathHash> DependentShaders;
     std::map<std::filesystem::path, std::string> FailureLogs;
+    std::uint32_t NumReloads = 0;
+    std::uint32_t NumFailedReloads = 0;
 };
@@ -0,0 +1,367 @@
+#include "StreamingImageWriter.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <iostream>
+#include <limits>
+
+// Os chunks IDAT sao gravados quando o buffer chega a este tamanho
+static constexpr std::size_t MaxIDATSize = 1 << 20;
+
+// Maior bloco "stored" do deflate
+static constexpr std::uint32_t MaxStoredBlockSize = 65535;
+
+static constexpr std::array<std::uint32_t, 256> CRC32Table = []
+{
+    std::array<std::uint32_t, 256> Table{};
+    for (std::uint32_t Index = 0; Index < 256; ++Index)
+    {
+        std::uint32_t Value = Index;
+        for (std::int32_t Bit = 0; Bit < 8; ++Bit)
+        {
+            Value = (Value & 1) ? 0xEDB88320u ^ (Value >> 1) : Value >> 1;
+        }
+        Table[Index] = Value;
+    }
+    return Table;
+}();
+
+static std::uint32_t UpdateCRC32(std::uint32_t InCRC, const std::uint8_t* InData, std::size_t InSize)
+{
+    std::uint32_t CRC = ~InCRC;
+    for (std::size_t Index = 0; Index < InSize; ++Index)
+    {
+        CRC = CRC32Table[(CRC ^ InData[Index]) & 0xFF] ^ (CRC >> 8);
+    }
+    return ~CRC;
+}
+
+static std::uint32_t UpdateAdler32(std::uint32_t InAdler, const std::uint8_t* InData, std::size_t InSize)
+{
+    // 5552 e o maior bloco que nao estoura 32 bits antes do modulo
+    std::uint32_t A = InAdler & 0xFFFF;
+    std::uint32_t B = InAdler >> 16;
+    while (InSize > 0)
+    {
+        const std::size_t BlockSize = std::min<std::size_t>(InSize, 5552);
+        for (std::size_t Index = 0; Index < BlockSize; ++Index)
+        {
+            A += InData[Index];
+            B += A;
+        }
+        A %= 65521;
+        B %= 65521;
+        InData += BlockSize;
+        InSize -= BlockSize;
+    }
+    return (B << 16) | A;
+}
+
+static void StoreBigEndian32(std::uint8_t* OutBytes, std::uint32_t InValue)
+{
+    OutBytes[0] = static_cast<std::uint8_t>(InValue >> 24);
+    OutBytes[1] = static_cast<std::uint8_t>(InValue >> 16);
+    OutBytes[2] = static_cast<std::uint8_t>(InValue >> 8);
+    OutBytes[3] = static_cast<std::uint8_t>(InValue);
+}
+
+static void AppendLittleEndian(std::vector<std::uint8_t>& OutBytes, std::uint32_t InValue, std::size_t InSize)
+{
+    for (std::size_t Byte = 0; Byte < InSize; ++Byte)
+    {
+        OutBytes.push_back(static_cast<std::uint8_t>(InValue >> (Byte * 8)));
+    }
+}
+
+FStreamingImageWriter::~FStreamingImageWriter()
+{
+    if (File.is_open())
+    {
+        std::cout << "Imagem " << FilePath << " nao foi terminada" << std::endl;
+    }
+}
+
+bool FStreamingImageWriter::Open(const std::filesystem::path& InFilePath, std::int32_t InWidth, std::int32_t InHeight)
+{
+    std::string Extension = InFilePath.extension().string();
+    std::transform(Extension.begin(), Extension.end(), Extension.begin(), [](char Character) { return static_cast<char>(std::tolower(Character)); });
+    if (Extension == ".png")
+    {
+        Format = EImageFileFormat::PNG;
+    }
+    else if (Extension == ".tif" || Extension == ".tiff")
+    {
+        Format = EImageFileFormat::TIFF;
+    }
+    else
+    {
+        std::cout << "Formato de imagem nao suportado: " << InFilePath << " (use .png, .tif ou .tiff)" << std::endl;
+        return false;
+    }
+
+    FilePath = InFilePath;
+    Width = InWidth;
+    Height = InHeight;
+    NumWrittenRows = 0;
+
+    const std::uint64_t RowSize = static_cast<std::uint64_t>(Width) * 3;
+    if (Format == EImageFileFormat::TIFF)
+    {
+        // Pixels, diretorio e as tabelas das strips precisam caber nos offsets de 32 bits
+        const std::uint64_t FileSize = 8 + RowSize * Height + 1 + 256 + static_cast<std::uint64_t>(Height) * 8;
+        if (FileSize > std::numeric_limits<std::uint32_t>::max())
+        {
+            std::cout << "Imagem grande demais para TIFF, use PNG: " << Width << "x" << Height << std::endl;
+            return false;
+        }
+    }
+
+    if (FilePath.has_parent_path())
+    {
+        std::error_code Error;
+        std::filesystem::create_directories(FilePath.parent_path(), Error);
+    }
+
+    File.open(FilePath, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!File)
+    {
+        std::cout << "Nao foi possivel criar " << FilePath << std::endl;
+        return false;
+    }
+
+    if (Format == EImageFileFormat::PNG)
+    {
+        static constexpr std::uint8_t Signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        File.write(reinterpret_cast<const char*>(Signature), sizeof(Signature));
+
+        // RGB com 8 bits por canal, sem entrelacamento
+        std::uint8_t Header[13] = {};
+        StoreBigEndian32(Header, static_cast<std::uint32_t>(Width));
+        StoreBigEndian32(Header + 4, static_cast<std::uint32_t>(Height));
+        Header[8] = 8;
+        Header[9] = 2;
+        WritePNGChunk("IHDR", Header, sizeof(Header));
+
+        IDATBuffer.clear();
+        IDATBuffer.reserve(MaxIDATSize + MaxStoredBlockSize);
+        RemainingDeflateBytes = (RowSize + 1) * Height;
+        RemainingBlockBytes = 0;
+        Adler32 = 1;
+
+        static constexpr std::uint8_t ZlibHeader[] = { 0x78, 0x01 };
+        AppendIDATData(ZlibHeader, sizeof(ZlibHeader));
+    }
+    else
+    {
+        // Little endian, o diretorio fica depois dos pixels porque so e gravado no Close
+        const std::uint32_t DirectoryOffset = static_cast<std::uint32_t>((8 + RowSize * Height + 1) & ~1ull);
+        std::vector<std::uint8_t> Header = { 'I', 'I' };
+        AppendLittleEndian(Header, 42, 2);
+        AppendLittleEndian(Header, DirectoryOffset, 4);
+        File.write(reinterpret_cast<const char*>(Header.data()), static_cast<std::streamsize>(Header.size()));
+    }
+
+    return static_cast<bool>(File);
+}
+
+bool FStreamingImageWriter::WriteRow(const std::uint8_t* InPixels)
+{
+    if (!File.is_open() || NumWrittenRows >= Height)
+    {
+        return false;
+    }
+
+    const std::size_t RowSize = static_cast<std::size_t>(Width) * 3;
+    if (Format == EImageFileFormat::PNG)
+    {
+        // Filtro None em todas as linhas, sem compressao os filtros nao ajudam
+        static constexpr std::uint8_t FilterType = 0;
+        AppendDeflateData(&FilterType, 1);
+        AppendDeflateData(InPixels, RowSize);
+    }
+    else
+    {
+        File.write(reinterpret_cast<const char*>(InPixels), static_cast<std::streamsize>(RowSize));
+    }
+
+    NumWrittenRows++;
+    return static_cast<bool>(File);
+}
+
+bool FStreamingImageWriter::Close()
+{
+    if (!File.is_open())
+    {
+        return false;
+    }
+
+    bool bSuccess = NumWrittenRows == Height;
+    if (bSuccess)
+    {
+        if (Format == EImageFileFormat::PNG)
+        {
+            std::uint8_t Checksum[4];
+            StoreBigEndian32(Checksum, Adler32);
+            AppendIDATData(Checksum, sizeof(Checksum));
+            FlushIDAT();
+            WritePNGChunk("IEND", nullptr, 0);
+        }
+        else
+        {
+            WriteTIFFDirectory();
+        }
+    }
+    else
+    {
+        std::cout << "Imagem " << FilePath << " incompleta: " << NumWrittenRows << " de " << Height << " linhas" << std::endl;
+    }
+
+    bSuccess = bSuccess && static_cast<bool>(File);
+    File.close();
+    IDATBuffer = {};
+    return bSuccess;
+}
+
+void FStreamingImageWriter::WritePNGChunk(const char* InType, const std::uint8_t* InData, std::uint32_t InSize)
+{
+    std::uint8_t Header[8];
+    StoreBigEndian32(Header, InSize);
+    std::copy(InType, InType + 4, Header + 4);
+
+    std::uint32_t CRC = UpdateCRC32(0, Header + 4, 4);
+    CRC = UpdateCRC32(CRC, InData, InSize);
+    std::uint8_t Footer[4];
+    StoreBigEndian32(Footer, CRC);
+
+    File.write(reinterpret_cast<const char*>(Header), sizeof(Header));
+    File.write(reinterpret_cast<const char*>(InData), InSize);
+    File.write(reinterpret_cast<const char*>(Footer), sizeof(Footer));
+}
+
+void FStreamingImageWriter::AppendDeflateData(const std::uint8_t* InData, std::size_t InSize)
+{
+    Adler32 = UpdateAdler32(Adler32, InData, InSize);
+
+    while (InSize > 0)
+    {
+        if (RemainingBlockBytes == 0)
+        {
+            // O tamanho total e conhecido desde o Open, entao da para marcar o ultimo bloco ao abri-lo
+            const std::uint32_t BlockSize = static_cast<std::uint32_t>(std::min<std::uint64_t>(RemainingDeflateBytes, MaxStoredBlockSize));
+            const bool bFinalBlock = BlockSize == RemainingDeflateBytes;
+            const std::uint8_t BlockHeader[] = {
+                static_cast<std::uint8_t>(bFinalBlock ? 1 : 0),
+                static_cast<std::uint8_t>(BlockSize),
+                static_cast<std::uint8_t>(BlockSize >> 8),
+                static_cast<std::uint8_t>(~BlockSize),
+                static_cast<std::uint8_t>(~BlockSize >> 8),
+            };
+            AppendIDATData(BlockHeader, sizeof(BlockHeader));
+            RemainingBlockBytes = BlockSize;
+        }
+
+        const std::uint32_t Size = static_cast<std::uint32_t>(std::min<std::size_t>(InSize, RemainingBlockBytes));
+        AppendIDATData(InData, Size);
+        RemainingBlockBytes -= Size;
+        RemainingDeflateBytes -= Size;
+        InData += Size;
+        InSize -= Size;
+    }
+}
+
+void FStreamingImageWriter::AppendIDATData(const std::uint8_t* InData, std::size_t InSize)
+{
+    IDATBuffer.insert(IDATBuffer.end(), InData, InData + InSize);
+    if (IDATBuffer.size() >= MaxIDATSize)
+    {
+        FlushIDAT();
+    }
+}
+
+void FStreamingImageWriter::FlushIDAT()
+{
+    if (!IDATBuffer.empty())
+    {
+        WritePNGChunk("IDAT", IDATBuffer.data(), static_cast<std::uint32_t>(IDATBuffer.size()));
+        IDATBuffer.clear();
+    }
+}
+
+void FStreamingImageWriter::WriteTIFFDirectory()
+{
+    enum : std::uint16_t
+    {
+        Short = 3,
+        Long = 4,
+    };
+
+    struct FEntry
+    {
+        std::uint16_t Tag;
+        std::uint16_t Type;
+        std::uint32_t Count;
+        std::uint32_t Value;
+    };
+
+    const std::uint32_t RowSize = static_cast<std::uint32_t>(Width) * 3;
+    const std::uint32_t PixelsEnd = 8 + RowSize * static_cast<std::uint32_t>(Height);
+    if (PixelsEnd % 2 != 0)
+    {
+        File.put(0);
+    }
+
+    // Os valores que nao cabem em 4 bytes ficam depois do diretorio
+    static constexpr std::uint32_t NumEntries = 10;
+    const std::uint32_t DirectoryOffset = (PixelsEnd + 1) & ~1u;
+    const std::uint32_t BitsPerSampleOffset = DirectoryOffset + 2 + NumEntries * 12 + 4;
+    const std::uint32_t StripOffsetsOffset = BitsPerSampleOffset + 8;
+    const std::uint32_t StripByteCountsOffset = StripOffsetsOffset + static_cast<std::uint32_t>(Height) * 4;
+    const bool bSingleStrip = Height == 1;
+
+    const std::array<FEntry, NumEntries> Entries = { {
+        { 256, Long, 1, static_cast<std::uint32_t>(Width) },                            // ImageWidth
+        { 257, Long, 1, static_cast<std::uint32_t>(Height) },                           // ImageLength
+        { 258, Short, 3, BitsPerSampleOffset },                                         // BitsPerSample
+        { 259, Short, 1, 1 },                                                           // Compression: nenhuma
+        { 262, Short, 1, 2 },                                                           // PhotometricInterpretation: RGB
+        { 273, Long, static_cast<std::uint32_t>(Height), bSingleStrip ? 8 : StripOffsetsOffset },  // StripOffsets
+        { 277, Short, 1, 3 },                                                           // SamplesPerPixel
+        { 278, Long, 1, 1 },                                                            // RowsPerStrip
+        { 279, Long, static_cast<std::uint32_t>(Height), bSingleStrip ? RowSize : StripByteCountsOffset },  // StripByteCounts
+        { 284, Short, 1, 1 },                                                           // PlanarConfiguration: intercalado
+    } };
+
+    std::vector<std::uint8_t> Directory;
+    Directory.reserve(StripByteCountsOffset + static_cast<std::size_t>(Height) * 4 - DirectoryOffset);
+
+    AppendLittleEndian(Directory, NumEntries, 2);
+    for (const FEntry& Entry : Entries)
+    {
+        AppendLittleEndian(Directory, Entry.Tag, 2);
+        AppendLittleEndian(Directory, Entry.Type, 2);
+        AppendLittleEndian(Directory, Entry.Count, 4);
+        // Um SHORT unico fica nos primeiros 2 bytes do campo
+        AppendLittleEndian(Directory, Entry.Value, 4);
+    }
+    AppendLittleEndian(Directory, 0, 4);
+
+    for (std::int32_t Channel = 0; Channel < 4; ++Channel)
+    {
+        AppendLittleEndian(Directory, Channel < 3 ? 8 : 0, 2);
+    }
+
+    if (!bSingleStrip)
+    {
+        for (std::int32_t Row = 0; Row < Height; ++Row)
+        {
+            AppendLittleEndian(Directory, 8 + RowSize * static_cast<std::uint32_t>(Row), 4);
+        }
+        for (std::int32_t Row = 0; Row < Height; ++Row)
+        {
+            AppendLittleEndian(Directory, RowSize, 4);
+        }
+    }
+
+    File.write(reinterpret_cast<const char*>(Directory.data()), static_cast<std::streamsize>(Directory.size()));
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+enum class EImageFileFormat : std::uint8_t
+{
+    // Sem compressao (blocos "stored" do deflate), o stb_image_write so grava a imagem inteira de uma vez
+    PNG,
+
+    // Baseline sem compressao, uma strip por linha. Limitado a 4 GB
+    TIFF,
+};
+
+// Grava uma imagem RGB8 linha a linha, de cima para baixo, sem nunca ter a imagem inteira na memoria.
+// O formato e escolhido pela extensao (.png, .tif ou .tiff)
+class FStreamingImageWriter
+{
+public:
+
+    ~FStreamingImageWriter();
+
+    bool Open(const std::filesystem::path& InFilePath, std::int32_t InWidth, std::int32_t InHeight);
+
+    // InPixels tem Width * 3 bytes
+    bool WriteRow(const std::uint8_t* InPixels);
+
+    // Grava o final do arquivo. Falha se nem todas as linhas foram gravadas
+    bool Close();
+
+    bool IsOpen() const { return File.is_open(); }
+    std::int32_t GetNumWrittenRows() const { return NumWrittenRows; }
+
+private:
+
+    void WritePNGChunk(const char* InType, const std::uint8_t* InData, std::uint32_t InSize);
+    void AppendDeflateData(const std::uint8_t* InData, std::size_t InSize);
+    void AppendIDATData(const std::uint8_t* InData, std::size_t InSize);
+    void FlushIDAT();
+
+    void WriteTIFFDirectory();
+
+    std::ofstream File;
+    std::filesystem::path FilePath;
+    EImageFileFormat Format = EImageFileFormat::PNG;
+    std::int32_t Width = 0;
+    std::int32_t Height = 0;
+    std::int32_t NumWrittenRows = 0;
+
+    // Estado do stream zlib do PNG
+    std::vector<std::uint8_t> IDATBuffer;
+    std::uint64_t RemainingDeflateBytes = 0;
+    std::uint32_t RemainingBlockBytes = 0;
+    std::uint32_t Adler32 = 1;
+};
@@ -0,0 +1,472 @@
+// Mede o BlueMarble headless em uma grade de parametros e compara o resultado com um baseline
+//
+// Uso: BlueMarbleSweep [--executable <BlueMarble>] [--output-dir <Diretorio>] [--frames <N>] [--warmup <N>]
+//                      [--width <W>] [--height <H>] [--filter <Texto>] [--baseline <Arquivo.csv>]
+//                      [--tolerance <Fracao>] [--tail-tolerance <Fracao>] [--update-baseline]
+//
+// Cada configuracao roda em um processo separado com --headless e --stats. As configuracoes formam curvas:
+// numero de instancias, resolucao da esfera, wireframe e cada bloco de desenho desligado. O resultado vai
+// para <Diretorio>/BlueMarbleSweep.csv, uma linha por configuracao.
+//
+// A mediana e o p99 de cada configuracao sao comparados com a linha de mesmo nome do baseline. Uma coluna
+// "tolerance" no baseline substitui --tolerance para aquela linha. O baseline so vale para a maquina e a
+// resolucao em que foi gravado, gere um novo com --update-baseline. Com --filter so as linhas medidas mudam.
+// Uma configuracao sem linha ou sem medidas no baseline reprova a execucao, em vez de passar sem comparar.
+//
+// Retorna 0 sem regressoes, 1 com alguma regressao, 2 se alguma execucao falhou e 3 se o baseline nao existe
+// ou nao cobre todas as configuracoes medidas.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifndef BLUEMARBLE_EXECUTABLE
+#define BLUEMARBLE_EXECUTABLE "BlueMarble"
+#endif
+
+#ifndef BLUEMARBLE_SWEEP_BASELINE
+#define BLUEMARBLE_SWEEP_BASELINE "SweepBaseline.csv"
+#endif
+
+using FCsvRow = std::map<std::string, std::string>;
+
+struct FSweepSettings
+{
+    std::filesystem::path Executable = BLUEMARBLE_EXECUTABLE;
+    std::filesystem::path OutputDir = "sweep";
+    std::filesystem::path BaselineFile = BLUEMARBLE_SWEEP_BASELINE;
+    std::uint32_t NumFrames = 300;
+    std::uint32_t NumWarmUpFrames = 60;
+    std::int32_t Width = 1280;
+    std::int32_t Height = 720;
+    std::string Filter;
+
+    // Aumento relativo permitido na mediana e no p99, que varia mais entre execucoes
+    double Tolerance = 0.10;
+    double TailTolerance = 0.25;
+
+    bool bUpdateBaseline = false;
+};
+
+struct FSweepRun
+{
+    std::string Name;
+    std::string Curve;
+    std::vector<std::string> Arguments;
+};
+
+// Colunas gravadas pelo FFrameStatsRecorder::WriteCsv copiadas para o resultado. A tolerancia so e
+// preenchida a mao no baseline
+static constexpr std::string_view StatsColumns[] =
+{
+    "width", "height", "instances", "sphere_resolution", "wireframe", "draw_axis", "draw_object", "draw_instances",
+    "frames", "mean_ms", "median_ms", "p95_ms", "p99_ms", "max_ms", "fps", "update_ms", "render_ms", "tolerance"
+};
+
+static std::vector<FSweepRun> BuildSweepRuns()
+{
+    std::vector<FSweepRun> Runs;
+
+    for (const std::uint32_t NumInstances : { 1'000u, 10'000u, 100'000u, 1'000'000u, 10'000'000u })
+    {
+        Runs.push_back({ "instances/" + std::to_string(NumInstances), "instances", { "--instances", std::to_string(NumInstances) } });
+    }
+
+    // Sem as instancias, que dominariam o custo do frame
+    for (const std::uint32_t Resolution : { 16u, 64u, 256u, 1024u, 2048u })
+    {
+        Runs.push_back({ "sphere/" + std::to_string(Resolution), "sphere_resolution", { "--sphere-resolution", std::to_string(Resolution), "--no-instances" } });
+    }
+
+    Runs.push_back({ "wireframe/off", "wireframe", {} });
+    Runs.push_back({ "wireframe/on", "wireframe", { "--wireframe" } });
+
+    Runs.push_back({ "blocks/all", "blocks", {} });
+    Runs.push_back({ "blocks/no-axis", "blocks", { "--no-axis" } });
+    Runs.push_back({ "blocks/no-object", "blocks", { "--no-object" } });
+    Runs.push_back({ "blocks/no-instances", "blocks", { "--no-instances" } });
+
+    return Runs;
+}
+
+static std::vector<std::string> SplitCsvLine(const std::string& InLine)
+{
+    std::vector<std::string> Fields;
+    std::istringstream LineStream{ InLine };
+    std::string Field;
+    while (std::getline(LineStream, Field, ','))
+    {
+        if (!Field.empty() && Field.back() == '\r')
+        {
+            Field.pop_back();
+        }
+        Fields.push_back(Field);
+    }
+    return Fields;
+}
+
+static std::vector<FCsvRow> ReadCsv(const std::filesystem::path& InFilePath)
+{
+    std::vector<FCsvRow> Rows;
+
+    std::ifstream File{ InFilePath };
+    std::string Line;
+    if (!std::getline(File, Line))
+    {
+        return Rows;
+    }
+
+    const std::vector<std::string> Header = SplitCsvLine(Line);
+    while (std::getline(File, Line))
+    {
+        if (Line.empty())
+        {
+            continue;
+        }
+
+        const std::vector<std::string> Fields = SplitCsvLine(Line);
+        FCsvRow& Row = Rows.emplace_back();
+        for (std::size_t ColumnIndex = 0; ColumnIndex < Header.size() && ColumnIndex < Fields.size(); ++ColumnIndex)
+        {
+            Row[Header[ColumnIndex]] = Fields[ColumnIndex];
+        }
+    }
+
+    return Rows;
+}
+
+static bool WriteCsv(const std::filesystem::path& InFilePath, const std::vector<FCsvRow>& InRows)
+{
+    std::ofstream File{ InFilePath, std::ios::out | std::ios::trunc };
+    if (!File)
+    {
+        std::cout << "Nao foi possivel criar " << InFilePath << std::endl;
+        return false;
+    }
+
+    File << "name,curve";
+    for (const std::string_view Column : StatsColumns)
+    {
+        File << ',' << Column;
+    }
+    File << '\n';
+
+    for (const FCsvRow& Row : InRows)
+    {
+        File << Row.at("name") << ',' << Row.at("curve");
+        for (const std::string_view Column : StatsColumns)
+        {
+            const auto ValueIt = Row.find(std::string{ Column });
+            File << ',' << (ValueIt != Row.end() ? ValueIt->second : "");
+        }
+        File << '\n';
+    }
+
+    return static_cast<bool>(File);
+}
+
+static std::optional<double> GetNumber(const FCsvRow& InRow, const std::string& InColumn)
+{
+    const auto ValueIt = InRow.find(InColumn);
+    if (ValueIt == InRow.end() || ValueIt->second.empty())
+    {
+        return std::nullopt;
+    }
+
+    char* End = nullptr;
+    const double Value = std::strtod(ValueIt->second.c_str(), &End);
+    return End != ValueIt->second.c_str() ? std::optional<double>{ Value } : std::nullopt;
+}
+
+static std::string Quote(const std::string& InArgument)
+{
+    return '"' + InArgument + '"';
+}
+
+static std::optional<FCsvRow> RunConfiguration(const FSweepSettings& InSettings, const FSweepRun& InRun)
+{
+    std::string StatsFileName = InRun.Name;
+    std::replace(StatsFileName.begin(), StatsFileName.end(), '/', '_');
+    const std::filesystem::path StatsFile = InSettings.OutputDir / (StatsFileName + ".csv");
+
+    std::error_code Error;
+    std::filesystem::remove(StatsFile, Error);
+
+    // A semente fixa garante as mesmas instancias em todas as execucoes
+    std::string Command = Quote(InSettings.Executable.string());
+    Command += " --headless --seed 1";
+    Command += " --width " + std::to_string(InSettings.Width) + " --height " + std::to_string(InSettings.Height);
+    Command += " --frames " + std::to_string(InSettings.NumWarmUpFrames + InSettings.NumFrames);
+    Command += " --stats-warmup " + std::to_string(InSettings.NumWarmUpFrames);
+    Command += " --stats " + Quote(StatsFile.string());
+    for (const std::string& Argument : InRun.Arguments)
+    {
+        Command += ' ' + Argument;
+    }
+
+#ifdef _WIN32
+    // O cmd remove as aspas externas quando o comando comeca com aspas
+    Command = Quote(Command);
+#endif
+
+    std::cout << "== " << InRun.Name << std::endl;
+    const int ExitCode = std::system(Command.c_str());
+    if (ExitCode != 0)
+    {
+        std::cout << "Execucao de " << InRun.Name << " falhou (" << ExitCode << ")" << std::endl;
+        return std::nullopt;
+    }
+
+    const std::vector<FCsvRow> StatsRows = ReadCsv(StatsFile);
+    if (StatsRows.empty())
+    {
+        std::cout << "Execucao de " << InRun.Name << " nao gravou " << StatsFile << std::endl;
+        return std::nullopt;
+    }
+
+    FCsvRow Result = StatsRows.front();
+    Result["name"] = InRun.Name;
+    Result["curve"] = InRun.Curve;
+    return Result;
+}
+
+// Retorna o numero de regressoes. OutNumMissing recebe as configuracoes que o baseline nao cobre
+static std::uint32_t CompareWithBaseline(const FSweepSettings& InSettings, const std::vector<FCsvRow>& InResults, const std::vector<FCsvRow>& InBaseline, std::uint32_t& OutNumMissing)
+{
+    OutNumMissing = 0;
+
+    std::map<std::string, const FCsvRow*> BaselineRows;
+    for (const FCsvRow& Row : InBaseline)
+    {
+        if (const auto NameIt = Row.find("name"); NameIt != Row.end())
+        {
+            BaselineRows[NameIt->second] = &Row;
+        }
+    }
+
+    std::uint32_t NumRegressions = 0;
+    for (const FCsvRow& Result : InResults)
+    {
+        const std::string& Name = Result.at("name");
+        const auto BaselineIt = BaselineRows.find(Name);
+        if (BaselineIt == BaselineRows.end() || !GetNumber(*BaselineIt->second, "median_ms") || !GetNumber(*BaselineIt->second, "p99_ms"))
+        {
+            std::cout << Name << ": sem medidas no baseline, grave com --update-baseline" << std::endl;
+            OutNumMissing++;
+            continue;
+        }
+
+        const FCsvRow& Baseline = *BaselineIt->second;
+        if (GetNumber(Result, "width") != GetNumber(Baseline, "width") || GetNumber(Result, "height") != GetNumber(Baseline, "height"))
+        {
+            std::cout << Name << ": baseline gravado em outra resolucao, ignorado" << std::endl;
+            continue;
+        }
+
+        const double Tolerance = GetNumber(Baseline, "tolerance").value_or(InSettings.Tolerance);
+        const double TailTolerance = std::max(InSettings.TailTolerance, Tolerance);
+
+        const auto Check = [&](const char* InColumn, double InTolerance)
+        {
+            const std::optional<double> Current = GetNumber(Result, InColumn);
+            const std::optional<double> Reference = GetNumber(Baseline, InColumn);
+            if (!Current || !Reference || *Reference <= 0.0)
+            {
+                return;
+            }
+
+            const double Change = *Current / *Reference - 1.0;
+            const bool bRegressed = Change > InTolerance;
+            char Line[256];
+            std::snprintf(Line, sizeof(Line), "%-24s %-10s %10.3f ms  baseline %10.3f ms  %+7.1f%%  (limite %+.1f%%)%s",
+                          Name.c_str(), InColumn, *Current, *Reference, Change * 100.0, InTolerance * 100.0, bRegressed ? "  REGRESSAO" : "");
+            std::cout << Line << std::endl;
+
+            NumRegressions += bRegressed ? 1 : 0;
+        };
+
+        Check("median_ms", Tolerance);
+        Check("p99_ms", TailTolerance);
+    }
+
+    return NumRegressions;
+}
+
+int main(int Argc, char** Argv)
+{
+    FSweepSettings Settings;
+
+    for (std::int32_t ArgIndex = 1; ArgIndex < Argc; ++ArgIndex)
+    {
+        const std::string_view Arg = Argv[ArgIndex];
+        const bool bHasValue = ArgIndex + 1 < Argc;
+
+        if (Arg == "--executable" && bHasValue)
+        {
+            Settings.Executable = Argv[++ArgIndex];
+        }
+        else if (Arg == "--output-dir" && bHasValue)
+        {
+            Settings.OutputDir = Argv[++ArgIndex];
+        }
+        else if (Arg == "--baseline" && bHasValue)
+        {
+            Settings.BaselineFile = Argv[++ArgIndex];
+        }
+        else if (Arg == "--frames" && bHasValue)
+        {
+            Settings.NumFrames = static_cast<std::uint32_t>(std::max(std::atoi(Argv[++ArgIndex]), 1));
+        }
+        else if (Arg == "--warmup" && bHasValue)
+        {
+            Settings.NumWarmUpFrames = static_cast<std::uint32_t>(std::max(std::atoi(Argv[++ArgIndex]), 0));
+        }
+        else if (Arg == "--width" && bHasValue)
+        {
+            Settings.Width = std::max(std::atoi(Argv[++ArgIndex]), 1);
+        }
+        else if (Arg == "--height" && bHasValue)
+        {
+            Settings.Height = std::max(std::atoi(Argv[++ArgIndex]), 1);
+        }
+        else if (Arg == "--filter" && bHasValue)
+        {
+            Settings.Filter = Argv[++ArgIndex];
+        }
+        else if (Arg == "--tolerance" && bHasValue)
+        {
+            Settings.Tolerance = std::max(std::atof(Argv[++ArgIndex]), 0.0);
+        }
+        else if (Arg == "--tail-tolerance" && bHasValue)
+        {
+            Settings.TailTolerance = std::max(std::atof(Argv[++ArgIndex]), 0.0);
+        }
+        else if (Arg == "--update-baseline")
+        {
+            Settings.bUpdateBaseline = true;
+        }
+        else
+        {
+            std::cout << "Argumento desconhecido: " << Arg << std::endl;
+            return 2;
+        }
+    }
+
+    std::error_code Error;
+    std::filesystem::create_directories(Settings.OutputDir, Error);
+
+    std::vector<FCsvRow> Results;
+    bool bAnyRunFailed = false;
+    for (const FSweepRun& Run : BuildSweepRuns())
+    {
+        if (!Settings.Filter.empty() && Run.Name.find(Settings.Filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        if (std::optional<FCsvRow> Result = RunConfiguration(Settings, Run))
+        {
+            Results.push_back(std::move(*Result));
+        }
+        else
+        {
+            bAnyRunFailed = true;
+        }
+    }
+
+    const std::filesystem::path ResultsFile = Settings.OutputDir / "BlueMarbleSweep.csv";
+    WriteCsv(ResultsFile, Results);
+    std::cout << "Resultados gravados em " << ResultsFile << std::endl;
+
+    // As curvas: o custo de cada configuracao em relacao a primeira da mesma curva
+    std::map<std::string, double> CurveStart;
+    for (const FCsvRow& Result : Results)
+    {
+        const double Median = GetNumber(Result, "median_ms").value_or(0.0);
+        const double Start = CurveStart.emplace(Result.at("curve"), Median).first->second;
+        char Line[256];
+        std::snprintf(Line, sizeof(Line), "%-24s %10.3f ms  p99 %10.3f ms  %9.1f fps  %6.2fx",
+                      Result.at("name").c_str(), Median, GetNumber(Result, "p99_ms").value_or(0.0), GetNumber(Result, "fps").value_or(0.0), Start > 0.0 ? Median / Start : 0.0);
+        std::cout << Line << std::endl;
+    }
+
+    if (bAnyRunFailed)
+    {
+        return 2;
+    }
+
+    const std::vector<FCsvRow> Baseline = ReadCsv(Settings.BaselineFile);
+
+    if (Settings.bUpdateBaseline)
+    {
+        // As linhas medidas substituem as de mesmo nome e as demais continuam no baseline, entao um --filter so
+        // atualiza as configuracoes que rodaram
+        std::vector<FCsvRow> UpdatedBaseline;
+        for (const FCsvRow& Row : Baseline)
+        {
+            if (Row.contains("name") && Row.contains("curve"))
+            {
+                UpdatedBaseline.push_back(Row);
+            }
+        }
+
+        for (const FCsvRow& Result : Results)
+        {
+            const auto BaselineIt = std::find_if(UpdatedBaseline.begin(), UpdatedBaseline.end(), [&Result](const FCsvRow& Row)
+            {
+                return Row.at("name") == Result.at("name");
+            });
+            if (BaselineIt == UpdatedBaseline.end())
+            {
+                UpdatedBaseline.push_back(Result);
+                continue;
+            }
+
+            // Mantem as tolerancias ajustadas a mao
+            FCsvRow UpdatedRow = Result;
+            if (BaselineIt->contains("tolerance"))
+            {
+                UpdatedRow["tolerance"] = BaselineIt->at("tolerance");
+            }
+            *BaselineIt = std::move(UpdatedRow);
+        }
+
+        if (Settings.BaselineFile.has_parent_path())
+        {
+            std::filesystem::create_directories(Settings.BaselineFile.parent_path(), Error);
+        }
+        WriteCsv(Settings.BaselineFile, UpdatedBaseline);
+        std::cout << "Baseline atualizado em " << Settings.BaselineFile << std::endl;
+        return 0;
+    }
+
+    if (Baseline.empty())
+    {
+        std::cout << "Sem baseline em " << Settings.BaselineFile << ", grave um com --update-baseline" << std::endl;
+        return 3;
+    }
+
+    std::uint32_t NumMissing = 0;
+    const std::uint32_t NumRegressions = CompareWithBaseline(Settings, Results, Baseline, NumMissing);
+    std::cout << NumRegressions << " regressoes em relacao a " << Settings.BaselineFile << std::endl;
+    if (NumRegressions > 0)
+    {
+        return 1;
+    }
+
+    if (NumMissing > 0)
+    {
+        std::cout << NumMissing << " configuracoes sem medidas no baseline" << std::endl;
+        return 3;
+    }
+    return 0;
+}
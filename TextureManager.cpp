@@ -0,0 +1,307 @@
+#include "TextureManager.h"
+
+#include "AssetPack.h"
+#include "GPUResourceRegistry.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#include <algorithm>
+#include <iostream>
+
+static std::filesystem::path NormalizePath(const std::filesystem::path& InFilePath)
+{
+    return std::filesystem::absolute(InFilePath).lexically_normal();
+}
+
+void FTextureManager::Initialize(const std::filesystem::path& InTexturesDir, const FAssetPack* InAssetPack)
+{
+    TexturesDir = NormalizePath(InTexturesDir);
+    AssetPack = InAssetPack;
+
+    if (AssetPack != nullptr)
+    {
+        std::cout << "Texturas no pacote " << AssetPack->GetPackFilePath() << std::endl;
+    }
+    else
+    {
+        std::cout << "Texturas em " << TexturesDir << std::endl;
+    }
+}
+
+FTextureManager::FImage FTextureManager::DecodeImage(const std::filesystem::path& InFilePath) const
+{
+    constexpr std::int32_t NumReqComponents = 3;
+
+    FImage Image;
+    if (AssetPack == nullptr)
+    {
+        Image.Data = stbi_load(InFilePath.string().c_str(), &Image.Width, &Image.Height, nullptr, NumReqComponents);
+    }
+    else
+    {
+        // Imagens sem compressao no pacote sao decodificadas direto do arquivo mapeado
+        const std::string AssetName = "textures/" + InFilePath.lexically_relative(TexturesDir).generic_string();
+        std::vector<std::uint8_t> AssetData;
+        std::span<const std::uint8_t> EncodedImage = AssetPack->GetMappedData(AssetName);
+        if (EncodedImage.empty() && AssetPack->ReadAsset(AssetName, AssetData))
+        {
+            EncodedImage = AssetData;
+        }
+
+        if (EncodedImage.empty())
+        {
+            Image.FailureReason = "asset nao encontrado no pacote";
+            return Image;
+        }
+
+        Image.Data = stbi_load_from_memory(EncodedImage.data(), static_cast<int>(EncodedImage.size()), &Image.Width, &Image.Height, nullptr, NumReqComponents);
+    }
+
+    if (Image.Data == nullptr)
+    {
+        Image.FailureReason = stbi_failure_reason();
+    }
+    return Image;
+}
+
+void FTextureManager::Upload(FTexture& InTexture, FImage& InImage)
+{
+    // Habilita a textura para ser modificada
+    glBindTexture(GL_TEXTURE_2D, InTexture.TextureId);
+
+    // As linhas de uma imagem RGB nem sempre sao multiplas de 4 bytes
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    // Copia a textura para a memoria da GPU. Se o tamanho nao mudou os dados sao apenas substituidos
+    const GLint Level = 0;
+    if (InTexture.Width == InImage.Width && InTexture.Height == InImage.Height)
+    {
+        glTexSubImage2D(GL_TEXTURE_2D, Level, 0, 0, InImage.Width, InImage.Height, GL_RGB, GL_UNSIGNED_BYTE, InImage.Data);
+    }
+    else
+    {
+        const GLint Border = 0;
+        glTexImage2D(GL_TEXTURE_2D, Level, GL_RGB, InImage.Width, InImage.Height, Border, GL_RGB, GL_UNSIGNED_BYTE, InImage.Data);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    }
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    InTexture.Width = InImage.Width;
+    InTexture.Height = InImage.Height;
+
+    // Estimativa: os drivers guardam GL_RGB8 com 4 bytes por texel, mais a cadeia de mipmaps
+    std::int64_t TextureSize = 0;
+    for (std::int64_t MipWidth = InImage.Width, MipHeight = InImage.Height; MipWidth > 0 || MipHeight > 0; MipWidth /= 2, MipHeight /= 2)
+    {
+        TextureSize += std::max<std::int64_t>(MipWidth, 1) * std::max<std::int64_t>(MipHeight, 1) * 4;
+    }
+    FGPUResourceRegistry::Get().SetSize(EGPUResourceType::Texture, InTexture.TextureId, TextureSize);
+
+    stbi_image_free(InImage.Data);
+    InImage.Data = nullptr;
+}
+
+std::vector<FTexturePtr> FTextureManager::LoadTextures(const std::vector<std::string>& InTextureFiles)
+{
+    std::vector<FPendingReload> Loads;
+    for (const std::string& TextureFile : InTextureFiles)
+    {
+        FTexturePtr Texture = std::make_shared<FTexture>();
+        Texture->FilePath = NormalizePath(TexturesDir / TextureFile);
+
+        std::cout << "Carregando Textura " << Texture->FilePath << std::endl;
+
+        std::future<FImage> Image = std::async(std::launch::async, &FTextureManager::DecodeImage, this, Texture->FilePath);
+        Loads.push_back(FPendingReload{ .Texture = std::move(Texture), .Image = std::move(Image) });
+    }
+
+    std::vector<FTexturePtr> LoadedTextures;
+    for (FPendingReload& Load : Loads)
+    {
+        FImage Image = Load.Image.get();
+        if (Image.Data == nullptr)
+        {
+            std::cout << "Erro ao carregar " << Load.Texture->FilePath << ": " << Image.FailureReason << std::endl;
+        }
+        else
+        {
+            // Gerar o Identifador da Textura
+            Load.Texture->TextureId = CreateTexture(*Load.Texture);
+            Upload(*Load.Texture, Image);
+        }
+
+        Textures.push_back(Load.Texture);
+        LoadedTextures.push_back(Load.Texture);
+    }
+
+    return LoadedTextures;
+}
+
+bool FTextureManager::UpdateTextures(const std::vector<std::filesystem::path>& InChangedFiles)
+{
+    for (const std::filesystem::path& ChangedFile : InChangedFiles)
+    {
+        const std::filesystem::path ChangedFilePath = NormalizePath(ChangedFile);
+        const auto TextureIt = std::find_if(Textures.begin(), Textures.end(), [&ChangedFilePath](const FTexturePtr& Texture)
+        {
+            return Texture->FilePath == ChangedFilePath;
+        });
+        if (TextureIt == Textures.end())
+        {
+            continue;
+        }
+
+        // Salvar o arquivo varias vezes seguidas nao enfileira varias decodificacoes da mesma textura
+        const auto PendingIt = std::find_if(PendingReloads.begin(), PendingReloads.end(), [&TextureIt](const FPendingReload& PendingReload)
+        {
+            return PendingReload.Texture == *TextureIt;
+        });
+        if (PendingIt != PendingReloads.end())
+        {
+            PendingIt->bReloadAgain = true;
+            continue;
+        }
+
+        std::cout << "Recarregando Textura " << ChangedFilePath << std::endl;
+
+        std::future<FImage> Image = std::async(std::launch::async, &FTextureManager::DecodeImage, this, ChangedFilePath);
+        PendingReloads.push_back(FPendingReload{ .Texture = *TextureIt, .Image = std::move(Image) });
+    }
+
+    return UploadDecodedImages(false);
+}
+
+std::vector<FTexturePtr> FTextureManager::LoadTexturesAsync(const std::vector<std::string>& InTextureFiles)
+{
+    std::vector<FTexturePtr> RequestedTextures;
+    for (const std::string& TextureFile : InTextureFiles)
+    {
+        const std::filesystem::path FilePath = NormalizePath(TexturesDir / TextureFile);
+        const auto TextureIt = std::find_if(Textures.begin(), Textures.end(), [&FilePath](const FTexturePtr& Texture)
+        {
+            return Texture->FilePath == FilePath;
+        });
+        if (TextureIt != Textures.end())
+        {
+            RequestedTextures.push_back(*TextureIt);
+            continue;
+        }
+
+        FTexturePtr Texture = std::make_shared<FTexture>();
+        Texture->FilePath = FilePath;
+
+        std::cout << "Carregando Textura em segundo plano " << Texture->FilePath << std::endl;
+
+        std::future<FImage> Image = std::async(std::launch::async, &FTextureManager::DecodeImage, this, Texture->FilePath);
+        PendingReloads.push_back(FPendingReload{ .Texture = Texture, .Image = std::move(Image) });
+
+        Textures.push_back(Texture);
+        RequestedTextures.push_back(std::move(Texture));
+    }
+
+    return RequestedTextures;
+}
+
+bool FTextureManager::IsLoading(const FTexturePtr& InTexture) const
+{
+    return std::any_of(PendingReloads.begin(), PendingReloads.end(), [&InTexture](const FPendingReload& PendingReload)
+    {
+        return PendingReload.Texture == InTexture;
+    });
+}
+
+void FTextureManager::WaitForPendingLoads()
+{
+    UploadDecodedImages(true);
+}
+
+void FTextureManager::RemoveUnusedTextures()
+{
+    // Uma textura com envio pendente tambem e referenciada pelo PendingReloads
+    const auto FirstUnusedIt = std::remove_if(Textures.begin(), Textures.end(), [](const FTexturePtr& Texture)
+    {
+        if (Texture.use_count() > 1)
+        {
+            return false;
+        }
+
+        std::cout << "Apagando Textura " << Texture->FilePath << std::endl;
+        FGPUResourceRegistry::Get().Delete(EGPUResourceType::Texture, Texture->TextureId);
+        return true;
+    });
+    Textures.erase(FirstUnusedIt, Textures.end());
+}
+
+bool FTextureManager::UploadDecodedImages(bool bInWait)
+{
+    bool bAnyTextureUploaded = false;
+    for (auto ReloadIt = PendingReloads.begin(); ReloadIt != PendingReloads.end();)
+    {
+        if (!bInWait && ReloadIt->Image.wait_for(std::chrono::seconds{ 0 }) != std::future_status::ready)
+        {
+            ++ReloadIt;
+            continue;
+        }
+
+        FImage Image = ReloadIt->Image.get();
+        if (ReloadIt->bReloadAgain)
+        {
+            // A imagem pode ser de antes do ultimo save, o arquivo e decodificado de novo sem enviar esta
+            stbi_image_free(Image.Data);
+            std::cout << "Recarregando Textura " << ReloadIt->Texture->FilePath << std::endl;
+            ReloadIt->Image = std::async(std::launch::async, &FTextureManager::DecodeImage, this, ReloadIt->Texture->FilePath);
+            ReloadIt->bReloadAgain = false;
+            continue;
+        }
+
+        if (Image.Data == nullptr)
+        {
+            // Mantem a textura antiga, o arquivo pode ter sido salvo pela metade
+            std::cout << "Erro ao recarregar " << ReloadIt->Texture->FilePath << ": " << Image.FailureReason << std::endl;
+        }
+        else
+        {
+            if (ReloadIt->Texture->TextureId == 0)
+            {
+                ReloadIt->Texture->TextureId = CreateTexture(*ReloadIt->Texture);
+            }
+
+            Upload(*ReloadIt->Texture, Image);
+            bAnyTextureUploaded = true;
+        }
+
+        ReloadIt = PendingReloads.erase(ReloadIt);
+    }
+
+    return bAnyTextureUploaded;
+}
+
+GLuint FTextureManager::CreateTexture(const FTexture& InTexture)
+{
+    return FGPUResourceRegistry::Get().CreateTexture(GL_TEXTURE_2D, InTexture.FilePath.filename().string());
+}
+
+void FTextureManager::Shutdown()
+{
+    // As decodificacoes em andamento precisam terminar antes de liberar as imagens
+    for (FPendingReload& PendingReload : PendingReloads)
+    {
+        stbi_image_free(PendingReload.Image.get().Data);
+    }
+    PendingReloads.clear();
+
+    for (const FTexturePtr& Texture : Textures)
+    {
+        FGPUResourceRegistry::Get().Delete(EGPUResourceType::Texture, Texture->TextureId);
+        Texture->Width = 0;
+        Texture->Height = 0;
+    }
+    Textures.clear();
+}
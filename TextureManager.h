@@ -0,0 +1,89 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+class FAssetPack;
+
+struct FTexture
+{
+    GLuint TextureId = 0;
+    std::filesystem::path FilePath;
+    std::int32_t Width = 0;
+    std::int32_t Height = 0;
+};
+
+using FTexturePtr = std::shared_ptr<FTexture>;
+
+class FTextureManager
+{
+public:
+
+    // Com um pacote de assets as texturas sao lidas do pacote, com o caminho relativo a InTexturesDir e o prefixo "textures/"
+    void Initialize(const std::filesystem::path& InTexturesDir, const FAssetPack* InAssetPack = nullptr);
+
+    const std::filesystem::path& GetTexturesDir() const { return TexturesDir; }
+
+    // Decodifica todas as texturas em paralelo e envia para a GPU
+    std::vector<FTexturePtr> LoadTextures(const std::vector<std::string>& InTextureFiles);
+
+    // Decodifica em segundo plano e retorna na hora. Cada textura so ganha um identificador quando for enviada
+    // por um UpdateTextures depois de decodificada. Arquivos ja carregados reaproveitam a textura existente
+    std::vector<FTexturePtr> LoadTexturesAsync(const std::vector<std::string>& InTextureFiles);
+
+    // Se a textura ainda esta sendo decodificada ou aguardando o envio
+    bool IsLoading(const FTexturePtr& InTexture) const;
+
+    // Espera as decodificacoes em andamento e envia todas para a GPU
+    void WaitForPendingLoads();
+
+    // Apaga as texturas que so o gerenciador ainda referencia
+    void RemoveUnusedTextures();
+
+    // Decodifica de novo, em segundo plano, as texturas que foram alteradas e envia os novos dados
+    // para a GPU mantendo o mesmo identificador. Retorna true se alguma textura foi enviada neste frame.
+    bool UpdateTextures(const std::vector<std::filesystem::path>& InChangedFiles);
+
+    // Apaga todas as texturas, os identificadores em FTexture voltam a ser zero
+    void Shutdown();
+
+private:
+
+    struct FImage
+    {
+        std::int32_t Width = 0;
+        std::int32_t Height = 0;
+        std::uint8_t* Data = nullptr;
+        const char* FailureReason = nullptr;
+    };
+
+    struct FPendingReload
+    {
+        FTexturePtr Texture;
+        std::future<FImage> Image;
+
+        // O arquivo mudou de novo durante a decodificacao, que pode ter lido o arquivo pela metade. Quando ela
+        // termina a imagem e descartada e o arquivo e decodificado outra vez, entao o ultimo save sempre vale
+        bool bReloadAgain = false;
+    };
+
+    FImage DecodeImage(const std::filesystem::path& InFilePath) const;
+
+    // Envia as imagens ja decodificadas, ou todas esperando as que faltam. Retorna true se alguma foi enviada
+    bool UploadDecodedImages(bool bInWait);
+
+    static void Upload(FTexture& InTexture, FImage& InImage);
+
+    static GLuint CreateTexture(const FTexture& InTexture);
+
+    std::filesystem::path TexturesDir;
+    const FAssetPack* AssetPack = nullptr;
+    std::vector<FTexturePtr> Textures;
+    std::vector<FPendingReload> PendingReloads;
+};
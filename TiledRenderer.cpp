@@ -0,0 +1,134 @@
+#include "TiledRenderer.h"
+
+#include <algorithm>
+#include <iostream>
+
+bool FTiledRenderer::Start(const FTiledRenderSettings& InSettings, const FSimpleCamera& InCamera, float InTime)
+{
+    if (IsActive())
+    {
+        Cancel();
+    }
+
+    Settings = InSettings;
+    Settings.Width = std::max(Settings.Width, 1);
+    Settings.Height = std::max(Settings.Height, 1);
+
+    GLint MaxTextureSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &MaxTextureSize);
+    GLint MaxViewportSize[2] = {};
+    glGetIntegerv(GL_MAX_VIEWPORT_DIMS, MaxViewportSize);
+    Settings.TileSize = std::clamp(Settings.TileSize, 16, std::min({ MaxTextureSize, MaxViewportSize[0], MaxViewportSize[1] }));
+
+    Camera = InCamera;
+    ViewMatrix = Camera.GetView();
+    Time = InTime;
+
+    NumTilesX = (Settings.Width + Settings.TileSize - 1) / Settings.TileSize;
+    NumTilesY = (Settings.Height + Settings.TileSize - 1) / Settings.TileSize;
+
+    if (!Writer.Open(Settings.OutputPath, Settings.Width, Settings.Height))
+    {
+        return false;
+    }
+
+    RowPixels.resize(static_cast<std::size_t>(Settings.Width) * Settings.TileSize * 3);
+    TileTarget.Initialize(Settings.TileSize, Settings.TileSize, "Tile Target");
+    SetCurrentTile(0, 0);
+
+    std::cout << "Renderizando " << Settings.OutputPath << " (" << Settings.Width << "x" << Settings.Height << ") em "
+              << NumTilesX << "x" << NumTilesY << " tiles de " << Settings.TileSize << std::endl;
+    return true;
+}
+
+void FTiledRenderer::Cancel()
+{
+    if (IsActive())
+    {
+        Writer.Close();
+        std::error_code Error;
+        std::filesystem::remove(Settings.OutputPath, Error);
+        std::cout << "Renderizacao de " << Settings.OutputPath << " cancelada" << std::endl;
+    }
+
+    RowPixels = {};
+}
+
+void FTiledRenderer::Shutdown()
+{
+    Cancel();
+    TileTarget.Shutdown();
+}
+
+glm::mat4 FTiledRenderer::GetProjectionMatrix() const
+{
+    return Camera.GetTileProjection(Settings.Width, Settings.Height, CurrentTile.X, CurrentTile.Y, CurrentTile.Width, CurrentTile.Height);
+}
+
+void FTiledRenderer::SetCurrentTile(std::int32_t InTileX, std::int32_t InTileY)
+{
+    TileIndexX = InTileX;
+    TileIndexY = InTileY;
+
+    CurrentTile.X = TileIndexX * Settings.TileSize;
+    CurrentTile.Y = TileIndexY * Settings.TileSize;
+    CurrentTile.Width = std::min(Settings.TileSize, Settings.Width - CurrentTile.X);
+    CurrentTile.Height = std::min(Settings.TileSize, Settings.Height - CurrentTile.Y);
+}
+
+void FTiledRenderer::FinishTile()
+{
+    if (!IsActive())
+    {
+        return;
+    }
+
+    // Leitura sincrona: a imagem e gerada offline e o tile precisa estar completo antes de desenhar o proximo.
+    // Com GL_PACK_ROW_LENGTH o tile cai direto na sua coluna dentro da linha de tiles
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, TileTarget.GetFramebuffer());
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glPixelStorei(GL_PACK_ROW_LENGTH, Settings.Width);
+    glReadPixels(0, 0, CurrentTile.Width, CurrentTile.Height, GL_RGB, GL_UNSIGNED_BYTE, RowPixels.data() + static_cast<std::size_t>(CurrentTile.X) * 3);
+    glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+    if (TileIndexX + 1 < NumTilesX)
+    {
+        SetCurrentTile(TileIndexX + 1, TileIndexY);
+        return;
+    }
+
+    // Linha de tiles completa, o arquivo e gravado de cima para baixo
+    const std::size_t RowSize = static_cast<std::size_t>(Settings.Width) * 3;
+    for (std::int32_t Row = CurrentTile.Height - 1; Row >= 0; --Row)
+    {
+        Writer.WriteRow(RowPixels.data() + static_cast<std::size_t>(Row) * RowSize);
+    }
+
+    if (TileIndexY + 1 < NumTilesY)
+    {
+        SetCurrentTile(0, TileIndexY + 1);
+        return;
+    }
+
+    if (Writer.Close())
+    {
+        std::cout << "Imagem gravada em " << Settings.OutputPath << std::endl;
+    }
+    else
+    {
+        std::cout << "Erro ao gravar " << Settings.OutputPath << std::endl;
+    }
+
+    RowPixels = {};
+}
+
+float FTiledRenderer::GetProgress() const
+{
+    if (!IsActive())
+    {
+        return 0.0f;
+    }
+
+    return static_cast<float>(TileIndexY * NumTilesX + TileIndexX) / static_cast<float>(NumTilesX * NumTilesY);
+}
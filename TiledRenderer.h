@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Camera.h"
+#include "RenderTarget.h"
+#include "StreamingImageWriter.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+struct FTiledRenderSettings
+{
+    // .png ou .tif/.tiff
+    std::filesystem::path OutputPath = "poster/BlueMarble.png";
+    std::int32_t Width = 16384;
+    std::int32_t Height = 8192;
+
+    // Limitado pelo maior framebuffer suportado pelo driver
+    std::int32_t TileSize = 2048;
+};
+
+// Renderiza imagens maiores que o maior framebuffer possivel, um tile por frame. Cada tile usa uma parte
+// do frustum da camera (FSimpleCamera::GetTileProjection) e e lido para a linha de tiles atual. Quando a
+// linha termina ela e gravada no disco, entao so uma linha de tiles fica na memoria. A camera e o tempo
+// ficam congelados no Start para que todos os tiles mostrem o mesmo instante.
+class FTiledRenderer
+{
+public:
+
+    struct FTile
+    {
+        std::int32_t X = 0;
+        std::int32_t Y = 0;
+        std::int32_t Width = 0;
+        std::int32_t Height = 0;
+    };
+
+    bool Start(const FTiledRenderSettings& InSettings, const FSimpleCamera& InCamera, float InTime);
+
+    // Descarta a imagem incompleta
+    void Cancel();
+
+    void Shutdown();
+
+    bool IsActive() const { return Writer.IsOpen(); }
+
+    // Framebuffer e area que o frame atual deve desenhar
+    GLuint GetFramebuffer() const { return TileTarget.GetFramebuffer(); }
+    const FTile& GetCurrentTile() const { return CurrentTile; }
+
+    glm::mat4 GetViewMatrix() const { return ViewMatrix; }
+    glm::mat4 GetProjectionMatrix() const;
+    float GetTime() const { return Time; }
+
+    // Le o tile desenhado e passa para o proximo. Grava a linha de tiles quando ela termina
+    void FinishTile();
+
+    float GetProgress() const;
+    const FTiledRenderSettings& GetSettings() const { return Settings; }
+
+private:
+
+    void SetCurrentTile(std::int32_t InTileX, std::int32_t InTileY);
+
+    FTiledRenderSettings Settings;
+    FSimpleCamera Camera;
+    glm::mat4 ViewMatrix{ 1.0f };
+    float Time = 0.0f;
+
+    FRenderTarget TileTarget;
+    FStreamingImageWriter Writer;
+
+    // Uma linha de tiles, RGB8 com as linhas de baixo para cima como o glReadPixels entrega
+    std::vector<std::uint8_t> RowPixels;
+
+    FTile CurrentTile;
+    std::int32_t NumTilesX = 0;
+    std::int32_t NumTilesY = 0;
+    std::int32_t TileIndexX = 0;
+    std::int32_t TileIndexY = 0;
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Tres copias de T trocadas sem locks entre exatamente uma thread escritora e uma leitora.
+// A escritora sempre tem um buffer livre para escrever e a leitora sempre le o ultimo publicado
+template<typename T>
+class TTripleBuffer
+{
+public:
+
+    // Chamado apenas pela thread escritora
+    T& GetWriteBuffer() { return Buffers[WriteIndex]; }
+
+    // Chamado apenas pela thread escritora. Troca o buffer escrito pelo buffer intermediario
+    void Publish()
+    {
+        const std::uint8_t PreviousState = State.exchange(WriteIndex | DirtyBit, std::memory_order_acq_rel);
+        WriteIndex = PreviousState & IndexMask;
+    }
+
+    // Chamado apenas pela thread leitora. Retorna true se um novo buffer foi publicado desde a ultima chamada
+    bool Acquire()
+    {
+        if ((State.load(std::memory_order_relaxed) & DirtyBit) == 0)
+        {
+            return false;
+        }
+
+        const std::uint8_t PreviousState = State.exchange(ReadIndex, std::memory_order_acq_rel);
+        ReadIndex = PreviousState & IndexMask;
+        return true;
+    }
+
+    // Chamado apenas pela thread leitora
+    const T& GetReadBuffer() const { return Buffers[ReadIndex]; }
+
+private:
+
+    static constexpr std::uint8_t IndexMask = 0x3;
+    static constexpr std::uint8_t DirtyBit = 0x4;
+
+    std::array<T, 3> Buffers{};
+
+    // Indice do buffer intermediario e se ele foi publicado mas ainda nao lido
+    std::atomic<std::uint8_t> State{ 1 };
+    std::uint8_t WriteIndex = 0;
+    std::uint8_t ReadIndex = 2;
+};
@@ -0,0 +1,107 @@
+#include "WorkerPool.h"
+
+#include <algorithm>
+
+std::uint32_t FWorkerPool::DefaultNumWorkers()
+{
+    // Uma thread a menos porque a thread que chama ParallelFor tambem trabalha
+    const std::uint32_t NumHardwareThreads = std::thread::hardware_concurrency();
+    return std::max(NumHardwareThreads, 2u) - 1;
+}
+
+FWorkerPool::FWorkerPool(std::uint32_t InNumWorkers)
+{
+    for (std::uint32_t WorkerIndex = 0; WorkerIndex < InNumWorkers; ++WorkerIndex)
+    {
+        Workers.emplace_back([this] { WorkerMain(); });
+    }
+}
+
+FWorkerPool::~FWorkerPool()
+{
+    {
+        std::lock_guard Lock{ Mutex };
+        bShouldStop = true;
+    }
+    WakeCondition.notify_all();
+
+    for (std::thread& Worker : Workers)
+    {
+        Worker.join();
+    }
+}
+
+std::uint32_t FWorkerPool::RunJobs(const std::function<void(std::uint32_t)>& InJob, std::uint32_t InNumJobs)
+{
+    std::uint32_t NumJobsRun = 0;
+    for (std::uint32_t JobIndex = NextJob.fetch_add(1); JobIndex < InNumJobs; JobIndex = NextJob.fetch_add(1))
+    {
+        InJob(JobIndex);
+        NumJobsRun++;
+    }
+    return NumJobsRun;
+}
+
+void FWorkerPool::WorkerMain()
+{
+    std::uint64_t LastGeneration = 0;
+
+    std::unique_lock Lock{ Mutex };
+    while (true)
+    {
+        WakeCondition.wait(Lock, [this, LastGeneration] { return bShouldStop || Generation != LastGeneration; });
+        if (bShouldStop)
+        {
+            return;
+        }
+
+        // Um worker que acorda depois do ParallelFor terminar nao tem o que fazer. O job, a contagem e a geracao sao
+        // lidos juntos sob o lock, e o ParallelFor so limpa CurrentJob depois que os workers ativos terminam
+        LastGeneration = Generation;
+        if (CurrentJob == nullptr)
+        {
+            continue;
+        }
+
+        const std::function<void(std::uint32_t)>* Job = CurrentJob;
+        const std::uint32_t JobCount = NumJobs;
+        NumActiveWorkers++;
+
+        Lock.unlock();
+        const std::uint32_t NumJobsRun = RunJobs(*Job, JobCount);
+        Lock.lock();
+
+        NumCompletedJobs += NumJobsRun;
+        NumActiveWorkers--;
+        DoneCondition.notify_one();
+    }
+}
+
+void FWorkerPool::ParallelFor(std::uint32_t InNumJobs, const std::function<void(std::uint32_t)>& InJob)
+{
+    if (Workers.empty() || InNumJobs <= 1)
+    {
+        for (std::uint32_t JobIndex = 0; JobIndex < InNumJobs; ++JobIndex)
+        {
+            InJob(JobIndex);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard Lock{ Mutex };
+        CurrentJob = &InJob;
+        NumJobs = InNumJobs;
+        NumCompletedJobs = 0;
+        NextJob = 0;
+        Generation++;
+    }
+    WakeCondition.notify_all();
+
+    const std::uint32_t NumJobsRun = RunJobs(InJob, InNumJobs);
+
+    std::unique_lock Lock{ Mutex };
+    NumCompletedJobs += NumJobsRun;
+    DoneCondition.wait(Lock, [this] { return NumCompletedJobs == NumJobs && NumActiveWorkers == 0; });
+    CurrentJob = nullptr;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Conjunto fixo de threads para executar jobs curtos em paralelo sem criar threads a cada frame
+class FWorkerPool
+{
+public:
+
+    explicit FWorkerPool(std::uint32_t InNumWorkers = DefaultNumWorkers());
+    ~FWorkerPool();
+
+    FWorkerPool(const FWorkerPool&) = delete;
+    FWorkerPool& operator=(const FWorkerPool&) = delete;
+
+    static std::uint32_t DefaultNumWorkers();
+
+    std::uint32_t GetNumWorkers() const { return static_cast<std::uint32_t>(Workers.size()); }
+
+    // Executa InJob(JobIndex) para JobIndex em [0, InNumJobs). A thread que chama tambem executa
+    // jobs e so retorna quando todos terminarem
+    void ParallelFor(std::uint32_t InNumJobs, const std::function<void(std::uint32_t)>& InJob);
+
+private:
+
+    void WorkerMain();
+
+    // Executa jobs ate acabarem, retorna quantos foram executados
+    std::uint32_t RunJobs(const std::function<void(std::uint32_t)>& InJob, std::uint32_t InNumJobs);
+
+    std::vector<std::thread> Workers;
+
+    std::mutex Mutex;
+    std::condition_variable WakeCondition;
+    std::condition_variable DoneCondition;
+
+    const std::function<void(std::uint32_t)>* CurrentJob = nullptr;
+    std::uint32_t NumJobs = 0;
+    std::uint32_t NumCompletedJobs = 0;
+    std::uint32_t NumActiveWorkers = 0;
+    std::uint64_t Generation = 0;
+    bool bShouldStop = false;
+
+    std::atomic<std::uint32_t> NextJob{ 0 };
+};
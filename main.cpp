@@ -1,4 +1,6 @@
 #include <array>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
 #include <vector>
@@ -8,6 +10,8 @@
 #include <thread>
 #include <functional>
 #include <numeric>
+#include <limits>
+#include <string>
 #include <filesystem>
 
 #include <glad/glad.h>
@@ -22,38 +26,72 @@
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
 
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
-
+#include "AssetPack.h"
 #include "Camera.h"
+#include "ControlServer.h"
+#include "GLStateCache.h"
+#include "GLTracer.h"
+#include "GPUResourceRegistry.h"
+#include "InputRecording.h"
+#include "MeshArena.h"
+#include "MeshCache.h"
+#include "MeshGenerators.h"
+#include "MemoryTracker.h"
+#include "DirectoryWatcher.h"
+#include "DynamicResolution.h"
+#include "FrameAllocator.h"
+#include "FrameCapture.h"
+#include "FramePacer.h"
+#include "FrameStats.h"
+#include "FrameUpdateThread.h"
+#include "GPUTimer.h"
+#include "MetricsExporter.h"
+#include "RenderQueue.h"
+#include "RenderTarget.h"
+#include "Scene.h"
 #include "ShaderManager.h"
-
-enum class ESceneType
-{
-    BlueMarble,
-    Cylinder,
-    Cube,
-    Ortho
-};
-
-struct FVertex
-{
-    glm::vec3 Position;
-    glm::vec3 Normal;
-    glm::vec2 UV;
-};
-
-struct FTriangle
+#include "TextureManager.h"
+#include "TiledRenderer.h"
+#include "TripleBuffer.h"
+#include "WorkerPool.h"
+
+#ifndef BLUEMARBLE_SHADERS_DIR
+#define BLUEMARBLE_SHADERS_DIR "shaders"
+#endif
+
+#ifndef BLUEMARBLE_TEXTURES_DIR
+#define BLUEMARBLE_TEXTURES_DIR "textures"
+#endif
+
+// Vazio le os arquivos soltos dos diretorios de shaders e texturas, com hot reload
+#ifndef BLUEMARBLE_ASSET_PACK
+#define BLUEMARBLE_ASSET_PACK ""
+#endif
+
+#ifndef BLUEMARBLE_SCENES_DIR
+#define BLUEMARBLE_SCENES_DIR "scenes"
+#endif
+
+#ifndef BLUEMARBLE_CACHE_DIR
+#define BLUEMARBLE_CACHE_DIR "cache"
+#endif
+
+// Texto de um caminho mostrado pela UI. O path::string() cria uma copia a cada chamada, aqui ela so e refeita
+// quando o caminho muda, para a UI nao alocar a cada frame
+struct FPathLabel
 {
-    GLuint V0;
-    GLuint V1;
-    GLuint V2;
-};
+    const char* Get(const std::filesystem::path& InPath)
+    {
+        if (InPath.native() != Path.native())
+        {
+            Path = InPath;
+            Label = InPath.string();
+        }
+        return Label.c_str();
+    }
 
-struct FLineVertex
-{
-    glm::vec3 Position;
-    glm::vec3 Color;
+    std::filesystem::path Path;
+    std::string Label;
 };
 
 struct FLight
@@ -62,24 +100,41 @@ struct FLight
     float Intensity;
 };
 
-struct FGeometry
-{
-    std::vector<FVertex> Vertices;
-    std::vector<FTriangle> Indices;
-};
-
 struct FRenderData
 {
-    GLuint VAO;
-    GLuint NumElements;
+    FMeshHandle Mesh = InvalidMeshHandle;
     glm::mat4 Transform = glm::identity<glm::mat4>();
 };
 
 struct FInstancedRenderData : public FRenderData
 {
+    FGPUBufferHandle Instances = InvalidGPUBufferHandle;
     GLuint NumInstances;
 };
 
+// Objeto principal da cena e os handles do seu programa, trocados juntos quando a proxima cena fica pronta
+struct FObjectRenderData : public FRenderData
+{
+    explicit FObjectRenderData(FPreparedScene&& InScene)
+        : Scene{ std::move(InScene) }
+        , FrameBlock{ Scene.Program, "FrameUBO" }
+        , ModelBlock{ Scene.Program, "ModelUBO" }
+        , LightBlock{ Scene.Program, "LightUBO" }
+        , EarthTextureUniform{ Scene.Program, "EarthTexture" }
+        , CloudsTextureUniform{ Scene.Program, "CloudsTexture" }
+    {
+        Mesh = Scene.Mesh;
+        Transform = Scene.Description.GetTransform();
+    }
+
+    FPreparedScene Scene;
+    FUniformBlockHandle FrameBlock;
+    FUniformBlockHandle ModelBlock;
+    FUniformBlockHandle LightBlock;
+    FUniformHandle EarthTextureUniform;
+    FUniformHandle CloudsTextureUniform;
+};
+
 struct FPerFrameData
 {
     glm::mat4 ViewMatrix;
@@ -87,12 +142,19 @@ struct FPerFrameData
     float Time;
 };
 
-struct FPerModelData
+// Estado imutavel de um frame, produzido pela thread de update e lido pela thread do OpenGL
+struct FFrameSnapshot
 {
-    glm::mat4 ModelMatrix;
-    glm::mat4 NormalMatrix;
+    FPerFrameData FrameData;
+    FLight PointLight;
+    float CameraFar = 0.0f;
+    double UpdateTime = 0.0;
+
+    // Instante do primeiro evento de entrada aplicado neste update, zero se nenhum
+    double InputEventTime = 0.0;
 };
 
+
 struct FSimulationConfig
 {
     bool bPause = true;
@@ -107,8 +169,34 @@ struct FSimulationConfig
     std::vector<float> FrameTimeHistory;
     std::vector<float> FramesPerSecondHistory;
 
+    // Tempo entre um evento de entrada e o glfwSwapBuffers do primeiro frame que mostra o seu efeito
+    double InputLatency = 0.0;
+    std::vector<float> InputLatencyHistory;
+    std::uint32_t InputLatencyPlotOffset = 0;
+
     std::uint32_t NumFramePlotValues = 120;
     std::uint32_t FramePlotOffset = 0;
+
+    // Com o pipeline o update do proximo frame roda junto com o desenho do frame atual
+    bool bPipelineFrames = true;
+    double UpdateTime = 0.0;
+    double RenderTime = 0.0;
+
+    // Se maior que zero a simulacao avanca sempre este tempo por frame, usado na captura para que o video
+    // tenha a velocidade certa independente de quanto tempo cada frame levou para ser desenhado
+    double FixedTimeStep = 0.0;
+
+    // Fecha o programa depois deste numero de frames, zero nao tem limite
+    std::uint32_t MaxFrames = 0;
+
+    // Com --stats os tempos dos frames depois do aquecimento sao resumidos em um CSV no fim da execucao
+    FFrameStatsRecorder FrameStats;
+    std::filesystem::path StatsFile;
+    std::uint32_t NumStatsWarmUpFrames = 60;
+
+    // Com --metrics-port as metricas de cada frame sao servidas para o Prometheus em 127.0.0.1
+    FMetricsExporter MetricsExporter;
+    std::uint16_t MetricsPort = 0;
 };
 
 struct FRenderConfig
@@ -120,7 +208,60 @@ struct FRenderConfig
     bool bDrawInstances = true;
     bool bEnableVsync = true;
 
+    // Limite do FFramePacer, zero nao limita. Com o VSync desligado evita que o loop ocupe um nucleo inteiro
+    float FrameRateLimit = 0.0f;
+    FFramePacer FramePacer;
+
+    std::filesystem::path ShadersDir = BLUEMARBLE_SHADERS_DIR;
+    std::filesystem::path TexturesDir = BLUEMARBLE_TEXTURES_DIR;
+    std::filesystem::path CacheDir = BLUEMARBLE_CACHE_DIR;
+    std::filesystem::path AssetPackFile = BLUEMARBLE_ASSET_PACK;
+
+    // Se aberto, shaders e texturas sao lidos do pacote e nao ha hot reload
+    FAssetPack AssetPack;
+
+    // Observa os diretorios de shaders e texturas para o hot reload
+    std::unique_ptr<FDirectoryWatcher> AssetWatcher;
+    std::vector<std::filesystem::path> ChangedAssetFiles;
+
     FShaderManager ShaderManager;
+    FTextureManager TextureManager;
+    FGLStateCache StateCache;
+
+    // Tempo de GPU de cada passada, lido alguns frames depois sem travar o frame
+    std::array<FGPUTimer, static_cast<std::size_t>(EGPUPass::Count)> GPUPassTimers;
+
+    // Vertices, indices e matrizes das instancias de todas as malhas estaticas
+    FMeshArena MeshArena;
+
+    // Malhas geradas ficam em disco e sao mapeadas direto nas proximas execucoes
+    FMeshCache MeshCache;
+
+    // Os pacotes de desenho sao gravados em paralelo pelo WorkerPool e enviados pela thread do OpenGL
+    FWorkerPool WorkerPool;
+    FRenderQueue RenderQueue;
+
+    // Textos e dados temporarios da thread principal, descartados no inicio de cada frame
+    FFrameAllocator FrameAllocator;
+
+    // Grava os frames em disco, lidos da GPU por PBOs sem travar o frame
+    FFrameCapture FrameCapture;
+    std::filesystem::path CaptureFile = "capture/BlueMarble.y4m";
+    ECaptureFormat CaptureFormat = ECaptureFormat::Y4M;
+    std::uint32_t CaptureFramesPerSecond = 60;
+    bool bCaptureOnStart = false;
+
+    // Imagens maiores que o framebuffer, um tile por frame
+    FTiledRenderer TiledRenderer;
+    FTiledRenderSettings PosterSettings;
+    bool bPosterOnStart = false;
+
+    // Caminhos mostrados pela UI
+    FPathLabel CaptureOutputLabel;
+    FPathLabel PosterOutputLabel;
+    std::vector<FPathLabel> ShaderLogLabels;
+
+    std::int32_t NumTraceFrames = 1;
 };
 
 struct FViewportConfig
@@ -128,14 +269,46 @@ struct FViewportConfig
     GLFWwindow* Window = nullptr;
     std::int32_t WindowWidth = 1920;
     std::int32_t WindowHeight = 1080;
+
+    // Sem janela visivel e sem UI, a cena e desenhada no SceneTarget. Continua precisando de um contexto
+    // do OpenGL: em maquinas sem GPU o Mesa (llvmpipe) com Xvfb atende
+    bool bHeadless = false;
+    FRenderTarget SceneTarget;
+
+    // Sob demanda o loop so desenha quando algo muda a imagem, senao dorme esperando eventos
+    bool bRenderOnDemand = false;
+    double IdleEventTimeout = 0.25;
+
+    // Frames ainda pedidos pela ultima mudanca e quantas vezes o loop acordou sem desenhar
+    std::uint32_t NumRequestedFrames = 0;
+    std::uint64_t NumIdleWakeUps = 0;
+
+    // Com a janela visivel a cena pode ser desenhada em resolucao menor e ampliada, a UI fica na resolucao da janela
+    FDynamicResolution DynamicResolution;
 };
 
 struct FSceneConfig
 {
-    static constexpr ESceneType SceneType = ESceneType::BlueMarble;
-    static constexpr GLuint SphereResolution = 100;
+    // Cenas descritas em arquivos JSON. Sem --scene a cena inicial e a FSceneDescription padrao, a BlueMarble
+    std::filesystem::path ScenesDir = BLUEMARBLE_SCENES_DIR;
+    std::filesystem::path SceneFile;
+    std::vector<std::filesystem::path> SceneFiles;
+    std::vector<std::string> SceneNames;
+
+    // Cena desenhada. A proxima e preparada em segundo plano e trocada num unico frame quando fica pronta
+    FSceneDescription Description;
+    FScenePreparer Preparer;
+    double PreparationTime = 0.0;
+    double MeshGenerationTime = 0.0;
+
+    // Resolucao mostrada pela UI. Com --sphere-resolution substitui a da cena inicial, zero usa a do arquivo
+    std::int32_t MeshResolution = 0;
+
     std::int32_t NumInstances = 500'000;
 
+    // Semente das posicoes das instancias, zero sorteia uma no inicio. Fixa para que o replay gere a mesma cena
+    std::uint32_t RandomSeed = 0;
+
     FSimpleCamera Camera;
     FLight PointLight;
 };
@@ -150,6 +323,32 @@ struct FMouse
 struct FInputConfig
 {
     FMouse Mouse;
+
+    // Com --record a entrada e a camera de cada frame sao gravadas, com --replay sao reproduzidas
+    // no lugar da entrada ao vivo. Os dois usam um passo fixo na simulacao
+    FInputRecorder Recorder;
+    FInputReplay Replay;
+    std::filesystem::path RecordFile;
+    std::filesystem::path ReplayFile;
+    double RecordTimeStep = 1.0 / 60.0;
+
+    // Frames do replay em que a camera calculada nao bateu com a gravada
+    std::uint32_t NumDivergentFrames = 0;
+    float MaxCameraDivergence = 0.0f;
+
+    // Instante (glfwGetTime) do primeiro evento ao vivo que muda a imagem e ainda nao foi consumido por um update
+    double PendingEventTime = 0.0;
+
+    // Com --control-port comandos em linhas JSON chegam por um socket local e sao aplicados no inicio do frame
+    FControlServer ControlServer;
+    std::uint16_t ControlPort = 0;
+
+    // Frames que ainda faltam do ultimo comando step, que so e respondido quando eles terminam
+    std::uint32_t NumStepFrames = 0;
+    FControlCommand StepCommand;
+
+    // Ultimo comando scene, respondido quando a cena pedida entra no frame
+    FControlCommand SceneCommand;
 };
 
 struct FConfig
@@ -163,374 +362,15 @@ struct FConfig
 
 FConfig gConfig;
 
-FGeometry GenerateSphere(GLuint InResolution)
-{
-    FGeometry SphereGeometry;
-
-    constexpr float Pi = glm::pi<float>();
-    constexpr float TwoPi = glm::two_pi<float>();
-    const float InvResolution = 1.0f / static_cast<float>(InResolution - 1);
-
-    for (GLuint UIndex = 0; UIndex < InResolution; ++UIndex)
-    {
-        const float U = UIndex * InvResolution;
-        const float Phi = glm::mix(0.0f, TwoPi, U);
-
-        for (GLuint VIndex = 0; VIndex < InResolution; ++VIndex)
-        {
-            const float V = VIndex * InvResolution;
-            const float Theta = glm::mix(0.0f, Pi, V);
-
-            // Equao paramtrica da esfera usando o Y como eixo polar
-            const glm::vec3 VertexPosition =
-            {
-                glm::sin(Theta) * glm::sin(Phi),
-                glm::cos(Theta),
-                glm::sin(Theta) * glm::cos(Phi)
-            };
-
-            const glm::vec3 VertexNormal = glm::normalize(VertexPosition);
-            SphereGeometry.Vertices.emplace_back(FVertex{ .Position = VertexPosition, .Normal = VertexNormal, .UV = { U, V } });
-        }
-    }
-
-    for (GLuint U = 0; U < InResolution - 1; ++U)
-    {
-        for (GLuint V = 0; V < InResolution - 1; ++V)
-        {
-            const GLuint P0 = U + V * InResolution;
-            const GLuint P1 = U + 1 + V * InResolution;
-            const GLuint P2 = U + (V + 1) * InResolution;
-            const GLuint P3 = U + 1 + (V + 1) * InResolution;
-
-            SphereGeometry.Indices.emplace_back(FTriangle{ P3, P2, P0 });
-            SphereGeometry.Indices.emplace_back(FTriangle{ P1, P3, P0 });
-        }
-    }
-
-    return SphereGeometry;
-}
-
-FGeometry GenerateCylinder(GLuint InResolution)
-{
-    constexpr float CylinderHeight = 1.0f;
-    constexpr float HalfCylinderHeight = CylinderHeight / 2.0f;
-
-    FGeometry CylinderGeometry;
-
-    constexpr float TwoPi = glm::two_pi<float>();
-    const float InvResolution = 1.0f / static_cast<float>(InResolution - 1);
-
-    for (GLuint UIndex = 0; UIndex < InResolution; ++UIndex)
-    {
-        const float U = UIndex * InvResolution;
-        const float Theta = glm::mix(0.0f, TwoPi, U);
-
-        for (GLuint VIndex = 0; VIndex < InResolution; ++VIndex)
-        {
-            const float V = VIndex * InvResolution;
-            const float Height = glm::mix(-HalfCylinderHeight, HalfCylinderHeight, V);
-
-            glm::vec3 VertexPosition =
-            {
-                glm::sin(Theta),
-                Height,
-                glm::cos(Theta),
-            };
-
-            const glm::vec3 VertexNormal = glm::normalize(glm::vec3{ VertexPosition.x, 0.0f, VertexPosition.z });
-            CylinderGeometry.Vertices.emplace_back(FVertex{ .Position = VertexPosition, .Normal = VertexNormal, .UV = { U, 1.0 - V } });
-        }
-    }
-
-    for (GLuint U = 0; U < InResolution - 1; ++U)
-    {
-        for (GLuint V = 0; V < InResolution - 1; ++V)
-        {
-            const GLuint P0 = U + V * InResolution;
-            const GLuint P1 = U + 1 + V * InResolution;
-            const GLuint P2 = U + (V + 1) * InResolution;
-            const GLuint P3 = U + 1 + (V + 1) * InResolution;
-
-            CylinderGeometry.Indices.emplace_back(FTriangle{ P0, P2, P3 });
-            CylinderGeometry.Indices.emplace_back(FTriangle{ P0, P3, P1 });
-        }
-    }
-
-    const glm::vec3 TopVertex = { 0.0f, HalfCylinderHeight, 0.0f };
-    const glm::vec3 BotVertex = { 0.0f, -HalfCylinderHeight, 0.0f };
-
-    CylinderGeometry.Vertices.emplace_back(FVertex{ .Position = TopVertex, .Normal = { 0.0f, 1.0f, 0.0f }, .UV = { 1.0f, 1.0f } });
-    const GLuint TopVertexIndex = static_cast<GLuint>(CylinderGeometry.Vertices.size() - 1);
-    CylinderGeometry.Vertices.emplace_back(FVertex{ .Position = BotVertex, .Normal = { 0.0f, -1.0f, 0.0f }, .UV = { 0.0f, 0.0f } });
-    const GLuint BotVertexIndex = static_cast<GLuint>(CylinderGeometry.Vertices.size() - 1);
-
-    for (GLuint UIndex = 0; UIndex < InResolution - 1; ++UIndex)
-    {
-        GLuint U = UIndex * InResolution;
-
-        GLuint P0 = U;
-        GLuint P1 = BotVertexIndex;
-        GLuint P2 = U + InResolution;
-
-        CylinderGeometry.Indices.emplace_back(FTriangle{ P0, P1, P2 });
-    }
-
-    for (GLuint UIndex = 0; UIndex < InResolution - 1; ++UIndex)
-    {
-        GLuint U = UIndex * InResolution + (InResolution - 1);
-
-        GLuint P0 = U;
-        GLuint P1 = (UIndex + 1) * InResolution + (InResolution - 1);
-        GLuint P2 = TopVertexIndex;
-
-        CylinderGeometry.Indices.emplace_back(FTriangle{ P0, P1, P2 });
-    }
-
-    return CylinderGeometry;
-}
-
-FGeometry GenerateQuad()
-{
-    FGeometry QuadGeometry;
-
-    constexpr glm::vec3 Normal = { 0.0f, 0.0f, 1.0f };
-    QuadGeometry.Vertices =
-    {
-        FVertex{.Position = { 0.0f, 0.0f, 0.0f }, .Normal = Normal, .UV = { 0.0f, 1.0f } },
-        FVertex{.Position = { 1.0f, 0.0f, 0.0f }, .Normal = Normal, .UV = { 1.0f, 1.0f } },
-        FVertex{.Position = { 1.0f, 1.0f, 0.0f }, .Normal = Normal, .UV = { 1.0f, 0.0f } },
-        FVertex{.Position = { 0.0f, 1.0f, 0.0f }, .Normal = Normal, .UV = { 0.0f, 0.0f } },
-    };
-    QuadGeometry.Indices =
-    {
-        FTriangle{ 0, 1, 2 },
-        FTriangle{ 2, 3, 0 },
-    };
-
-    return QuadGeometry;
-}
-
-FGeometry GenerateCube()
-{
-    FGeometry CubeGeometry;
-
-    constexpr glm::vec3 XNormal = { 1.0f, 0.0f, 0.0f };
-    constexpr glm::vec3 YNormal = { 0.0f, 1.0f, 0.0f };
-    constexpr glm::vec3 ZNormal = { 0.0f, 0.0f, 1.0f };
-
-    CubeGeometry.Vertices =
-    {
-        // +Z
-        FVertex{ .Position = { -0.5f, -0.5f, 0.5f }, .Normal = ZNormal, . UV = { 0.0f, 1.0f } },
-        FVertex{ .Position = {  0.5f, -0.5f, 0.5f }, .Normal = ZNormal, . UV = { 1.0f, 1.0f } },
-        FVertex{ .Position = {  0.5f,  0.5f, 0.5f }, .Normal = ZNormal, . UV = { 1.0f, 0.0f } },
-        FVertex{ .Position = { -0.5f,  0.5f, 0.5f }, .Normal = ZNormal, . UV = { 0.0f, 0.0f } },
-
-        // -Z
-        FVertex{ .Position = { -0.5f, -0.5f, -0.5f }, .Normal = -ZNormal, . UV = { 0.0f, 1.0f } },
-        FVertex{ .Position = {  0.5f, -0.5f, -0.5f }, .Normal = -ZNormal, . UV = { 1.0f, 1.0f } },
-        FVertex{ .Position = {  0.5f,  0.5f, -0.5f }, .Normal = -ZNormal, . UV = { 1.0f, 0.0f } },
-        FVertex{ .Position = { -0.5f,  0.5f, -0.5f }, .Normal = -ZNormal, . UV = { 0.0f, 0.0f } },
-
-        // +X
-        FVertex{ .Position = { 0.5f, -0.5f, -0.5f }, .Normal = XNormal, . UV = { 0.0f, 1.0f } },
-        FVertex{ .Position = { 0.5f,  0.5f, -0.5f }, .Normal = XNormal, . UV = { 1.0f, 1.0f } },
-        FVertex{ .Position = { 0.5f,  0.5f,  0.5f }, .Normal = XNormal, . UV = { 1.0f, 0.0f } },
-        FVertex{ .Position = { 0.5f, -0.5f,  0.5f }, .Normal = XNormal, . UV = { 0.0f, 0.0f } },
-
-        // -X
-        FVertex{ .Position = { -0.5f, -0.5f, -0.5f }, .Normal = -XNormal, . UV = { 0.0f, 1.0f } },
-        FVertex{ .Position = { -0.5f,  0.5f, -0.5f }, .Normal = -XNormal, . UV = { 1.0f, 1.0f } },
-        FVertex{ .Position = { -0.5f,  0.5f,  0.5f }, .Normal = -XNormal, . UV = { 1.0f, 0.0f } },
-        FVertex{ .Position = { -0.5f, -0.5f,  0.5f }, .Normal = -XNormal, . UV = { 0.0f, 0.0f } },
-
-        // +Y
-        FVertex{ .Position = { -0.5f, 0.5f, -0.5f }, .Normal = YNormal, . UV = { 0.0f, 1.0f } },
-        FVertex{ .Position = {  0.5f, 0.5f, -0.5f }, .Normal = YNormal, . UV = { 1.0f, 1.0f } },
-        FVertex{ .Position = {  0.5f, 0.5f,  0.5f }, .Normal = YNormal, . UV = { 1.0f, 0.0f } },
-        FVertex{ .Position = { -0.5f, 0.5f,  0.5f }, .Normal = YNormal, . UV = { 0.0f, 0.0f } },
-
-        // -Y
-        FVertex{.Position = { -0.5f, -0.5f, -0.5f }, .Normal = -YNormal, . UV = { 0.0f, 1.0f } },
-        FVertex{.Position = {  0.5f, -0.5f, -0.5f }, .Normal = -YNormal, . UV = { 1.0f, 1.0f } },
-        FVertex{.Position = {  0.5f, -0.5f,  0.5f }, .Normal = -YNormal, . UV = { 1.0f, 0.0f } },
-        FVertex{.Position = { -0.5f, -0.5f,  0.5f }, .Normal = -YNormal, . UV = { 0.0f, 0.0f } },
-    };
-    CubeGeometry.Indices =
-    {
-        FTriangle{ 0, 1, 2 },
-        FTriangle{ 2, 3, 0 },
-
-        FTriangle{ 4, 5, 6 },
-        FTriangle{ 6, 7, 4 },
-
-        FTriangle{ 8, 9, 10 },
-        FTriangle{ 10, 11, 8 },
-
-        FTriangle{ 12, 13, 14 },
-        FTriangle{ 14, 15, 12 },
-
-        FTriangle{ 16, 17, 18 },
-        FTriangle{ 18, 19, 16 },
-
-        FTriangle{ 20, 21, 22 },
-        FTriangle{ 22, 23, 20 },
-    };
-
-    return CubeGeometry;
-}
-
-std::vector<glm::mat4> GenerateInstances(GLuint InNumInstances)
-{
-    std::vector<glm::mat4> ModelMatrices;
-    ModelMatrices.reserve(InNumInstances);
-
-    std::random_device Device;
-    std::default_random_engine Generator(Device());
-
-    constexpr float Jitter = 0.1f;
-    std::normal_distribution<float> JitterDistribution{ -Jitter, Jitter };
-    std::normal_distribution<float> NormalDistribution(0.0f, 0.1f);
-
-    for (std::uint32_t Index = 0; Index < InNumInstances; ++Index)
-    {
-        const float Radius = 5.0f + JitterDistribution(Generator);
-
-        const float Alpha = static_cast<float>(Index) / static_cast<float>(InNumInstances);
-        const float Angle = glm::mix(0.0f, glm::two_pi<float>(), Alpha);
-
-        const float X = Radius * glm::sin(Angle);
-        // const float Y = NormalDistribution(Generator);
-        float Y = Index / (float) InNumInstances;
-        Y += NormalDistribution(Generator) * 0.5f;
-        const float Z = Radius * glm::cos(Angle);
-
-        glm::mat4 InstanceMatrix = glm::translate(glm::identity<glm::mat4>(), { X, Y, Z });
-        constexpr float Scale = 0.01f;
-        InstanceMatrix = glm::scale(InstanceMatrix, { Scale, Scale, Scale });
-
-        ModelMatrices.emplace_back(InstanceMatrix);
-    }
-
-    return ModelMatrices;
-}
-
-GLuint LoadTexture(const char* TextureFile)
-{
-    std::cout << "Carregando Textura " << TextureFile << std::endl;
-
-    int TextureWidth = 0;
-    int TextureHeight = 0;
-    int NumberOfComponents = 0;
-    unsigned char* TextureData = stbi_load(TextureFile, &TextureWidth, &TextureHeight, &NumberOfComponents, 3);
-    assert(TextureData);
-
-    // Gerar o Identifador da Textura
-    GLuint TextureId;
-    glGenTextures(1, &TextureId);
-
-    // Habilita a textura para ser modificada
-    glBindTexture(GL_TEXTURE_2D, TextureId);
-
-    // Copia a textura para a memria da GPU
-    GLint Level = 0;
-    GLint Border = 0;
-    glTexImage2D(GL_TEXTURE_2D, Level, GL_RGB, TextureWidth, TextureHeight, Border, GL_RGB, GL_UNSIGNED_BYTE, TextureData);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glGenerateMipmap(GL_TEXTURE_2D);
-
-    glBindTexture(GL_TEXTURE_2D, 0);
-
-    stbi_image_free(TextureData);
-    return TextureId;
-}
-
-std::map<std::string, GLint> LoadTextures(const std::vector<std::string>& InTextureFiles)
-{
-    struct TextureData
-    {
-        std::int32_t TextureWidth = 0;
-        std::int32_t TextureHeight = 0;
-        std::uint8_t* Data = nullptr;
-    };
-
-    std::mutex PrintMutex;
-
-    std::vector<std::thread> Threads;
-    std::map<std::string, std::future<TextureData>> TextureFutures;
-    for (const std::string& TextureFile : InTextureFiles)
-    {
-        std::packaged_task<TextureData()> LoadTextureTask([&TextureFile, &PrintMutex]
-        {
-            TextureData Data;
-            constexpr std::int32_t NumReqComponents = 3;
-            Data.Data = stbi_load(TextureFile.c_str(), &Data.TextureWidth, &Data.TextureHeight, 0, NumReqComponents);
-            assert(Data.Data);
-            return Data;
-        });
-
-        TextureFutures.emplace(TextureFile, LoadTextureTask.get_future());
-
-        Threads.emplace_back(std::move(LoadTextureTask));
-    }
-
-    std::map<std::string, GLint> LoadedTextures;
-    for (std::pair<const std::string, std::future<TextureData>>& TextureFuturePair : TextureFutures)
-    {
-        std::string TextureFile = TextureFuturePair.first;
-        TextureData Data = std::move(TextureFuturePair.second).get();
-
-        // Gerar o Identifador da Textura
-        GLuint TextureId;
-        glGenTextures(1, &TextureId);
-
-        // Habilita a textura para ser modificada
-        glBindTexture(GL_TEXTURE_2D, TextureId);
-
-        // Copia a textura para a memria da GPU
-        const GLint Level = 0;
-        const GLint Border = 0;
-        glTexImage2D(GL_TEXTURE_2D, Level, GL_RGB, Data.TextureWidth, Data.TextureHeight, Border, GL_RGB, GL_UNSIGNED_BYTE, Data.Data);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        glBindTexture(GL_TEXTURE_2D, 0);
-
-        stbi_image_free(Data.Data);
-        LoadedTextures[TextureFile] = TextureId;
-    }
-
-    for (std::thread& Thread : Threads)
-    {
-        Thread.join();
-    }
-
-    return LoadedTextures;
-}
-
-void MouseButtonCallback(GLFWwindow* Window, std::int32_t Button, std::int32_t Action, std::int32_t Modifiers)
+// Os Handle* recebem a entrada ja filtrada pelo ImGui, vinda dos callbacks ou de uma gravacao
+void HandleMouseButton(GLFWwindow* Window, std::int32_t Button, std::int32_t Action, double X, double Y)
 {
-    if (ImGui::GetIO().WantCaptureMouse)
-    {
-        return;
-    }
-
     if (Button == GLFW_MOUSE_BUTTON_LEFT)
     {
         if (Action == GLFW_PRESS)
         {
             glfwSetInputMode(Window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 
-            double X, Y;
-            glfwGetCursorPos(Window, &X, &Y);
-
             gConfig.Scene.Camera.PreviousCursor = glm::vec2{ X, Y };
             gConfig.Scene.Camera.bEnableMouseMovement = true;
         }
@@ -543,13 +383,8 @@ void MouseButtonCallback(GLFWwindow* Window, std::int32_t Button, std::int32_t A
     }
 }
 
-void MouseMotionCallback(GLFWwindow* Window, double X, double Y)
+void HandleCursorPos(double X, double Y)
 {
-    if (ImGui::GetIO().WantCaptureMouse)
-    {
-        return;
-    }
-
     const glm::ivec2 CurrentPos = { static_cast<std::int32_t>(X), static_cast<std::int32_t>(Y) };
 
     if (gConfig.Input.Mouse.PreviousMousePos == glm::ivec2{ -1, -1 })
@@ -565,20 +400,15 @@ void MouseMotionCallback(GLFWwindow* Window, double X, double Y)
 
     gConfig.Scene.Camera.MouseMove(static_cast<float>(X), static_cast<float>(Y));
 
-    if (gConfig.Scene.SceneType == ESceneType::Ortho)
+    if (gConfig.Scene.Description.bLightFollowsCursor)
     {
         gConfig.Scene.PointLight.Position.x = static_cast<float>(CurrentPos.x) / gConfig.Viewport.WindowWidth;
         gConfig.Scene.PointLight.Position.y = static_cast<float>(gConfig.Viewport.WindowHeight - CurrentPos.y) / gConfig.Viewport.WindowHeight;
     }
 }
 
-void KeyCallback(GLFWwindow* Window, std::int32_t Key, std::int32_t ScanCode, std::int32_t Action, std::int32_t Modifers)
+void HandleKey(GLFWwindow* Window, std::int32_t Key, std::int32_t Action)
 {
-    if (ImGui::GetIO().WantCaptureKeyboard)
-    {
-        return;
-    }
-
     if (Action == GLFW_PRESS)
     {
         switch (Key)
@@ -661,199 +491,278 @@ void KeyCallback(GLFWwindow* Window, std::int32_t Key, std::int32_t ScanCode, st
     }
 }
 
-void ResizeCallback(GLFWwindow* Window, std::int32_t Width, std::int32_t Height)
-{
-    gConfig.Viewport.WindowWidth = Width;
-    gConfig.Viewport.WindowHeight = Height;
-
-    gConfig.Scene.Camera.SetViewportSize(Width, Height);
-
-    glViewport(0, 0, Width, Height);
-}
-
-FRenderData GetRenderData()
+void ApplyInputEvent(GLFWwindow* Window, const FInputEvent& InEvent)
 {
-    FGeometry Geo;
-    FRenderData GeoRenderData;
-
-    switch (gConfig.Scene.SceneType)
+    switch (InEvent.Type)
     {
-        case ESceneType::BlueMarble:
-            Geo = GenerateSphere(gConfig.Scene.SphereResolution);
-            GeoRenderData.Transform = glm::rotate(glm::identity<glm::mat4>(), glm::radians(180.0f), { 0.0f, 1.0f, 0.0f });
-            gConfig.Scene.Camera.bIsOrtho = false;
-            gConfig.Scene.PointLight.Position = { 0.0f, 0.0f, 1000.0f };
-            gConfig.Scene.PointLight.Intensity = 1.0f;
-            break;
-
-        case ESceneType::Ortho:
-            Geo = GenerateQuad();
-            gConfig.Scene.Camera.bIsOrtho = true;
-            gConfig.Scene.PointLight.Position = { 0.0f, 0.0f, 0.05f };
-            gConfig.Scene.PointLight.Intensity = 1.0f;
+        case EInputEventType::Key:
+            HandleKey(Window, InEvent.Code, InEvent.Action);
             break;
 
-        case ESceneType::Cylinder:
-            Geo = GenerateCylinder(20);
-            gConfig.Scene.Camera.bIsOrtho = false;
-            gConfig.Scene.PointLight.Position = { 0.0f, 0.0f, 1000.0f };
-            gConfig.Scene.PointLight.Intensity = 1.0f;
+        case EInputEventType::MouseButton:
+            HandleMouseButton(Window, InEvent.Code, InEvent.Action, InEvent.X, InEvent.Y);
             break;
 
-        case ESceneType::Cube:
-            Geo = GenerateCube();
-            gConfig.Scene.Camera.bIsOrtho = false;
-            gConfig.Scene.PointLight.Position = { 0.0f, 0.0f, 1000.0f };
-            gConfig.Scene.PointLight.Intensity = 1.0f;
+        case EInputEventType::CursorPos:
+            HandleCursorPos(InEvent.X, InEvent.Y);
             break;
 
         default:
-            exit(1);
+            break;
     }
+}
 
-    GLuint VertexBuffer, ElementBuffer;
-    glGenBuffers(1, &VertexBuffer);
-    glBindBuffer(GL_ARRAY_BUFFER, VertexBuffer);
-    glBufferData(GL_ARRAY_BUFFER, Geo.Vertices.size() * sizeof(FVertex), Geo.Vertices.data(), GL_STATIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-    glGenBuffers(1, &ElementBuffer);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ElementBuffer);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, Geo.Indices.size() * sizeof(FTriangle), Geo.Indices.data(), GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-
-    GeoRenderData.NumElements = (GLuint) Geo.Indices.size() * 3;
-
-    glGenVertexArrays(1, &GeoRenderData.VAO);
-    glBindVertexArray(GeoRenderData.VAO);
+// Pede frames para o modo sob demanda. Com o update em pipeline a mudanca so aparece no segundo frame,
+// e o ImGui precisa de mais um para acomodar hover e layout
+void RequestRedraw()
+{
+    constexpr std::uint32_t NumFramesPerChange = 3;
+    gConfig.Viewport.NumRequestedFrames = std::max(gConfig.Viewport.NumRequestedFrames, NumFramesPerChange);
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, VertexBuffer);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ElementBuffer);
+// Algo que muda a imagem a cada frame mesmo sem entrada nova
+bool IsSceneAnimating()
+{
+    const FSimpleCamera& Camera = gConfig.Scene.Camera;
+    return !gConfig.Simulation.bPause
+        || Camera.ForwardScale != 0.0f
+        || Camera.RightScale != 0.0f
+        || gConfig.Scene.Preparer.IsBusy()
+        || gConfig.Render.FrameCapture.IsCapturing()
+        || gConfig.Render.TiledRenderer.IsActive()
+        || gConfig.Input.Recorder.IsRecording()
+        || gConfig.Input.Replay.IsReplaying();
+}
 
-    // Gerar o identificador do VAO
-    // Identificador do Vertex Array Object (VAO)
-    glEnableVertexAttribArray(0);
-    glEnableVertexAttribArray(1);
-    glEnableVertexAttribArray(2);
+// Durante um replay a entrada ao vivo e ignorada, so a gravacao controla o programa
+void DispatchInputEvent(GLFWwindow* Window, const FInputEvent& InEvent)
+{
+    if (gConfig.Input.Replay.IsReplaying())
+    {
+        return;
+    }
 
-    // Informa ao OpenGL onde, dentro do VertexBuffer, os vrtices esto. No
-    // nosso caso o array Triangles  tudo o que a gente precisa
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(FVertex), nullptr);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_TRUE, sizeof(FVertex), reinterpret_cast<void*>(offsetof(FVertex, Normal)));
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(FVertex), reinterpret_cast<void*>(offsetof(FVertex, UV)));
+    if (gConfig.Input.Recorder.IsRecording())
+    {
+        gConfig.Input.Recorder.AddEvent(InEvent);
+    }
 
-    // Disabilitar o VAO
-    glBindVertexArray(0);
+    // So os eventos que mudam a imagem entram na medida de latencia. O glfw nao informa o instante do
+    // evento, entao vale o instante em que o callback o recebe
+    const bool bChangesView = InEvent.Type == EInputEventType::Key || (InEvent.Type == EInputEventType::CursorPos && gConfig.Scene.Camera.bEnableMouseMovement);
+    if (bChangesView && gConfig.Input.PendingEventTime == 0.0)
+    {
+        gConfig.Input.PendingEventTime = glfwGetTime();
+    }
 
-    return GeoRenderData;
+    ApplyInputEvent(Window, InEvent);
 }
 
-FRenderData GetAxisRenderData()
+void MouseButtonCallback(GLFWwindow* Window, std::int32_t Button, std::int32_t Action, std::int32_t Modifiers)
 {
-    const std::array<FLineVertex, 6> Vertices =
+    RequestRedraw();
+
+    if (ImGui::GetIO().WantCaptureMouse)
     {
-        FLineVertex{.Position = { 0.0f, 0.0f, 0.0f }, .Color = { 1.0f, 0.0f, 0.0f } },
-        FLineVertex{.Position = { 10.0f, 0.0f, 0.0f }, .Color = { 1.0f, 0.0f, 0.0f } },
+        return;
+    }
 
-        FLineVertex{.Position = { 0.0f, 0.0f, 0.0f }, .Color = { 0.0f, 1.0f, 0.0f } },
-        FLineVertex{.Position = { 0.0f, 10.0f, 0.0f }, .Color = { 0.0f, 1.0f, 0.0f } },
+    // A posicao vai junto no evento para que o replay nao dependa do cursor real
+    double X, Y;
+    glfwGetCursorPos(Window, &X, &Y);
 
-        FLineVertex{.Position = { 0.0f, 0.0f, 0.0f }, .Color = { 0.0f, 0.0f, 1.0f } },
-        FLineVertex{.Position = { 0.0f, 0.0f, 10.0f }, .Color = { 0.0f, 0.0f, 1.0f } },
-    };
+    DispatchInputEvent(Window, FInputEvent{ .Type = EInputEventType::MouseButton, .Code = Button, .Action = Action, .X = X, .Y = Y });
+}
 
-    GLuint VertexBuffer;
-    glGenBuffers(1, &VertexBuffer);
-    glBindBuffer(GL_ARRAY_BUFFER, VertexBuffer);
-    glBufferData(GL_ARRAY_BUFFER, Vertices.size() * sizeof(FVertex), Vertices.data(), GL_STATIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+void MouseMotionCallback(GLFWwindow* Window, double X, double Y)
+{
+    RequestRedraw();
 
-    FRenderData AxisRenderData;
-    AxisRenderData.NumElements = (GLuint) Vertices.size();
+    if (ImGui::GetIO().WantCaptureMouse)
+    {
+        return;
+    }
 
-    glGenVertexArrays(1, &AxisRenderData.VAO);
-    glBindVertexArray(AxisRenderData.VAO);
+    DispatchInputEvent(Window, FInputEvent{ .Type = EInputEventType::CursorPos, .X = X, .Y = Y });
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, VertexBuffer);
+void KeyCallback(GLFWwindow* Window, std::int32_t Key, std::int32_t ScanCode, std::int32_t Action, std::int32_t Modifers)
+{
+    RequestRedraw();
 
-    glEnableVertexAttribArray(0);
-    glEnableVertexAttribArray(1);
+    if (ImGui::GetIO().WantCaptureKeyboard)
+    {
+        return;
+    }
 
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(FLineVertex), nullptr);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_TRUE, sizeof(FLineVertex), reinterpret_cast<void*>(offsetof(FLineVertex, Color)));
+    DispatchInputEvent(Window, FInputEvent{ .Type = EInputEventType::Key, .Code = Key, .Action = Action });
+}
 
-    glBindVertexArray(0);
+// Eventos que so a UI usa. Registrados antes do ImGui, que os encadeia, para acordar o modo sob demanda
+void ScrollCallback(GLFWwindow* Window, double OffsetX, double OffsetY)
+{
+    RequestRedraw();
+}
 
-    return AxisRenderData;
+void CharCallback(GLFWwindow* Window, std::uint32_t Codepoint)
+{
+    RequestRedraw();
 }
 
-FInstancedRenderData GetInstancedRenderData(std::int32_t InNumInstances)
+void CursorEnterCallback(GLFWwindow* Window, std::int32_t bEntered)
 {
-    FGeometry Geo = GenerateSphere(10);
-    std::vector<glm::mat4> Instances = GenerateInstances(InNumInstances);
+    RequestRedraw();
+}
 
-    GLuint VertexBuffer, ElementBuffer;
-    glGenBuffers(1, &VertexBuffer);
-    glBindBuffer(GL_ARRAY_BUFFER, VertexBuffer);
-    glBufferData(GL_ARRAY_BUFFER, Geo.Vertices.size() * sizeof(FVertex), Geo.Vertices.data(), GL_STATIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+void WindowFocusCallback(GLFWwindow* Window, std::int32_t bFocused)
+{
+    RequestRedraw();
+}
 
-    glGenBuffers(1, &ElementBuffer);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ElementBuffer);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, Geo.Indices.size() * sizeof(FTriangle), Geo.Indices.data(), GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+void WindowRefreshCallback(GLFWwindow* Window)
+{
+    RequestRedraw();
+}
 
-    GLuint InstancesBuffer;
-    glGenBuffers(1, &InstancesBuffer);
-    glBindBuffer(GL_ARRAY_BUFFER, InstancesBuffer);
-    glBufferData(GL_ARRAY_BUFFER, Instances.size() * sizeof(glm::mat4), &Instances[0], GL_STATIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+void ResizeCallback(GLFWwindow* Window, std::int32_t Width, std::int32_t Height)
+{
+    gConfig.Viewport.WindowWidth = Width;
+    gConfig.Viewport.WindowHeight = Height;
 
-    GLuint InstanceVAO;
-    glGenVertexArrays(1, &InstanceVAO);
-    glBindVertexArray(InstanceVAO);
+    gConfig.Scene.Camera.SetViewportSize(Width, Height);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ElementBuffer);
+    glViewport(0, 0, Width, Height);
+    RequestRedraw();
+}
 
-    // Faz o bind do VertexBuffer e configura o layout dos atributos 0, 1 e 2
-    glBindBuffer(GL_ARRAY_BUFFER, VertexBuffer);
+// Caminhos relativos que nao existem a partir do diretorio atual sao procurados no diretorio das cenas
+bool LoadSceneFile(const std::filesystem::path& InFilePath, FSceneDescription& OutDescription, std::string& OutError)
+{
+    std::filesystem::path FilePath = InFilePath;
+    if (FilePath.is_relative() && !std::filesystem::exists(FilePath))
+    {
+        FilePath = gConfig.Scene.ScenesDir / FilePath;
+    }
+    return FSceneDescription::LoadFromFile(FilePath, OutDescription, OutError);
+}
 
-    glEnableVertexAttribArray(0);
-    glEnableVertexAttribArray(1);
-    glEnableVertexAttribArray(2);
+// A cena continua sendo desenhada ate a proxima ficar pronta. Com bInUseCache a malha passa pelo cache em disco
+void RequestScene(const FSceneDescription& InDescription, bool bInUseCache)
+{
+    gConfig.Scene.Preparer.Request(InDescription, bInUseCache ? &gConfig.Render.MeshCache : nullptr);
+    RequestRedraw();
+}
 
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(FVertex), nullptr);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_TRUE, sizeof(FVertex), reinterpret_cast<void*>(offsetof(FVertex, Normal)));
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(FVertex), reinterpret_cast<void*>(offsetof(FVertex, UV)));
+void FindSceneFiles()
+{
+    FSceneConfig& Scene = gConfig.Scene;
+    Scene.SceneFiles.clear();
 
-    // configura o array de matrizes nos atributos 3, 4, 5, 6
-    glBindBuffer(GL_ARRAY_BUFFER, InstancesBuffer);
+    std::error_code ErrorCode;
+    for (const std::filesystem::directory_entry& Entry : std::filesystem::directory_iterator{ Scene.ScenesDir, ErrorCode })
+    {
+        if (Entry.is_regular_file() && Entry.path().extension() == ".json")
+        {
+            Scene.SceneFiles.push_back(Entry.path());
+        }
+    }
+    std::sort(Scene.SceneFiles.begin(), Scene.SceneFiles.end());
 
-    glEnableVertexAttribArray(3);
-    glEnableVertexAttribArray(4);
-    glEnableVertexAttribArray(5);
-    glEnableVertexAttribArray(6);
+    // Os nomes da lista da UI sao montados uma vez aqui
+    Scene.SceneNames.clear();
+    for (const std::filesystem::path& SceneFile : Scene.SceneFiles)
+    {
+        Scene.SceneNames.push_back(SceneFile.stem().string());
+    }
+}
 
-    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*) 0);
-    glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*) (sizeof(glm::vec4)));
-    glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*) (2 * sizeof(glm::vec4)));
-    glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*) (3 * sizeof(glm::vec4)));
+// Camera e luz da cena nova. Chamado com o update parado, entre o Wait e o Kick
+void ApplyPreparedScene(const FPreparedScene& InScene)
+{
+    FSceneConfig& Scene = gConfig.Scene;
+    const FSceneDescription& Description = InScene.Description;
 
-    glVertexAttribDivisor(3, 1);
-    glVertexAttribDivisor(4, 1);
-    glVertexAttribDivisor(5, 1);
-    glVertexAttribDivisor(6, 1);
+    Scene.Camera.bIsOrtho = Description.bOrthoCamera;
+    if (Description.CameraLocation)
+    {
+        Scene.Camera.Location = *Description.CameraLocation;
+    }
+    if (Description.CameraDirection)
+    {
+        Scene.Camera.Direction = glm::normalize(*Description.CameraDirection);
+    }
+
+    Scene.PointLight.Position = Description.LightPosition;
+    Scene.PointLight.Intensity = Description.LightIntensity;
+
+    Scene.Description = Description;
+    Scene.MeshResolution = static_cast<std::int32_t>(Description.MeshResolution);
+    Scene.PreparationTime = InScene.PreparationTime;
+    Scene.MeshGenerationTime = InScene.MeshGenerationTime;
+}
+
+// A primeira cena e preparada esperando, ainda nao existe uma cena para continuar desenhando
+FObjectRenderData PrepareInitialScene()
+{
+    FSceneConfig& Scene = gConfig.Scene;
 
-    glBindVertexArray(0);
+    FSceneDescription Description;
+    std::string Error;
+    if (!Scene.SceneFile.empty() && !LoadSceneFile(Scene.SceneFile, Description, Error))
+    {
+        std::cout << "Erro ao carregar a cena: " << Error << ", usando a cena " << Description.Name << std::endl;
+    }
+
+    if (Scene.MeshResolution > 0)
+    {
+        Description.MeshResolution = static_cast<std::uint32_t>(Scene.MeshResolution);
+    }
+
+    FRenderConfig& Render = gConfig.Render;
+    Scene.Preparer.Request(Description, &Render.MeshCache);
+    Scene.Preparer.Finish(Render.MeshArena, Render.ShaderManager, Render.TextureManager);
+
+    FObjectRenderData ObjectRenderData{ Scene.Preparer.TakePreparedScene() };
+    ApplyPreparedScene(ObjectRenderData.Scene);
+    return ObjectRenderData;
+}
+
+FRenderData GetAxisRenderData()
+{
+    // A cor de cada linha vai no lugar da normal, que e o atributo 1 lido pelo lines.vert
+    const std::array<FVertex, 6> Vertices =
+    {
+        FVertex{.Position = { 0.0f, 0.0f, 0.0f }, .Normal = { 1.0f, 0.0f, 0.0f } },
+        FVertex{.Position = { 10.0f, 0.0f, 0.0f }, .Normal = { 1.0f, 0.0f, 0.0f } },
+
+        FVertex{.Position = { 0.0f, 0.0f, 0.0f }, .Normal = { 0.0f, 1.0f, 0.0f } },
+        FVertex{.Position = { 0.0f, 10.0f, 0.0f }, .Normal = { 0.0f, 1.0f, 0.0f } },
+
+        FVertex{.Position = { 0.0f, 0.0f, 0.0f }, .Normal = { 0.0f, 0.0f, 1.0f } },
+        FVertex{.Position = { 0.0f, 0.0f, 10.0f }, .Normal = { 0.0f, 0.0f, 1.0f } },
+    };
+
+    const std::array<GLuint, 6> Indices = { 0, 1, 2, 3, 4, 5 };
+
+    FRenderData AxisRenderData;
+    AxisRenderData.Mesh = gConfig.Render.MeshArena.AddMesh(Vertices, Indices);
+
+    return AxisRenderData;
+}
+
+FInstancedRenderData GetInstancedRenderData(std::int32_t InNumInstances)
+{
+    std::vector<glm::mat4> Instances = GenerateInstances(InNumInstances, gConfig.Scene.RandomSeed);
 
     FInstancedRenderData InstRenderData;
-    InstRenderData.VAO = InstanceVAO;
+    InstRenderData.Mesh = GenerateSphereMesh(gConfig.Render.MeshArena, gConfig.Render.WorkerPool, 10, &gConfig.Render.MeshCache);
+    InstRenderData.Instances = gConfig.Render.MeshArena.AddInstances(Instances);
     InstRenderData.NumInstances = static_cast<GLuint>(Instances.size());
-    InstRenderData.NumElements = static_cast<GLuint>(Geo.Indices.size()) * 3;
     return InstRenderData;
 }
 
 
+
 void APIENTRY glDebugOutput(GLenum source,
                             GLenum type,
                             unsigned int id,
@@ -901,6 +810,304 @@ void APIENTRY glDebugOutput(GLenum source,
     std::cout << std::endl;
 }
 
+// O replay e a gravacao da entrada tem prioridade, o passo deles nao pode mudar no meio da sequencia
+void UpdateFixedTimeStep()
+{
+    double FixedTimeStep = 0.0;
+    if (gConfig.Input.Replay.IsReplaying())
+    {
+        FixedTimeStep = gConfig.Input.Replay.GetHeader().TimeStep;
+    }
+    else if (gConfig.Input.Recorder.IsRecording())
+    {
+        FixedTimeStep = gConfig.Input.Recorder.GetTimeStep();
+    }
+    else if (gConfig.Render.FrameCapture.IsCapturing())
+    {
+        FixedTimeStep = 1.0 / gConfig.Render.CaptureFramesPerSecond;
+    }
+
+    gConfig.Simulation.FixedTimeStep = FixedTimeStep;
+}
+
+void StartCapture()
+{
+    FRenderConfig& Render = gConfig.Render;
+    Render.FrameCapture.Start(Render.CaptureFile, Render.CaptureFormat, Render.CaptureFramesPerSecond);
+    UpdateFixedTimeStep();
+}
+
+void StopCapture()
+{
+    gConfig.Render.FrameCapture.Stop();
+    UpdateFixedTimeStep();
+}
+
+void StartInputRecordingOrReplay()
+{
+    FInputConfig& Input = gConfig.Input;
+    if (!Input.ReplayFile.empty() && Input.Replay.Open(Input.ReplayFile))
+    {
+        gConfig.Scene.RandomSeed = Input.Replay.GetHeader().RandomSeed;
+        gConfig.Simulation.bPause = Input.Replay.GetHeader().bStartPaused != 0;
+    }
+
+    if (gConfig.Scene.RandomSeed == 0)
+    {
+        gConfig.Scene.RandomSeed = std::random_device{}();
+    }
+
+    if (!Input.RecordFile.empty() && !Input.Replay.IsReplaying())
+    {
+        Input.Recorder.Open(Input.RecordFile, gConfig.Scene.RandomSeed, gConfig.Simulation.bPause, Input.RecordTimeStep);
+    }
+
+    UpdateFixedTimeStep();
+}
+
+// Aplica um comando do socket de controle. Retorna a mensagem de erro, vazia se o comando foi aplicado
+std::string ApplyControlCommand(const FControlCommand& InCommand)
+{
+    FJsonObjectReader Arguments{ InCommand.Arguments };
+    const std::string& Name = InCommand.Name;
+
+    if (Name == "camera")
+    {
+        // O comando inteiro e validado antes de mudar a camera
+        FSimpleCamera Camera = gConfig.Scene.Camera;
+        if (Arguments.Has("reset"))
+        {
+            Camera.Reset();
+        }
+        Arguments.ReadFloats("location", glm::value_ptr(Camera.Location), 3);
+        Arguments.ReadFloats("direction", glm::value_ptr(Camera.Direction), 3);
+        Arguments.ReadFloats("up", glm::value_ptr(Camera.Up), 3);
+        Arguments.Read("fov", Camera.FieldOfView);
+        Arguments.Read("near", Camera.Near);
+        Arguments.Read("far", Camera.Far);
+        Arguments.Read("ortho", Camera.bIsOrtho);
+        if (Arguments.HasError())
+        {
+            return Arguments.GetError();
+        }
+
+        if (glm::length(Camera.Direction) == 0.0f || glm::length(Camera.Up) == 0.0f)
+        {
+            return "direction e up nao podem ser nulos";
+        }
+        Camera.Direction = glm::normalize(Camera.Direction);
+        Camera.Up = glm::normalize(Camera.Up);
+        gConfig.Scene.Camera = Camera;
+    }
+    else if (Name == "instances")
+    {
+        std::int32_t NumInstances = gConfig.Scene.NumInstances;
+        if (!Arguments.Read("count", NumInstances))
+        {
+            return Arguments.HasError() ? Arguments.GetError() : "falta \"count\"";
+        }
+        gConfig.Scene.NumInstances = std::max(NumInstances, 0);
+    }
+    else if (Name == "render")
+    {
+        FRenderConfig& Render = gConfig.Render;
+        bool bDrawAxis = Render.bDrawAxis;
+        bool bDrawObject = Render.bDrawObject;
+        bool bDrawInstances = Render.bDrawInstances;
+        bool bShowWireframe = Render.bShowWireframe;
+        bool bCullFace = Render.bCullFace;
+        float FrameRateLimit = Render.FrameRateLimit;
+        Arguments.Read("axis", bDrawAxis);
+        Arguments.Read("object", bDrawObject);
+        Arguments.Read("instances", bDrawInstances);
+        Arguments.Read("wireframe", bShowWireframe);
+        Arguments.Read("cull_face", bCullFace);
+        Arguments.Read("fps_limit", FrameRateLimit);
+
+        FDynamicResolutionSettings ResolutionSettings = gConfig.Viewport.DynamicResolution.GetSettings();
+        Arguments.Read("dynamic_resolution", ResolutionSettings.bEnabled);
+        Arguments.Read("frame_budget", ResolutionSettings.FrameTimeBudget);
+        if (Arguments.HasError())
+        {
+            return Arguments.GetError();
+        }
+
+        Render.bDrawAxis = bDrawAxis;
+        Render.bDrawObject = bDrawObject;
+        Render.bDrawInstances = bDrawInstances;
+        Render.bShowWireframe = bShowWireframe;
+        Render.bCullFace = bCullFace;
+        Render.FrameRateLimit = std::max(FrameRateLimit, 0.0f);
+        ResolutionSettings.FrameTimeBudget = std::max(ResolutionSettings.FrameTimeBudget, 1.0f);
+        gConfig.Viewport.DynamicResolution.GetSettings() = ResolutionSettings;
+    }
+    else if (Name == "vsync" || Name == "pause")
+    {
+        bool bEnabled = false;
+        if (!Arguments.Read("enabled", bEnabled))
+        {
+            return Arguments.HasError() ? Arguments.GetError() : "falta \"enabled\"";
+        }
+        (Name == "vsync" ? gConfig.Render.bEnableVsync : gConfig.Simulation.bPause) = bEnabled;
+    }
+    else if (Name == "capture")
+    {
+        std::string Action;
+        std::string File;
+        std::string FormatName;
+        Arguments.Read("action", Action);
+        Arguments.Read("file", File);
+        Arguments.Read("format", FormatName);
+        if (Arguments.HasError())
+        {
+            return Arguments.GetError();
+        }
+
+        FRenderConfig& Render = gConfig.Render;
+        if (Action == "start")
+        {
+            if (Render.FrameCapture.IsCapturing())
+            {
+                return "a captura ja esta em andamento";
+            }
+
+            const std::optional<ECaptureFormat> Format = FormatName.empty() ? Render.CaptureFormat : ParseCaptureFormat(FormatName);
+            if (!Format)
+            {
+                return "formato de captura desconhecido: " + FormatName;
+            }
+
+            Render.CaptureFormat = *Format;
+            if (!File.empty())
+            {
+                Render.CaptureFile = File;
+            }
+            StartCapture();
+        }
+        else if (Action == "stop")
+        {
+            StopCapture();
+        }
+        else
+        {
+            return "action deve ser \"start\" ou \"stop\"";
+        }
+    }
+    else if (Name == "poster")
+    {
+        FTiledRenderSettings PosterSettings = gConfig.Render.PosterSettings;
+        std::string File;
+        Arguments.Read("file", File);
+        Arguments.Read("width", PosterSettings.Width);
+        Arguments.Read("height", PosterSettings.Height);
+        if (Arguments.HasError())
+        {
+            return Arguments.GetError();
+        }
+
+        if (!File.empty())
+        {
+            PosterSettings.OutputPath = File;
+        }
+        if (gConfig.Render.TiledRenderer.IsActive() || !gConfig.Render.TiledRenderer.Start(PosterSettings, gConfig.Scene.Camera, static_cast<float>(gConfig.Simulation.TotalTime)))
+        {
+            return "nao foi possivel iniciar o poster";
+        }
+        gConfig.Render.PosterSettings = PosterSettings;
+    }
+    else if (Name == "quit")
+    {
+        glfwSetWindowShouldClose(gConfig.Viewport.Window, true);
+    }
+    else
+    {
+        return "comando desconhecido: " + Name;
+    }
+
+    return {};
+}
+
+// Aplica todos os comandos que chegaram desde o ultimo frame. O step so e respondido quando os frames terminam
+// e o scene quando a cena pedida entra no frame
+void ApplyControlCommands()
+{
+    FInputConfig& Input = gConfig.Input;
+
+    // O update do frame anterior ja terminou, entao a pausa pode mudar aqui e nao no fim do frame
+    if (!Input.StepCommand.Name.empty() && Input.NumStepFrames == 0)
+    {
+        gConfig.Simulation.bPause = true;
+        Input.ControlServer.SendReply(Input.StepCommand);
+        Input.StepCommand = {};
+    }
+
+    FControlCommand Command;
+    while (Input.ControlServer.PopCommand(Command))
+    {
+        RequestRedraw();
+
+        if (Command.Name == "scene")
+        {
+            FJsonObjectReader Arguments{ Command.Arguments };
+            std::string File;
+            FSceneDescription Description;
+            std::string Error;
+            if (!Arguments.Read("file", File) && !Arguments.HasError())
+            {
+                Error = "falta \"file\"";
+            }
+            else if (Arguments.HasError())
+            {
+                Error = Arguments.GetError();
+            }
+            else if (LoadSceneFile(File, Description, Error))
+            {
+                Arguments.Read("resolution", Description.MeshResolution);
+                Error = Arguments.GetError();
+            }
+
+            if (!Error.empty())
+            {
+                Input.ControlServer.SendReply(Command, Error);
+                continue;
+            }
+
+            if (!Input.SceneCommand.Name.empty())
+            {
+                Input.ControlServer.SendReply(Input.SceneCommand, "substituido por outra cena");
+            }
+
+            RequestScene(Description, true);
+            Input.SceneCommand = std::move(Command);
+            continue;
+        }
+
+        if (Command.Name != "step")
+        {
+            Input.ControlServer.SendReply(Command, ApplyControlCommand(Command));
+            continue;
+        }
+
+        std::uint32_t NumFrames = 0;
+        FJsonObjectReader Arguments{ Command.Arguments };
+        if (!Arguments.Read("frames", NumFrames) || NumFrames == 0)
+        {
+            Input.ControlServer.SendReply(Command, Arguments.HasError() ? Arguments.GetError() : "\"frames\" deve ser maior que zero");
+            continue;
+        }
+
+        if (!Input.StepCommand.Name.empty())
+        {
+            Input.ControlServer.SendReply(Input.StepCommand, "substituido por outro step");
+        }
+
+        // A simulacao anda NumFrames frames e pausa de novo
+        Input.NumStepFrames = NumFrames;
+        Input.StepCommand = std::move(Command);
+        gConfig.Simulation.bPause = false;
+    }
+}
+
 void DrawUI()
 {
     ImGui_ImplOpenGL3_NewFrame();
@@ -922,88 +1129,576 @@ void DrawUI()
             ImGui::Checkbox("Cull Face", &gConfig.Render.bCullFace);
             ImGui::Checkbox("Wireframe", &gConfig.Render.bShowWireframe);
             ImGui::Checkbox("VSync", &gConfig.Render.bEnableVsync);
+
+            const FFramePacerStats& PacerStats = gConfig.Render.FramePacer.GetStats();
+            ImGui::SeparatorText("Frame Pacing");
+            ImGui::DragFloat("Frame Rate Limit", &gConfig.Render.FrameRateLimit, 1.0f, 0.0f, 1000.0f, "%.0f");
+            ImGui::Text("Sleep / Spin  : %.3f / %.3f ms", PacerStats.SleepTime, PacerStats.SpinTime);
+            ImGui::Text("Spin Margin   : %.3f ms (oversleep %.3f ms)", PacerStats.SpinMargin, PacerStats.Oversleep);
+            ImGui::Text("Missed Frames : %u", PacerStats.NumMissedFrames);
+
+            const FGLStateCacheStats& StateCacheStats = gConfig.Render.StateCache.GetLastFrameStats();
+            ImGui::SeparatorText("State Cache");
+            ImGui::Text("Issued Calls  : %u", StateCacheStats.IssuedCalls);
+            ImGui::Text("Skipped Calls : %u", StateCacheStats.SkippedCalls);
+
+            ImGui::SeparatorText("GPU Passes");
+            for (std::size_t PassIndex = 0; PassIndex < gConfig.Render.GPUPassTimers.size(); ++PassIndex)
+            {
+                ImGui::Text("%-14s: %.3f ms", GetGPUPassName(static_cast<EGPUPass>(PassIndex)), gConfig.Render.GPUPassTimers[PassIndex].GetLastTime());
+            }
+
+            if (gConfig.Simulation.MetricsExporter.IsRunning())
+            {
+                const FMetricsExporter& MetricsExporter = gConfig.Simulation.MetricsExporter;
+                ImGui::SeparatorText("Metrics");
+                ImGui::Text("Port          : %u", static_cast<unsigned>(MetricsExporter.GetPort()));
+                ImGui::Text("Scrapes       : %llu", static_cast<unsigned long long>(MetricsExporter.GetNumScrapes()));
+                ImGui::Text("Dropped       : %llu", static_cast<unsigned long long>(MetricsExporter.GetNumDroppedSamples()));
+            }
+
+            ImGui::SeparatorText("Render Queue");
+            ImGui::Text("Draw Packets  : %u", gConfig.Render.RenderQueue.GetNumSubmittedPackets());
+            ImGui::Text("Draw Calls    : %u", gConfig.Render.RenderQueue.GetNumDrawCalls());
+            ImGui::Text("Workers       : %u", gConfig.Render.WorkerPool.GetNumWorkers());
+
+            const FGPUBufferArenaStats VertexStats = gConfig.Render.MeshArena.GetVertexStats();
+            const FGPUBufferArenaStats IndexStats = gConfig.Render.MeshArena.GetIndexStats();
+            ImGui::SeparatorText("Mesh Arena");
+            ImGui::Text("Vertex Bytes  : %lld / %lld", static_cast<long long>(VertexStats.UsedBytes), static_cast<long long>(VertexStats.Capacity));
+            ImGui::Text("Index Bytes   : %lld / %lld", static_cast<long long>(IndexStats.UsedBytes), static_cast<long long>(IndexStats.Capacity));
+            ImGui::Text("Free Blocks   : %u / %u", VertexStats.NumFreeBlocks, IndexStats.NumFreeBlocks);
+            if (ImGui::Button("Defragment"))
+            {
+                gConfig.Render.MeshArena.Defragment();
+            }
+
+            ImGui::SeparatorText("Mesh Cache");
+            ImGui::Text("Hits / Misses : %u / %u", gConfig.Render.MeshCache.GetNumHits(), gConfig.Render.MeshCache.GetNumMisses());
+        }
+
+#if BLUEMARBLE_GL_TRACE
+        if (ImGui::CollapsingHeader("GL Trace"))
+        {
+            FGLTracer& Tracer = FGLTracer::Get();
+            const FGLFrameStats& FrameStats = Tracer.GetLastFrameStats();
+
+            ImGui::SeparatorText("Last Frame");
+            ImGui::Text("Draw Calls       : %u", FrameStats.DrawCalls);
+            ImGui::Text("State Changes    : %u", FrameStats.StateChanges);
+            ImGui::Text("Uploads          : %u", FrameStats.Uploads);
+            ImGui::Text("Buffer Bytes     : %llu", static_cast<unsigned long long>(FrameStats.BufferBytesUploaded));
+            ImGui::Text("Texture Bytes    : %llu", static_cast<unsigned long long>(FrameStats.TextureBytesUploaded));
+            ImGui::Text("Triangles        : %llu", static_cast<unsigned long long>(FrameStats.TrianglesSubmitted));
+
+            ImGui::SeparatorText("Calls");
+            for (std::size_t CallIndex = 0; CallIndex < FrameStats.CallCounts.size(); ++CallIndex)
+            {
+                if (FrameStats.CallCounts[CallIndex] > 0)
+                {
+                    ImGui::Text("%-24s : %u", FGLTracer::GetCallName(static_cast<EGLTracedCall>(CallIndex)), FrameStats.CallCounts[CallIndex]);
+                }
+            }
+
+            ImGui::SeparatorText("Capture");
+            ImGui::DragInt("Frames", &gConfig.Render.NumTraceFrames, 1.0f, 1, 1000);
+            ImGui::BeginDisabled(Tracer.IsCapturing());
+            if (ImGui::Button("Capture Trace"))
+            {
+                Tracer.CaptureFrames(static_cast<std::uint32_t>(gConfig.Render.NumTraceFrames), "gl_trace.txt");
+            }
+            ImGui::EndDisabled();
+        }
+#endif
+
+        if (ImGui::CollapsingHeader("Simulation"))
+        {
+            ImGui::Checkbox("Pause", &gConfig.Simulation.bPause);
+            ImGui::Checkbox("Reverse", &gConfig.Simulation.bReverse);
+
+            ImGui::Text("Time (s)             : %f", gConfig.Simulation.TotalTime);
+            ImGui::Text("Application Time (s) : %f", gConfig.Simulation.ApplicationTime);
+            ImGui::Text("Frame Count          : %d", gConfig.Simulation.FrameCount);
+            ImGui::Text("Frame Time (ms)      : %f", gConfig.Simulation.FrameTime);
+            ImGui::Text("FPS                  : %f", gConfig.Simulation.FramesPerSecond);
+            ImGui::Text("Frames:              : %d", gConfig.Simulation.TotalFrames);
+
+            ImGui::Checkbox("Pipeline Frames", &gConfig.Simulation.bPipelineFrames);
+            ImGui::Text("Update Time (ms)     : %f", gConfig.Simulation.UpdateTime * 1000.0);
+            ImGui::Text("Render Time (ms)     : %f", gConfig.Simulation.RenderTime * 1000.0);
+            ImGui::Text("Input Latency (ms)   : %f", gConfig.Simulation.InputLatency * 1000.0);
+
+            if (ImGui::CollapsingHeader("Plots"))
+            {
+                const float AverageFrameTime = std::accumulate(gConfig.Simulation.FrameTimeHistory.begin(), gConfig.Simulation.FrameTimeHistory.end(), 0.0f) / gConfig.Simulation.FrameTimeHistory.size();
+                const char* AverageFrameTimeOverlay = gConfig.Render.FrameAllocator.Format("Avg: %f ms", AverageFrameTime);
+                ImGui::PlotLines("Frame Times", gConfig.Simulation.FrameTimeHistory.data(), gConfig.Simulation.NumFramePlotValues, gConfig.Simulation.FramePlotOffset, AverageFrameTimeOverlay, 0.0f, 100.0f, ImVec2(0, 100.0f));
+
+                const float AvgFPS = std::accumulate(gConfig.Simulation.FramesPerSecondHistory.begin(), gConfig.Simulation.FramesPerSecondHistory.end(), 0.0f) / gConfig.Simulation.FramesPerSecondHistory.size();
+                const char* AverageFPSOverlay = gConfig.Render.FrameAllocator.Format("Avg: %f", AvgFPS);
+                ImGui::PlotLines("FPS", gConfig.Simulation.FramesPerSecondHistory.data(), gConfig.Simulation.NumFramePlotValues, gConfig.Simulation.FramePlotOffset, AverageFPSOverlay, 0.0f, 300.0f, ImVec2(0, 100.0f));
+
+                const float AverageLatency = std::accumulate(gConfig.Simulation.InputLatencyHistory.begin(), gConfig.Simulation.InputLatencyHistory.end(), 0.0f) / gConfig.Simulation.InputLatencyHistory.size();
+                const char* AverageLatencyOverlay = gConfig.Render.FrameAllocator.Format("Avg: %f ms", AverageLatency);
+                ImGui::PlotLines("Input Latency", gConfig.Simulation.InputLatencyHistory.data(), gConfig.Simulation.NumFramePlotValues, gConfig.Simulation.InputLatencyPlotOffset, AverageLatencyOverlay, 0.0f, 100.0f, ImVec2(0, 100.0f));
+            }
+        }
+
+        if (ImGui::CollapsingHeader("Scene"))
+        {
+            FSceneConfig& Scene = gConfig.Scene;
+
+            ImGui::SeparatorText("Scene File");
+            if (ImGui::BeginCombo("Scene", Scene.Description.Name.c_str()))
+            {
+                for (std::size_t SceneIndex = 0; SceneIndex < Scene.SceneFiles.size(); ++SceneIndex)
+                {
+                    const std::filesystem::path& SceneFile = Scene.SceneFiles[SceneIndex];
+                    if (ImGui::Selectable(Scene.SceneNames[SceneIndex].c_str()))
+                    {
+                        FSceneDescription Description;
+                        std::string Error;
+                        if (LoadSceneFile(SceneFile, Description, Error))
+                        {
+                            RequestScene(Description, true);
+                        }
+                        else
+                        {
+                            std::cout << "Erro ao carregar a cena: " << Error << std::endl;
+                        }
+                    }
+                }
+                ImGui::EndCombo();
+            }
+            if (Scene.Preparer.IsBusy())
+            {
+                ImGui::Text("Preparing            : %s", Scene.Preparer.GetPendingSceneName().c_str());
+            }
+            ImGui::Text("Preparation (ms)     : %f", Scene.PreparationTime * 1000.0);
+            ImGui::Text("Mesh Generation (ms) : %f", Scene.MeshGenerationTime * 1000.0);
+
+            ImGui::SeparatorText("Drawables");
+            ImGui::DragInt("Num Instances", &Scene.NumInstances, 1000.0f, 0, 1'000'000);
+
+            // A malha nova e gerada em segundo plano. Resolucoes escolhidas pelo slider nao passam pelo cache para nao encher o disco
+            const bool bHasResolution = Scene.Description.Mesh == ESceneMesh::Sphere || Scene.Description.Mesh == ESceneMesh::Cylinder;
+            ImGui::BeginDisabled(!bHasResolution);
+            if (ImGui::SliderInt("Mesh Resolution", &Scene.MeshResolution, 2, 2048))
+            {
+                FSceneDescription Description = Scene.Description;
+                Description.MeshResolution = static_cast<std::uint32_t>(Scene.MeshResolution);
+                RequestScene(Description, false);
+            }
+            ImGui::EndDisabled();
+
+            ImGui::SeparatorText("Camera");
+            ImGui::DragFloat3("Camera Location", glm::value_ptr(gConfig.Scene.Camera.Location), 0.1f);
+            ImGui::DragFloat3("Camera Direction", glm::value_ptr(gConfig.Scene.Camera.Direction), 0.05f);
+            ImGui::DragFloat3("Camera Orientation", glm::value_ptr(gConfig.Scene.Camera.Up), 0.05f);
+            ImGui::DragFloat("Camera Near", &gConfig.Scene.Camera.Near, 0.05f, 0.0001f);
+            ImGui::DragFloat("Camera Far", &gConfig.Scene.Camera.Far, 0.05f, 0.0001f);
+            ImGui::DragFloat("Camera Field Of View", &gConfig.Scene.Camera.FieldOfView, 0.05f, 0.1f);
+            ImGui::Checkbox("Camera Orthographic", &gConfig.Scene.Camera.bIsOrtho);
+
+            ImGui::SeparatorText("Light");
+            ImGui::DragFloat3("Light Position", glm::value_ptr(gConfig.Scene.PointLight.Position), 0.1f);
+            ImGui::DragFloat("Intensity", &gConfig.Scene.PointLight.Intensity, 0.1f);
+        }
+
+        if (ImGui::CollapsingHeader("Memory"))
+        {
+            const FFrameAllocator& FrameAllocator = gConfig.Render.FrameAllocator;
+            ImGui::SeparatorText("Frame Allocator");
+            ImGui::Text("Used Bytes    : %zu / %zu", FrameAllocator.GetUsedBytes(), FrameAllocator.GetCapacity());
+            ImGui::Text("Peak Bytes    : %zu", FrameAllocator.GetPeakBytes());
+
+            FMemoryTracker& MemoryTracker = FMemoryTracker::Get();
+            ImGui::SeparatorText("Heap Allocations");
+            if (!FMemoryTracker::IsEnabled())
+            {
+                ImGui::TextUnformatted("Compile com BLUEMARBLE_TRACK_ALLOCATIONS para contar as alocacoes");
+            }
+            else
+            {
+                const FMemoryFrameStats& MemoryStats = MemoryTracker.GetLastFrameStats();
+                for (std::size_t ZoneIndex = 0; ZoneIndex < MemoryStats.Zones.size(); ++ZoneIndex)
+                {
+                    const FAllocationStats& ZoneStats = MemoryStats.Zones[ZoneIndex];
+                    ImGui::Text("%-8s : %u allocs, %u frees, %llu bytes", FMemoryTracker::GetZoneName(static_cast<EAllocationZone>(ZoneIndex)), ZoneStats.NumAllocations, ZoneStats.NumFrees, static_cast<unsigned long long>(ZoneStats.AllocatedBytes));
+                }
+                ImGui::Text("%-8s : %u allocs, %u frees, %llu bytes", "Total", MemoryStats.Total.NumAllocations, MemoryStats.Total.NumFrees, static_cast<unsigned long long>(MemoryStats.Total.AllocatedBytes));
+
+                ImGui::Text("Frames With Allocations : %llu / %llu", static_cast<unsigned long long>(MemoryTracker.GetNumFramesWithAllocations()), static_cast<unsigned long long>(MemoryTracker.GetNumTrackedFrames()));
+                if (ImGui::Button("Reset"))
+                {
+                    MemoryTracker.ResetFramesWithAllocations();
+                }
+            }
+        }
+
+        if (ImGui::CollapsingHeader("GPU Memory"))
+        {
+            const FGPUResourceRegistry& ResourceRegistry = FGPUResourceRegistry::Get();
+            ImGui::SeparatorText("Totals");
+            for (std::size_t TypeIndex = 0; TypeIndex < static_cast<std::size_t>(EGPUResourceType::Count); ++TypeIndex)
+            {
+                const EGPUResourceType Type = static_cast<EGPUResourceType>(TypeIndex);
+                const FGPUResourceTotals& Totals = ResourceRegistry.GetTotals(Type);
+                ImGui::Text("%-12s : %4u objects, %8.2f MB", FGPUResourceRegistry::GetTypeName(Type), Totals.NumResources, Totals.Size / (1024.0 * 1024.0));
+            }
+            const FGPUResourceTotals Totals = ResourceRegistry.GetTotals();
+            ImGui::Text("%-12s : %4u objects, %8.2f MB", "Total", Totals.NumResources, Totals.Size / (1024.0 * 1024.0));
+
+            ImGui::SeparatorText("Resources");
+            if (ImGui::BeginTable("GPUResources", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY, ImVec2(0.0f, 200.0f)))
+            {
+                ImGui::TableSetupColumn("Type");
+                ImGui::TableSetupColumn("Id");
+                ImGui::TableSetupColumn("Label");
+                ImGui::TableSetupColumn("Size (KB)");
+                ImGui::TableHeadersRow();
+
+                for (const auto& [Key, Info] : ResourceRegistry.GetResources())
+                {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(FGPUResourceRegistry::GetTypeName(Key.first));
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%u", Key.second);
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(Info.Label.c_str());
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.1f", Info.Size / 1024.0);
+                }
+                ImGui::EndTable();
+            }
+        }
+
+        if (ImGui::CollapsingHeader("Capture"))
+        {
+            FFrameCapture& FrameCapture = gConfig.Render.FrameCapture;
+            if (FrameCapture.IsCapturing())
+            {
+                if (ImGui::Button("Stop"))
+                {
+                    StopCapture();
+                }
+            }
+            else
+            {
+                static constexpr std::array<const char*, 3> FormatNames = { "Y4M", "PNG", "Raw" };
+                std::int32_t FormatIndex = static_cast<std::int32_t>(gConfig.Render.CaptureFormat);
+                if (ImGui::Combo("Format", &FormatIndex, FormatNames.data(), static_cast<std::int32_t>(FormatNames.size())))
+                {
+                    gConfig.Render.CaptureFormat = static_cast<ECaptureFormat>(FormatIndex);
+                }
+
+                if (ImGui::Button("Start"))
+                {
+                    StartCapture();
+                }
+            }
+
+            const FFrameCaptureStats CaptureStats = FrameCapture.GetStats();
+            ImGui::Text("Output        : %s", gConfig.Render.CaptureOutputLabel.Get(FrameCapture.GetOutputPath()));
+            ImGui::Text("Captured      : %u", CaptureStats.NumCaptured);
+            ImGui::Text("Encoded       : %u", CaptureStats.NumEncoded);
+            ImGui::Text("Dropped (GPU) : %u", CaptureStats.NumDroppedReadback);
+            ImGui::Text("Dropped (Enc) : %u", CaptureStats.NumDroppedEncoder);
+            ImGui::Text("Dropped (Size): %u", CaptureStats.NumDroppedResize);
+        }
+
+        if (ImGui::CollapsingHeader("Poster"))
+        {
+            FTiledRenderer& TiledRenderer = gConfig.Render.TiledRenderer;
+            FTiledRenderSettings& PosterSettings = gConfig.Render.PosterSettings;
+            if (TiledRenderer.IsActive())
+            {
+                ImGui::ProgressBar(TiledRenderer.GetProgress());
+                if (ImGui::Button("Cancel"))
+                {
+                    TiledRenderer.Cancel();
+                }
+            }
+            else
+            {
+                ImGui::InputInt("Width", &PosterSettings.Width);
+                ImGui::InputInt("Height", &PosterSettings.Height);
+                ImGui::InputInt("Tile Size", &PosterSettings.TileSize);
+
+                static constexpr std::array<const char*, 2> FormatNames = { "PNG", "TIFF" };
+                static constexpr std::array<const char*, 2> FormatExtensions = { ".png", ".tif" };
+                std::int32_t FormatIndex = PosterSettings.OutputPath.extension() == ".png" ? 0 : 1;
+                if (ImGui::Combo("Format", &FormatIndex, FormatNames.data(), static_cast<std::int32_t>(FormatNames.size())))
+                {
+                    PosterSettings.OutputPath.replace_extension(FormatExtensions[FormatIndex]);
+                }
+
+                if (ImGui::Button("Render"))
+                {
+                    TiledRenderer.Start(PosterSettings, gConfig.Scene.Camera, static_cast<float>(gConfig.Simulation.TotalTime));
+                }
+            }
+            ImGui::Text("Output        : %s", gConfig.Render.PosterOutputLabel.Get(PosterSettings.OutputPath));
+        }
+
+        if (ImGui::CollapsingHeader("Viewport"))
+        {
+            ImGui::SeparatorText("Window");
+            ImGui::Text("Width  : %d", gConfig.Viewport.WindowWidth);
+            ImGui::Text("Height : %d", gConfig.Viewport.WindowHeight);
+
+            ImGui::SeparatorText("Idle");
+            ImGui::Checkbox("Render On Demand", &gConfig.Viewport.bRenderOnDemand);
+            ImGui::Text("Idle Wake-ups : %llu", static_cast<unsigned long long>(gConfig.Viewport.NumIdleWakeUps));
+
+            FDynamicResolution& DynamicResolution = gConfig.Viewport.DynamicResolution;
+            FDynamicResolutionSettings& ResolutionSettings = DynamicResolution.GetSettings();
+            ImGui::SeparatorText("Dynamic Resolution");
+            ImGui::Checkbox("Dynamic Resolution", &ResolutionSettings.bEnabled);
+            ImGui::DragFloat("Frame Time Budget", &ResolutionSettings.FrameTimeBudget, 0.1f, 1.0f, 100.0f, "%.1f ms");
+            ImGui::SliderFloat("Min Scale", &ResolutionSettings.MinScale, 0.25f, ResolutionSettings.MaxScale, "%.2f");
+            ImGui::SliderFloat("Sharpness", &ResolutionSettings.Sharpness, 0.0f, 1.0f, "%.2f");
+            if (DynamicResolution.IsEnabled())
+            {
+                ImGui::Text("Render Scale  : %.2f (%d x %d)", DynamicResolution.GetScale(), DynamicResolution.GetSceneWidth(), DynamicResolution.GetSceneHeight());
+                ImGui::Text("Scene GPU Time: %.2f ms", gConfig.Render.GPUPassTimers[static_cast<std::size_t>(EGPUPass::Scene)].GetLastTime());
+            }
+            else
+            {
+                ImGui::Text("Render Scale  : 1.00 (%d x %d)", gConfig.Viewport.WindowWidth, gConfig.Viewport.WindowHeight);
+            }
+        }
+
+        if (ImGui::CollapsingHeader("Input"))
+        {
+            ImGui::Text("Mouse Position: (%d, %d)", gConfig.Input.Mouse.MousePos.x, gConfig.Input.Mouse.MousePos.y);
+            ImGui::Text("Mouse Delta   : (%d, %d)", gConfig.Input.Mouse.MouseDelta.x, gConfig.Input.Mouse.MouseDelta.y);
+
+            ImGui::SeparatorText("Recording");
+            ImGui::Text("Random Seed   : %u", gConfig.Scene.RandomSeed);
+            if (gConfig.Input.Recorder.IsRecording())
+            {
+                ImGui::Text("Recording     : %u frames", gConfig.Input.Recorder.GetNumFrames());
+            }
+            else if (gConfig.Input.Replay.IsReplaying())
+            {
+                ImGui::Text("Replaying     : %u frames", gConfig.Input.Replay.GetNumFrames());
+                ImGui::Text("Divergent     : %u (max %.6f)", gConfig.Input.NumDivergentFrames, gConfig.Input.MaxCameraDivergence);
+            }
+
+            if (gConfig.Input.ControlServer.IsRunning())
+            {
+                ImGui::SeparatorText("Control");
+                ImGui::Text("Port          : %u", static_cast<unsigned>(gConfig.Input.ControlServer.GetPort()));
+                ImGui::Text("Commands      : %llu", static_cast<unsigned long long>(gConfig.Input.ControlServer.GetNumCommands()));
+                ImGui::Text("Step Frames   : %u", gConfig.Input.NumStepFrames);
+            }
+        }
+    }
+    ImGui::End();
+
+    const std::map<std::filesystem::path, std::string>& ShaderFailureLogs = gConfig.Render.ShaderManager.GetFailureLogs();
+    if (!ShaderFailureLogs.empty())
+    {
+        ImGui::Begin("Shader Compilation Logs");
+        {
+            std::vector<FPathLabel>& ShaderLogLabels = gConfig.Render.ShaderLogLabels;
+            if (ShaderLogLabels.size() < ShaderFailureLogs.size())
+            {
+                ShaderLogLabels.resize(ShaderFailureLogs.size());
+            }
+
+            std::size_t LogIndex = 0;
+            for (const auto& [ShaderFilePath, FailureLog] : ShaderFailureLogs)
+            {
+                ImGui::TextWrapped("%s", ShaderLogLabels[LogIndex++].Get(ShaderFilePath));
+                ImGui::TextWrapped("%s", FailureLog.c_str());
+                ImGui::Spacing();
+            }
+        }
+        ImGui::End();
+    }
+
+    // Os dados de desenho da UI so sao enviados depois da cena
+    ImGui::Render();
+}
+
+void ParseCommandLine(std::int32_t Argc, char** Argv)
+{
+    for (std::int32_t ArgIndex = 1; ArgIndex < Argc; ++ArgIndex)
+    {
+        const std::string_view Arg = Argv[ArgIndex];
+        const bool bHasValue = ArgIndex + 1 < Argc;
+
+        if (Arg == "--shaders-dir" && bHasValue)
+        {
+            gConfig.Render.ShadersDir = Argv[++ArgIndex];
+        }
+        else if (Arg == "--textures-dir" && bHasValue)
+        {
+            gConfig.Render.TexturesDir = Argv[++ArgIndex];
+        }
+        else if (Arg == "--asset-pack" && bHasValue)
+        {
+            // Um caminho vazio usa os arquivos soltos
+            gConfig.Render.AssetPackFile = Argv[++ArgIndex];
+        }
+        else if (Arg == "--cache-dir" && bHasValue)
+        {
+            // Um diretorio vazio desliga o cache de malhas
+            gConfig.Render.CacheDir = Argv[++ArgIndex];
+        }
+        else if (Arg == "--width" && bHasValue)
+        {
+            gConfig.Viewport.WindowWidth = std::max(std::atoi(Argv[++ArgIndex]), 1);
+        }
+        else if (Arg == "--height" && bHasValue)
+        {
+            gConfig.Viewport.WindowHeight = std::max(std::atoi(Argv[++ArgIndex]), 1);
+        }
+        else if (Arg == "--headless")
+        {
+            // Sem UI ninguem tiraria a simulacao da pausa
+            gConfig.Viewport.bHeadless = true;
+            gConfig.Simulation.bPause = false;
+        }
+        else if (Arg == "--frames" && bHasValue)
+        {
+            gConfig.Simulation.MaxFrames = static_cast<std::uint32_t>(std::max(std::atoi(Argv[++ArgIndex]), 0));
+        }
+        else if (Arg == "--stats" && bHasValue)
+        {
+            gConfig.Simulation.StatsFile = Argv[++ArgIndex];
+        }
+        else if (Arg == "--control-port" && bHasValue)
+        {
+            gConfig.Input.ControlPort = static_cast<std::uint16_t>(std::clamp(std::atoi(Argv[++ArgIndex]), 0, 65535));
+        }
+        else if (Arg == "--metrics-port" && bHasValue)
+        {
+            gConfig.Simulation.MetricsPort = static_cast<std::uint16_t>(std::clamp(std::atoi(Argv[++ArgIndex]), 0, 65535));
+        }
+        else if (Arg == "--stats-warmup" && bHasValue)
+        {
+            gConfig.Simulation.NumStatsWarmUpFrames = static_cast<std::uint32_t>(std::max(std::atoi(Argv[++ArgIndex]), 0));
+        }
+        else if (Arg == "--instances" && bHasValue)
+        {
+            gConfig.Scene.NumInstances = std::max(std::atoi(Argv[++ArgIndex]), 0);
+        }
+        else if (Arg == "--sphere-resolution" && bHasValue)
+        {
+            gConfig.Scene.MeshResolution = std::max(std::atoi(Argv[++ArgIndex]), 2);
+        }
+        else if (Arg == "--scene" && bHasValue)
+        {
+            gConfig.Scene.SceneFile = Argv[++ArgIndex];
+        }
+        else if (Arg == "--scenes-dir" && bHasValue)
+        {
+            gConfig.Scene.ScenesDir = Argv[++ArgIndex];
+        }
+        else if (Arg == "--wireframe")
+        {
+            gConfig.Render.bShowWireframe = true;
+        }
+        else if (Arg == "--no-axis")
+        {
+            gConfig.Render.bDrawAxis = false;
+        }
+        else if (Arg == "--no-object")
+        {
+            gConfig.Render.bDrawObject = false;
+        }
+        else if (Arg == "--no-instances")
+        {
+            gConfig.Render.bDrawInstances = false;
+        }
+        else if (Arg == "--no-vsync")
+        {
+            gConfig.Render.bEnableVsync = false;
         }
-
-        if (ImGui::CollapsingHeader("Simulation"))
+        else if (Arg == "--on-demand")
         {
-            ImGui::Checkbox("Pause", &gConfig.Simulation.bPause);
-            ImGui::Checkbox("Reverse", &gConfig.Simulation.bReverse);
-
-            ImGui::Text("Time (s)             : %f", gConfig.Simulation.TotalTime);
-            ImGui::Text("Application Time (s) : %f", gConfig.Simulation.ApplicationTime);
-            ImGui::Text("Frame Count          : %d", gConfig.Simulation.FrameCount);
-            ImGui::Text("Frame Time (ms)      : %f", gConfig.Simulation.FrameTime);
-            ImGui::Text("FPS                  : %f", gConfig.Simulation.FramesPerSecond);
-            ImGui::Text("Frames:              : %d", gConfig.Simulation.TotalFrames);
-
-            if (ImGui::CollapsingHeader("Plots"))
+            gConfig.Viewport.bRenderOnDemand = true;
+        }
+        else if (Arg == "--dynamic-resolution" && bHasValue)
+        {
+            FDynamicResolutionSettings& ResolutionSettings = gConfig.Viewport.DynamicResolution.GetSettings();
+            ResolutionSettings.bEnabled = true;
+            ResolutionSettings.FrameTimeBudget = static_cast<float>(std::max(std::atof(Argv[++ArgIndex]), 1.0));
+        }
+        else if (Arg == "--fps-limit" && bHasValue)
+        {
+            gConfig.Render.FrameRateLimit = static_cast<float>(std::max(std::atof(Argv[++ArgIndex]), 0.0));
+        }
+        else if (Arg == "--capture" && bHasValue)
+        {
+            gConfig.Render.CaptureFile = Argv[++ArgIndex];
+            gConfig.Render.bCaptureOnStart = true;
+        }
+        else if (Arg == "--capture-format" && bHasValue)
+        {
+            const std::string_view FormatName = Argv[++ArgIndex];
+            if (const std::optional<ECaptureFormat> Format = ParseCaptureFormat(FormatName))
             {
-                const float AverageFrameTime = std::accumulate(gConfig.Simulation.FrameTimeHistory.begin(), gConfig.Simulation.FrameTimeHistory.end(), 0.0f) / gConfig.Simulation.FrameTimeHistory.size();
-                const std::string AverageFrameTimeOverlay = "Avg: " + std::to_string(AverageFrameTime) + " ms";
-                ImGui::PlotLines("Frame Times", gConfig.Simulation.FrameTimeHistory.data(), gConfig.Simulation.NumFramePlotValues, gConfig.Simulation.FramePlotOffset, AverageFrameTimeOverlay.c_str(), 0.0f, 100.0f, ImVec2(0, 100.0f));
-
-                const float AvgFPS = std::accumulate(gConfig.Simulation.FramesPerSecondHistory.begin(), gConfig.Simulation.FramesPerSecondHistory.end(), 0.0f) / gConfig.Simulation.FramesPerSecondHistory.size();
-                const std::string AverageFPSOverlay = "Avg:" + std::to_string(AvgFPS) + " ms";
-                ImGui::PlotLines("FPS", gConfig.Simulation.FramesPerSecondHistory.data(), gConfig.Simulation.NumFramePlotValues, gConfig.Simulation.FramePlotOffset, AverageFPSOverlay.c_str(), 0.0f, 300.0f, ImVec2(0, 100.0f));
+                gConfig.Render.CaptureFormat = *Format;
+            }
+            else
+            {
+                std::cout << "Formato de captura desconhecido: " << FormatName << std::endl;
             }
         }
-
-        if (ImGui::CollapsingHeader("Scene"))
+        else if (Arg == "--capture-fps" && bHasValue)
         {
-            ImGui::SeparatorText("Drawables");
-            ImGui::DragInt("Num Instances", &gConfig.Scene.NumInstances, 1000.0f, 0, 1'000'000);
-
-            ImGui::SeparatorText("Camera");
-            ImGui::DragFloat3("Camera Location", glm::value_ptr(gConfig.Scene.Camera.Location), 0.1f);
-            ImGui::DragFloat3("Camera Direction", glm::value_ptr(gConfig.Scene.Camera.Direction), 0.05f);
-            ImGui::DragFloat3("Camera Orientation", glm::value_ptr(gConfig.Scene.Camera.Up), 0.05f);
-            ImGui::DragFloat("Camera Near", &gConfig.Scene.Camera.Near, 0.05f, 0.0001f);
-            ImGui::DragFloat("Camera Far", &gConfig.Scene.Camera.Far, 0.05f, 0.0001f);
-            ImGui::DragFloat("Camera Field Of View", &gConfig.Scene.Camera.FieldOfView, 0.05f, 0.1f);
-            ImGui::Checkbox("Camera Orthographic", &gConfig.Scene.Camera.bIsOrtho);
-
-            ImGui::SeparatorText("Light");
-            ImGui::DragFloat3("Light Position", glm::value_ptr(gConfig.Scene.PointLight.Position), 0.1f);
-            ImGui::DragFloat("Intensity", &gConfig.Scene.PointLight.Intensity, 0.1f);
+            gConfig.Render.CaptureFramesPerSecond = static_cast<std::uint32_t>(std::max(std::atoi(Argv[++ArgIndex]), 1));
         }
-
-        if (ImGui::CollapsingHeader("Viewport"))
+        else if (Arg == "--record" && bHasValue)
         {
-            ImGui::SeparatorText("Window");
-            ImGui::Text("Width  : %d", gConfig.Viewport.WindowWidth);
-            ImGui::Text("Height : %d", gConfig.Viewport.WindowHeight);
+            gConfig.Input.RecordFile = Argv[++ArgIndex];
         }
-
-        if (ImGui::CollapsingHeader("Input"))
+        else if (Arg == "--record-timestep" && bHasValue)
         {
-            ImGui::Text("Mouse Position: (%d, %d)", gConfig.Input.Mouse.MousePos.x, gConfig.Input.Mouse.MousePos.y);
-            ImGui::Text("Mouse Delta   : (%d, %d)", gConfig.Input.Mouse.MouseDelta.x, gConfig.Input.Mouse.MouseDelta.y);
+            gConfig.Input.RecordTimeStep = std::max(std::atof(Argv[++ArgIndex]), 1.0e-4);
         }
-    }
-    ImGui::End();
-
-    const std::map<std::filesystem::path, std::string>& ShaderFailureLogs = gConfig.Render.ShaderManager.GetFailureLogs();
-    if (!ShaderFailureLogs.empty())
-    {
-        ImGui::Begin("Shader Compilation Logs");
+        else if (Arg == "--replay" && bHasValue)
+        {
+            gConfig.Input.ReplayFile = Argv[++ArgIndex];
+        }
+        else if (Arg == "--seed" && bHasValue)
+        {
+            gConfig.Scene.RandomSeed = static_cast<std::uint32_t>(std::strtoul(Argv[++ArgIndex], nullptr, 10));
+        }
+        else if (Arg == "--poster" && bHasValue)
+        {
+            gConfig.Render.PosterSettings.OutputPath = Argv[++ArgIndex];
+            gConfig.Render.bPosterOnStart = true;
+        }
+        else if (Arg == "--poster-size" && bHasValue)
         {
-            std::stringstream LogStream;
-            for (auto [ShaderFilePath, FailureLog] : ShaderFailureLogs)
+            FTiledRenderSettings& PosterSettings = gConfig.Render.PosterSettings;
+            if (std::sscanf(Argv[++ArgIndex], "%dx%d", &PosterSettings.Width, &PosterSettings.Height) != 2)
             {
-                LogStream << ShaderFilePath << "\n\n";
-                LogStream << FailureLog << "\n\n";
+                std::cout << "Tamanho invalido, use <Largura>x<Altura>: " << Argv[ArgIndex] << std::endl;
             }
-            ImGui::TextWrapped(LogStream.str().c_str());
         }
-        ImGui::End();
+        else if (Arg == "--poster-tile" && bHasValue)
+        {
+            gConfig.Render.PosterSettings.TileSize = std::atoi(Argv[++ArgIndex]);
+        }
+        else
+        {
+            std::cout << "Argumento desconhecido: " << Arg << std::endl;
+        }
     }
-
-    ImGui::Render();
-    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 }
 
-int main()
+int main(int Argc, char** Argv)
 {
+    ParseCommandLine(Argc, Argv);
+    StartInputRecordingOrReplay();
+
     if (!glfwInit())
     {
         std::cout << "Erro ao inicializar o GLFW" << std::endl;
@@ -1014,6 +1709,7 @@ int main()
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
     glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, true);
+    glfwWindowHint(GLFW_VISIBLE, !gConfig.Viewport.bHeadless);
 
     gConfig.Viewport.Window = glfwCreateWindow(gConfig.Viewport.WindowWidth, gConfig.Viewport.WindowHeight, "BlueMarble", nullptr, nullptr);
     if (!gConfig.Viewport.Window)
@@ -1027,6 +1723,11 @@ int main()
     glfwSetMouseButtonCallback(gConfig.Viewport.Window, MouseButtonCallback);
     glfwSetCursorPosCallback(gConfig.Viewport.Window, MouseMotionCallback);
     glfwSetKeyCallback(gConfig.Viewport.Window, KeyCallback);
+    glfwSetScrollCallback(gConfig.Viewport.Window, ScrollCallback);
+    glfwSetCharCallback(gConfig.Viewport.Window, CharCallback);
+    glfwSetCursorEnterCallback(gConfig.Viewport.Window, CursorEnterCallback);
+    glfwSetWindowFocusCallback(gConfig.Viewport.Window, WindowFocusCallback);
+    glfwSetWindowRefreshCallback(gConfig.Viewport.Window, WindowRefreshCallback);
 
     glfwMakeContextCurrent(gConfig.Viewport.Window);
 
@@ -1059,6 +1760,10 @@ int main()
         glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_TRUE);
     }
 
+#if BLUEMARBLE_GL_TRACE
+    FGLTracer::Get().Install();
+#endif
+
     // Imprime informaes sobre a verso do OpenGL que o programa est usando
     GLint GLMajorVersion = 0;
     GLint GLMinorVersion = 0;
@@ -1072,86 +1777,159 @@ int main()
     std::cout << "glfw Version    : " << glfwGetVersionString() << std::endl;
     std::cout << "ImGui Version   : " << IMGUI_VERSION << std::endl;
 
-    FShaderPtr ProgramId = gConfig.Render.ShaderManager.AddShader("triangle.vert", "triangle.frag");
+    // Sem o pacote os arquivos soltos sao usados
+    const FAssetPack* AssetPack = nullptr;
+    if (!gConfig.Render.AssetPackFile.empty() && gConfig.Render.AssetPack.Open(gConfig.Render.AssetPackFile))
+    {
+        AssetPack = &gConfig.Render.AssetPack;
+    }
+
+    gConfig.Render.ShaderManager.Initialize(gConfig.Render.ShadersDir, AssetPack);
+    gConfig.Render.TextureManager.Initialize(gConfig.Render.TexturesDir, AssetPack);
+    gConfig.Render.MeshArena.Initialize(64 * 1024 * 1024, 8 * 1024 * 1024);
+    gConfig.Render.MeshCache.Initialize(gConfig.Render.CacheDir);
+    if (AssetPack == nullptr)
+    {
+        gConfig.Render.AssetWatcher = std::make_unique<FDirectoryWatcher>(std::vector<std::filesystem::path>{ gConfig.Render.ShaderManager.GetShadersDir(),
+                                                                                                              gConfig.Render.TextureManager.GetTexturesDir() });
+    }
+
     FShaderPtr InstancedProgramId = gConfig.Render.ShaderManager.AddShader("instanced.vert", "instanced.frag");
     FShaderPtr AxisProgramId = gConfig.Render.ShaderManager.AddShader("lines.vert", "lines.frag");
 
-    FRenderData AxisRenderData = GetAxisRenderData();
-    FRenderData GeoRenderData = GetRenderData();
-    FInstancedRenderData InstRenderData = GetInstancedRenderData(gConfig.Scene.NumInstances);
-
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LESS);
+    if (!gConfig.Viewport.bHeadless)
+    {
+        gConfig.Viewport.DynamicResolution.Initialize(gConfig.Render.ShaderManager);
+    }
 
-    GLint EarthTextureId, CloudsTextureId;
+    for (std::size_t PassIndex = 0; PassIndex < gConfig.Render.GPUPassTimers.size(); ++PassIndex)
+    {
+        gConfig.Render.GPUPassTimers[PassIndex].Initialize(std::string{ GetGPUPassName(static_cast<EGPUPass>(PassIndex)) } + " GPU Timer");
+    }
 
-    const std::string EarthTextureFile = "textures/earth_2k.jpg";
-    const std::string CloudsTextureFile = "textures/earth_clouds_2k.jpg";
+    if (gConfig.Simulation.MetricsPort != 0)
+    {
+        gConfig.Simulation.MetricsExporter.Start(gConfig.Simulation.MetricsPort);
+    }
 
-    const double LoadTexturesStartTime = glfwGetTime();
-    constexpr bool bParallelLoadTextures = true;
-    if constexpr (bParallelLoadTextures)
+    if (gConfig.Input.ControlPort != 0)
     {
-        // No vale a pena fazer isso s com duas texturas mas eu quis fazer uma funo que fizesse isso de forma paralela mesmo assim
-        const std::map<std::string, GLint> TextureIds = LoadTextures({ EarthTextureFile, CloudsTextureFile });
-        EarthTextureId = TextureIds.at(EarthTextureFile);
-        CloudsTextureId = TextureIds.at(CloudsTextureFile);
+        // Acorda o glfwWaitEventsTimeout do modo sob demanda para que o comando seja aplicado logo
+        gConfig.Input.ControlServer.Start(gConfig.Input.ControlPort, []
+        {
+            glfwPostEmptyEvent();
+        });
     }
-    else
+
+    const FUniformBlockHandle AxisFrameBlock{ AxisProgramId, "FrameUBO" };
+    const FUniformBlockHandle AxisModelBlock{ AxisProgramId, "ModelUBO" };
+
+
+    const FUniformBlockHandle InstancedFrameBlock{ InstancedProgramId, "FrameUBO" };
+    const FUniformBlockHandle InstancedModelBlock{ InstancedProgramId, "ModelUBO" };
+    const FUniformHandle InstancedNumInstances{ InstancedProgramId, "NumInstances" };
+    const FUniformHandle InstancedEarthTexture{ InstancedProgramId, "EarthTexture" };
+    const FUniformHandle InstancedCloudsTexture{ InstancedProgramId, "CloudsTexture" };
+
+    FindSceneFiles();
+
+    FRenderData AxisRenderData = GetAxisRenderData();
+    FObjectRenderData ObjectRenderData = PrepareInitialScene();
+    FInstancedRenderData InstRenderData = GetInstancedRenderData(gConfig.Scene.NumInstances);
+
+    // Os dois estagios de cada programa incluem o mesmo frame_ubo.glsl, entao um programa sem link aqui tambem
+    // denuncia um include perdido entre os estagios. Com janela o shader pode ser corrigido com o programa rodando,
+    // sem janela ninguem corrige e a automacao precisa ver a falha no codigo de saida. O loop nem comeca e o
+    // encerramento passa pelo caminho normal, que para os servidores e libera os recursos
+    const bool bProgramsLinked = ObjectRenderData.Scene.Program->ProgramId != 0 && InstancedProgramId->ProgramId != 0 && AxisProgramId->ProgramId != 0;
+    bool bStartupFailed = false;
+    if (!bProgramsLinked)
     {
-        // Carregar a Textura para a Memria de Vdeo
-        EarthTextureId = LoadTexture(EarthTextureFile.c_str());
-        CloudsTextureId = LoadTexture(CloudsTextureFile.c_str());
+        std::cout << "Erro: programas iniciais nao compilaram" << std::endl;
+        for (const auto& [ShaderFilePath, FailureLog] : gConfig.Render.ShaderManager.GetFailureLogs())
+        {
+            std::cout << ShaderFilePath.string() << ": " << FailureLog << std::endl;
+        }
+
+        if (gConfig.Viewport.bHeadless)
+        {
+            bStartupFailed = true;
+            glfwSetWindowShouldClose(gConfig.Viewport.Window, true);
+        }
     }
-    const double LoadTexturesEndTime = glfwGetTime();
-    std::cout << "Texturas Carregadas em " << (LoadTexturesEndTime - LoadTexturesStartTime) << " segundos" << std::endl;
 
-    GLuint FrameUBO;
-    glGenBuffers(1, &FrameUBO);
+    glEnable(GL_DEPTH_TEST);
+    glDepthFunc(GL_LESS);
+
+    FGPUResourceRegistry& ResourceRegistry = FGPUResourceRegistry::Get();
+
+    GLuint FrameUBO = ResourceRegistry.CreateBuffer("Frame UBO");
     glBindBuffer(GL_UNIFORM_BUFFER, FrameUBO);
     glBufferData(GL_UNIFORM_BUFFER, sizeof(FPerFrameData), nullptr, GL_STATIC_DRAW);
     glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    ResourceRegistry.SetSize(EGPUResourceType::Buffer, FrameUBO, sizeof(FPerFrameData));
 
-    GLuint ModelUBO;
-    glGenBuffers(1, &ModelUBO);
-    glBindBuffer(GL_UNIFORM_BUFFER, ModelUBO);
-    glBufferData(GL_UNIFORM_BUFFER, sizeof(FPerModelData), nullptr, GL_STATIC_DRAW);
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
 
-    GLuint LightUBO;
-    glGenBuffers(1, &LightUBO);
+    GLuint LightUBO = ResourceRegistry.CreateBuffer("Light UBO");
     glBindBuffer(GL_UNIFORM_BUFFER, LightUBO);
     glBufferData(GL_UNIFORM_BUFFER, sizeof(FLight), nullptr, GL_STATIC_DRAW);
     glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    ResourceRegistry.SetSize(EGPUResourceType::Buffer, LightUBO, sizeof(FLight));
 
     // Configura a cor de fundo
     glClearColor(0.1f, 0.1f, 0.1f, 1.0);
 
     gConfig.Scene.Camera.SetViewportSize(gConfig.Viewport.WindowWidth, gConfig.Viewport.WindowHeight);
 
+    if (gConfig.Viewport.bHeadless)
+    {
+        gConfig.Viewport.SceneTarget.Initialize(gConfig.Viewport.WindowWidth, gConfig.Viewport.WindowHeight, "Scene Target");
+        glViewport(0, 0, gConfig.Viewport.WindowWidth, gConfig.Viewport.WindowHeight);
+    }
+
+    if (gConfig.Render.bCaptureOnStart && !bStartupFailed)
+    {
+        StartCapture();
+    }
+
+    if (gConfig.Render.bPosterOnStart && !bStartupFailed)
+    {
+        gConfig.Render.TiledRenderer.Start(gConfig.Render.PosterSettings, gConfig.Scene.Camera, static_cast<float>(gConfig.Simulation.TotalTime));
+    }
+
     gConfig.Simulation.FrameTimeHistory.resize(gConfig.Simulation.NumFramePlotValues);
     gConfig.Simulation.FramesPerSecondHistory.resize(gConfig.Simulation.NumFramePlotValues);
+    gConfig.Simulation.InputLatencyHistory.resize(gConfig.Simulation.NumFramePlotValues);
 
     double TimeSinceLastFrame = 0.0f;
     double PreviousTime = glfwGetTime();
+    double DisplayedFramesPerSecond = 0.0;
 
-    while (!glfwWindowShouldClose(gConfig.Viewport.Window))
-    {
-        gConfig.Render.ShaderManager.UpdateShaders();
+    // O estado foi alterado diretamente durante a carga dos recursos
+    FGLStateCache& StateCache = gConfig.Render.StateCache;
+    StateCache.Invalidate();
 
-        glfwPollEvents();
-
-        glfwSwapInterval(gConfig.Render.bEnableVsync);
+    // Cada drawable e gravado por um job do WorkerPool
+    enum class EDrawable : std::uint32_t
+    {
+        Axis,
+        Object,
+        Instances,
+        Count
+    };
 
-        gConfig.Render.bCullFace ? glEnable(GL_CULL_FACE) : glDisable(GL_CULL_FACE);
+    // O update do frame N+1 roda nesta thread enquanto a thread do OpenGL desenha o snapshot do frame N.
+    // Ela so acessa gConfig.Simulation, a camera e o PendingEventTime da entrada, que a thread principal
+    // nao toca entre o Kick e o Wait
+    TTripleBuffer<FFrameSnapshot> FrameSnapshots;
+    FFrameUpdateThread UpdateThread{ [&]
+    {
+        FAllocationZoneScope AllocationZone{ EAllocationZone::Update };
 
         const double CurrentTime = glfwGetTime();
         gConfig.Simulation.ApplicationTime = CurrentTime;
         gConfig.Simulation.FrameTime = CurrentTime - PreviousTime;
 
-        gConfig.Simulation.FrameTimeHistory.resize(gConfig.Simulation.NumFramePlotValues);
-        gConfig.Simulation.FramesPerSecondHistory.resize(gConfig.Simulation.NumFramePlotValues);
-
         gConfig.Simulation.FrameTimeHistory[gConfig.Simulation.FramePlotOffset] = static_cast<float>(gConfig.Simulation.FrameTime) * 1000.0f;
         gConfig.Simulation.FramesPerSecondHistory[gConfig.Simulation.FramePlotOffset] = static_cast<float>(gConfig.Simulation.FramesPerSecond);
 
@@ -1159,124 +1937,574 @@ int main()
 
         if (gConfig.Simulation.FrameTime > 0.0)
         {
+            const double SimulationTime = gConfig.Simulation.FixedTimeStep > 0.0 ? gConfig.Simulation.FixedTimeStep : gConfig.Simulation.FrameTime;
             const double TimeScale = gConfig.Simulation.bReverse ? -1.0 : 1.0;
-            gConfig.Simulation.TotalTime += gConfig.Simulation.FrameTime * (gConfig.Simulation.bPause ? 0.0f : TimeScale);
+            gConfig.Simulation.TotalTime += SimulationTime * (gConfig.Simulation.bPause ? 0.0f : TimeScale);
             TimeSinceLastFrame += gConfig.Simulation.FrameTime;
             if (TimeSinceLastFrame >= 1.0f)
             {
                 gConfig.Simulation.FramesPerSecond = gConfig.Simulation.FrameCount / TimeSinceLastFrame;
                 TimeSinceLastFrame = 0.0;
                 gConfig.Simulation.FrameCount = 0;
-                const std::string WindowTitle = "BlueMarble - FPS: " + std::to_string(gConfig.Simulation.FramesPerSecond);
-                glfwSetWindowTitle(gConfig.Viewport.Window, WindowTitle.c_str());
             }
 
-            gConfig.Scene.Camera.Update(static_cast<float>(gConfig.Simulation.FrameTime));
+            gConfig.Scene.Camera.Update(static_cast<float>(SimulationTime));
             PreviousTime = CurrentTime;
         }
 
         gConfig.Simulation.FrameCount++;
         gConfig.Simulation.TotalFrames++;
 
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        FFrameSnapshot& Snapshot = FrameSnapshots.GetWriteBuffer();
+        Snapshot.FrameData = { .ViewMatrix = gConfig.Scene.Camera.GetView(),
+                               .ProjectionMatrix = gConfig.Scene.Camera.GetProjection(),
+                               .Time = static_cast<float>(gConfig.Simulation.TotalTime) };
+        Snapshot.PointLight = gConfig.Scene.PointLight;
+        Snapshot.CameraFar = gConfig.Scene.Camera.Far;
+        Snapshot.UpdateTime = glfwGetTime() - CurrentTime;
+        Snapshot.InputEventTime = gConfig.Input.PendingEventTime;
+        gConfig.Input.PendingEventTime = 0.0;
+        FrameSnapshots.Publish();
+    } };
+
+    UpdateThread.Kick();
+
+    std::uint32_t NumRenderedFrames = 0;
+    FInputFrame ReplayFrame;
+
+    // Sem o glfwSwapBuffers nada impede a CPU de enfileirar frames sem limite na frente da GPU. No modo
+    // headless cada frame espera a fence de MaxHeadlessFramesInFlight frames atras, como faria a swap chain
+    constexpr std::uint32_t MaxHeadlessFramesInFlight = 2;
+    std::array<GLsync, MaxHeadlessFramesInFlight> HeadlessFrameFences{};
+
+    // Uma execucao que falhou nao deixa um arquivo de estatisticas vazio para o sweep
+    if (!gConfig.Simulation.StatsFile.empty() && !bStartupFailed)
+    {
+        gConfig.Simulation.FrameStats.Start(gConfig.Simulation.NumStatsWarmUpFrames);
+    }
+    double PreviousFrameEndTime = glfwGetTime();
+
+    // O ultimo loop nao desenhou, modo sob demanda
+    bool bIdle = false;
+
+    while (!glfwWindowShouldClose(gConfig.Viewport.Window))
+    {
+        // Os callbacks e a UI alteram o gConfig, entao o update anterior precisa ter terminado
+        UpdateThread.Wait();
+        FrameSnapshots.Acquire();
+
+        FMemoryTracker::Get().BeginFrame();
+        gConfig.Render.FrameAllocator.Reset();
+
+        if (gConfig.Simulation.FramesPerSecond != DisplayedFramesPerSecond)
+        {
+            // O titulo da janela so pode ser alterado pela thread principal
+            DisplayedFramesPerSecond = gConfig.Simulation.FramesPerSecond;
+            glfwSetWindowTitle(gConfig.Viewport.Window, gConfig.Render.FrameAllocator.Format("BlueMarble - FPS: %f", DisplayedFramesPerSecond));
+        }
+
+        StateCache.BeginFrame();
+#if BLUEMARBLE_GL_TRACE
+        FGLTracer::Get().BeginFrame();
+#endif
+
+        // A zona muda a cada etapa do frame e volta para Other no fim da iteracao
+        FAllocationZoneScope FrameAllocationZone{ EAllocationZone::Assets };
+
+        gConfig.Render.ChangedAssetFiles.clear();
+        if (gConfig.Render.AssetWatcher)
+        {
+            gConfig.Render.AssetWatcher->GetChangedFiles(gConfig.Render.ChangedAssetFiles);
+        }
+
+        if (gConfig.Render.ShaderManager.UpdateShaders(gConfig.Render.ChangedAssetFiles))
+        {
+            // Os programas antigos foram apagados e seus identificadores podem ser reutilizados
+            StateCache.UseProgram(0);
+            RequestRedraw();
+        }
+
+        if (gConfig.Render.TextureManager.UpdateTextures(gConfig.Render.ChangedAssetFiles))
+        {
+            // O envio das texturas altera o binding da unidade de textura ativa
+            StateCache.Invalidate();
+            RequestRedraw();
+        }
+
+        FMemoryTracker::ExchangeCurrentZone(EAllocationZone::UI);
+
+        // Sob demanda e sem nada mudando, o loop dorme no glfwWaitEventsTimeout em vez de desenhar. O timeout
+        // mantem o hot reload de shaders e texturas funcionando
+        FViewportConfig& Viewport = gConfig.Viewport;
+        const bool bOnDemand = Viewport.bRenderOnDemand && !Viewport.bHeadless;
+        const bool bWaitForEvents = bOnDemand && Viewport.NumRequestedFrames == 0 && !IsSceneAnimating();
+
+        // A espera fica logo antes de ler a entrada para que o update e o desenho usem a entrada mais recente
+        FFramePacer& FramePacer = gConfig.Render.FramePacer;
+        if (FramePacer.GetTargetFrameRate() != gConfig.Render.FrameRateLimit)
+        {
+            FramePacer.SetTargetFrameRate(gConfig.Render.FrameRateLimit);
+        }
+        if (!bWaitForEvents)
+        {
+            FramePacer.WaitForNextFrame();
+        }
+
+        FInputConfig& Input = gConfig.Input;
+        if (Input.Recorder.IsRecording())
+        {
+            Input.Recorder.BeginFrame(gConfig.Scene.Camera);
+        }
+
+        if (bWaitForEvents)
+        {
+            glfwWaitEventsTimeout(Viewport.IdleEventTimeout);
+        }
+        else
+        {
+            glfwPollEvents();
+        }
+
+        if (Input.Recorder.IsRecording())
+        {
+            Input.Recorder.EndFrame();
+        }
+        else if (Input.Replay.IsReplaying())
+        {
+            if (Input.Replay.ReadFrame(ReplayFrame))
+            {
+                // Com o mesmo passo e a mesma semente a camera deve bater; a gravada vale para que builds com
+                // mudancas na camera ainda desenhem exatamente os mesmos frames
+                const float CameraDivergence = FCameraState::FromCamera(gConfig.Scene.Camera).GetMaxDifference(ReplayFrame.Camera);
+                if (CameraDivergence > 1.0e-4f)
+                {
+                    Input.NumDivergentFrames++;
+                }
+                Input.MaxCameraDivergence = std::max(Input.MaxCameraDivergence, CameraDivergence);
+                ReplayFrame.Camera.ApplyTo(gConfig.Scene.Camera);
+
+                for (const FInputEvent& Event : ReplayFrame.Events)
+                {
+                    ApplyInputEvent(gConfig.Viewport.Window, Event);
+                }
+            }
+            else
+            {
+                std::cout << "Replay terminado: " << Input.Replay.GetNumFrames() << " frames, " << Input.NumDivergentFrames
+                          << " com a camera divergente (maximo " << Input.MaxCameraDivergence << ")" << std::endl;
+                Input.Replay.Close();
+                glfwSetWindowShouldClose(gConfig.Viewport.Window, true);
+            }
+        }
+
+        // Os comandos de controle entram depois da entrada, com o update do frame ainda parado
+        ApplyControlCommands();
+
+        if (bOnDemand && Viewport.NumRequestedFrames == 0 && !IsSceneAnimating())
+        {
+            // Nada mudou: sem update, sem envio de UBOs e instancias e sem swap
+            Viewport.NumIdleWakeUps++;
+            bIdle = true;
+            continue;
+        }
+
+        if (bIdle)
+        {
+            // Sem update em andamento; o primeiro update depois da pausa nao deve ver o tempo parado como um frame
+            PreviousTime = glfwGetTime();
+            FramePacer.Reset();
+            bIdle = false;
+        }
 
-        const FPerFrameData PerFrameUBO = { .ViewMatrix = gConfig.Scene.Camera.GetView(),
-                                        .ProjectionMatrix = gConfig.Scene.Camera.GetProjection(),
-                                        .Time = static_cast<float>(gConfig.Simulation.TotalTime) };
+        const bool bHeadless = gConfig.Viewport.bHeadless;
+        if (!bHeadless)
+        {
+            DrawUI();
+        }
+
+        // A proxima cena e preparada aos poucos e entra inteira neste frame, com o update ainda parado. Durante
+        // um poster a troca espera o ultimo tile para que a imagem toda seja da mesma cena
+        FRenderConfig& Render = gConfig.Render;
+        FScenePreparer& ScenePreparer = gConfig.Scene.Preparer;
+        if (ScenePreparer.Update(Render.MeshArena, Render.ShaderManager, Render.TextureManager) && !Render.TiledRenderer.IsActive())
+        {
+            // A regiao liberada e reaproveitada por outra malha, o driver sincroniza com os frames ainda na GPU
+            Render.MeshArena.RemoveMesh(ObjectRenderData.Mesh);
+            ObjectRenderData = FObjectRenderData{ ScenePreparer.TakePreparedScene() };
+            ApplyPreparedScene(ObjectRenderData.Scene);
+            Render.TextureManager.RemoveUnusedTextures();
+            RequestRedraw();
+
+            if (!Input.SceneCommand.Name.empty())
+            {
+                Input.ControlServer.SendReply(Input.SceneCommand);
+                Input.SceneCommand = {};
+            }
+        }
 
-        glBindBuffer(GL_UNIFORM_BUFFER, FrameUBO);
-        glBufferData(GL_UNIFORM_BUFFER, sizeof(FPerFrameData), &PerFrameUBO, GL_STATIC_DRAW);
+        FMemoryTracker::ExchangeCurrentZone(EAllocationZone::Render);
 
-        glBindBuffer(GL_UNIFORM_BUFFER, LightUBO);
-        glBufferData(GL_UNIFORM_BUFFER, sizeof(FLight), &gConfig.Scene.PointLight, GL_STATIC_DRAW);
+        const double RenderStartTime = glfwGetTime();
 
-        if (gConfig.Render.bDrawAxis)
+        UpdateThread.Kick();
+        if (!gConfig.Simulation.bPipelineFrames)
         {
-            glBindBufferRange(GL_UNIFORM_BUFFER, AxisProgramId->UniformBlockBindings["FrameUBO"], FrameUBO, 0, sizeof(FPerFrameData));
-            glBindBufferRange(GL_UNIFORM_BUFFER, AxisProgramId->UniformBlockBindings["ModelUBO"], ModelUBO, 0, sizeof(FPerModelData));
+            // Sem o pipeline o frame desenhado e o que acabou de ser atualizado
+            UpdateThread.Wait();
+            FrameSnapshots.Acquire();
+        }
 
-            glUseProgram(AxisProgramId->ProgramId);
+        const FFrameSnapshot& Snapshot = FrameSnapshots.GetReadBuffer();
 
-            const glm::mat4 ModelMatrix = glm::identity<glm::mat4>();
+        StateCache.SetSwapInterval(gConfig.Render.bEnableVsync ? 1 : 0);
+        StateCache.SetCullFace(gConfig.Render.bCullFace);
 
-            const FPerModelData PerModelUBO = { .ModelMatrix = ModelMatrix, .NormalMatrix = ModelMatrix };
+        // Durante uma renderizacao em tiles o frame desenha o proximo tile com a camera congelada no inicio
+        FTiledRenderer& TiledRenderer = gConfig.Render.TiledRenderer;
+        const bool bRenderTile = TiledRenderer.IsActive();
+        FPerFrameData FrameData = Snapshot.FrameData;
+        if (bRenderTile)
+        {
+            FrameData = { .ViewMatrix = TiledRenderer.GetViewMatrix(),
+                          .ProjectionMatrix = TiledRenderer.GetProjectionMatrix(),
+                          .Time = TiledRenderer.GetTime() };
+        }
 
-            glBindBuffer(GL_UNIFORM_BUFFER, ModelUBO);
-            glBufferData(GL_UNIFORM_BUFFER, sizeof(FPerModelData), &PerModelUBO, GL_STATIC_DRAW);
+        // Medicoes de frames anteriores que a GPU ja terminou. Negativo quando a passada nao tem uma nova
+        std::array<FGPUTimer, static_cast<std::size_t>(EGPUPass::Count)>& GPUPassTimers = gConfig.Render.GPUPassTimers;
+        std::array<double, static_cast<std::size_t>(EGPUPass::Count)> GPUPassTimes;
+        for (std::size_t PassIndex = 0; PassIndex < GPUPassTimers.size(); ++PassIndex)
+        {
+            GPUPassTimes[PassIndex] = GPUPassTimers[PassIndex].Poll() > 0 ? GPUPassTimers[PassIndex].GetLastTime() : -1.0;
+        }
+        FGPUTimer& SceneTimer = GPUPassTimers[static_cast<std::size_t>(EGPUPass::Scene)];
 
-            glBindVertexArray(AxisRenderData.VAO);
-            glDrawArrays(GL_LINES, 0, AxisRenderData.NumElements);
-            glBindVertexArray(0);
+        // Os tiles e o modo headless sempre usam a resolucao cheia
+        FDynamicResolution& DynamicResolution = gConfig.Viewport.DynamicResolution;
+        const double SceneGPUTime = GPUPassTimes[static_cast<std::size_t>(EGPUPass::Scene)];
+        if (DynamicResolution.IsEnabled() && !bRenderTile && SceneGPUTime >= 0.0)
+        {
+            DynamicResolution.AddSceneTime(SceneGPUTime);
+        }
+        const bool bScaledScene = !bHeadless && !bRenderTile && DynamicResolution.IsEnabled();
+        if (!bHeadless && !DynamicResolution.IsEnabled())
+        {
+            DynamicResolution.ReleaseTarget();
         }
 
-        if (gConfig.Render.bDrawObject)
+        // Zero e o back buffer da janela
+        const GLuint SceneFramebuffer = bRenderTile ? TiledRenderer.GetFramebuffer() : gConfig.Viewport.SceneTarget.GetFramebuffer();
+        if (bScaledScene)
+        {
+            DynamicResolution.BeginScene(gConfig.Viewport.WindowWidth, gConfig.Viewport.WindowHeight);
+        }
+        else
+        {
+            glBindFramebuffer(GL_FRAMEBUFFER, SceneFramebuffer);
+        }
+        if (bRenderTile)
         {
-            glBindBufferRange(GL_UNIFORM_BUFFER, ProgramId->UniformBlockBindings["FrameUBO"], FrameUBO, 0, sizeof(FPerFrameData));
-            glBindBufferRange(GL_UNIFORM_BUFFER, ProgramId->UniformBlockBindings["ModelUBO"], ModelUBO, 0, sizeof(FPerModelData));
-            glBindBufferRange(GL_UNIFORM_BUFFER, ProgramId->UniformBlockBindings["LightUBO"], LightUBO, 0, sizeof(FLight));
+            glViewport(0, 0, TiledRenderer.GetCurrentTile().Width, TiledRenderer.GetCurrentTile().Height);
+        }
 
-            glUseProgram(ProgramId->ProgramId);
+        SceneTimer.Begin();
 
-            const glm::mat4 ModelMatrix = GeoRenderData.Transform;
-            const glm::mat4 NormalMatrix = glm::transpose(glm::inverse(ModelMatrix));
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        StateCache.BindBuffer(GL_UNIFORM_BUFFER, FrameUBO);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(FPerFrameData), &FrameData, GL_STATIC_DRAW);
+
+        StateCache.BindBuffer(GL_UNIFORM_BUFFER, LightUBO);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(FLight), &Snapshot.PointLight, GL_STATIC_DRAW);
+
+        // Os dados lidos pelos jobs de gravacao sao copiados aqui, antes de comecar o Record
+        const glm::mat4 ViewMatrix = FrameData.ViewMatrix;
+        const GLenum PolygonMode = gConfig.Render.bShowWireframe ? GL_LINE : GL_FILL;
+        const bool bDrawAxis = gConfig.Render.bDrawAxis;
+        const bool bDrawObject = gConfig.Render.bDrawObject;
+        const bool bDrawInstances = gConfig.Render.bDrawInstances;
+        const FMeshArena& MeshArena = gConfig.Render.MeshArena;
+        const GLsizei NumDrawnInstances = static_cast<GLsizei>(std::min(static_cast<GLuint>(InstRenderData.NumInstances), static_cast<GLuint>(gConfig.Scene.NumInstances)));
+        const GLuint EarthTextureId = ObjectRenderData.Scene.EarthTexture->TextureId;
+        const GLuint CloudsTextureId = ObjectRenderData.Scene.CloudsTexture->TextureId;
+
+        const auto GetViewDepth = [&ViewMatrix](const glm::mat4& InModelMatrix)
+        {
+            return -(ViewMatrix * InModelMatrix[3]).z;
+        };
+
+        FRenderQueue& RenderQueue = gConfig.Render.RenderQueue;
+        RenderQueue.Record(gConfig.Render.WorkerPool, static_cast<std::uint32_t>(EDrawable::Count), [&](FDrawPacketRecorder& Recorder, std::uint32_t DrawableIndex)
+        {
+            FAllocationZoneScope AllocationZone{ EAllocationZone::Render };
 
-            const FPerModelData PerModelUBO = { .ModelMatrix = ModelMatrix, .NormalMatrix = NormalMatrix };
+            switch (static_cast<EDrawable>(DrawableIndex))
+            {
+                case EDrawable::Axis:
+                {
+                    if (!bDrawAxis)
+                    {
+                        break;
+                    }
+
+                    const glm::mat4 ModelMatrix = glm::identity<glm::mat4>();
+
+                    FDrawPacket& Packet = Recorder.AddPacket();
+                    Packet.ViewDepth = GetViewDepth(ModelMatrix);
+                    const FMeshDrawInfo DrawInfo = MeshArena.GetDrawInfo(AxisRenderData.Mesh);
+
+                    Packet.ProgramId = AxisProgramId->ProgramId;
+                    Packet.VAO = MeshArena.GetVAO();
+                    Packet.PrimitiveType = GL_LINES;
+                    Packet.NumElements = DrawInfo.NumIndices;
+                    Packet.FirstIndex = DrawInfo.FirstIndex;
+                    Packet.BaseVertex = DrawInfo.BaseVertex;
+                    Packet.UniformBlocks[0] = { &AxisFrameBlock, FrameUBO, sizeof(FPerFrameData) };
+                    Packet.ModelBlock = &AxisModelBlock;
+                    Packet.ModelData = { .ModelMatrix = ModelMatrix, .NormalMatrix = ModelMatrix };
+                    break;
+                }
+
+                case EDrawable::Object:
+                {
+                    if (!bDrawObject)
+                    {
+                        break;
+                    }
+
+                    const glm::mat4 ModelMatrix = ObjectRenderData.Transform;
+                    const glm::mat4 NormalMatrix = glm::transpose(glm::inverse(ModelMatrix));
+
+                    FDrawPacket& Packet = Recorder.AddPacket();
+                    Packet.ViewDepth = GetViewDepth(ModelMatrix);
+                    const FMeshDrawInfo DrawInfo = MeshArena.GetDrawInfo(ObjectRenderData.Mesh);
+
+                    Packet.ProgramId = ObjectRenderData.Scene.Program->ProgramId;
+                    Packet.VAO = MeshArena.GetVAO();
+                    Packet.PolygonMode = PolygonMode;
+                    Packet.NumElements = DrawInfo.NumIndices;
+                    Packet.FirstIndex = DrawInfo.FirstIndex;
+                    Packet.BaseVertex = DrawInfo.BaseVertex;
+                    Packet.Textures = { EarthTextureId, CloudsTextureId };
+                    Packet.UniformBlocks[0] = { &ObjectRenderData.FrameBlock, FrameUBO, sizeof(FPerFrameData) };
+                    Packet.UniformBlocks[1] = { &ObjectRenderData.LightBlock, LightUBO, sizeof(FLight) };
+                    Packet.Uniforms[0] = { &ObjectRenderData.EarthTextureUniform, 0 };
+                    Packet.Uniforms[1] = { &ObjectRenderData.CloudsTextureUniform, 1 };
+                    Packet.ModelBlock = &ObjectRenderData.ModelBlock;
+                    Packet.ModelData = { .ModelMatrix = ModelMatrix, .NormalMatrix = NormalMatrix };
+                    break;
+                }
+
+                case EDrawable::Instances:
+                {
+                    if (!bDrawInstances)
+                    {
+                        break;
+                    }
+
+                    const glm::mat4 ModelMatrix = glm::identity<glm::mat4>();
+
+                    FDrawPacket& Packet = Recorder.AddPacket();
+                    Packet.ViewDepth = GetViewDepth(ModelMatrix);
+                    const FMeshDrawInfo DrawInfo = MeshArena.GetDrawInfo(InstRenderData.Mesh);
+
+                    Packet.ProgramId = InstancedProgramId->ProgramId;
+                    Packet.VAO = MeshArena.GetVAO();
+                    Packet.PolygonMode = PolygonMode;
+                    Packet.NumElements = DrawInfo.NumIndices;
+                    Packet.FirstIndex = DrawInfo.FirstIndex;
+                    Packet.BaseVertex = DrawInfo.BaseVertex;
+                    Packet.NumInstances = NumDrawnInstances;
+                    Packet.BaseInstance = MeshArena.GetBaseInstance(InstRenderData.Instances);
+                    Packet.Textures = { EarthTextureId, CloudsTextureId };
+                    Packet.UniformBlocks[0] = { &InstancedFrameBlock, FrameUBO, sizeof(FPerFrameData) };
+                    Packet.Uniforms[0] = { &InstancedNumInstances, static_cast<GLint>(InstRenderData.NumInstances) };
+                    Packet.Uniforms[1] = { &InstancedEarthTexture, 0 };
+                    Packet.Uniforms[2] = { &InstancedCloudsTexture, 1 };
+                    Packet.ModelBlock = &InstancedModelBlock;
+                    Packet.ModelData = { .ModelMatrix = ModelMatrix, .NormalMatrix = ModelMatrix };
+                    break;
+                }
+
+                default:
+                    break;
+            }
+        });
 
-            glBindBuffer(GL_UNIFORM_BUFFER, ModelUBO);
-            glBufferData(GL_UNIFORM_BUFFER, sizeof(FPerModelData), &PerModelUBO, GL_STATIC_DRAW);
+        RenderQueue.Submit(StateCache, Snapshot.CameraFar);
 
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, EarthTextureId);
+        SceneTimer.End();
 
-            glActiveTexture(GL_TEXTURE1);
-            glBindTexture(GL_TEXTURE_2D, CloudsTextureId);
+        if (bScaledScene)
+        {
+            FGPUTimer& UpscaleTimer = GPUPassTimers[static_cast<std::size_t>(EGPUPass::Upscale)];
+            UpscaleTimer.Begin();
+            DynamicResolution.Upscale(StateCache);
+            UpscaleTimer.End();
+        }
 
-            GLint TextureSamplerLoc = glGetUniformLocation(ProgramId->ProgramId, "EarthTexture");
-            glUniform1i(TextureSamplerLoc, 0);
+        if (bRenderTile)
+        {
+            TiledRenderer.FinishTile();
 
-            GLint CloudsTextureSamplerLoc = glGetUniformLocation(ProgramId->ProgramId, "CloudsTexture");
-            glUniform1i(CloudsTextureSamplerLoc, 1);
+            // A janela so mostra a UI com o progresso
+            glBindFramebuffer(GL_FRAMEBUFFER, gConfig.Viewport.SceneTarget.GetFramebuffer());
+            glViewport(0, 0, gConfig.Viewport.WindowWidth, gConfig.Viewport.WindowHeight);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-            glPolygonMode(GL_FRONT_AND_BACK, gConfig.Render.bShowWireframe ? GL_LINE : GL_FILL);
-            glBindVertexArray(GeoRenderData.VAO);
-            glDrawElements(GL_TRIANGLES, GeoRenderData.NumElements, GL_UNSIGNED_INT, nullptr);
-            glBindVertexArray(0);
+            if (bHeadless && gConfig.Render.bPosterOnStart && !TiledRenderer.IsActive())
+            {
+                glfwSetWindowShouldClose(gConfig.Viewport.Window, true);
+            }
+        }
+        else
+        {
+            // A UI nao entra na captura
+            gConfig.Render.FrameCapture.CaptureFrame(SceneFramebuffer, gConfig.Viewport.WindowWidth, gConfig.Viewport.WindowHeight);
         }
 
-        if (gConfig.Render.bDrawInstances)
+        if (!bHeadless)
         {
-            glBindBufferRange(GL_UNIFORM_BUFFER, InstancedProgramId->UniformBlockBindings["FrameUBO"], FrameUBO, 0, sizeof(FPerFrameData));
-            glBindBufferRange(GL_UNIFORM_BUFFER, InstancedProgramId->UniformBlockBindings["ModelUBO"], ModelUBO, 0, sizeof(FPerModelData));
+            FGPUTimer& UITimer = GPUPassTimers[static_cast<std::size_t>(EGPUPass::UI)];
+            UITimer.Begin();
+            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            UITimer.End();
+        }
 
-            // Render Instanced Data
-            glUseProgram(InstancedProgramId->ProgramId);
+        gConfig.Simulation.UpdateTime = Snapshot.UpdateTime;
+        gConfig.Simulation.RenderTime = glfwGetTime() - RenderStartTime;
 
-            glUniform1i(InstancedProgramId->UniformLocations["NumInstances"], InstRenderData.NumInstances);
+        if (!bHeadless)
+        {
+            glfwSwapBuffers(gConfig.Viewport.Window);
 
-            GLint TextureSamplerLoc = glGetUniformLocation(InstancedProgramId->ProgramId, "EarthTexture");
-            glUniform1i(TextureSamplerLoc, 0);
+            if (Snapshot.InputEventTime > 0.0)
+            {
+                FSimulationConfig& Simulation = gConfig.Simulation;
+                Simulation.InputLatency = glfwGetTime() - Snapshot.InputEventTime;
+                Simulation.InputLatencyHistory[Simulation.InputLatencyPlotOffset] = static_cast<float>(Simulation.InputLatency) * 1000.0f;
+                Simulation.InputLatencyPlotOffset = (Simulation.InputLatencyPlotOffset + 1) % Simulation.NumFramePlotValues;
+            }
+        }
+        else
+        {
+            GLsync& FrameFence = HeadlessFrameFences[NumRenderedFrames % MaxHeadlessFramesInFlight];
+            if (FrameFence != nullptr)
+            {
+                glClientWaitSync(FrameFence, GL_SYNC_FLUSH_COMMANDS_BIT, std::numeric_limits<GLuint64>::max());
+                glDeleteSync(FrameFence);
+            }
+            FrameFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            glFlush();
+        }
 
-            GLint CloudsTextureSamplerLoc = glGetUniformLocation(InstancedProgramId->ProgramId, "CloudsTexture");
-            glUniform1i(CloudsTextureSamplerLoc, 1);
+        const double FrameEndTime = glfwGetTime();
+        gConfig.Simulation.FrameStats.AddFrame(FrameEndTime - PreviousFrameEndTime, gConfig.Simulation.UpdateTime, gConfig.Simulation.RenderTime);
 
-            glPolygonMode(GL_FRONT_AND_BACK, gConfig.Render.bShowWireframe ? GL_LINE : GL_FILL);
-            glBindVertexArray(InstRenderData.VAO);
-            glDrawElementsInstanced(GL_TRIANGLES, InstRenderData.NumElements, GL_UNSIGNED_INT, nullptr, std::min(static_cast<GLuint>(InstRenderData.NumInstances), static_cast<GLuint>(gConfig.Scene.NumInstances)));
-            glBindVertexArray(0);
+        FMetricsExporter& MetricsExporter = gConfig.Simulation.MetricsExporter;
+        if (MetricsExporter.IsRunning())
+        {
+            FMetricsSample MetricsSample;
+            MetricsSample.FrameTime = FrameEndTime - PreviousFrameEndTime;
+            MetricsSample.UpdateTime = gConfig.Simulation.UpdateTime;
+            MetricsSample.RenderTime = gConfig.Simulation.RenderTime;
+            for (std::size_t PassIndex = 0; PassIndex < GPUPassTimes.size(); ++PassIndex)
+            {
+                MetricsSample.GPUPassTimes[PassIndex] = GPUPassTimes[PassIndex] >= 0.0 ? GPUPassTimes[PassIndex] / 1000.0 : -1.0;
+            }
+            MetricsSample.NumDrawCalls = RenderQueue.GetNumDrawCalls();
+            MetricsSample.NumDrawPackets = RenderQueue.GetNumSubmittedPackets();
+            MetricsSample.NumInstances = bDrawInstances ? static_cast<std::uint32_t>(NumDrawnInstances) : 0;
+            MetricsSample.RenderScale = bScaledScene ? DynamicResolution.GetScale() : 1.0f;
+            MetricsSample.NumShaderReloads = gConfig.Render.ShaderManager.GetNumReloads();
+            MetricsSample.NumFailedShaderReloads = gConfig.Render.ShaderManager.GetNumFailedReloads();
+            for (std::size_t TypeIndex = 0; TypeIndex < MetricsSample.GPUResources.size(); ++TypeIndex)
+            {
+                MetricsSample.GPUResources[TypeIndex] = ResourceRegistry.GetTotals(static_cast<EGPUResourceType>(TypeIndex));
+            }
+            MetricsExporter.AddSample(MetricsSample);
         }
 
-        glUseProgram(0);
+        PreviousFrameEndTime = FrameEndTime;
 
-        DrawUI();
+        if (Viewport.NumRequestedFrames > 0)
+        {
+            Viewport.NumRequestedFrames--;
+        }
+
+        if (Input.NumStepFrames > 0)
+        {
+            Input.NumStepFrames--;
+        }
 
-        glfwSwapBuffers(gConfig.Viewport.Window);
+        NumRenderedFrames++;
+        if (gConfig.Simulation.MaxFrames > 0 && NumRenderedFrames >= gConfig.Simulation.MaxFrames)
+        {
+            glfwSetWindowShouldClose(gConfig.Viewport.Window, true);
+        }
 
         // O Mouse Delta precisa ser resetado aqui ou ele fica com o valor acumulado do frame anterior
         gConfig.Input.Mouse.MouseDelta = { 0, 0 };
     }
 
+    // O ultimo update pedido ainda pode estar usando a glfw
+    UpdateThread.Wait();
+
+    gConfig.Input.Recorder.Close();
+    gConfig.Input.Replay.Close();
+
+    for (GLsync FrameFence : HeadlessFrameFences)
+    {
+        if (FrameFence != nullptr)
+        {
+            glDeleteSync(FrameFence);
+        }
+    }
+
+    if (gConfig.Simulation.FrameStats.IsRecording())
+    {
+        const FSceneConfig& Scene = gConfig.Scene;
+        const FRenderConfig& Render = gConfig.Render;
+        gConfig.Simulation.FrameStats.WriteCsv(gConfig.Simulation.StatsFile, {
+            { "width", std::to_string(gConfig.Viewport.WindowWidth) },
+            { "height", std::to_string(gConfig.Viewport.WindowHeight) },
+            { "instances", std::to_string(Scene.NumInstances) },
+            { "sphere_resolution", std::to_string(Scene.Description.MeshResolution) },
+            { "wireframe", std::to_string(Render.bShowWireframe) },
+            { "draw_axis", std::to_string(Render.bDrawAxis) },
+            { "draw_object", std::to_string(Render.bDrawObject) },
+            { "draw_instances", std::to_string(Render.bDrawInstances) },
+        });
+    }
+
+    if (FMemoryTracker::IsEnabled())
+    {
+        const FMemoryTracker& MemoryTracker = FMemoryTracker::Get();
+        std::cout << "Frames com alocacoes: " << MemoryTracker.GetNumFramesWithAllocations() << " de " << MemoryTracker.GetNumTrackedFrames() << std::endl;
+    }
+
+    // Libera tudo explicitamente para que o que sobrar no registro seja de fato um vazamento
+    ResourceRegistry.Delete(EGPUResourceType::Buffer, FrameUBO);
+    ResourceRegistry.Delete(EGPUResourceType::Buffer, LightUBO);
+    gConfig.Render.FrameCapture.Shutdown();
+    gConfig.Render.TiledRenderer.Shutdown();
+    gConfig.Viewport.SceneTarget.Shutdown();
+    gConfig.Viewport.DynamicResolution.Shutdown();
+    for (FGPUTimer& PassTimer : gConfig.Render.GPUPassTimers)
+    {
+        PassTimer.Shutdown();
+    }
+    gConfig.Simulation.MetricsExporter.Stop();
+    gConfig.Input.ControlServer.Stop();
+    gConfig.Render.RenderQueue.Shutdown();
+    gConfig.Scene.Preparer.Shutdown(gConfig.Render.MeshArena);
+    gConfig.Render.MeshArena.Shutdown();
+    gConfig.Render.TextureManager.Shutdown();
+    gConfig.Render.ShaderManager.Shutdown();
+    ResourceRegistry.ReportLeaks();
+
     glfwDestroyWindow(gConfig.Viewport.Window);
     glfwTerminate();
 
-    return 0;
+    return bStartupFailed ? EXIT_FAILURE : 0;
 }
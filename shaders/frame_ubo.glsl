@@ -0,0 +1,6 @@
+layout (std140) uniform FrameUBO
+{
+    mat4 View;
+    mat4 Projection;
+    float Time;
+};
@@ -7,12 +7,7 @@ in VertexData
     vec2 UV;
 } In;
 
-layout (std140) uniform FrameUBO
-{
-    mat4 View;
-    mat4 Projection;
-    float Time;
-};
+#include "frame_ubo.glsl"
 
 uniform sampler2D EarthTexture;
 uniform sampler2D CloudsTexture;
@@ -7,18 +7,8 @@ layout(location = 3) in mat4 InModelMatrix;
 
 uniform int NumInstances;
 
-layout (std140) uniform FrameUBO
-{
-    mat4 View;
-    mat4 Projection;
-    float Time;
-};
-
-layout (std140) uniform ModelUBO
-{
-    mat4 Model;
-    mat4 Normal;
-};
+#include "frame_ubo.glsl"
+#include "model_ubo.glsl"
 
 out VertexData
 {
@@ -0,0 +1,10 @@
+struct Light
+{
+    vec3 Position;
+    float Intensity;
+};
+
+layout (std140) uniform LightUBO
+{
+    Light PointLight;
+};
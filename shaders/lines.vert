@@ -5,18 +5,8 @@ layout(location = 1) in vec3 InColor;
 
 out vec3 Color;
 
-layout (std140) uniform FrameUBO
-{
-    mat4 View;
-    mat4 Projection;
-    float Time;
-};
-
-layout (std140) uniform ModelUBO
-{
-    mat4 Model;
-    mat4 Normal;
-};
+#include "frame_ubo.glsl"
+#include "model_ubo.glsl"
 
 void main()
 {
@@ -0,0 +1,5 @@
+layout (std140) uniform ModelUBO
+{
+    mat4 Model;
+    mat4 Normal;
+};
@@ -7,24 +7,8 @@ in VertexData
     vec2 UV;
 } In;
 
-struct Light
-{
-    vec3 Position;
-    float Intensity;
-};
-
-layout (std140) uniform LightUBO
-{
-    Light PointLight;
-};
-
-layout (std140) uniform FrameUBO
-{
-    mat4 View;
-    mat4 Projection;
-
-    float Time;
-};
+#include "frame_ubo.glsl"
+#include "light_ubo.glsl"
 
 uniform sampler2D EarthTexture;
 uniform sampler2D CloudsTexture;
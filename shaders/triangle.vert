@@ -4,19 +4,8 @@ layout(location = 0) in vec3 InPosition;
 layout(location = 1) in vec3 InNormal;
 layout(location = 2) in vec2 InUV;
 
-layout (std140) uniform FrameUBO
-{
-    mat4 View;
-    mat4 Projection;
-
-    float Time;
-};
-
-layout (std140) uniform ModelUBO
-{
-    mat4 Model;
-    mat4 Normal;
-};
+#include "frame_ubo.glsl"
+#include "model_ubo.glsl"
 
 out VertexData
 {
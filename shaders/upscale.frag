@@ -0,0 +1,35 @@
+#version 330 core
+
+in vec2 UV;
+
+// A cena ocupa so o canto inferior esquerdo da textura, na fracao UVScale
+uniform sampler2D SceneTexture;
+uniform vec2 UVScale;
+
+// Meio texel antes da borda da area desenhada, o resto da textura tem frames antigos
+uniform vec2 MaxUV;
+
+// Zero e so o filtro bilinear
+uniform float Sharpness = 0.0;
+
+out vec4 OutColor;
+
+vec3 SampleScene(vec2 InUV)
+{
+    return texture(SceneTexture, min(InUV, MaxUV)).rgb;
+}
+
+void main()
+{
+    vec2 SceneUV = UV * UVScale;
+    vec2 Texel = 1.0 / vec2(textureSize(SceneTexture, 0));
+
+    vec3 Center = SampleScene(SceneUV);
+    vec3 Neighbors = SampleScene(SceneUV + vec2(Texel.x, 0.0)) + SampleScene(SceneUV - vec2(Texel.x, 0.0)) +
+                     SampleScene(SceneUV + vec2(0.0, Texel.y)) + SampleScene(SceneUV - vec2(0.0, Texel.y));
+
+    // Unsharp mask: o bilinear borra a imagem ampliada, a diferenca para a media dos vizinhos devolve parte das bordas
+    vec3 Sharpened = Center + (Center - Neighbors * 0.25) * Sharpness;
+
+    OutColor = vec4(clamp(Sharpened, 0.0, 1.0), 1.0);
+}
\ No newline at end of file
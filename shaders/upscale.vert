@@ -0,0 +1,10 @@
+#version 330 core
+
+out vec2 UV;
+
+// Um triangulo que cobre a tela inteira, gerado a partir do gl_VertexID sem vertex buffer
+void main()
+{
+    UV = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    gl_Position = vec4(UV * 2.0 - 1.0, 0.0, 1.0);
+}
\ No newline at end of file